@@ -0,0 +1,29 @@
+# Codigo compartido por biometria_oreja y biometria_voz.
+# Cada proyecto lo incluye y agrega BIOMETRIA_COMUN_SRC a su biblioteca base:
+#   set(BIOMETRIA_SERVICIO "oreja")   # prefijo de metricas y nombre en trazas
+#   include(${BIOMETRIA_COMUN_DIR}/comun.cmake)
+# Los headers se incluyen como "comun/<archivo>.h"
+
+if(NOT BIOMETRIA_SERVICIO)
+    message(FATAL_ERROR "Fijar BIOMETRIA_SERVICIO antes de incluir comun.cmake")
+endif()
+add_compile_definitions(BIOMETRIA_SERVICIO="${BIOMETRIA_SERVICIO}")
+
+set(BIOMETRIA_COMUN_INCLUDE "${CMAKE_CURRENT_LIST_DIR}/include")
+
+file(GLOB BIOMETRIA_COMUN_SRC CONFIGURE_DEPENDS
+    "${CMAKE_CURRENT_LIST_DIR}/src/*.cpp"
+)
+
+# Contador de reservas (reemplaza operator new/delete globales): NO va en la
+# biblioteca base, solo en los ejecutables de micro-benchmark
+set(BIOMETRIA_COMUN_BENCHMARK_SRC "${CMAKE_CURRENT_LIST_DIR}/src/benchmark/contador_reservas.cpp")
+
+# Instrumentacion HTTP y sync en bloque (necesitan httplib.h y json.hpp en el
+# include path): solo servidores
+set(BIOMETRIA_COMUN_HTTP_SRC
+    "${CMAKE_CURRENT_LIST_DIR}/src/http/metricas_http.cpp"
+    "${CMAKE_CURRENT_LIST_DIR}/src/http/sync_bulk.cpp"
+)
+
+include_directories(${BIOMETRIA_COMUN_INCLUDE})
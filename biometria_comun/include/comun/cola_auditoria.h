@@ -0,0 +1,77 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Cola de auditoria en proceso (validaciones_biometricas), comun a oreja y voz:
+// - registrar() no bloquea ni lanza: la autenticacion nunca espera a la BD
+// - Un hilo de fondo agrupa filas en un POST con body array (insercion en bloque)
+// - Si la BD no responde, las filas van a un spool JSONL append-only y se
+//   reenvian, en orden, al recuperar conexion
+// El transporte (cliente HTTP + metricas) y el log los pone cada servicio.
+namespace auditoria {
+
+// Ok: insertado. Reintentar: sin respuesta o 5xx (va al spool).
+// Descartar: 4xx, error de datos que reintentar no arregla (bloquearia el spool).
+// Un lote rechazado se reenvia fila por fila: solo se descarta la fila mala
+enum class Envio { Ok, Reintentar, Descartar };
+
+enum class Nivel { Info, Aviso, Error };
+
+struct Config {
+    std::string rutaSpool;      // vacio: sin spool, con BD caida se pierden filas
+    size_t maxLote = 64;        // filas por POST
+    int flushMs = 500;          // flush por tiempo aunque el lote no se llene
+    int reintentoMs = 5000;     // reintento del spool con BD caida
+    size_t maxCola = 10000;     // tope en memoria (se descartan las mas viejas)
+};
+
+// cuerpo: array JSON con `filas` elementos
+using FuncionEnviar = std::function<Envio(const std::string& cuerpo, size_t filas)>;
+using FuncionLog = std::function<void(Nivel, const std::string&)>;
+
+class Cola {
+public:
+    // log vacio: std::cerr
+    Cola(Config cfg, FuncionEnviar enviar, FuncionLog log = {});
+    ~Cola(); // drena la cola (BD o spool) antes de salir
+
+    Cola(const Cola&) = delete;
+    Cola& operator=(const Cola&) = delete;
+
+    // filaJson: un objeto JSON serializado (una fila de la tabla)
+    void registrar(std::string filaJson);
+
+private:
+    void bucle();
+    void vaciarLote(std::vector<std::string>& lote);
+    size_t enviarLote(const std::vector<std::string>& filas, size_t ini, size_t fin);
+    Envio enviarFilas(const std::vector<std::string>& filas, size_t ini, size_t fin);
+    void guardarEnSpool(const std::vector<std::string>& filas);
+    bool reenviarSpool();
+    void log(Nivel nivel, const std::string& msg) const;
+
+    Config cfg_;
+    FuncionEnviar enviar_;
+    FuncionLog log_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::deque<std::string> cola_;
+    bool detener_ = false;
+    size_t descartadas_ = 0;
+
+    // Solo los toca el hilo de fondo
+    bool spoolPendiente_ = false;
+    std::chrono::steady_clock::time_point ultimoReintento_{};
+
+    std::thread hilo_;
+};
+
+} // namespace auditoria
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// CODECS DE TRANSPORTE PARA VECTORES DE CARACTERISTICAS (SYNC MOVIL)
+// Comun a oreja y voz (biometria_comun)
+// Blob empaquetado (little-endian), header de 8 bytes:
+//   [0..1] 'F' 'V'  [2] version (1)  [3] bytes por valor (4=float32, 8=float64)
+//   [4..7] dimension (uint32)        [8..] dimension * bytesPorValor
+// En JSON viaja como base64 ("vector_features_b64") en lugar de un array de
+// doubles (~20 caracteres por valor): ~2x menos bytes en float64, ~4x en float32
+// ============================================================================
+
+// Base64 estandar (RFC 4648, con padding)
+std::string codificarBase64(const uint8_t* data, size_t n);
+bool decodificarBase64(const std::string& in, std::vector<uint8_t>& out);
+
+// Blob con header
+std::vector<uint8_t> empaquetarFeatures(const std::vector<double>& v, bool float32);
+bool desempaquetarFeatures(const uint8_t* data, size_t n, std::vector<double>& out);
+
+// BYTEA de PostgreSQL en formato hex ("\x" + 2 digitos por byte), via tablas
+std::string vectorAByteaHex(const std::vector<double>& v);
+bool byteaHexAVector(const std::string& hex, std::vector<double>& out);
@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Registro de metricas en proceso, comun a oreja y voz, exportado en formato
+// de texto de Prometheus (GET /metrics).
+// - Contador / Medidor / Histograma: solo atomicos relaxed en el camino caliente
+// - El alta de una serie (nombre + etiquetas) toma un mutex y devuelve una
+//   referencia estable: en bucles calientes se guarda en un static local
+//     static auto& h = metricas::etapa("preproc");
+// Los nombres propios de cada servicio llevan el prefijo BIOMETRIA_SERVICIO
+// ("oreja" / "voz", definido por comun.cmake).
+namespace metricas {
+
+using Etiquetas = std::vector<std::pair<std::string, std::string>>;
+
+class Contador {
+public:
+    void inc(uint64_t n = 1) { valor_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t valor() const { return valor_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> valor_{ 0 };
+};
+
+class Medidor {
+public:
+    void fijar(double v) { valor_.store(v, std::memory_order_relaxed); }
+    void sumar(double d) { valor_.fetch_add(d, std::memory_order_relaxed); }
+    double valor() const { return valor_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> valor_{ 0.0 };
+};
+
+// Cubetas fijas (limite superior inclusivo, "le"); se acumulan al exportar
+class Histograma {
+public:
+    explicit Histograma(std::vector<double> limites);
+
+    void observar(double v);
+
+    const std::vector<double>& limites() const { return limites_; }
+    uint64_t cubeta(size_t i) const { return cubetas_[i].load(std::memory_order_relaxed); } // i == limites().size(): +Inf
+    double suma() const { return suma_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<double> limites_;
+    std::unique_ptr<std::atomic<uint64_t>[]> cubetas_;
+    std::atomic<double> suma_{ 0.0 };
+};
+
+// RAII: observa la duracion del bloque en segundos
+class Temporizador {
+public:
+    explicit Temporizador(Histograma& h) : h_(h), t0_(std::chrono::steady_clock::now()) {}
+    ~Temporizador() { h_.observar(segundos()); }
+
+    double segundos() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0_).count();
+    }
+
+private:
+    Histograma& h_;
+    std::chrono::steady_clock::time_point t0_;
+};
+
+// Latencias en segundos: 0.5 ms .. 30 s
+const std::vector<double>& limitesLatencia();
+
+// Alta o busqueda de la serie; mismo nombre con otro tipo -> std::invalid_argument
+Contador& contador(const std::string& nombre, const std::string& ayuda, const Etiquetas& etiquetas = {});
+Medidor& medidor(const std::string& nombre, const std::string& ayuda, const Etiquetas& etiquetas = {});
+Histograma& histograma(const std::string& nombre, const std::string& ayuda, const Etiquetas& etiquetas = {},
+                       const std::vector<double>& limites = limitesLatencia());
+
+// Histograma de etapas del pipeline: <servicio>_etapa_duracion_segundos{etapa}
+Histograma& etapa(const std::string& nombre);
+
+// Texto para GET /metrics (Content-Type: text/plain; version=0.0.4)
+std::string exportarPrometheus();
+
+} // namespace metricas
@@ -0,0 +1,57 @@
+#pragma once
+#include "httplib.h"
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+#include "comun/metricas.h"
+#include "comun/trazas.h"
+
+// Instrumentacion HTTP comun a los servidores de oreja y voz (GET /metrics),
+// con el prefijo BIOMETRIA_SERVICIO:
+//  - <servicio>_http_solicitudes_total{ruta,metodo,codigo}
+//  - <servicio>_http_duracion_segundos{ruta}      (desde el ruteo hasta escribir la respuesta)
+//  - <servicio>_http_en_curso
+//  - <servicio>_cola_espera_segundos{cola="http"} (conexion aceptada -> hilo del pool libre)
+//  - <servicio>_bd_duracion_segundos{metodo,tabla} y <servicio>_bd_errores_total{metodo,tabla}
+// Las series por ruta/tabla se resuelven una vez por hilo (cache thread_local):
+// el mutex del registro no se toma en cada solicitud.
+// Compilado aparte (BIOMETRIA_COMUN_HTTP_SRC): solo lo enlazan los servidores.
+namespace metricas_http {
+
+struct Opciones {
+    // Pre-routing propio (p. ej. CORS): se encadena detras de la instrumentacion
+    httplib::Server::HandlerWithResponse preRuteo;
+    // Rid nuevo por solicitud (cabecera X-Request-Id) y raiz de traza con ese rid,
+    // cerrada en el logger. Apagado si los handlers abren su propia raiz
+    bool trazaPorSolicitud = false;
+};
+
+// Ocupa el pre-routing handler y el logger del servidor: llamar antes de listen()
+void instrumentarServidorHttp(httplib::Server& srv, Opciones opciones = {});
+
+// Mide una llamada a PostgREST (reintentos incluidos, de la construccion a fin())
+// y la deja como span "bd <metodo> <tabla>" si el hilo tiene traza.
+// Construir y terminar en el mismo hilo
+class MedicionBD {
+public:
+    MedicionBD(const char* metodo, const std::string& endpoint);
+
+    // Sin respuesta o status >= 400 cuenta como error
+    void fin(const httplib::Result& res);
+
+private:
+    struct Series;
+    static Series& seriesDe(const char* metodo, const std::string& endpoint); // cache por hilo
+
+    Series& series_;
+    trazas::Span span_;
+    std::chrono::steady_clock::time_point inicio_;
+};
+
+// MedicionBD alrededor de una sola llamada
+httplib::Result medirBD(const char* metodo, const std::string& endpoint,
+                        const std::function<httplib::Result()>& llamada);
+
+} // namespace metricas_http
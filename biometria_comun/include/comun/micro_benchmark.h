@@ -0,0 +1,303 @@
+#pragma once
+
+// Micro-benchmarks repetibles por etapa del pipeline, comunes a oreja y voz.
+// - Calibra iteraciones hasta --min-ms por repeticion, corre --reps
+//   repeticiones y reporta la mediana de ns/op (mas min/max)
+// - Throughput en items/s (pixeles, muestras, clases... segun la etapa)
+// - Reservas de memoria por op contando operator new
+// - --json=<ruta> escribe los resultados; --base=<ruta> compara contra un
+//   JSON anterior y sale con codigo 2 si algo empeora mas de --tolerancia
+//
+// Los contadores de reservas (operator new/delete globales) viven en
+// src/benchmark/contador_reservas.cpp: enlazar BIOMETRIA_COMUN_BENCHMARK_SRC
+// solo en los binarios de benchmark.
+
+#include "json.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ==========================
+// Conteo de reservas
+// ==========================
+// Definidos junto con operator new en contador_reservas.cpp
+extern std::atomic<uint64_t> g_benchReservas;
+extern std::atomic<uint64_t> g_benchBytes;
+
+// Evita que el compilador elimine un resultado no usado
+template <typename T>
+inline void noOptimizar(const T& valor) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(valor) : "memory");
+#else
+    static volatile const void* sumidero;
+    sumidero = &valor;
+#endif
+}
+
+struct ResultadoBenchmark {
+    std::string nombre;
+    std::string unidad;          // que cuenta itemsPorOp
+    uint64_t iteraciones = 0;    // por repeticion
+    double nsOp = 0.0;           // mediana
+    double nsMin = 0.0;
+    double nsMax = 0.0;
+    double itemsPorSeg = 0.0;
+    double reservasOp = 0.0;
+    double bytesOp = 0.0;
+};
+
+class SuiteBenchmark {
+public:
+    SuiteBenchmark(std::string nombre, int argc, char** argv) : suite(std::move(nombre)) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string a = argv[i];
+            auto valor = [&](const char* clave) -> const char* {
+                const size_t n = std::char_traits<char>::length(clave);
+                return (a.compare(0, n, clave) == 0) ? a.c_str() + n : nullptr;
+            };
+            if (const char* v = valor("--filtro=")) filtro = v;
+            else if (const char* v = valor("--json=")) rutaJson = v;
+            else if (const char* v = valor("--base=")) rutaBase = v;
+            else if (const char* v = valor("--tolerancia=")) tolerancia = std::atof(v);
+            else if (const char* v = valor("--min-ms=")) minMs = std::max(1.0, std::atof(v));
+            else if (const char* v = valor("--reps=")) reps = std::max(1, std::atoi(v));
+            else if (a == "--listar") soloListar = true;
+            else {
+                std::cerr << "Uso: " << argv[0] << " [--filtro=txt] [--json=salida.json] [--base=anterior.json]"
+                          << " [--tolerancia=0.10] [--min-ms=200] [--reps=5] [--listar]\n";
+                std::exit(1);
+            }
+        }
+    }
+
+    // Metadatos de compilacion/entorno que acompanan al JSON (precision, build)
+    void anotar(const std::string& clave, const std::string& valor) { notas[clave] = valor; }
+
+    // Silencio adicional mientras se mide (p. ej. un logger que escribe directo
+    // a stderr sin pasar por std::cerr): fn(true) al entrar, fn(false) al salir
+    void alSilenciar(std::function<void(bool)> fn) { silenciarExtra = std::move(fn); }
+
+    void agregar(const std::string& nombre, const std::string& unidad, double itemsPorOp,
+                 std::function<void()> fn) {
+        casos.push_back({ nombre, unidad, itemsPorOp, std::move(fn) });
+    }
+
+    // 0 = ok, 2 = regresion contra --base
+    int ejecutar() {
+        std::vector<ResultadoBenchmark> resultados;
+        for (const auto& c : casos) {
+            if (!filtro.empty() && c.nombre.find(filtro) == std::string::npos) continue;
+            if (soloListar) {
+                std::cout << c.nombre << "\n";
+                continue;
+            }
+            resultados.push_back(medir(c));
+            imprimir(resultados.back());
+        }
+        if (soloListar) return 0;
+
+        auto build = notas.find("build");
+        if (build != notas.end() && build->second != "release") {
+            std::cout << "\nADVERTENCIA: binario sin optimizar (build=" << build->second
+                      << "); compilar con -DCMAKE_BUILD_TYPE=Release para medir\n";
+        }
+
+        if (!rutaJson.empty()) guardarJson(resultados);
+        return rutaBase.empty() ? 0 : comparar(resultados);
+    }
+
+private:
+    struct Caso {
+        std::string nombre;
+        std::string unidad;
+        double itemsPorOp;
+        std::function<void()> fn;
+    };
+
+    using Reloj = std::chrono::steady_clock;
+
+    static double nsDesde(Reloj::time_point t0) {
+        return std::chrono::duration<double, std::nano>(Reloj::now() - t0).count();
+    }
+
+    // Descarta lo que las etapas escriben por std::cout/std::cerr (logs de carga, etc.)
+    // y lo que cubra el hook de alSilenciar
+    struct SilenciarSalida {
+        struct Nulo : std::streambuf {
+            int overflow(int c) override { return c; }
+        } nulo;
+        const std::function<void(bool)>& extra;
+        std::streambuf* out;
+        std::streambuf* err;
+        explicit SilenciarSalida(const std::function<void(bool)>& fn)
+            : extra(fn), out(std::cout.rdbuf(&nulo)), err(std::cerr.rdbuf(&nulo)) {
+            if (extra) extra(true);
+        }
+        ~SilenciarSalida() {
+            if (extra) extra(false);
+            std::cout.rdbuf(out);
+            std::cerr.rdbuf(err);
+        }
+    };
+
+    ResultadoBenchmark medir(const Caso& c) const {
+        SilenciarSalida silencio(silenciarExtra);
+
+        // Calentamiento + calibracion: duplicar hasta llegar a minMs
+        c.fn();
+        uint64_t n = 1;
+        for (;;) {
+            const auto t0 = Reloj::now();
+            for (uint64_t i = 0; i < n; ++i) c.fn();
+            const double ns = nsDesde(t0);
+            if (ns >= minMs * 1e6 || n >= (1ull << 30)) break;
+            const double factor = (ns > 0.0) ? (minMs * 1e6 * 1.2) / ns : 10.0;
+            n = std::max<uint64_t>(n * 2, static_cast<uint64_t>(n * std::min(factor, 10.0)));
+        }
+
+        std::vector<double> nsPorOp;
+        nsPorOp.reserve(reps);
+        const uint64_t r0 = g_benchReservas.load(std::memory_order_relaxed);
+        const uint64_t b0 = g_benchBytes.load(std::memory_order_relaxed);
+        for (int r = 0; r < reps; ++r) {
+            const auto t0 = Reloj::now();
+            for (uint64_t i = 0; i < n; ++i) c.fn();
+            nsPorOp.push_back(nsDesde(t0) / n);
+        }
+        const double total = static_cast<double>(n) * reps;
+
+        ResultadoBenchmark res;
+        res.nombre = c.nombre;
+        res.unidad = c.unidad;
+        res.iteraciones = n;
+        res.reservasOp = (g_benchReservas.load(std::memory_order_relaxed) - r0) / total;
+        res.bytesOp = (g_benchBytes.load(std::memory_order_relaxed) - b0) / total;
+
+        std::sort(nsPorOp.begin(), nsPorOp.end());
+        res.nsOp = nsPorOp[nsPorOp.size() / 2];
+        res.nsMin = nsPorOp.front();
+        res.nsMax = nsPorOp.back();
+        res.itemsPorSeg = (res.nsOp > 0.0) ? c.itemsPorOp * 1e9 / res.nsOp : 0.0;
+        return res;
+    }
+
+    static std::string formatoTiempo(double ns) {
+        char buf[32];
+        if (ns >= 1e9) std::snprintf(buf, sizeof(buf), "%.3f s", ns / 1e9);
+        else if (ns >= 1e6) std::snprintf(buf, sizeof(buf), "%.3f ms", ns / 1e6);
+        else if (ns >= 1e3) std::snprintf(buf, sizeof(buf), "%.3f us", ns / 1e3);
+        else std::snprintf(buf, sizeof(buf), "%.1f ns", ns);
+        return buf;
+    }
+
+    void imprimir(const ResultadoBenchmark& r) const {
+        if (!cabeceraImpresa) {
+            std::cout << std::left << std::setw(34) << "benchmark" << std::right
+                      << std::setw(14) << "tiempo/op" << std::setw(10) << "+/-%"
+                      << std::setw(22) << "throughput" << std::setw(12) << "allocs/op"
+                      << std::setw(14) << "bytes/op" << "\n"
+                      << std::string(106, '-') << "\n";
+            cabeceraImpresa = true;
+        }
+        const double dispersion = (r.nsOp > 0.0) ? 100.0 * (r.nsMax - r.nsMin) / (2.0 * r.nsOp) : 0.0;
+        char thr[48];
+        std::snprintf(thr, sizeof(thr), "%.3g %s/s", r.itemsPorSeg, r.unidad.c_str());
+        std::cout << std::left << std::setw(34) << r.nombre << std::right
+                  << std::setw(14) << formatoTiempo(r.nsOp)
+                  << std::setw(10) << std::fixed << std::setprecision(1) << dispersion
+                  << std::setw(22) << thr
+                  << std::setw(12) << std::setprecision(1) << r.reservasOp
+                  << std::setw(14) << std::setprecision(0) << r.bytesOp << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+    }
+
+    void guardarJson(const std::vector<ResultadoBenchmark>& resultados) const {
+        nlohmann::json j;
+        j["suite"] = suite;
+        j["fecha"] = static_cast<int64_t>(std::time(nullptr));
+        j["hilos_hw"] = std::thread::hardware_concurrency();
+        j["reps"] = reps;
+        j["min_ms"] = minMs;
+        for (const auto& [k, v] : notas) j["entorno"][k] = v;
+        j["resultados"] = nlohmann::json::array();
+        for (const auto& r : resultados) {
+            j["resultados"].push_back({
+                { "nombre", r.nombre }, { "unidad", r.unidad }, { "iteraciones", r.iteraciones },
+                { "ns_op", r.nsOp }, { "ns_min", r.nsMin }, { "ns_max", r.nsMax },
+                { "items_s", r.itemsPorSeg }, { "allocs_op", r.reservasOp }, { "bytes_op", r.bytesOp } });
+        }
+        std::ofstream f(rutaJson);
+        if (!f) {
+            std::cerr << "No se pudo escribir " << rutaJson << "\n";
+            return;
+        }
+        f << j.dump(2) << "\n";
+        std::cout << "\nResultados: " << rutaJson << "\n";
+    }
+
+    int comparar(const std::vector<ResultadoBenchmark>& resultados) const {
+        std::ifstream f(rutaBase);
+        nlohmann::json base;
+        try { f >> base; }
+        catch (...) {
+            std::cerr << "Base ilegible: " << rutaBase << "\n";
+            return 1;
+        }
+
+        std::map<std::string, std::pair<double, double>> previos;  // nombre -> (ns_op, allocs_op)
+        for (const auto& r : base.value("resultados", nlohmann::json::array())) {
+            previos[r.value("nombre", "")] = { r.value("ns_op", 0.0), r.value("allocs_op", 0.0) };
+        }
+
+        std::cout << "\nComparacion contra " << rutaBase << " (tolerancia "
+                  << std::fixed << std::setprecision(0) << tolerancia * 100.0 << "%)\n";
+        int regresiones = 0;
+        for (const auto& r : resultados) {
+            auto it = previos.find(r.nombre);
+            if (it == previos.end() || it->second.first <= 0.0) {
+                std::cout << "  " << std::left << std::setw(34) << r.nombre << "  (nuevo)\n";
+                continue;
+            }
+            const double delta = r.nsOp / it->second.first - 1.0;
+            const bool masAllocs = r.reservasOp > it->second.second + 0.5;
+            const bool regresion = delta > tolerancia || masAllocs;
+            if (regresion) ++regresiones;
+            std::cout << "  " << std::left << std::setw(34) << r.nombre << std::right
+                      << std::showpos << std::setw(8) << std::setprecision(1) << delta * 100.0 << "%"
+                      << std::noshowpos
+                      << (masAllocs ? "  +allocs" : "")
+                      << (regresion ? "  REGRESION" : (delta < -tolerancia ? "  mejora" : "")) << "\n";
+        }
+        std::cout.unsetf(std::ios::floatfield);
+        return regresiones > 0 ? 2 : 0;
+    }
+
+    std::string suite;
+    std::vector<Caso> casos;
+    std::map<std::string, std::string> notas;
+    std::function<void(bool)> silenciarExtra;
+
+    std::string filtro;
+    std::string rutaJson;
+    std::string rutaBase;
+    double tolerancia = 0.10;
+    double minMs = 200.0;
+    int reps = 5;
+    bool soloListar = false;
+    mutable bool cabeceraImpresa = false;
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include "httplib.h"
+#include "json.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Insercion en bloque de caracteristicas sincronizadas desde el movil, comun a
+// oreja (caracteristicas_oreja) y voz (caracteristicas_hablantes):
+// - POST con body array en chunks de `chunk` filas (todas con las mismas claves:
+//   PostgREST lo exige en bulk; los opcionales van como null)
+// - Idempotente por (uuid_dispositivo, id_muestra_cliente) con
+//   resolution=merge-duplicates: un reintento devuelve el mismo id_caracteristica
+// - Claves repetidas en la entrada se insertan una vez y comparten resultado
+// - Chunk rechazado por datos (4xx): se reintenta fila por fila para aislar la mala
+// - BD sin respuesta o 5xx: el chunk queda con error (el movil reenvia el lote)
+// Compilado aparte (BIOMETRIA_COMUN_HTTP_SRC): solo lo enlazan los servidores.
+namespace sync_bulk {
+
+// Mismo orden que la entrada
+struct Resultado {
+    int idCaracteristica = -1;  // -1 si no se inserto
+    std::string error;          // vacio si OK
+};
+
+enum class Nivel { Info, Aviso };
+
+// log vacio: std::cerr
+using FuncionLog = std::function<void(Nivel, const std::string&)>;
+
+std::vector<Resultado> insertar(httplib::Client& cli, const std::string& tabla,
+                                const std::vector<nlohmann::json>& filas, size_t chunk,
+                                const FuncionLog& log = {});
+
+} // namespace sync_bulk
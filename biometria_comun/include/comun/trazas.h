@@ -0,0 +1,60 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Trazas por solicitud, comunes a oreja y voz: spans anidados con rid e hilo,
+// exportados como Chrome trace_event (chrome://tracing, Perfetto) u OTLP/JSON.
+// - El primer span con rid en un hilo es la raiz; decide el muestreo con un
+//   hash del rid (determinista: padre e hijo deciden igual) y al cerrarse
+//   escribe <dir>/<rid>-<proceso>.trace.json | .otlp.json
+// - Los spans se acumulan en un buffer propio del hilo (sin locks); sin traza
+//   muestreada en el hilo, un Span no hace nada mas que leer un thread_local
+// - Un proceso hijo (predecir) recibe el span padre por argumento y manda sus
+//   spans por stderr como lineas "TRAZA_SPAN ..."; el padre las importa a su traza
+// El servicio (categoria Chrome, service.name OTLP) es BIOMETRIA_SERVICIO.
+namespace trazas {
+
+enum class Formato { Chrome, Otlp };
+
+// tasa en [0, 1]: fraccion de rids trazados (0 = apagado, por defecto)
+void configurar(double tasa, const std::string& directorio, Formato formato, const std::string& proceso);
+
+// <prefijo>TASA (0), <prefijo>DIR ("trazas"), <prefijo>FORMATO ("chrome" | "otlp");
+// prefijoEnv: "TRAZAS_" en oreja, "VOZ_TRAZAS_" en voz
+void configurarDesdeEntorno(const std::string& proceso, const std::string& prefijoEnv);
+
+// En el proceso hijo: la proxima raiz cuelga de spanPadre, se muestrea siempre
+// y sus spans salen por stderr en vez de a archivo
+void continuarTrazaDe(const std::string& spanPadre);
+
+// Id corto de solicitud (12 hex), mismo formato en oreja y voz
+std::string nuevoRid();
+
+// Id (16 hex) del span abierto mas interno si el hilo tiene traza muestreada; "" si no
+std::string spanActual();
+
+// Linea "TRAZA_SPAN ..." del stderr de un hijo -> traza del hilo. false si no lo es
+bool importarLinea(const std::string& linea);
+
+class Span {
+public:
+    explicit Span(const std::string& nombre, const std::string& rid = {});
+    ~Span() { terminar(); }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    // Cierra antes del fin del bloque (etapas secuenciales). Idempotente
+    void terminar();
+
+private:
+    std::string nombre_;
+    uint64_t id_ = 0;   // 0: no registra
+    uint64_t padre_ = 0;
+    bool raiz_ = false;
+    int64_t inicioUs_ = 0;
+    std::chrono::steady_clock::time_point t0_;
+};
+
+} // namespace trazas
@@ -0,0 +1,33 @@
+// Reemplazo de operator new/delete globales para contar reservas por op en
+// los micro-benchmarks (comun/micro_benchmark.h). Fuera del glob de
+// BIOMETRIA_COMUN_SRC: solo se enlaza en benchmark_oreja y voz_benchmark.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+std::atomic<uint64_t> g_benchReservas{ 0 };
+std::atomic<uint64_t> g_benchBytes{ 0 };
+
+void* operator new(std::size_t n) {
+    g_benchReservas.fetch_add(1, std::memory_order_relaxed);
+    g_benchBytes.fetch_add(n, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) { return ::operator new(n); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+    try { return ::operator new(n); }
+    catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept {
+    try { return ::operator new(n); }
+    catch (...) { return nullptr; }
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
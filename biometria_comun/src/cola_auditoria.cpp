@@ -0,0 +1,244 @@
+#include "comun/cola_auditoria.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace auditoria {
+
+Cola::Cola(Config cfg, FuncionEnviar enviar, FuncionLog log)
+    : cfg_(std::move(cfg)), enviar_(std::move(enviar)), log_(std::move(log)) {
+    if (cfg_.maxLote == 0) cfg_.maxLote = 1;
+
+    // Spool de una ejecucion anterior: se reintenta apenas arranque el hilo
+    std::error_code ec;
+    if (!cfg_.rutaSpool.empty() && fs::exists(cfg_.rutaSpool, ec) && fs::file_size(cfg_.rutaSpool, ec) > 0) {
+        spoolPendiente_ = true;
+        this->log(Nivel::Aviso, "Spool pendiente de ejecucion anterior: " + cfg_.rutaSpool);
+    }
+
+    hilo_ = std::thread(&Cola::bucle, this);
+}
+
+Cola::~Cola() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        detener_ = true;
+    }
+    cv_.notify_all();
+    if (hilo_.joinable()) hilo_.join();
+}
+
+void Cola::log(Nivel nivel, const std::string& msg) const {
+    if (log_) {
+        log_(nivel, msg);
+        return;
+    }
+    static const char* niveles[] = {"INFO", "WARN", "ERROR"};
+    std::cerr << "[AUDIT] " << niveles[(int)nivel] << ": " << msg << std::endl;
+}
+
+void Cola::registrar(std::string filaJson) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (cola_.size() >= cfg_.maxCola) {
+            cola_.pop_front();
+            ++descartadas_;
+        }
+        cola_.push_back(std::move(filaJson));
+        if (cola_.size() < cfg_.maxLote) return; // el timer se encarga
+    }
+    cv_.notify_one();
+}
+
+void Cola::bucle() {
+    std::vector<std::string> lote;
+    lote.reserve(cfg_.maxLote);
+
+    for (;;) {
+        bool terminar = false;
+        size_t perdidas = 0;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            cv_.wait_for(lock, std::chrono::milliseconds(cfg_.flushMs),
+                         [this] { return detener_ || cola_.size() >= cfg_.maxLote; });
+
+            while (!cola_.empty() && lote.size() < cfg_.maxLote) {
+                lote.push_back(std::move(cola_.front()));
+                cola_.pop_front();
+            }
+            std::swap(perdidas, descartadas_);
+            terminar = detener_ && cola_.empty();
+        }
+
+        if (perdidas > 0)
+            log(Nivel::Aviso, "Cola llena: se descartaron " + std::to_string(perdidas) + " validaciones");
+
+        if (!lote.empty()) {
+            vaciarLote(lote);
+        } else if (spoolPendiente_ && !terminar) {
+            const auto ahora = std::chrono::steady_clock::now();
+            if (ahora - ultimoReintento_ >= std::chrono::milliseconds(cfg_.reintentoMs)) {
+                ultimoReintento_ = ahora;
+                reenviarSpool();
+            }
+        }
+
+        if (terminar) break;
+    }
+}
+
+void Cola::vaciarLote(std::vector<std::string>& lote) {
+    const auto ahora = std::chrono::steady_clock::now();
+
+    // BD caida: no insistir en cada lote (la cola sigue drenando rapido);
+    // solo cada reintentoMs, y mientras el spool no se vacie se escribe detras
+    if (spoolPendiente_) {
+        bool recuperado = false;
+        if (ahora - ultimoReintento_ >= std::chrono::milliseconds(cfg_.reintentoMs)) {
+            ultimoReintento_ = ahora;
+            recuperado = reenviarSpool();
+        }
+        if (!recuperado) {
+            guardarEnSpool(lote);
+            lote.clear();
+            return;
+        }
+    }
+
+    const size_t resueltas = enviarLote(lote, 0, lote.size());
+    if (resueltas < lote.size()) {
+        lote.erase(lote.begin(), lote.begin() + resueltas);
+        guardarEnSpool(lote);
+        spoolPendiente_ = true;
+        ultimoReintento_ = ahora;
+    }
+    lote.clear();
+}
+
+Envio Cola::enviarFilas(const std::vector<std::string>& filas, size_t ini, size_t fin) {
+    std::string cuerpo = "[";
+    for (size_t i = ini; i < fin; ++i) {
+        if (i > ini) cuerpo += ',';
+        cuerpo += filas[i];
+    }
+    cuerpo += ']';
+    return enviar_(cuerpo, fin - ini);
+}
+
+// Filas resueltas (insertadas o descartadas) desde ini, en orden. Menos de
+// fin - ini: la BD dejo de responder y el resto hay que reintentarlo
+size_t Cola::enviarLote(const std::vector<std::string>& filas, size_t ini, size_t fin) {
+    const size_t n = fin - ini;
+    const Envio r = enviarFilas(filas, ini, fin);
+    if (r == Envio::Ok) return n;
+
+    if (r == Envio::Descartar && n > 1) {
+        // Alguna fila es invalida: aislarla fila por fila (igual que sync_bulk)
+        log(Nivel::Aviso, "POST rechazado por datos (filas=" + std::to_string(n) + ") -> reintento fila por fila");
+        size_t descartadas = 0;
+        for (size_t i = ini; i < fin; ++i) {
+            const Envio ri = enviarFilas(filas, i, i + 1);
+            if (ri == Envio::Reintentar) {
+                log(Nivel::Aviso, "POST sin respuesta o con error del servidor (filas=" +
+                                      std::to_string(fin - i) + ") -> spool");
+                return i - ini;
+            }
+            if (ri == Envio::Descartar) {
+                ++descartadas;
+                log(Nivel::Error, "Fila rechazada por datos, descartada: " + filas[i].substr(0, 300));
+            }
+        }
+        if (descartadas > 0)
+            log(Nivel::Error, "Filas descartadas: " + std::to_string(descartadas) + " de " + std::to_string(n));
+        return n;
+    }
+
+    if (r == Envio::Descartar) {
+        log(Nivel::Error, "Fila rechazada por datos, descartada: " + filas[ini].substr(0, 300));
+        return n;
+    }
+
+    log(Nivel::Aviso, "POST sin respuesta o con error del servidor (filas=" + std::to_string(n) + ") -> spool");
+    return 0;
+}
+
+void Cola::guardarEnSpool(const std::vector<std::string>& filas) {
+    if (cfg_.rutaSpool.empty()) {
+        log(Nivel::Error, "Sin spool configurado: se pierden " + std::to_string(filas.size()) + " validaciones");
+        return;
+    }
+
+    std::error_code ec;
+    const fs::path carpeta = fs::path(cfg_.rutaSpool).parent_path();
+    if (!carpeta.empty()) fs::create_directories(carpeta, ec);
+
+    std::ofstream out(cfg_.rutaSpool, std::ios::app);
+    if (!out.is_open()) {
+        log(Nivel::Error, "No se pudo abrir spool " + cfg_.rutaSpool + ": se pierden " +
+                              std::to_string(filas.size()) + " validaciones");
+        return;
+    }
+    for (const auto& fila : filas) out << fila << '\n';
+}
+
+bool Cola::reenviarSpool() {
+    std::vector<std::string> filas;
+    {
+        std::ifstream in(cfg_.rutaSpool);
+        if (!in.is_open()) {
+            spoolPendiente_ = false;
+            return true;
+        }
+        std::string linea;
+        while (std::getline(in, linea)) {
+            if (!linea.empty()) filas.push_back(std::move(linea));
+        }
+    }
+
+    size_t enviadas = 0;
+    while (enviadas < filas.size()) {
+        const size_t fin = std::min(filas.size(), enviadas + cfg_.maxLote);
+        const size_t resueltas = enviarLote(filas, enviadas, fin);
+        enviadas += resueltas;
+        if (enviadas < fin) break;
+    }
+
+    if (enviadas == filas.size()) {
+        std::error_code ec;
+        fs::remove(cfg_.rutaSpool, ec);
+        spoolPendiente_ = false;
+        if (!filas.empty()) log(Nivel::Info, "Spool reenviado a BD: filas=" + std::to_string(filas.size()));
+        return true;
+    }
+
+    if (enviadas == 0) return false;  // nada que recortar
+
+    // Reescribir solo lo pendiente, en el mismo orden. A un temporal y rename:
+    // una caida a mitad de la escritura deja el spool anterior intacto
+    const std::string temporal = cfg_.rutaSpool + ".tmp";
+    {
+        std::ofstream out(temporal, std::ios::trunc);
+        for (size_t i = enviadas; i < filas.size(); ++i) out << filas[i] << '\n';
+        out.flush();
+        if (!out) {
+            log(Nivel::Error, "No se pudo reescribir spool " + temporal + ": se conserva el anterior");
+            std::error_code ec;
+            fs::remove(temporal, ec);
+            return false;
+        }
+    }
+    std::error_code ec;
+    fs::rename(temporal, cfg_.rutaSpool, ec);
+    if (ec) {
+        log(Nivel::Error, "No se pudo reemplazar spool " + cfg_.rutaSpool + ": " + ec.message());
+        fs::remove(temporal, ec);
+    }
+    return false;
+}
+
+} // namespace auditoria
@@ -0,0 +1,183 @@
+#include "comun/feature_codec.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+static_assert(std::endian::native == std::endian::little,
+              "feature_codec asume host little-endian (x86 / ARM)");
+
+namespace {
+
+constexpr char kB64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr char kHex[] = "0123456789abcdef";
+
+constexpr std::array<int8_t, 256> tablaB64() {
+    std::array<int8_t, 256> t{};
+    for (auto& x : t) x = -1;
+    for (int i = 0; i < 64; ++i) t[(unsigned char)kB64[i]] = (int8_t)i;
+    return t;
+}
+
+constexpr std::array<int8_t, 256> tablaHex() {
+    std::array<int8_t, 256> t{};
+    for (auto& x : t) x = -1;
+    for (int i = 0; i < 10; ++i) t['0' + i] = (int8_t)i;
+    for (int i = 0; i < 6; ++i) {
+        t['a' + i] = (int8_t)(10 + i);
+        t['A' + i] = (int8_t)(10 + i);
+    }
+    return t;
+}
+
+constexpr auto kDecB64 = tablaB64();
+constexpr auto kDecHex = tablaHex();
+
+constexpr size_t kHeader = 8;
+
+} // namespace
+
+std::string codificarBase64(const uint8_t* data, size_t n) {
+    std::string out;
+    out.resize(((n + 2) / 3) * 4);
+    char* o = out.data();
+
+    size_t i = 0;
+    for (; i + 3 <= n; i += 3) {
+        const uint32_t v = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8) | data[i + 2];
+        *o++ = kB64[(v >> 18) & 63];
+        *o++ = kB64[(v >> 12) & 63];
+        *o++ = kB64[(v >> 6) & 63];
+        *o++ = kB64[v & 63];
+    }
+
+    const size_t resto = n - i;
+    if (resto > 0) {
+        uint32_t v = uint32_t(data[i]) << 16;
+        if (resto == 2) v |= uint32_t(data[i + 1]) << 8;
+        *o++ = kB64[(v >> 18) & 63];
+        *o++ = kB64[(v >> 12) & 63];
+        *o++ = (resto == 2) ? kB64[(v >> 6) & 63] : '=';
+        *o++ = '=';
+    }
+    return out;
+}
+
+bool decodificarBase64(const std::string& in, std::vector<uint8_t>& out) {
+    out.clear();
+    size_t n = in.size();
+    if (n % 4 != 0) return false;
+
+    size_t pad = 0;
+    if (n >= 1 && in[n - 1] == '=') ++pad;
+    if (n >= 2 && in[n - 2] == '=') ++pad;
+
+    out.resize((n / 4) * 3 - pad);
+    uint8_t* o = out.data();
+    const auto* s = reinterpret_cast<const unsigned char*>(in.data());
+
+    for (size_t i = 0; i < n; i += 4) {
+        const bool ultimo = (i + 4 == n);
+        const int a = kDecB64[s[i]];
+        const int b = kDecB64[s[i + 1]];
+        const int c = (ultimo && pad >= 2) ? 0 : kDecB64[s[i + 2]];
+        const int d = (ultimo && pad >= 1) ? 0 : kDecB64[s[i + 3]];
+        if ((a | b | c | d) < 0) {
+            out.clear();
+            return false;
+        }
+
+        const uint32_t v = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | uint32_t(d);
+        *o++ = uint8_t(v >> 16);
+        if (!ultimo || pad < 2) *o++ = uint8_t(v >> 8);
+        if (!ultimo || pad < 1) *o++ = uint8_t(v);
+    }
+    return true;
+}
+
+std::vector<uint8_t> empaquetarFeatures(const std::vector<double>& v, bool float32) {
+    const uint8_t bpv = float32 ? 4 : 8;
+    const uint32_t dim = (uint32_t)v.size();
+
+    std::vector<uint8_t> out(kHeader + (size_t)dim * bpv);
+    out[0] = 'F';
+    out[1] = 'V';
+    out[2] = 1;
+    out[3] = bpv;
+    std::memcpy(out.data() + 4, &dim, 4);
+
+    if (float32) {
+        uint8_t* p = out.data() + kHeader;
+        for (uint32_t i = 0; i < dim; ++i) {
+            const float f = (float)v[i];
+            std::memcpy(p + (size_t)i * 4, &f, 4);
+        }
+    } else if (dim > 0) {
+        std::memcpy(out.data() + kHeader, v.data(), (size_t)dim * 8);
+    }
+    return out;
+}
+
+bool desempaquetarFeatures(const uint8_t* data, size_t n, std::vector<double>& out) {
+    out.clear();
+    if (n < kHeader || data[0] != 'F' || data[1] != 'V' || data[2] != 1) return false;
+
+    const uint8_t bpv = data[3];
+    if (bpv != 4 && bpv != 8) return false;
+
+    uint32_t dim = 0;
+    std::memcpy(&dim, data + 4, 4);
+    if (n != kHeader + (size_t)dim * bpv) return false;
+
+    out.resize(dim);
+    const uint8_t* p = data + kHeader;
+    if (bpv == 8) {
+        if (dim > 0) std::memcpy(out.data(), p, (size_t)dim * 8);
+    } else {
+        for (uint32_t i = 0; i < dim; ++i) {
+            float f;
+            std::memcpy(&f, p + (size_t)i * 4, 4);
+            out[i] = f;
+        }
+    }
+    return true;
+}
+
+std::string vectorAByteaHex(const std::vector<double>& v) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(v.data());
+    const size_t n = v.size() * sizeof(double);
+
+    std::string out;
+    out.resize(2 + 2 * n);
+    out[0] = '\\';
+    out[1] = 'x';
+    char* o = out.data() + 2;
+    for (size_t i = 0; i < n; ++i) {
+        *o++ = kHex[bytes[i] >> 4];
+        *o++ = kHex[bytes[i] & 15];
+    }
+    return out;
+}
+
+bool byteaHexAVector(const std::string& hex, std::vector<double>& out) {
+    out.clear();
+    if (hex.size() < 2 || hex[0] != '\\' || hex[1] != 'x') return false;
+
+    const size_t nHex = hex.size() - 2;
+    if (nHex % 2 != 0 || (nHex / 2) % sizeof(double) != 0) return false;
+
+    out.resize(nHex / 2 / sizeof(double));
+    auto* o = reinterpret_cast<uint8_t*>(out.data());
+    const auto* s = reinterpret_cast<const unsigned char*>(hex.data() + 2);
+
+    for (size_t i = 0; i < nHex; i += 2) {
+        const int hi = kDecHex[s[i]];
+        const int lo = kDecHex[s[i + 1]];
+        if ((hi | lo) < 0) {
+            out.clear();
+            return false;
+        }
+        *o++ = uint8_t((hi << 4) | lo);
+    }
+    return true;
+}
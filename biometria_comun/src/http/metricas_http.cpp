@@ -0,0 +1,158 @@
+#include "comun/metricas_http.h"
+
+#include <memory>
+#include <unordered_map>
+
+#ifndef BIOMETRIA_SERVICIO
+#error "BIOMETRIA_SERVICIO no definido: incluir comun.cmake con BIOMETRIA_SERVICIO fijado"
+#endif
+
+namespace metricas_http {
+
+using Reloj = std::chrono::steady_clock;
+
+namespace {
+
+// Pool de httplib con la espera en cola medida: cada tarea es una conexion
+// aceptada que espera un hilo libre (crece cuando el servidor se satura)
+class ColaMedida : public httplib::TaskQueue {
+public:
+    explicit ColaMedida(size_t hilos)
+        : pool_(hilos),
+          espera_(metricas::histograma(BIOMETRIA_SERVICIO "_cola_espera_segundos",
+                                       "Espera en cola antes de ser atendido", { { "cola", "http" } })),
+          enEspera_(metricas::medidor(BIOMETRIA_SERVICIO "_cola_en_espera", "Elementos esperando en la cola",
+                                      { { "cola", "http" } })) {}
+
+    bool enqueue(std::function<void()> fn) override {
+        const auto t0 = Reloj::now();
+        enEspera_.sumar(1);
+        return pool_.enqueue([this, t0, fn = std::move(fn)] {
+            enEspera_.sumar(-1);
+            espera_.observar(std::chrono::duration<double>(Reloj::now() - t0).count());
+            fn();
+        });
+    }
+
+    void shutdown() override { pool_.shutdown(); }
+
+private:
+    httplib::ThreadPool pool_;
+    metricas::Histograma& espera_;
+    metricas::Medidor& enEspera_;
+};
+
+// El pre-routing handler y el logger corren en el mismo hilo del pool
+thread_local Reloj::time_point t_inicioSolicitud{};
+thread_local std::unique_ptr<trazas::Span> t_trazaSolicitud;
+
+// Rutas registradas (matched_route) y codigos: pocas claves por hilo
+metricas::Histograma& duracionRuta(const std::string& ruta) {
+    thread_local std::unordered_map<std::string, metricas::Histograma*> cache;
+    auto& h = cache[ruta];
+    if (!h) {
+        h = &metricas::histograma(BIOMETRIA_SERVICIO "_http_duracion_segundos", "Duracion de solicitudes HTTP",
+                                  { { "ruta", ruta } });
+    }
+    return *h;
+}
+
+metricas::Contador& solicitudesRuta(const std::string& ruta, const std::string& metodo, int codigo) {
+    thread_local std::unordered_map<std::string, metricas::Contador*> cache;
+    const std::string cod = std::to_string(codigo);
+    auto& c = cache[ruta + ' ' + metodo + ' ' + cod];
+    if (!c) {
+        c = &metricas::contador(BIOMETRIA_SERVICIO "_http_solicitudes_total", "Solicitudes HTTP atendidas",
+                                { { "ruta", ruta }, { "metodo", metodo }, { "codigo", cod } });
+    }
+    return *c;
+}
+
+// "/usuarios?identificador_unico=eq.x" -> "usuarios" (cardinalidad acotada)
+std::string tablaDe(const std::string& endpoint) {
+    const size_t ini = (!endpoint.empty() && endpoint[0] == '/') ? 1 : 0;
+    return endpoint.substr(ini, endpoint.find('?') - ini);
+}
+
+} // namespace
+
+struct MedicionBD::Series {
+    metricas::Etiquetas etiquetas;
+    std::string nombreSpan;
+    metricas::Histograma* duracion = nullptr;
+    metricas::Contador* errores = nullptr; // al primer error: sin series en cero por tabla
+};
+
+MedicionBD::Series& MedicionBD::seriesDe(const char* metodo, const std::string& endpoint) {
+    thread_local std::unordered_map<std::string, MedicionBD::Series> cache;
+    const std::string tabla = tablaDe(endpoint);
+    auto& s = cache[std::string(metodo) + ' ' + tabla];
+    if (!s.duracion) {
+        s.etiquetas = { { "metodo", metodo }, { "tabla", tabla } };
+        s.nombreSpan = std::string("bd ") + metodo + " " + tabla;
+        s.duracion = &metricas::histograma(BIOMETRIA_SERVICIO "_bd_duracion_segundos",
+                                           "Duracion de llamadas a PostgREST", s.etiquetas);
+    }
+    return s;
+}
+
+void instrumentarServidorHttp(httplib::Server& srv, Opciones opciones) {
+    static auto& enCurso = metricas::medidor(BIOMETRIA_SERVICIO "_http_en_curso", "Solicitudes HTTP en proceso");
+
+    srv.new_task_queue = [] { return new ColaMedida(CPPHTTPLIB_THREAD_POOL_COUNT); };
+
+    srv.set_pre_routing_handler([opciones](const httplib::Request& req, httplib::Response& res) {
+        t_inicioSolicitud = Reloj::now();
+        enCurso.sumar(1);
+        if (opciones.trazaPorSolicitud) {
+            const std::string rid = trazas::nuevoRid();
+            res.set_header("X-Request-Id", rid);
+            t_trazaSolicitud.reset();
+            t_trazaSolicitud = std::make_unique<trazas::Span>(req.method + " " + req.path, rid);
+        }
+        return opciones.preRuteo ? opciones.preRuteo(req, res) : httplib::Server::HandlerResponse::Unhandled;
+    });
+
+    srv.set_logger([](const httplib::Request& req, const httplib::Response& res) {
+        if (t_inicioSolicitud == Reloj::time_point{}) return; // no paso por el ruteo
+        const double seg = std::chrono::duration<double>(Reloj::now() - t_inicioSolicitud).count();
+        t_inicioSolicitud = {};
+        enCurso.sumar(-1);
+        t_trazaSolicitud.reset();
+
+        // matched_route es el patron registrado: cardinalidad acotada
+        static const std::string kSinRuta = "sin_ruta";
+        const std::string& ruta = req.matched_route.empty() ? kSinRuta : req.matched_route;
+        duracionRuta(ruta).observar(seg);
+        solicitudesRuta(ruta, req.method, res.status).inc();
+    });
+
+    srv.Get("/metrics", [](const httplib::Request&, httplib::Response& res) {
+        res.set_content(metricas::exportarPrometheus(), "text/plain; version=0.0.4; charset=utf-8");
+    });
+}
+
+MedicionBD::MedicionBD(const char* metodo, const std::string& endpoint)
+    : series_(seriesDe(metodo, endpoint)), span_(series_.nombreSpan), inicio_(Reloj::now()) {}
+
+void MedicionBD::fin(const httplib::Result& res) {
+    span_.terminar();
+    series_.duracion->observar(std::chrono::duration<double>(Reloj::now() - inicio_).count());
+    if (!res || res->status >= 400) {
+        if (!series_.errores) {
+            series_.errores = &metricas::contador(BIOMETRIA_SERVICIO "_bd_errores_total",
+                                                  "Llamadas a PostgREST sin respuesta o con error", series_.etiquetas);
+        }
+        series_.errores->inc();
+    }
+}
+
+httplib::Result medirBD(const char* metodo, const std::string& endpoint,
+                        const std::function<httplib::Result()>& llamada) {
+    MedicionBD medicion(metodo, endpoint);
+    httplib::Result r = llamada();
+    medicion.fin(r);
+    return r;
+}
+
+} // namespace metricas_http
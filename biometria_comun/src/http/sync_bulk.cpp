@@ -0,0 +1,163 @@
+#include "comun/sync_bulk.h"
+
+#include "comun/metricas_http.h"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+
+using json = nlohmann::json;
+
+namespace sync_bulk {
+
+namespace {
+
+void registrar(const FuncionLog& log, Nivel nivel, const std::string& msg) {
+    if (log) {
+        log(nivel, msg);
+        return;
+    }
+    std::cerr << "[SYNC] " << (nivel == Nivel::Aviso ? "WARN: " : "INFO: ") << msg << std::endl;
+}
+
+// Asigna ids devueltos por PostgREST a las filas del chunk.
+// Con id_muestra_cliente se empareja por clave; sin el, por posicion.
+bool asignarIds(const json& data, const std::vector<json>& filas, size_t ini, size_t fin,
+                std::vector<Resultado>& out) {
+    if (!data.is_array()) return false;
+
+    std::map<std::string, int> porMuestra;
+    for (const auto& row : data) {
+        if (row.contains("id_muestra_cliente") && row["id_muestra_cliente"].is_string() &&
+            row.contains("id_caracteristica"))
+            porMuestra[row["id_muestra_cliente"].get<std::string>()] = row["id_caracteristica"].get<int>();
+    }
+
+    const bool porPosicion = (data.size() == fin - ini);
+    for (size_t i = ini; i < fin; ++i) {
+        const json& f = filas[i];
+        if (f.contains("id_muestra_cliente") && f["id_muestra_cliente"].is_string()) {
+            auto it = porMuestra.find(f["id_muestra_cliente"].get<std::string>());
+            if (it != porMuestra.end()) {
+                out[i].idCaracteristica = it->second;
+                continue;
+            }
+        }
+        if (porPosicion && data[i - ini].contains("id_caracteristica")) {
+            out[i].idCaracteristica = data[i - ini]["id_caracteristica"].get<int>();
+        } else {
+            out[i].error = "sin id en respuesta";
+        }
+    }
+    return true;
+}
+
+std::string claveMuestra(const json& f) {
+    auto texto = [&](const char* k) -> std::string {
+        if (!f.contains(k) || f[k].is_null()) return {};
+        return f[k].is_string() ? f[k].get<std::string>() : f[k].dump();
+    };
+    const std::string muestra = texto("id_muestra_cliente");
+    return muestra.empty() ? std::string() : texto("uuid_dispositivo") + '\n' + muestra;
+}
+
+std::vector<Resultado> insertarSinRepetidos(httplib::Client& cli, const std::string& tabla,
+                                            const std::vector<json>& filas, size_t chunk,
+                                            const FuncionLog& log) {
+    std::vector<Resultado> out(filas.size());
+    if (filas.empty()) return out;
+    chunk = std::max<size_t>(1, chunk);
+
+    // merge-duplicates: un reintento del movil actualiza la misma fila y devuelve su id
+    const std::string url = "/" + tabla + "?on_conflict=uuid_dispositivo,id_muestra_cliente";
+    const httplib::Headers headers = {
+        {"Prefer", "return=representation,resolution=merge-duplicates"}};
+
+    auto postFilas = [&](size_t ini, size_t fin) -> httplib::Result {
+        json body = json::array();
+        for (size_t i = ini; i < fin; ++i) body.push_back(filas[i]);
+        return metricas_http::medirBD("POST", url, [&] {
+            return cli.Post(url.c_str(), headers, body.dump(), "application/json");
+        });
+    };
+
+    auto anotar = [&](const httplib::Result& r, size_t ini, size_t fin) {
+        try {
+            if (asignarIds(json::parse(r->body), filas, ini, fin, out)) return;
+        } catch (...) {}
+        for (size_t i = ini; i < fin; ++i) out[i].error = "respuesta BD invalida";
+    };
+
+    for (size_t ini = 0; ini < filas.size(); ini += chunk) {
+        const size_t fin = std::min(filas.size(), ini + chunk);
+        auto r = postFilas(ini, fin);
+
+        if (!r) {
+            registrar(log, Nivel::Aviso, "POST /" + tabla + " sin respuesta filas=" + std::to_string(fin - ini));
+            for (size_t i = ini; i < fin; ++i) out[i].error = "BD sin respuesta";
+            continue;
+        }
+
+        registrar(log, Nivel::Info, "POST /" + tabla + " (bulk) filas=" + std::to_string(fin - ini) +
+                                        " status=" + std::to_string(r->status));
+
+        if (r->status == 201 || r->status == 200) {
+            anotar(r, ini, fin);
+            continue;
+        }
+
+        if (r->status >= 500) {
+            for (size_t i = ini; i < fin; ++i) out[i].error = "BD status " + std::to_string(r->status);
+            continue;
+        }
+
+        // 4xx: alguna fila es invalida (FK, tipos...). Aislar fila por fila.
+        registrar(log, Nivel::Aviso, "chunk rechazado status=" + std::to_string(r->status) +
+                                         " -> reintento fila por fila. body=" + r->body.substr(0, 300));
+        for (size_t i = ini; i < fin; ++i) {
+            auto ri = postFilas(i, i + 1);
+            if (ri && (ri->status == 201 || ri->status == 200)) {
+                anotar(ri, i, i + 1);
+            } else {
+                out[i].error = ri ? ("BD status " + std::to_string(ri->status)) : "BD sin respuesta";
+            }
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+std::vector<Resultado> insertar(httplib::Client& cli, const std::string& tabla,
+                                const std::vector<json>& filas, size_t chunk,
+                                const FuncionLog& log) {
+    // Una clave repetida en el mismo POST hace fallar el ON CONFLICT ("cannot affect
+    // row a second time") y con el todo el chunk: cada clave se envia una vez y
+    // las repetidas copian el resultado de la primera
+    std::vector<json> unicas;
+    std::vector<size_t> origen(filas.size());   // fila de entrada -> indice en unicas
+    std::map<std::string, size_t> porClave;
+    for (size_t i = 0; i < filas.size(); ++i) {
+        const std::string clave = claveMuestra(filas[i]);
+        if (!clave.empty()) {
+            auto [it, nueva] = porClave.emplace(clave, unicas.size());
+            if (!nueva) {
+                origen[i] = it->second;
+                continue;
+            }
+        }
+        origen[i] = unicas.size();
+        unicas.push_back(filas[i]);
+    }
+
+    if (unicas.size() == filas.size())
+        return insertarSinRepetidos(cli, tabla, filas, chunk, log);
+
+    registrar(log, Nivel::Info, "Filas repetidas en el lote: " + std::to_string(filas.size() - unicas.size()));
+    const std::vector<Resultado> res = insertarSinRepetidos(cli, tabla, unicas, chunk, log);
+    std::vector<Resultado> out(filas.size());
+    for (size_t i = 0; i < filas.size(); ++i) out[i] = res[origen[i]];
+    return out;
+}
+
+} // namespace sync_bulk
@@ -0,0 +1,170 @@
+#include "comun/metricas.h"
+
+#include <algorithm>
+#include <locale>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef BIOMETRIA_SERVICIO
+#error "BIOMETRIA_SERVICIO no definido: incluir comun.cmake con BIOMETRIA_SERVICIO fijado"
+#endif
+
+namespace metricas {
+
+Histograma::Histograma(std::vector<double> limites)
+    : limites_(std::move(limites)),
+      cubetas_(new std::atomic<uint64_t>[limites_.size() + 1]) {
+    std::sort(limites_.begin(), limites_.end());
+    for (size_t i = 0; i <= limites_.size(); ++i) cubetas_[i].store(0, std::memory_order_relaxed);
+}
+
+void Histograma::observar(double v) {
+    // Pocas cubetas (~15): busqueda lineal, sin ramas impredecibles de la binaria
+    size_t i = 0;
+    while (i < limites_.size() && v > limites_[i]) ++i;
+    cubetas_[i].fetch_add(1, std::memory_order_relaxed);
+    suma_.fetch_add(v, std::memory_order_relaxed);
+}
+
+const std::vector<double>& limitesLatencia() {
+    static const std::vector<double> limites = {
+        0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0
+    };
+    return limites;
+}
+
+namespace {
+
+enum class Tipo { Contador, Medidor, Histograma };
+
+struct Serie {
+    std::string etiquetas; // ya formateadas: k="v",k2="v2"
+    std::unique_ptr<Contador> contador;
+    std::unique_ptr<Medidor> medidor;
+    std::unique_ptr<Histograma> histograma;
+};
+
+struct Familia {
+    Tipo tipo;
+    std::string ayuda;
+    std::map<std::string, Serie> series; // por etiquetas formateadas
+};
+
+std::mutex g_mtx;
+std::map<std::string, Familia>& familias() {
+    static std::map<std::string, Familia> f;
+    return f;
+}
+
+std::string escaparValor(const std::string& v) {
+    std::string o;
+    o.reserve(v.size());
+    for (char c : v) {
+        if (c == '\\') o += "\\\\";
+        else if (c == '"') o += "\\\"";
+        else if (c == '\n') o += "\\n";
+        else o += c;
+    }
+    return o;
+}
+
+std::string formatearEtiquetas(const Etiquetas& etiquetas) {
+    std::string o;
+    for (const auto& [k, v] : etiquetas) {
+        if (!o.empty()) o += ',';
+        o += k + "=\"" + escaparValor(v) + "\"";
+    }
+    return o;
+}
+
+Serie& serie(const std::string& nombre, const std::string& ayuda, Tipo tipo, const Etiquetas& etiquetas) {
+    auto& fs = familias();
+    auto it = fs.find(nombre);
+    if (it == fs.end()) {
+        it = fs.emplace(nombre, Familia{ tipo, ayuda, {} }).first;
+    } else if (it->second.tipo != tipo) {
+        throw std::invalid_argument("metrica '" + nombre + "' ya registrada con otro tipo");
+    }
+    const std::string clave = formatearEtiquetas(etiquetas);
+    auto& s = it->second.series[clave];
+    s.etiquetas = clave;
+    return s;
+}
+
+std::string conLe(const std::string& etiquetas, const std::string& le) {
+    return "{" + etiquetas + (etiquetas.empty() ? "" : ",") + "le=\"" + le + "\"}";
+}
+
+std::string entreLlaves(const std::string& etiquetas) {
+    return etiquetas.empty() ? "" : "{" + etiquetas + "}";
+}
+
+} // namespace
+
+Contador& contador(const std::string& nombre, const std::string& ayuda, const Etiquetas& etiquetas) {
+    std::lock_guard<std::mutex> lock(g_mtx);
+    auto& s = serie(nombre, ayuda, Tipo::Contador, etiquetas);
+    if (!s.contador) s.contador = std::make_unique<Contador>();
+    return *s.contador;
+}
+
+Medidor& medidor(const std::string& nombre, const std::string& ayuda, const Etiquetas& etiquetas) {
+    std::lock_guard<std::mutex> lock(g_mtx);
+    auto& s = serie(nombre, ayuda, Tipo::Medidor, etiquetas);
+    if (!s.medidor) s.medidor = std::make_unique<Medidor>();
+    return *s.medidor;
+}
+
+Histograma& histograma(const std::string& nombre, const std::string& ayuda, const Etiquetas& etiquetas,
+                       const std::vector<double>& limites) {
+    std::lock_guard<std::mutex> lock(g_mtx);
+    auto& s = serie(nombre, ayuda, Tipo::Histograma, etiquetas);
+    if (!s.histograma) s.histograma = std::make_unique<Histograma>(limites);
+    return *s.histograma;
+}
+
+Histograma& etapa(const std::string& nombre) {
+    return histograma(BIOMETRIA_SERVICIO "_etapa_duracion_segundos",
+                      "Duracion de cada etapa del pipeline de " BIOMETRIA_SERVICIO, { { "etapa", nombre } });
+}
+
+std::string exportarPrometheus() {
+    // Locale "C" (punto decimal) y precision suficiente para sumas grandes
+    std::ostringstream os;
+    os.imbue(std::locale::classic());
+    os.precision(10);
+
+    std::lock_guard<std::mutex> lock(g_mtx);
+    for (const auto& [nombre, familia] : familias()) {
+        static const char* tipos[] = { "counter", "gauge", "histogram" };
+        os << "# HELP " << nombre << ' ' << familia.ayuda << '\n'
+           << "# TYPE " << nombre << ' ' << tipos[(int)familia.tipo] << '\n';
+
+        for (const auto& [_, s] : familia.series) {
+            if (s.contador) {
+                os << nombre << entreLlaves(s.etiquetas) << ' ' << s.contador->valor() << '\n';
+            } else if (s.medidor) {
+                os << nombre << entreLlaves(s.etiquetas) << ' ' << s.medidor->valor() << '\n';
+            } else if (s.histograma) {
+                const Histograma& h = *s.histograma;
+                uint64_t acumulado = 0;
+                for (size_t i = 0; i < h.limites().size(); ++i) {
+                    acumulado += h.cubeta(i);
+                    std::ostringstream le;
+                    le.imbue(std::locale::classic());
+                    le << h.limites()[i];
+                    os << nombre << "_bucket" << conLe(s.etiquetas, le.str()) << ' ' << acumulado << '\n';
+                }
+                acumulado += h.cubeta(h.limites().size());
+                os << nombre << "_bucket" << conLe(s.etiquetas, "+Inf") << ' ' << acumulado << '\n'
+                   << nombre << "_sum" << entreLlaves(s.etiquetas) << ' ' << h.suma() << '\n'
+                   << nombre << "_count" << entreLlaves(s.etiquetas) << ' ' << acumulado << '\n';
+            }
+        }
+    }
+    return os.str();
+}
+
+} // namespace metricas
@@ -0,0 +1,332 @@
+#include "comun/trazas.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#if defined(_WIN32)
+#include <process.h>
+#define TRAZAS_GETPID _getpid
+#else
+#include <unistd.h>
+#define TRAZAS_GETPID getpid
+#endif
+
+#ifndef BIOMETRIA_SERVICIO
+#error "BIOMETRIA_SERVICIO no definido: incluir comun.cmake con BIOMETRIA_SERVICIO fijado"
+#endif
+
+namespace fs = std::filesystem;
+
+namespace trazas {
+
+namespace {
+
+constexpr const char* kPrefijoLinea = "TRAZA_SPAN ";
+
+struct Evento {
+    std::string nombre;
+    std::string proceso;
+    uint64_t id = 0;
+    uint64_t padre = 0;
+    int pid = 0;
+    uint32_t tid = 0;
+    int64_t inicioUs = 0; // reloj de pared: alinea procesos distintos
+    int64_t durUs = 0;
+};
+
+// Estado por hilo: la traza en curso y sus spans (solo lo toca el hilo dueno)
+struct EstadoHilo {
+    std::string rid;              // vacio: sin traza muestreada
+    std::string proceso;          // copiado al abrir la raiz (sin lock por span)
+    std::vector<uint64_t> pila;   // spans abiertos
+    std::vector<Evento> eventos;
+    uint32_t tid = 0;
+};
+
+std::atomic<double> g_tasa{ 0.0 };
+std::atomic<uint64_t> g_padreExterno{ 0 };   // != 0: proceso hijo, salida por stderr
+std::atomic<uint32_t> g_siguienteHilo{ 1 };
+std::atomic<uint64_t> g_siguienteId{ 0 };
+
+std::mutex g_cfgMtx;
+std::string g_dir = "trazas";
+std::string g_proceso = BIOMETRIA_SERVICIO;
+Formato g_formato = Formato::Chrome;
+
+EstadoHilo& hilo() {
+    thread_local EstadoHilo h;
+    if (h.tid == 0) h.tid = g_siguienteHilo.fetch_add(1, std::memory_order_relaxed);
+    return h;
+}
+
+uint64_t hashFNV1a64(const std::string& s) {
+    uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+bool muestreado(const std::string& rid) {
+    const double tasa = g_tasa.load(std::memory_order_relaxed);
+    if (tasa <= 0.0) return false;
+    if (tasa >= 1.0) return true;
+    return (double)(hashFNV1a64(rid) % 1000000) < tasa * 1000000.0;
+}
+
+uint64_t nuevoId() {
+    static const uint64_t semilla = [] {
+        std::random_device rd;
+        return ((uint64_t)rd() << 32) ^ rd() ^
+               (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+    }();
+    // splitmix64 sobre un contador: ids unicos en el proceso y con aspecto aleatorio
+    uint64_t z = semilla + g_siguienteId.fetch_add(1, std::memory_order_relaxed) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return z ? z : 1;
+}
+
+int64_t ahoraUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string hex16(uint64_t v) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    std::string s(16, '0');
+    for (int i = 15; i >= 0; --i, v >>= 4) s[i] = kHex[v & 15];
+    return s;
+}
+
+uint64_t desdeHex(const std::string& s) {
+    try {
+        return s.empty() ? 0 : std::stoull(s, nullptr, 16);
+    } catch (...) {
+        return 0;
+    }
+}
+
+std::string escaparJson(const std::string& s) {
+    std::string o;
+    o.reserve(s.size() + 2);
+    for (char c : s) {
+        if (c == '"') o += "\\\"";
+        else if (c == '\\') o += "\\\\";
+        else if (c == '\n') o += "\\n";
+        else if ((unsigned char)c < 0x20) o += ' ';
+        else o += c;
+    }
+    return o;
+}
+
+// rid -> nombre de archivo seguro
+std::string paraArchivo(const std::string& s) {
+    std::string o = s;
+    for (char& c : o)
+        if (!std::isalnum((unsigned char)c) && c != '-' && c != '_') c = '_';
+    return o;
+}
+
+void escribirChrome(std::ostream& os, const std::string& rid, const std::vector<Evento>& eventos) {
+    os << "{\"traceEvents\":[";
+    std::map<int, std::string> procesos;
+    bool primero = true;
+    for (const auto& e : eventos) {
+        procesos[e.pid] = e.proceso;
+        os << (primero ? "\n" : ",\n")
+           << "{\"name\":\"" << escaparJson(e.nombre) << "\",\"cat\":\"" BIOMETRIA_SERVICIO "\",\"ph\":\"X\""
+           << ",\"ts\":" << e.inicioUs << ",\"dur\":" << e.durUs
+           << ",\"pid\":" << e.pid << ",\"tid\":" << e.tid
+           << ",\"args\":{\"rid\":\"" << escaparJson(rid) << "\",\"span\":\"" << hex16(e.id) << "\""
+           << (e.padre ? ",\"padre\":\"" + hex16(e.padre) + "\"" : std::string()) << "}}";
+        primero = false;
+    }
+    for (const auto& [pid, proceso] : procesos) {
+        os << ",\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+           << ",\"args\":{\"name\":\"" << escaparJson(proceso) << "\"}}";
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void escribirOtlp(std::ostream& os, const std::string& rid, const std::vector<Evento>& eventos) {
+    // traceId de 128 bits derivado del rid (mismo rid -> misma traza en todos los procesos)
+    const std::string traceId = hex16(hashFNV1a64(rid)) + hex16(hashFNV1a64(rid + "#"));
+
+    std::map<std::string, std::vector<const Evento*>> porProceso;
+    for (const auto& e : eventos) porProceso[e.proceso].push_back(&e);
+
+    os << "{\"resourceSpans\":[";
+    bool primerProceso = true;
+    for (const auto& [proceso, evs] : porProceso) {
+        os << (primerProceso ? "\n" : ",\n")
+           << "{\"resource\":{\"attributes\":["
+           << "{\"key\":\"service.name\",\"value\":{\"stringValue\":\"" BIOMETRIA_SERVICIO "\"}},"
+           << "{\"key\":\"process.executable.name\",\"value\":{\"stringValue\":\"" << escaparJson(proceso) << "\"}},"
+           << "{\"key\":\"process.pid\",\"value\":{\"intValue\":\"" << evs.front()->pid << "\"}}]},"
+           << "\"scopeSpans\":[{\"scope\":{\"name\":\"" BIOMETRIA_SERVICIO ".trazas\"},\"spans\":[";
+        bool primero = true;
+        for (const Evento* e : evs) {
+            os << (primero ? "\n" : ",\n")
+               << "{\"traceId\":\"" << traceId << "\",\"spanId\":\"" << hex16(e->id) << "\""
+               << (e->padre ? ",\"parentSpanId\":\"" + hex16(e->padre) + "\"" : std::string())
+               << ",\"name\":\"" << escaparJson(e->nombre) << "\",\"kind\":1"
+               << ",\"startTimeUnixNano\":\"" << e->inicioUs * 1000 << "\""
+               << ",\"endTimeUnixNano\":\"" << (e->inicioUs + e->durUs) * 1000 << "\""
+               << ",\"attributes\":[{\"key\":\"rid\",\"value\":{\"stringValue\":\"" << escaparJson(rid) << "\"}},"
+               << "{\"key\":\"thread.id\",\"value\":{\"intValue\":\"" << e->tid << "\"}}]}";
+            primero = false;
+        }
+        os << "\n]}]}";
+        primerProceso = false;
+    }
+    os << "\n]}\n";
+}
+
+void exportar(const EstadoHilo& h) {
+    if (g_padreExterno.load(std::memory_order_relaxed) != 0) {
+        // Hijo: el padre importa estas lineas del stderr (nombre al final: puede tener espacios)
+        for (const auto& e : h.eventos) {
+            std::cerr << kPrefijoLinea << hex16(e.id) << ' ' << hex16(e.padre) << ' ' << e.pid << ' ' << e.tid
+                      << ' ' << e.inicioUs << ' ' << e.durUs << ' ' << e.proceso << ' ' << e.nombre << '\n';
+        }
+        return;
+    }
+
+    std::string dir;
+    Formato formato;
+    {
+        std::lock_guard<std::mutex> lock(g_cfgMtx);
+        dir = g_dir;
+        formato = g_formato;
+    }
+
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    const std::string ruta = dir + "/" + paraArchivo(h.rid) + "-" + paraArchivo(h.proceso) +
+                             (formato == Formato::Otlp ? ".otlp.json" : ".trace.json");
+    std::ofstream f(ruta, std::ios::binary);
+    if (!f) {
+        std::cerr << "[TRAZAS] No se pudo escribir " << ruta << '\n';
+        return;
+    }
+    if (formato == Formato::Otlp) escribirOtlp(f, h.rid, h.eventos);
+    else escribirChrome(f, h.rid, h.eventos);
+}
+
+} // namespace
+
+void configurar(double tasa, const std::string& directorio, Formato formato, const std::string& proceso) {
+    {
+        std::lock_guard<std::mutex> lock(g_cfgMtx);
+        g_dir = directorio;
+        g_formato = formato;
+        g_proceso = proceso;
+    }
+    g_tasa.store(std::clamp(tasa, 0.0, 1.0), std::memory_order_relaxed);
+}
+
+void configurarDesdeEntorno(const std::string& proceso, const std::string& prefijoEnv) {
+    const char* tasa = std::getenv((prefijoEnv + "TASA").c_str());
+    const char* dir = std::getenv((prefijoEnv + "DIR").c_str());
+    const char* formato = std::getenv((prefijoEnv + "FORMATO").c_str());
+    double t = 0.0;
+    try {
+        if (tasa && *tasa) t = std::stod(tasa);
+    } catch (...) {
+        t = 0.0;
+    }
+    configurar(t, (dir && *dir) ? dir : "trazas",
+               (formato && std::string(formato) == "otlp") ? Formato::Otlp : Formato::Chrome, proceso);
+}
+
+void continuarTrazaDe(const std::string& spanPadre) {
+    g_padreExterno.store(desdeHex(spanPadre), std::memory_order_relaxed);
+}
+
+std::string nuevoRid() {
+    thread_local std::mt19937_64 rng(std::random_device{}() ^
+        (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count());
+    return hex16(rng()).substr(4);
+}
+
+std::string spanActual() {
+    const auto& h = hilo();
+    return (h.rid.empty() || h.pila.empty()) ? std::string() : hex16(h.pila.back());
+}
+
+bool importarLinea(const std::string& linea) {
+    if (linea.rfind(kPrefijoLinea, 0) != 0) return false;
+    auto& h = hilo();
+    if (h.rid.empty()) return true;
+
+    std::istringstream ss(linea.substr(std::char_traits<char>::length(kPrefijoLinea)));
+    std::string id, padre;
+    Evento e;
+    if (!(ss >> id >> padre >> e.pid >> e.tid >> e.inicioUs >> e.durUs >> e.proceso)) return true;
+    std::getline(ss >> std::ws, e.nombre);
+    e.id = desdeHex(id);
+    e.padre = desdeHex(padre);
+    h.eventos.push_back(std::move(e));
+    return true;
+}
+
+Span::Span(const std::string& nombre, const std::string& rid) {
+    auto& h = hilo();
+    if (h.rid.empty()) {
+        // Sin traza en el hilo: solo un span con rid puede abrir una (raiz)
+        if (rid.empty()) return;
+        padre_ = g_padreExterno.load(std::memory_order_relaxed);
+        if (padre_ == 0 && !muestreado(rid)) return;
+        h.rid = rid;
+        {
+            std::lock_guard<std::mutex> lock(g_cfgMtx);
+            h.proceso = g_proceso;
+        }
+        raiz_ = true;
+    } else {
+        padre_ = h.pila.empty() ? 0 : h.pila.back();
+    }
+
+    nombre_ = nombre;
+    id_ = nuevoId();
+    h.pila.push_back(id_);
+    inicioUs_ = ahoraUs();
+    t0_ = std::chrono::steady_clock::now();
+}
+
+void Span::terminar() {
+    if (id_ == 0) return;
+    const int64_t dur = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t0_).count();
+
+    auto& h = hilo();
+    static const int pid = (int)TRAZAS_GETPID();
+    h.eventos.push_back(Evento{ std::move(nombre_), h.proceso, id_, padre_, pid, h.tid, inicioUs_, dur });
+
+    auto it = std::find(h.pila.rbegin(), h.pila.rend(), id_);
+    if (it != h.pila.rend()) h.pila.erase(std::next(it).base());
+    id_ = 0;
+
+    if (raiz_) {
+        exportar(h);
+        h.rid.clear();
+        h.pila.clear();
+        h.eventos.clear();
+    }
+}
+
+} // namespace trazas
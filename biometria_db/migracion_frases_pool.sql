@@ -0,0 +1,34 @@
+-- Migracion para bases creadas con un schema.sql anterior:
+-- seleccion de frases con pool en memoria (updated_at por trigger + incremento atomico)
+-- Uso: docker exec -i biometria_db psql -U biometria -d usuarios_db < migracion_frases_pool.sql
+
+CREATE OR REPLACE FUNCTION tocar_updated_at() RETURNS TRIGGER
+LANGUAGE plpgsql AS $$
+BEGIN
+    NEW.updated_at = CURRENT_TIMESTAMP;
+    RETURN NEW;
+END $$;
+
+DROP TRIGGER IF EXISTS trg_textos_updated ON textos_dinamicos_audio;
+CREATE TRIGGER trg_textos_updated
+    BEFORE UPDATE ON textos_dinamicos_audio
+    FOR EACH ROW EXECUTE FUNCTION tocar_updated_at();
+
+CREATE OR REPLACE FUNCTION sumar_usos_frases(p_usos JSONB)
+RETURNS TABLE (id_texto INT, contador_usos INT, limite_usos INT, estado_texto VARCHAR)
+LANGUAGE sql AS $$
+    UPDATE textos_dinamicos_audio t
+    SET contador_usos = COALESCE(t.contador_usos, 0) + u.usos,
+        estado_texto = CASE
+            WHEN COALESCE(t.contador_usos, 0) + u.usos >= COALESCE(t.limite_usos, 150) THEN 'desactivado'
+            ELSE t.estado_texto
+        END
+    FROM jsonb_to_recordset(p_usos) AS u(id_texto INT, usos INT)
+    WHERE t.id_texto = u.id_texto AND u.usos > 0
+    RETURNING t.id_texto, t.contador_usos, t.limite_usos, t.estado_texto;
+$$;
+
+GRANT EXECUTE ON FUNCTION sumar_usos_frases(JSONB) TO web_anon;
+
+-- PostgREST debe recargar el cache de esquema para exponer la funcion
+NOTIFY pgrst, 'reload schema';
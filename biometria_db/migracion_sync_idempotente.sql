@@ -0,0 +1,21 @@
+-- Migracion para bases creadas con un schema.sql anterior:
+-- idempotencia del sync movil (reintentos no duplican vectores)
+-- Uso: docker exec -i biometria_db psql -U biometria -d usuarios_db < migracion_sync_idempotente.sql
+
+ALTER TABLE caracteristicas_hablantes ADD COLUMN IF NOT EXISTS id_muestra_cliente VARCHAR(100);
+ALTER TABLE caracteristicas_oreja ADD COLUMN IF NOT EXISTS id_muestra_cliente VARCHAR(100);
+
+DO $$
+BEGIN
+    IF NOT EXISTS (SELECT 1 FROM pg_constraint WHERE conname = 'uq_caracteristicas_hablantes_muestra') THEN
+        ALTER TABLE caracteristicas_hablantes
+            ADD CONSTRAINT uq_caracteristicas_hablantes_muestra UNIQUE (uuid_dispositivo, id_muestra_cliente);
+    END IF;
+    IF NOT EXISTS (SELECT 1 FROM pg_constraint WHERE conname = 'uq_caracteristicas_oreja_muestra') THEN
+        ALTER TABLE caracteristicas_oreja
+            ADD CONSTRAINT uq_caracteristicas_oreja_muestra UNIQUE (uuid_dispositivo, id_muestra_cliente);
+    END IF;
+END $$;
+
+-- PostgREST debe recargar el cache de esquema para ver la columna nueva
+NOTIFY pgrst, 'reload schema';
@@ -0,0 +1,9 @@
+-- Migracion para bases creadas con un schema.sql anterior:
+-- resultado de cada intento de autenticacion en validaciones_biometricas
+-- (los servidores lo envian en cada fila; sin la columna PostgREST rechaza el lote)
+-- Uso: docker exec -i biometria_db psql -U biometria -d usuarios_db < migracion_validaciones_resultado.sql
+
+ALTER TABLE validaciones_biometricas ADD COLUMN IF NOT EXISTS resultado VARCHAR(20);
+
+-- PostgREST debe recargar el cache de esquema para ver la columna nueva
+NOTIFY pgrst, 'reload schema';
@@ -40,6 +40,7 @@ CREATE TABLE validaciones_biometricas (
     ip_cliente VARCHAR(45),
     ubicacion VARCHAR(200),
     dispositivo VARCHAR(200),
+    resultado VARCHAR(20),  -- exito | fallo | error (intento sobre id_usuario, el usuario reclamado)
     timestamp TIMESTAMP DEFAULT CURRENT_TIMESTAMP
 );  
 
@@ -52,7 +53,9 @@ CREATE TABLE caracteristicas_hablantes (
     dimension INTEGER NOT NULL,
     origen VARCHAR(20) DEFAULT 'mobile',
     uuid_dispositivo VARCHAR(100),
-    fecha_captura TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+    id_muestra_cliente VARCHAR(100), -- id local de la muestra en el dispositivo (idempotencia del sync)
+    fecha_captura TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+    CONSTRAINT uq_caracteristicas_hablantes_muestra UNIQUE (uuid_dispositivo, id_muestra_cliente)
 );
 
 CREATE INDEX idx_caracteristicas_usuario ON caracteristicas_hablantes(id_usuario);
@@ -66,7 +69,9 @@ CREATE TABLE caracteristicas_oreja (
     dimension INTEGER NOT NULL,
     origen VARCHAR(20) DEFAULT 'mobile',
     uuid_dispositivo VARCHAR(100),
-    fecha_captura TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+    id_muestra_cliente VARCHAR(100), -- id local de la muestra en el dispositivo (idempotencia del sync)
+    fecha_captura TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+    CONSTRAINT uq_caracteristicas_oreja_muestra UNIQUE (uuid_dispositivo, id_muestra_cliente)
 );
 
 CREATE INDEX idx_caracteristicas_oreja_usuario ON caracteristicas_oreja(id_usuario);
@@ -97,3 +102,34 @@ GRANT ALL ON SEQUENCE caracteristicas_oreja_id_caracteristica_seq TO web_anon;
 CREATE INDEX idx_usuarios_updated ON usuarios(updated_at);
 CREATE INDEX idx_credenciales_updated ON credenciales_biometricas(updated_at);
 CREATE INDEX idx_textos_updated ON textos_dinamicos_audio(updated_at);
+
+-- Frases dinamicas: updated_at se mantiene en cada UPDATE (el pool del servidor
+-- de voz refresca incrementalmente con ?updated_at=gte.<marca>)
+CREATE OR REPLACE FUNCTION tocar_updated_at() RETURNS TRIGGER
+LANGUAGE plpgsql AS $$
+BEGIN
+    NEW.updated_at = CURRENT_TIMESTAMP;
+    RETURN NEW;
+END $$;
+
+CREATE TRIGGER trg_textos_updated
+    BEFORE UPDATE ON textos_dinamicos_audio
+    FOR EACH ROW EXECUTE FUNCTION tocar_updated_at();
+
+-- Incremento atomico y en lote de contador_usos (POST /rpc/sumar_usos_frases)
+-- p_usos: [{"id_texto": 3, "usos": 5}, ...]; desactiva la frase al llegar al limite
+CREATE OR REPLACE FUNCTION sumar_usos_frases(p_usos JSONB)
+RETURNS TABLE (id_texto INT, contador_usos INT, limite_usos INT, estado_texto VARCHAR)
+LANGUAGE sql AS $$
+    UPDATE textos_dinamicos_audio t
+    SET contador_usos = COALESCE(t.contador_usos, 0) + u.usos,
+        estado_texto = CASE
+            WHEN COALESCE(t.contador_usos, 0) + u.usos >= COALESCE(t.limite_usos, 150) THEN 'desactivado'
+            ELSE t.estado_texto
+        END
+    FROM jsonb_to_recordset(p_usos) AS u(id_texto INT, usos INT)
+    WHERE t.id_texto = u.id_texto AND u.usos > 0
+    RETURNING t.id_texto, t.contador_usos, t.limite_usos, t.estado_texto;
+$$;
+
+GRANT EXECUTE ON FUNCTION sumar_usos_frases(JSONB) TO web_anon;
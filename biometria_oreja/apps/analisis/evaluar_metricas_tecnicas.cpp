@@ -31,6 +31,7 @@
 #include "utilidades/pca_utils.h"
 #include "utilidades/svm_ova_utils.h"
 #include "utilidades/zscore_params.h"
+#include "utilidades/estadisticas_gris.h"
 #include "svm/svm_prediccion.h"
 
 namespace fs = std::filesystem;
@@ -50,52 +51,18 @@ struct ImageMetrics {
     double dynamic_range = 0.0;
 };
 
-// Entropía de Shannon (Shannon 1948)
-double calcEntropy(const uint8_t* img, int w, int h) {
-    if (!img || w <= 0 || h <= 0) return 0.0;
-    
-    std::vector<int> hist(256, 0);
-    const int N = w * h;
-    
-    for (int i = 0; i < N; ++i) hist[img[i]]++;
-    
-    double entropy = 0.0;
-    for (int i = 0; i < 256; ++i) {
-        if (hist[i] > 0) {
-            double p = (double)hist[i] / N;
-            entropy -= p * std::log2(p);
-        }
-    }
-    return entropy;
-}
-
-// Calcular todas las métricas
+// Calcular todas las métricas (kernel de histograma compartido: una pasada)
 ImageMetrics calcMetrics(const uint8_t* img, int w, int h) {
     ImageMetrics m;
-    const int N = w * h;
-    if (!img || N <= 0) return m;
-
-    long long sum = 0, sum2 = 0;
-    
-    for (int i = 0; i < N; ++i) {
-        int v = (int)img[i];
-        sum += v;
-        sum2 += 1LL * v * v;
-        if (v < m.min_val) m.min_val = v;
-        if (v > m.max_val) m.max_val = v;
-    }
+    if (!img || w <= 0 || h <= 0) return m;
 
-    m.mean = (double)sum / (double)N;
-    double var = (double)sum2 / (double)N - m.mean * m.mean;
-    m.stddev = std::sqrt(var > 0 ? var : 0);
-    
-    m.entropy = calcEntropy(img, w, h);
-    
-    // Michelson Contrast (Michelson 1927)
-    if (m.max_val + m.min_val > 0) {
-        m.michelson_contrast = (double)(m.max_val - m.min_val) / (double)(m.max_val + m.min_val);
-    }
-    
+    const EstadisticasGris e = calcularEstadisticasGris(img, w, h);
+    m.mean = e.mean;
+    m.stddev = e.stddev;
+    m.min_val = e.minv;
+    m.max_val = e.maxv;
+    m.entropy = e.entropy;                       // Shannon 1948
+    m.michelson_contrast = e.michelson_contrast; // Michelson 1927
     m.rms_contrast = m.stddev; // RMS = stddev (Peli 1990)
     m.dynamic_range = m.max_val - m.min_val;
 
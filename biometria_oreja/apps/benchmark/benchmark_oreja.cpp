@@ -0,0 +1,233 @@
+// benchmark_oreja.cpp
+// Micro-benchmarks por etapa del pipeline de oreja con fixtures sintéticos
+// (deterministas, sin dataset ni modelos en disco).
+//
+// Uso: benchmark_oreja [--filtro=preproc] [--json=out/bench.json] [--base=out/bench_prev.json]
+//   Para aceptar una optimización: correr en la rama base con --json=base.json,
+//   luego en la rama nueva con --base=base.json (código 2 si hay regresión).
+
+#include "comun/micro_benchmark.h"
+
+#include "preprocesamiento/frontend_gris.h"
+#include "preprocesamiento/redimensionar_imagen.h"
+#include "preprocesamiento/preproc_workspace.h"
+#include "preprocesamiento/aumentar_dataset.h"
+#include "extraccion_caracteristicas/lbp.h"
+#include "utilidades/pca_utils.h"
+#include "utilidades/lda_utils.h"
+#include "utilidades/zscore_params.h"
+#include "utilidades/svm_ova_utils.h"
+#include "svm/svm_prediccion.h"
+#include "utilidades/logger.h"
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Dimensiones del pipeline FASE 6 (ver procesar_dataset.cpp / predecir.cpp)
+static constexpr int DIM_LBP = 6 * 6 * 118;
+static constexpr int DIM_PCA = 120;
+static constexpr int DIM_LDA = 40;
+static constexpr int NUM_CLASES = 100;
+
+// Foto RGB sintética: gradiente + textura periódica + ruido (semilla fija)
+static std::vector<uint8_t> fotoSintetica(int ancho, int alto) {
+    std::vector<uint8_t> rgb(static_cast<size_t>(ancho) * alto * 3);
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> ruido(-12, 12);
+    for (int y = 0; y < alto; ++y) {
+        for (int x = 0; x < ancho; ++x) {
+            const double base = 90.0 + 60.0 * std::sin(x * 0.031) * std::cos(y * 0.027) + 40.0 * x / ancho;
+            for (int c = 0; c < 3; ++c) {
+                const int v = static_cast<int>(base) + 15 * c + ruido(gen);
+                rgb[(static_cast<size_t>(y) * ancho + x) * 3 + c] = static_cast<uint8_t>(std::clamp(v, 0, 255));
+            }
+        }
+    }
+    return rgb;
+}
+
+static std::vector<std::vector<double>> matrizAleatoria(int filas, int columnas, std::mt19937& gen) {
+    std::normal_distribution<double> n(0.0, 1.0);
+    std::vector<std::vector<double>> m(filas, std::vector<double>(columnas));
+    for (auto& f : m) for (auto& v : f) v = n(gen);
+    return m;
+}
+
+// Mismo criterio que scoreTemplatesK1 en predecir.cpp: coseno contra todos, top-2
+static int scoreTemplates(const std::vector<std::vector<double>>& templates, const std::vector<double>& normas,
+                          const std::vector<double>& x, double& top1, double& top2) {
+    double nx = 0.0;
+    for (double v : x) nx += v * v;
+    nx = std::sqrt(std::max(nx, 1e-12));
+    int mejor = -1;
+    top1 = top2 = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < templates.size(); ++i) {
+        double dot = 0.0;
+        for (size_t k = 0; k < x.size(); ++k) dot += x[k] * templates[i][k];
+        const double s = dot / (nx * normas[i]);
+        if (s > top1) { top2 = top1; top1 = s; mejor = static_cast<int>(i); }
+        else if (s > top2) top2 = s;
+    }
+    return mejor;
+}
+
+int main(int argc, char** argv) {
+    SuiteBenchmark suite("oreja", argc, argv);
+#ifdef NDEBUG
+    suite.anotar("build", "release");
+#else
+    suite.anotar("build", "debug");
+#endif
+
+    // El logger escribe a stderr desde su propio hilo (fwrite), fuera de std::cerr
+    suite.alSilenciar([nivel = LOG_INFO](bool silenciar) mutable {
+        if (silenciar) {
+            flushLogs();
+            nivel = getLogLevel();
+            setLogLevel(LOG_OFF);
+        } else {
+            setLogLevel(nivel);
+        }
+    });
+
+    // ===== Fixtures =====
+    const int anchoFoto = 1200, altoFoto = 1600;
+    const auto foto = fotoSintetica(anchoFoto, altoFoto);
+
+    BufferGris bufGris;
+    int anchoGris = 0, altoGris = 0;
+    const uint8_t* gris0 = grisReducidaDesde(foto.data(), anchoFoto, altoFoto, 3, 128, 128, bufGris, anchoGris, altoGris);
+    const std::vector<uint8_t> gris(gris0, gris0 + static_cast<size_t>(anchoGris) * altoGris);
+
+    PreprocWorkspace ws;
+    std::vector<uint8_t> img128(PreprocWorkspace::PIXELES), tmp128(PreprocWorkspace::PIXELES);
+    ws.preprocesar(gris.data(), anchoGris, altoGris, img128.data());
+    const uint8_t* mask128 = PreprocWorkspace::mascara();
+
+    std::mt19937 gen(42);
+    const auto lbp = calcularLBPMultiEscalaPorBloquesRobustoNorm(img128.data(), mask128, 128, 128, 6, 6, 200, true);
+
+    ZScoreParams zs;
+    zs.mean.assign(lbp.size(), 0.01);
+    zs.stdev.assign(lbp.size(), 0.02);
+
+    ModeloPCA pca;
+    pca.componentes = matrizAleatoria(DIM_PCA, static_cast<int>(lbp.size()), gen);
+    pca.medias.assign(lbp.size(), 0.0);
+
+    ModeloLDA lda;
+    lda.componentes = matrizAleatoria(DIM_LDA, DIM_PCA, gen);
+    lda.mediaGlobal.assign(DIM_PCA, 0.0);
+    lda.numClases = NUM_CLASES;
+
+    ModeloSVM svm;
+    svm.pesosPorClase = matrizAleatoria(NUM_CLASES, DIM_LDA, gen);
+    svm.biasPorClase.assign(NUM_CLASES, 0.1);
+    for (int c = 0; c < NUM_CLASES; ++c) svm.clases.push_back(c + 1);
+
+    const auto templates = matrizAleatoria(NUM_CLASES, DIM_LDA, gen);
+    std::vector<double> normas;
+    for (const auto& t : templates) {
+        double s = 0.0;
+        for (double v : t) s += v * v;
+        normas.push_back(std::sqrt(s));
+    }
+
+    const std::vector<std::vector<double>> xLbp{ lbp };
+    const auto xPca = aplicarPCAConModelo(xLbp, pca);
+    const auto xLda = aplicarLDAConModelo(xPca, lda);
+
+    // Modelos en disco (formato real de cada cargador)
+    const fs::path dirModelos = fs::temp_directory_path() / "benchmark_oreja";
+    fs::create_directories(dirModelos);
+    const std::string rutaPca = (dirModelos / "modelo_pca.csv").string();
+    const std::string rutaLda = (dirModelos / "modelo_lda.csv").string();
+    const std::string rutaSvm = (dirModelos / "modelo_svm.csv").string();
+    const std::string rutaZs = (dirModelos / "zscore_params.csv").string();
+    guardarModeloPCA(rutaPca, pca);
+    guardarModeloLDA(rutaLda, lda);
+    guardarModeloSVM(rutaSvm, svm);
+    guardarZScoreParams(rutaZs, zs);
+
+    // ===== Preprocesamiento =====
+    suite.agregar("preproc/frontend_gris_1200x1600", "px", double(anchoFoto) * altoFoto, [&] {
+        int w = 0, h = 0;
+        noOptimizar(grisReducidaDesde(foto.data(), anchoFoto, altoFoto, 3, 128, 128, bufGris, w, h));
+    });
+    suite.agregar("preproc/resize_128", "px", PreprocWorkspace::PIXELES, [&] {
+        ws.redimensionar(gris.data(), anchoGris, altoGris, tmp128.data());
+        noOptimizar(tmp128[0]);
+    });
+    suite.agregar("preproc/clahe_128", "px", PreprocWorkspace::PIXELES, [&] {
+        ws.clahe(img128.data(), tmp128.data());
+        noOptimizar(tmp128[0]);
+    });
+    suite.agregar("preproc/bilateral_128", "px", PreprocWorkspace::PIXELES, [&] {
+        ws.bilateral(img128.data(), tmp128.data());
+        noOptimizar(tmp128[0]);
+    });
+    suite.agregar("preproc/completo_128", "img", 1.0, [&] {
+        noOptimizar(ws.preprocesar(gris.data(), anchoGris, altoGris, tmp128.data()));
+    });
+
+    ConfigAumentoGeometrico cfgAug;
+    cfgAug.semilla = 12345u;
+    cfgAug.banco = 64;
+    std::vector<uint8_t> bufAug(static_cast<size_t>(cfgAug.variantes) * PreprocWorkspace::PIXELES);
+    suite.agregar("preproc/aumento_geom_x4", "img", cfgAug.variantes, [&] {
+        noOptimizar(aumentarGeometricoEnBuffer(img128.data(), 128, 128, "bench", cfgAug, bufAug.data()));
+    });
+
+    // ===== Características =====
+    suite.agregar("features/lbp_multiescala_6x6", "img", 1.0, [&] {
+        noOptimizar(calcularLBPMultiEscalaPorBloquesRobustoNorm(img128.data(), mask128, 128, 128, 6, 6, 200, true));
+    });
+    suite.agregar("features/zscore_4248", "vec", 1.0, [&] {
+        auto x = lbp;
+        aplicarZScore(x, zs);
+        noOptimizar(x);
+    });
+    suite.agregar("features/proyeccion_pca_4248x120", "vec", 1.0, [&] {
+        noOptimizar(aplicarPCAConModelo(xLbp, pca));
+    });
+    suite.agregar("features/proyeccion_lda_120x40", "vec", 1.0, [&] {
+        noOptimizar(aplicarLDAConModelo(xPca, lda));
+    });
+
+    // ===== Scoring =====
+    suite.agregar("scoring/templates_coseno_100", "clase", NUM_CLASES, [&] {
+        double t1 = 0.0, t2 = 0.0;
+        noOptimizar(scoreTemplates(templates, normas, xLda[0], t1, t2));
+    });
+    suite.agregar("scoring/svm_ova_100", "clase", NUM_CLASES, [&] {
+        noOptimizar(predecirConScores(xLda[0], svm));
+    });
+
+    // ===== Carga de modelos =====
+    suite.agregar("modelos/cargar_pca", "modelo", 1.0, [&] {
+        noOptimizar(cargarModeloPCA(rutaPca));
+    });
+    suite.agregar("modelos/cargar_lda", "modelo", 1.0, [&] {
+        noOptimizar(cargarModeloLDA(rutaLda));
+    });
+    suite.agregar("modelos/cargar_svm", "modelo", 1.0, [&] {
+        ModeloSVM m;
+        noOptimizar(cargarModeloSVM(rutaSvm, m));
+    });
+    suite.agregar("modelos/cargar_zscore", "modelo", 1.0, [&] {
+        ZScoreParams p;
+        noOptimizar(cargarZScoreParams(rutaZs, p));
+    });
+
+    const int rc = suite.ejecutar();
+    std::error_code ec;
+    fs::remove_all(dirModelos, ec);
+    return rc;
+}
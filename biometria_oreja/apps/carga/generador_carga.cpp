@@ -0,0 +1,541 @@
+// generador_carga.cpp
+// Generador de carga para los servidores HTTP de oreja y voz: reproduce un
+// corpus de imágenes/audios contra un servidor en marcha y reporta latencia
+// p50/p90/p99/p99.9, tasa de error y throughput por endpoint (JSON + HTML).
+//
+// Uso: generador_carga --oreja=http://localhost:8085 --voz=http://localhost:8081 --corpus=carga/
+//        [--endpoints=oreja_autenticar,voz_autenticar:2,frases_aleatoria] (nombre[:peso])
+//        [--concurrencia=8] [--qps=0] [--duracion=30] [--calentamiento=5] [--timeout=60]
+//        [--identificador=carga_0001] [--id-frase=1]
+//        [--json=out/carga.json] [--html=out/carga.html] [--base=out/carga_prev.json] [--tolerancia=0.2]
+//
+//   --qps=0  lazo cerrado: cada hilo envía la siguiente solicitud al recibir la anterior.
+//   --qps=N  lazo abierto: solicitudes programadas a N/s con hasta --concurrencia en vuelo;
+//            la latencia se mide desde el instante programado (incluye la espera si el
+//            servidor se satura, sin omisión coordinada).
+//   --base   compara p99 y tasa de error contra un reporte previo (código 2 si hay regresión).
+//
+// Corpus: <corpus>/oreja/**.{jpg,png,...} y <corpus>/voz/**.{wav,mp3,...}. Si el archivo
+// está en una subcarpeta, su nombre es el identificador (cédula); si no, --identificador.
+// Sin BD: levantar stub_postgrest y arrancar los servidores con POSTGREST_URL apuntando a él.
+// Ojo: oreja_registrar reentrena el modelo del servidor; usar un MODEL_DIR desechable.
+
+#include "httplib.h"
+#include "json.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+using Reloj = std::chrono::steady_clock;
+
+// ===================== Configuración =====================
+struct ConfigCarga {
+    std::string urlOreja;
+    std::string urlVoz;
+    std::string corpus = "carga";
+    std::string endpoints;
+    int concurrencia = 8;
+    double qps = 0.0;
+    double duracionS = 30.0;
+    double calentamientoS = 5.0;
+    int timeoutS = 60;
+    std::string identificador = "carga_0001";
+    int idFrase = 1;
+    std::string rutaJson;
+    std::string rutaHtml;
+    std::string rutaBase;
+    double tolerancia = 0.2;
+};
+
+static bool parsearArgs(int argc, char** argv, ConfigCarga& cfg) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        const auto eq = a.find('=');
+        if (a.rfind("--", 0) != 0 || eq == std::string::npos) {
+            std::cerr << "Argumento inválido: " << a << "\n";
+            return false;
+        }
+        const std::string k = a.substr(2, eq - 2);
+        const std::string v = a.substr(eq + 1);
+        if (k == "oreja") cfg.urlOreja = v;
+        else if (k == "voz") cfg.urlVoz = v;
+        else if (k == "corpus") cfg.corpus = v;
+        else if (k == "endpoints") cfg.endpoints = v;
+        else if (k == "concurrencia") cfg.concurrencia = std::max(1, std::atoi(v.c_str()));
+        else if (k == "qps") cfg.qps = std::max(0.0, std::atof(v.c_str()));
+        else if (k == "duracion") cfg.duracionS = std::max(1.0, std::atof(v.c_str()));
+        else if (k == "calentamiento") cfg.calentamientoS = std::max(0.0, std::atof(v.c_str()));
+        else if (k == "timeout") cfg.timeoutS = std::max(1, std::atoi(v.c_str()));
+        else if (k == "identificador") cfg.identificador = v;
+        else if (k == "id-frase") cfg.idFrase = std::atoi(v.c_str());
+        else if (k == "json") cfg.rutaJson = v;
+        else if (k == "html") cfg.rutaHtml = v;
+        else if (k == "base") cfg.rutaBase = v;
+        else if (k == "tolerancia") cfg.tolerancia = std::max(0.0, std::atof(v.c_str()));
+        else {
+            std::cerr << "Opción desconocida: --" << k << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// ===================== Corpus =====================
+struct ArchivoCorpus {
+    std::string identificador;
+    std::string nombre;
+    std::string tipoContenido;
+    std::string contenido;
+};
+
+static std::string extensionMinuscula(const fs::path& p) {
+    std::string ext = p.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return ext;
+}
+
+static std::vector<ArchivoCorpus> cargarCorpus(const fs::path& raiz, const std::map<std::string, std::string>& tipos,
+                                               const std::string& identificadorDefecto) {
+    std::vector<ArchivoCorpus> archivos;
+    std::error_code ec;
+    if (!fs::is_directory(raiz, ec)) return archivos;
+
+    for (const auto& e : fs::recursive_directory_iterator(raiz, ec)) {
+        if (!e.is_regular_file()) continue;
+        const auto it = tipos.find(extensionMinuscula(e.path()));
+        if (it == tipos.end()) continue;
+
+        std::ifstream in(e.path(), std::ios::binary);
+        std::ostringstream ss;
+        ss << in.rdbuf();
+
+        ArchivoCorpus a;
+        a.identificador = (e.path().parent_path() == raiz) ? identificadorDefecto
+                                                           : e.path().parent_path().filename().string();
+        a.nombre = e.path().filename().string();
+        a.tipoContenido = it->second;
+        a.contenido = ss.str();
+        archivos.push_back(std::move(a));
+    }
+    // Orden estable: la misma corrida reproduce la misma secuencia
+    std::sort(archivos.begin(), archivos.end(), [](const ArchivoCorpus& x, const ArchivoCorpus& y) {
+        return std::tie(x.identificador, x.nombre) < std::tie(y.identificador, y.nombre);
+    });
+    return archivos;
+}
+
+// ===================== Endpoints =====================
+enum class TipoEndpoint { OrejaAutenticar, OrejaRegistrar, VozAutenticar, FrasesAleatoria };
+
+struct Endpoint {
+    std::string nombre;
+    TipoEndpoint tipo;
+    bool esOreja;
+    int peso = 1;
+};
+
+static bool endpointPorNombre(const std::string& nombre, Endpoint& ep) {
+    static const std::map<std::string, std::pair<TipoEndpoint, bool>> conocidos = {
+        {"oreja_autenticar", {TipoEndpoint::OrejaAutenticar, true}},
+        {"oreja_registrar", {TipoEndpoint::OrejaRegistrar, true}},
+        {"voz_autenticar", {TipoEndpoint::VozAutenticar, false}},
+        {"frases_aleatoria", {TipoEndpoint::FrasesAleatoria, false}},
+    };
+    const auto it = conocidos.find(nombre);
+    if (it == conocidos.end()) return false;
+    ep.nombre = nombre;
+    ep.tipo = it->second.first;
+    ep.esOreja = it->second.second;
+    return true;
+}
+
+// Por defecto: los endpoints de solo lectura de cada servidor indicado
+static std::vector<Endpoint> seleccionarEndpoints(const ConfigCarga& cfg) {
+    std::string lista = cfg.endpoints;
+    if (lista.empty()) {
+        if (!cfg.urlOreja.empty()) lista += "oreja_autenticar,";
+        if (!cfg.urlVoz.empty()) lista += "voz_autenticar,frases_aleatoria,";
+    }
+
+    std::vector<Endpoint> eps;
+    std::stringstream ss(lista);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        Endpoint ep;
+        const auto dp = item.find(':');
+        const std::string nombre = item.substr(0, dp);
+        if (!endpointPorNombre(nombre, ep)) {
+            std::cerr << "Endpoint desconocido: " << nombre << "\n";
+            return {};
+        }
+        if (dp != std::string::npos) ep.peso = std::max(1, std::atoi(item.c_str() + dp + 1));
+        if ((ep.esOreja ? cfg.urlOreja : cfg.urlVoz).empty()) {
+            std::cerr << "Falta --" << (ep.esOreja ? "oreja" : "voz") << "=URL para " << nombre << "\n";
+            return {};
+        }
+        eps.push_back(ep);
+    }
+    return eps;
+}
+
+// ===================== Solicitudes =====================
+struct Muestra {
+    uint16_t endpoint = 0;
+    int status = 0;              // 0 = error de transporte
+    bool fallaAplicacion = false; // 200 con "success": false (servidor de voz)
+    double ms = 0.0;
+};
+
+class Cliente {
+public:
+    Cliente(const ConfigCarga& cfg, const std::vector<ArchivoCorpus>& imagenes, const std::vector<ArchivoCorpus>& audios)
+        : cfg_(cfg), imagenes_(imagenes), audios_(audios) {
+        if (!cfg.urlOreja.empty()) oreja_ = crear(cfg.urlOreja);
+        if (!cfg.urlVoz.empty()) voz_ = crear(cfg.urlVoz);
+    }
+
+    // k: número de solicitud (elige el archivo del corpus)
+    httplib::Result enviar(const Endpoint& ep, uint64_t k) {
+        switch (ep.tipo) {
+        case TipoEndpoint::OrejaAutenticar: {
+            const auto& img = imagenes_[k % imagenes_.size()];
+            httplib::MultipartFormDataItemsForClientInput items = { {"archivo", img.contenido, img.nombre, img.tipoContenido} };
+            return oreja_->Post(("/oreja/autenticar?etiqueta=" + img.identificador).c_str(), items);
+        }
+        case TipoEndpoint::OrejaRegistrar: {
+            // 5 imágenes del mismo identificador (cíclicas si tiene menos)
+            const auto& primera = imagenes_[k % imagenes_.size()];
+            std::vector<const ArchivoCorpus*> mismas;
+            for (const auto& img : imagenes_) {
+                if (img.identificador == primera.identificador) mismas.push_back(&img);
+            }
+            httplib::MultipartFormDataItemsForClientInput items;
+            for (int i = 0; i < 5; ++i) {
+                const auto* img = mismas[(k + i) % mismas.size()];
+                items.push_back({"imagen" + std::to_string(i), img->contenido, img->nombre, img->tipoContenido});
+            }
+            return oreja_->Post(("/oreja/registrar?identificador=" + primera.identificador).c_str(), items);
+        }
+        case TipoEndpoint::VozAutenticar: {
+            const auto& audio = audios_[k % audios_.size()];
+            httplib::MultipartFormDataItemsForClientInput items = {
+                {"audio", audio.contenido, audio.nombre, audio.tipoContenido},
+                {"identificador", audio.identificador, "", ""},
+                {"id_frase", std::to_string(cfg_.idFrase), "", ""},
+            };
+            return voz_->Post("/voz/autenticar", items);
+        }
+        case TipoEndpoint::FrasesAleatoria:
+            return voz_->Get("/frases/aleatoria");
+        }
+        return httplib::Result();
+    }
+
+private:
+    std::unique_ptr<httplib::Client> crear(const std::string& url) const {
+        auto cli = std::make_unique<httplib::Client>(url);
+        cli->set_keep_alive(true);
+        cli->set_connection_timeout(5, 0);
+        cli->set_read_timeout(cfg_.timeoutS, 0);
+        cli->set_write_timeout(cfg_.timeoutS, 0);
+        return cli;
+    }
+
+    const ConfigCarga& cfg_;
+    const std::vector<ArchivoCorpus>& imagenes_;
+    const std::vector<ArchivoCorpus>& audios_;
+    std::unique_ptr<httplib::Client> oreja_;
+    std::unique_ptr<httplib::Client> voz_;
+};
+
+// ===================== Estadísticas =====================
+static double percentil(const std::vector<double>& ordenadas, double p) {
+    if (ordenadas.empty()) return 0.0;
+    const size_t rango = (size_t)std::ceil(p * ordenadas.size());
+    return ordenadas[std::min(ordenadas.size() - 1, rango == 0 ? 0 : rango - 1)];
+}
+
+static bool esError(const Muestra& m) {
+    return m.status == 0 || m.status >= 500;
+}
+
+static json resumir(const std::vector<Muestra>& muestras, double segundos) {
+    std::vector<double> lat;
+    lat.reserve(muestras.size());
+    std::map<std::string, long long> porStatus;
+    long long errores = 0, fallosApp = 0, ok = 0;
+    double suma = 0.0;
+    for (const auto& m : muestras) {
+        lat.push_back(m.ms);
+        suma += m.ms;
+        ++porStatus[m.status == 0 ? "transporte" : std::to_string(m.status)];
+        if (esError(m)) ++errores;
+        else if (m.status >= 200 && m.status < 300) ++ok;
+        if (m.fallaAplicacion) ++fallosApp;
+    }
+    std::sort(lat.begin(), lat.end());
+
+    const double n = (double)muestras.size();
+    return {
+        {"solicitudes", muestras.size()},
+        {"ok_2xx", ok},
+        {"errores", errores},
+        {"tasa_error", n > 0 ? errores / n : 0.0},
+        {"fallos_aplicacion", fallosApp},
+        {"throughput_rps", segundos > 0 ? n / segundos : 0.0},
+        {"latencia_ms", {
+            {"media", n > 0 ? suma / n : 0.0},
+            {"min", lat.empty() ? 0.0 : lat.front()},
+            {"p50", percentil(lat, 0.50)},
+            {"p90", percentil(lat, 0.90)},
+            {"p99", percentil(lat, 0.99)},
+            {"p999", percentil(lat, 0.999)},
+            {"max", lat.empty() ? 0.0 : lat.back()},
+        }},
+        {"status", porStatus},
+    };
+}
+
+// ===================== Reportes =====================
+static void imprimirResumen(const json& reporte) {
+    std::cout << "\n" << std::left << std::setw(20) << "endpoint" << std::right
+              << std::setw(8) << "n" << std::setw(9) << "rps" << std::setw(8) << "err%"
+              << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+              << std::setw(10) << "p99.9" << std::setw(10) << "max" << "  (ms)\n";
+    auto fila = [](const std::string& nombre, const json& r) {
+        const auto& l = r["latencia_ms"];
+        std::cout << std::left << std::setw(20) << nombre << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << r["solicitudes"].get<long long>()
+                  << std::setw(9) << r["throughput_rps"].get<double>()
+                  << std::setw(8) << 100.0 * r["tasa_error"].get<double>()
+                  << std::setw(10) << l["p50"].get<double>() << std::setw(10) << l["p90"].get<double>()
+                  << std::setw(10) << l["p99"].get<double>() << std::setw(10) << l["p999"].get<double>()
+                  << std::setw(10) << l["max"].get<double>() << "\n";
+    };
+    for (const auto& [nombre, r] : reporte["endpoints"].items()) fila(nombre, r);
+    fila("TOTAL", reporte["global"]);
+}
+
+static std::string escaparHtml(const std::string& s) {
+    std::string o;
+    for (char c : s) {
+        if (c == '<') o += "&lt;";
+        else if (c == '>') o += "&gt;";
+        else if (c == '&') o += "&amp;";
+        else o += c;
+    }
+    return o;
+}
+
+// HTML autocontenido: tabla por endpoint + barras de percentiles a escala común
+static bool escribirHtml(const std::string& ruta, const json& reporte) {
+    std::ofstream out(ruta);
+    if (!out) return false;
+
+    double maxP999 = 1e-9;
+    for (const auto& [_, r] : reporte["endpoints"].items())
+        maxP999 = std::max(maxP999, r["latencia_ms"]["p999"].get<double>());
+
+    out << "<!DOCTYPE html><html><head><meta charset=\"utf-8\"><title>Prueba de carga</title><style>"
+           "body{font-family:sans-serif;margin:2em}table{border-collapse:collapse}"
+           "td,th{border:1px solid #ccc;padding:4px 8px;text-align:right}th{background:#eee}"
+           "td:first-child{text-align:left}.b{height:10px;margin:2px 0}"
+           ".p50{background:#4caf50}.p90{background:#ffc107}.p99{background:#ff5722}.p999{background:#9c27b0}"
+           "</style></head><body><h1>Prueba de carga</h1><pre>"
+        << escaparHtml(reporte["config"].dump(2)) << "</pre>"
+        << "<table><tr><th>endpoint</th><th>n</th><th>rps</th><th>error %</th><th>fallos app</th>"
+           "<th>p50 ms</th><th>p90 ms</th><th>p99 ms</th><th>p99.9 ms</th><th>max ms</th><th>status</th>"
+           "<th style=\"width:300px\">percentiles</th></tr>\n";
+
+    auto fila = [&](const std::string& nombre, const json& r, bool barras) {
+        const auto& l = r["latencia_ms"];
+        out << std::fixed << std::setprecision(1) << "<tr><td>" << escaparHtml(nombre) << "</td><td>"
+            << r["solicitudes"].get<long long>() << "</td><td>" << r["throughput_rps"].get<double>() << "</td><td>"
+            << 100.0 * r["tasa_error"].get<double>() << "</td><td>" << r["fallos_aplicacion"].get<long long>()
+            << "</td><td>" << l["p50"].get<double>() << "</td><td>" << l["p90"].get<double>() << "</td><td>"
+            << l["p99"].get<double>() << "</td><td>" << l["p999"].get<double>() << "</td><td>"
+            << l["max"].get<double>() << "</td><td>" << escaparHtml(r["status"].dump()) << "</td><td>";
+        if (barras) {
+            for (const char* p : { "p50", "p90", "p99", "p999" }) {
+                out << "<div class=\"b " << p << "\" title=\"" << p << "\" style=\"width:"
+                    << 100.0 * l[p].get<double>() / maxP999 << "%\"></div>";
+            }
+        }
+        out << "</td></tr>\n";
+    };
+    for (const auto& [nombre, r] : reporte["endpoints"].items()) fila(nombre, r, true);
+    fila("TOTAL", reporte["global"], false);
+    out << "</table></body></html>\n";
+    return true;
+}
+
+// Regresión: p99 por encima de base*(1+tolerancia) o tasa de error +1 punto
+static bool compararConBase(const json& reporte, const std::string& rutaBase, double tolerancia) {
+    std::ifstream in(rutaBase);
+    json base = json::parse(in, nullptr, false);
+    if (base.is_discarded() || !base.contains("endpoints")) {
+        std::cerr << "! No se pudo leer la base " << rutaBase << "\n";
+        return false;
+    }
+
+    bool regresion = false;
+    for (const auto& [nombre, r] : reporte["endpoints"].items()) {
+        if (!base["endpoints"].contains(nombre)) continue;
+        const auto& b = base["endpoints"][nombre];
+        const double p99 = r["latencia_ms"]["p99"].get<double>();
+        const double p99Base = b["latencia_ms"]["p99"].get<double>();
+        const double err = r["tasa_error"].get<double>();
+        const double errBase = b["tasa_error"].get<double>();
+        const bool malP99 = p99 > p99Base * (1.0 + tolerancia);
+        const bool malErr = err > errBase + 0.01;
+        std::cout << (malP99 || malErr ? "  REGRESION " : "  ok        ") << nombre << std::fixed << std::setprecision(1)
+                  << "  p99 " << p99Base << " -> " << p99 << " ms"
+                  << "  error " << 100.0 * errBase << "% -> " << 100.0 * err << "%\n";
+        regresion = regresion || malP99 || malErr;
+    }
+    return regresion;
+}
+
+// ===================== MAIN =====================
+int main(int argc, char** argv) {
+    ConfigCarga cfg;
+    if (!parsearArgs(argc, argv, cfg)) return 1;
+    if (cfg.urlOreja.empty() && cfg.urlVoz.empty()) {
+        std::cerr << "Indica al menos --oreja=URL o --voz=URL\n";
+        return 1;
+    }
+
+    const std::vector<Endpoint> endpoints = seleccionarEndpoints(cfg);
+    if (endpoints.empty()) return 1;
+
+    // Corpus en memoria: el disco no entra en la medición
+    const fs::path raiz(cfg.corpus);
+    const fs::path dirOreja = fs::is_directory(raiz / "oreja") ? raiz / "oreja" : raiz;
+    const fs::path dirVoz = fs::is_directory(raiz / "voz") ? raiz / "voz" : raiz;
+    const auto imagenes = cargarCorpus(dirOreja, {
+        {".jpg", "image/jpeg"}, {".jpeg", "image/jpeg"}, {".png", "image/png"}, {".bmp", "image/bmp"},
+    }, cfg.identificador);
+    const auto audios = cargarCorpus(dirVoz, {
+        {".wav", "audio/wav"}, {".mp3", "audio/mpeg"}, {".ogg", "audio/ogg"}, {".flac", "audio/flac"},
+        {".m4a", "audio/mp4"}, {".aac", "audio/aac"}, {".webm", "audio/webm"},
+    }, cfg.identificador);
+
+    std::vector<size_t> turnos; // índice de endpoint por turno, según pesos
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        const auto& ep = endpoints[i];
+        if ((ep.tipo == TipoEndpoint::OrejaAutenticar || ep.tipo == TipoEndpoint::OrejaRegistrar) && imagenes.empty()) {
+            std::cerr << "Sin imágenes en " << dirOreja << " para " << ep.nombre << "\n";
+            return 1;
+        }
+        if (ep.tipo == TipoEndpoint::VozAutenticar && audios.empty()) {
+            std::cerr << "Sin audios en " << dirVoz << " para " << ep.nombre << "\n";
+            return 1;
+        }
+        turnos.insert(turnos.end(), ep.peso, i);
+    }
+
+    std::cout << "Corpus: " << imagenes.size() << " imágenes, " << audios.size() << " audios\n"
+              << "Modo: lazo " << (cfg.qps > 0 ? "abierto a " : "cerrado");
+    if (cfg.qps > 0) std::cout << cfg.qps << " qps";
+    std::cout << ", concurrencia=" << cfg.concurrencia << ", duración=" << cfg.duracionS
+              << "s (+" << cfg.calentamientoS << "s calentamiento)\n";
+
+    const auto inicio = Reloj::now() + std::chrono::milliseconds(100);
+    const auto inicioMedicion = inicio + std::chrono::duration_cast<Reloj::duration>(std::chrono::duration<double>(cfg.calentamientoS));
+    const auto fin = inicioMedicion + std::chrono::duration_cast<Reloj::duration>(std::chrono::duration<double>(cfg.duracionS));
+    const auto intervalo = std::chrono::duration_cast<Reloj::duration>(std::chrono::duration<double>(cfg.qps > 0 ? 1.0 / cfg.qps : 0.0));
+
+    std::atomic<uint64_t> siguiente{ 0 };
+    std::vector<std::vector<Muestra>> porHilo(cfg.concurrencia);
+    std::vector<std::thread> hilos;
+    for (int h = 0; h < cfg.concurrencia; ++h) {
+        hilos.emplace_back([&, h] {
+            Cliente cliente(cfg, imagenes, audios);
+            auto& muestras = porHilo[h];
+            std::this_thread::sleep_until(inicio);
+            for (;;) {
+                const uint64_t k = siguiente.fetch_add(1);
+                Reloj::time_point programado = Reloj::now();
+                if (cfg.qps > 0) {
+                    programado = inicio + intervalo * (int64_t)k;
+                    if (programado >= fin) break;
+                    std::this_thread::sleep_until(programado);
+                } else if (programado >= fin) {
+                    break;
+                }
+
+                const size_t idx = turnos[k % turnos.size()];
+                auto res = cliente.enviar(endpoints[idx], k / turnos.size());
+                const auto t1 = Reloj::now();
+                if (programado < inicioMedicion) continue;
+
+                Muestra m;
+                m.endpoint = (uint16_t)idx;
+                m.status = res ? res->status : 0;
+                m.fallaAplicacion = res && res->status == 200 &&
+                                    res->body.find("\"success\":false") != std::string::npos;
+                m.ms = std::chrono::duration<double, std::milli>(t1 - programado).count();
+                muestras.push_back(m);
+            }
+        });
+    }
+    for (auto& t : hilos) t.join();
+
+    // ===== Agregación =====
+    std::vector<std::vector<Muestra>> porEndpoint(endpoints.size());
+    std::vector<Muestra> todas;
+    for (const auto& v : porHilo) {
+        for (const auto& m : v) {
+            porEndpoint[m.endpoint].push_back(m);
+            todas.push_back(m);
+        }
+    }
+
+    json cfgJson = {
+        {"oreja", cfg.urlOreja}, {"voz", cfg.urlVoz}, {"corpus", cfg.corpus},
+        {"modo", cfg.qps > 0 ? "abierto" : "cerrado"}, {"qps", cfg.qps}, {"concurrencia", cfg.concurrencia},
+        {"duracion_s", cfg.duracionS}, {"calentamiento_s", cfg.calentamientoS},
+        {"imagenes", imagenes.size()}, {"audios", audios.size()},
+    };
+    json reporte = { {"config", cfgJson}, {"endpoints", json::object()} };
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        reporte["endpoints"][endpoints[i].nombre] = resumir(porEndpoint[i], cfg.duracionS);
+    }
+    reporte["global"] = resumir(todas, cfg.duracionS);
+
+    imprimirResumen(reporte);
+
+    if (!cfg.rutaJson.empty()) {
+        std::ofstream out(cfg.rutaJson);
+        out << reporte.dump(2) << "\n";
+        std::cout << "JSON: " << cfg.rutaJson << "\n";
+    }
+    if (!cfg.rutaHtml.empty()) {
+        if (escribirHtml(cfg.rutaHtml, reporte)) std::cout << "HTML: " << cfg.rutaHtml << "\n";
+        else std::cerr << "! No se pudo escribir " << cfg.rutaHtml << "\n";
+    }
+    if (!cfg.rutaBase.empty()) {
+        std::cout << "\nComparación con " << cfg.rutaBase << " (tolerancia p99 " << 100.0 * cfg.tolerancia << "%):\n";
+        if (compararConBase(reporte, cfg.rutaBase, cfg.tolerancia)) return 2;
+    }
+    return 0;
+}
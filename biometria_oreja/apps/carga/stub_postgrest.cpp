@@ -0,0 +1,237 @@
+// stub_postgrest.cpp
+// Sustituto local de PostgREST para pruebas de carga sin base de datos.
+// Responde las consultas que hacen los servidores de oreja y voz con filas
+// sintéticas pero con el mismo formato (arrays JSON, nombres de columna de
+// biometria_db/schema.sql). Cualquier identificador existe y está activo.
+//
+// Uso: stub_postgrest [--puerto=3001] [--latencia-ms=0] [--jitter-ms=0] [--frases=20] [--hilos=32]
+//   Servidores: POSTGREST_URL=http://localhost:3001
+//   Estadísticas: GET /_stub/estadisticas (conteo por tabla y método)
+
+#include "httplib.h"
+#include "json.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+using json = nlohmann::json;
+
+struct ConfigStub {
+    int puerto = 3001;
+    int latenciaMs = 0;   // RTT simulado de la BD
+    int jitterMs = 0;     // + uniforme [0, jitter]
+    int frases = 20;
+    int hilos = 32;
+};
+
+static ConfigStub parsearArgs(int argc, char** argv) {
+    ConfigStub cfg;
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto valor = [&](const char* clave) -> const char* {
+            const std::string k = std::string(clave) + "=";
+            return a.rfind(k, 0) == 0 ? argv[i] + k.size() : nullptr;
+        };
+        if (auto v = valor("--puerto")) cfg.puerto = std::atoi(v);
+        else if (auto v = valor("--latencia-ms")) cfg.latenciaMs = std::max(0, std::atoi(v));
+        else if (auto v = valor("--jitter-ms")) cfg.jitterMs = std::max(0, std::atoi(v));
+        else if (auto v = valor("--frases")) cfg.frases = std::max(1, std::atoi(v));
+        else if (auto v = valor("--hilos")) cfg.hilos = std::max(1, std::atoi(v));
+        else std::cerr << "Argumento ignorado: " << a << "\n";
+    }
+    return cfg;
+}
+
+// "eq.123" -> "123" (filtros PostgREST)
+static std::string valorFiltro(const httplib::Request& req, const char* campo) {
+    if (!req.has_param(campo)) return "";
+    const std::string v = req.get_param_value(campo);
+    return v.rfind("eq.", 0) == 0 ? v.substr(3) : "";
+}
+
+// id_usuario estable por identificador (FNV-1a acotado a int positivo)
+static int idDesdeIdentificador(const std::string& identificador) {
+    uint32_t h = 2166136261u;
+    for (unsigned char c : identificador) { h ^= c; h *= 16777619u; }
+    return static_cast<int>(h % 1000000u) + 1;
+}
+
+static json filaUsuario(int id, const std::string& identificador) {
+    return {
+        {"id_usuario", id},
+        {"nombres", "Carga"},
+        {"apellidos", "Usuario " + std::to_string(id)},
+        {"fecha_nacimiento", "1990-01-01"},
+        {"sexo", "M"},
+        {"identificador_unico", identificador.empty() ? "carga_" + std::to_string(id) : identificador},
+        {"estado", "activo"},
+        {"fecha_registro", "2024-01-01T00:00:00"},
+        {"updated_at", "2024-01-01T00:00:00"}
+    };
+}
+
+static json filaFrase(int id) {
+    return {
+        {"id_texto", id},
+        {"frase", "frase de prueba numero " + std::to_string(id)},
+        {"estado_texto", "activo"},
+        {"contador_usos", 0},
+        {"limite_usos", 1000000},
+        {"updated_at", "2024-01-01T00:00:00"}
+    };
+}
+
+// Clave primaria por tabla (schema.sql), para el eco de return=representation
+static std::string clavePrimaria(const std::string& tabla) {
+    static const std::map<std::string, std::string> claves = {
+        {"usuarios", "id_usuario"},
+        {"credenciales_biometricas", "id_credencial"},
+        {"textos_dinamicos_audio", "id_texto"},
+        {"validaciones_biometricas", "id_validacion"},
+        {"caracteristicas_hablantes", "id_caracteristica"},
+        {"caracteristicas_oreja", "id_caracteristica"},
+    };
+    const auto it = claves.find(tabla);
+    return it != claves.end() ? it->second : "id";
+}
+
+class EstadisticasStub {
+public:
+    void contar(const std::string& clave) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        ++conteos_[clave];
+    }
+    json aJson() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return json(conteos_);
+    }
+
+private:
+    mutable std::mutex mtx_;
+    std::map<std::string, long long> conteos_;
+};
+
+int main(int argc, char** argv) {
+    const ConfigStub cfg = parsearArgs(argc, argv);
+    EstadisticasStub stats;
+    std::atomic<int> secuencia{ 1 };
+
+    auto esperar = [&cfg]() {
+        if (cfg.latenciaMs <= 0 && cfg.jitterMs <= 0) return;
+        static thread_local std::mt19937 gen(std::random_device{}());
+        std::uniform_int_distribution<int> jitter(0, cfg.jitterMs);
+        std::this_thread::sleep_for(std::chrono::milliseconds(cfg.latenciaMs + jitter(gen)));
+    };
+
+    // Prefer: return=representation -> eco de las filas con clave primaria asignada
+    auto responderEscritura = [&](const httplib::Request& req, httplib::Response& res, int statusSinCuerpo) {
+        const bool representacion = req.get_header_value("Prefer").find("return=representation") != std::string::npos;
+        if (!representacion) {
+            res.status = statusSinCuerpo;
+            return;
+        }
+        json cuerpo = json::parse(req.body, nullptr, false);
+        if (cuerpo.is_discarded()) cuerpo = json::object();
+        json filas = cuerpo.is_array() ? cuerpo : json::array({ cuerpo });
+        const std::string clave = clavePrimaria(req.path.substr(1));
+        for (auto& f : filas) {
+            if (f.is_object() && !f.contains(clave)) f[clave] = secuencia.fetch_add(1);
+        }
+        res.status = (req.method == "POST") ? 201 : 200;
+        res.set_content(filas.dump(), "application/json");
+    };
+
+    httplib::Server srv;
+    srv.new_task_queue = [&cfg] { return new httplib::ThreadPool(cfg.hilos); };
+
+    srv.set_pre_routing_handler([&](const httplib::Request& req, httplib::Response&) {
+        stats.contar(req.method + " " + req.path);
+        esperar();
+        return httplib::Server::HandlerResponse::Unhandled;
+    });
+
+    srv.Get("/usuarios", [](const httplib::Request& req, httplib::Response& res) {
+        json filas = json::array();
+        const std::string identificador = valorFiltro(req, "identificador_unico");
+        const std::string id = valorFiltro(req, "id_usuario");
+        if (!identificador.empty()) {
+            filas.push_back(filaUsuario(idDesdeIdentificador(identificador), identificador));
+        } else if (!id.empty()) {
+            filas.push_back(filaUsuario(std::atoi(id.c_str()), ""));
+        } else {
+            for (int i = 1; i <= 10; ++i) filas.push_back(filaUsuario(i, ""));
+        }
+        res.set_content(filas.dump(), "application/json");
+    });
+
+    srv.Get("/credenciales_biometricas", [](const httplib::Request& req, httplib::Response& res) {
+        const std::string id = valorFiltro(req, "id_usuario");
+        const int idUsuario = id.empty() ? 1 : std::atoi(id.c_str());
+        const std::string tipo = valorFiltro(req, "tipo_biometria");
+        json filas = json::array();
+        for (const char* t : { "oreja", "voz" }) {
+            if (!tipo.empty() && tipo != t) continue;
+            filas.push_back({
+                {"id_credencial", idUsuario * 2 + (std::string(t) == "voz")},
+                {"id_usuario", idUsuario},
+                {"tipo_biometria", t},
+                {"fecha_captura", "2024-01-01T00:00:00"},
+                {"estado", "activo"},
+                {"updated_at", "2024-01-01T00:00:00"}
+            });
+        }
+        res.set_content(filas.dump(), "application/json");
+    });
+
+    srv.Get("/textos_dinamicos_audio", [&cfg](const httplib::Request& req, httplib::Response& res) {
+        json filas = json::array();
+        const std::string id = valorFiltro(req, "id_texto");
+        if (!id.empty()) {
+            filas.push_back(filaFrase(std::atoi(id.c_str())));
+        } else if (!req.has_param("updated_at")) {
+            // Con updated_at=gte.X (refresco incremental) no hay cambios: vacío
+            for (int i = 1; i <= cfg.frases; ++i) filas.push_back(filaFrase(i));
+        }
+        res.set_content(filas.dump(), "application/json");
+    });
+
+    // Lecturas de otras tablas (sync): vacías
+    srv.Get(R"(/([a-z_]+))", [](const httplib::Request&, httplib::Response& res) {
+        res.set_content("[]", "application/json");
+    });
+
+    // Contadores de uso de frases: sin filas desactivadas
+    srv.Post("/rpc/sumar_usos_frases", [](const httplib::Request&, httplib::Response& res) {
+        res.set_content("[]", "application/json");
+    });
+
+    srv.Post(R"(/([a-z_]+))", [&](const httplib::Request& req, httplib::Response& res) {
+        responderEscritura(req, res, 201);
+    });
+    srv.Patch(R"(/([a-z_]+))", [&](const httplib::Request& req, httplib::Response& res) {
+        responderEscritura(req, res, 204);
+    });
+    srv.Delete(R"(/([a-z_]+))", [](const httplib::Request&, httplib::Response& res) {
+        res.status = 204;
+    });
+
+    srv.Get("/_stub/estadisticas", [&stats](const httplib::Request&, httplib::Response& res) {
+        res.set_content(stats.aJson().dump(2), "application/json");
+    });
+
+    std::cout << "stub_postgrest escuchando en 0.0.0.0:" << cfg.puerto
+              << " (latencia=" << cfg.latenciaMs << "ms jitter=" << cfg.jitterMs << "ms)" << std::endl;
+    if (!srv.listen("0.0.0.0", cfg.puerto)) {
+        std::cerr << "No se pudo escuchar en el puerto " << cfg.puerto << std::endl;
+        return 1;
+    }
+    return 0;
+}
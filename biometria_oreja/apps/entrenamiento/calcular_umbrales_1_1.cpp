@@ -24,10 +24,12 @@
 
 #include "cargar_imagen.h"
 #include "preprocesamiento/convertir_a_gris.h"
+#include "preprocesamiento/frontend_gris.h"
 #include "preprocesamiento/mejoras_preprocesamiento.h"
 #include "preprocesamiento/redimensionar_imagen.h"
 #include "preprocesamiento/clahe.h"
 #include "preprocesamiento/bilateral_filter.h"
+#include "preprocesamiento/preproc_workspace.h"
 #include "extraccion_caracteristicas/lbp.h"
 #include "utilidades/normalizacion.h"
 #include "utilidades/pca_utils.h"
@@ -39,8 +41,8 @@ namespace fs = std::filesystem;
 
 // ====== Pipeline FASE 6 (sincronizado con procesar_dataset.cpp) ======
 struct Imagen128 {
-    std::unique_ptr<uint8_t[]> img128;
-    std::unique_ptr<uint8_t[]> mask128;
+    const uint8_t* img128 = nullptr;    // buffer del PreprocWorkspace del hilo
+    const uint8_t* mask128 = nullptr;   // máscara fija compartida
     int w = 128;
     int h = 128;
 };
@@ -55,19 +57,14 @@ static Imagen128 preprocesarHasta128(const uint8_t* imagenGris, int ancho, int a
     // 4. Máscara elíptica FIJA (consistente entre todas las imágenes)
     // ============================================================================
 
+    static thread_local PreprocWorkspace ws;
     Imagen128 out;
 
-    // Paso 1: Resize directo a 128x128
-    auto img128 = redimensionarParaBiometria(imagenGris, ancho, alto, 128, 128);
-
-    // Paso 2: CLAHE (8×8 tiles, clipLimit=2.0)
-    auto img128_clahe = aplicarCLAHE(img128.get(), 128, 128, 8, 8, 2.0);
-
-    // Paso 3: Bilateral Filter (σ_space=3, σ_color=50)
-    out.img128 = aplicarBilateral(img128_clahe.get(), 128, 128, 3.0, 50.0);
+    // Pasos 1-3: Resize 128x128 -> CLAHE (8×8, clip 2.0) -> Bilateral (σ_space=3, σ_color=50)
+    out.img128 = ws.preprocesar(imagenGris, ancho, alto);
 
     // Paso 4: Máscara elíptica FIJA
-    out.mask128 = crearMascaraElipticaFija(128, 128);
+    out.mask128 = PreprocWorkspace::mascara();
 
     return out;
 }
@@ -81,7 +78,7 @@ static std::vector<double> extraerFeaturesDesde128(const uint8_t* img128, const
 
 static std::vector<double> extraerCaracteristicas(const uint8_t* imagenGris, int ancho, int alto) {
     Imagen128 base = preprocesarHasta128(imagenGris, ancho, alto);
-    return extraerFeaturesDesde128(base.img128.get(), base.mask128.get());
+    return extraerFeaturesDesde128(base.img128, base.mask128);
 }
 
 // Calcula TODOS los scores para una muestra
@@ -164,6 +161,7 @@ int main(int argc, char** argv) {
 
     int num_muestras = 0;
     int errores = 0;
+    BufferGris bufGris;
 
     std::cout << "Procesando dataset de test...\n";
 
@@ -195,17 +193,15 @@ int main(int argc, char** argv) {
         int idx_clase_real = (int)std::distance(svm.clases.begin(), it);
 
         // Cargar y procesar imagen
-        int w = 0, h = 0, ch = 0;
-        unsigned char* rgb = cargarImagen(path.string().c_str(), w, h, ch, 3);
-        if (!rgb) {
+        // Mismo front end que predecir (los umbrales dependen de él)
+        int w = 0, h = 0, wOrig = 0, hOrig = 0;
+        const uint8_t* gris = cargarGrisReducida(path.string(), 128, 128, bufGris, w, h, wOrig, hOrig);
+        if (!gris) {
             errores++;
             continue;
         }
 
-        auto gris = convertirAGris(rgb, w, h);
-        delete[] rgb;
-
-        auto feat = extraerCaracteristicas(gris.get(), w, h);
+        auto feat = extraerCaracteristicas(gris, w, h);
         if (feat.empty()) {
             errores++;
             continue;
@@ -2,11 +2,13 @@
 
 #include "cargar_imagen.h"
 #include "preprocesamiento/convertir_a_gris.h"
+#include "preprocesamiento/frontend_gris.h"
 #include "preprocesamiento/clahe.h"
 #include "preprocesamiento/bilateral_filter.h"
 #include "preprocesamiento/redimensionar_imagen.h"
 #include "preprocesamiento/aumentar_dataset.h"
 #include "preprocesamiento/mejoras_preprocesamiento.h"
+#include "preprocesamiento/preproc_workspace.h"
 #include "extraccion_caracteristicas/lbp.h"
 #include "utilidades/dataset_loader.h"
 #include "utilidades/guardar_csv.h"
@@ -14,6 +16,8 @@
 #include "utilidades/lda_utils.h"
 #include "utilidades/normalizacion.h"
 #include "utilidades/zscore_params.h"
+#include "utilidades/logger.h"
+#include "comun/trazas.h"
 
 #include <filesystem>
 #include <fstream>
@@ -119,6 +123,30 @@ static int resolverPCA(int argc, char** argv, int def = 120) {
     return def;
 }
 
+// Augmentation geométrico (solo train):
+//   AUG_SEED  (def 12345): semilla determinista por imagen; 0 = flujo por hilo
+//   AUG_BANCO (def 0 = continuas): N > 0 usa N transformaciones precalculadas
+//             compartidas (más rápido, menos diversidad; opt-in)
+static const ConfigAumentoGeometrico& configAumento() {
+    static const ConfigAumentoGeometrico cfg = [] {
+        ConfigAumentoGeometrico c;
+        c.semilla = 12345u;
+        c.banco = 0;
+        auto seed = getEnvStr("AUG_SEED");
+        if (!seed.empty()) {
+            try { c.semilla = static_cast<uint32_t>(std::stoul(seed)); }
+            catch (...) {}
+        }
+        auto banco = getEnvStr("AUG_BANCO");
+        if (!banco.empty()) {
+            try { c.banco = std::max(0, std::stoi(banco)); }
+            catch (...) {}
+        }
+        return c;
+    }();
+    return cfg;
+}
+
 static int resolverLDA(int argc, char** argv, int def = -1) {
     // argv[3] = LDA components (-1 = max = numClases-1)
     if (argc >= 4 && argv[3] && *argv[3]) {
@@ -219,17 +247,16 @@ static void procesarImagen(
     std::vector<int>& y_local,
     bool aplicarAugmentation = false
 ){
-    int ancho = 0, alto = 0, canales = 0;
-    unsigned char* imgRGB = cargarImagen(ruta, ancho, alto, canales, 3);
-    if (!imgRGB) {
+    // Front end fusionado (decode -> gris -> pirámide por área); mismo que predecir
+    static thread_local BufferGris bufGris;
+    int ancho = 0, alto = 0, anchoOrig = 0, altoOrig = 0;
+    const uint8_t* gris = cargarGrisReducida(ruta, 128, 128, bufGris, ancho, alto, anchoOrig, altoOrig);
+    if (!gris) {
         std::lock_guard<std::mutex> lock(mtxPrint);
         std::cerr << "\nError cargando imagen: " << ruta << "\n";
         return;
     }
 
-    auto gris = convertirAGris(imgRGB, ancho, alto);
-    liberarImagen(imgRGB);
-
     // ============================================================================
     // FASE 1 - Cambio 1: ELIMINA filtro bilateral (Solución 3A)
     // El bilateral era inconsistente porque dependía del contenido local de cada
@@ -248,7 +275,8 @@ static void procesarImagen(
     // Como ya no usamos recorte por bounding box (que necesita máscara variable),
     // vamos a trabajar directo con resize a 128x128 y luego aplicar máscara fija.
 
-    auto img128 = redimensionarParaBiometria(gris.get(), ancho, alto, 128, 128);
+    // Buffers, LUTs y kernels reutilizados entre imágenes del mismo hilo
+    static thread_local PreprocWorkspace ws;
 
     // ============================================================================
     // FASE 6 - CLAHE + Bilateral Filter (Mejora de contraste y reducción de ruido)
@@ -258,9 +286,13 @@ static void procesarImagen(
     //
     // RESTAURADO: Bilateral es crítico para test accuracy (+15%)
     // Tiempo: 11.5s/img pero necesario para 75% → 60% sin él
-    auto img128_clahe = aplicarCLAHE(img128.get(), 128, 128, 8, 8, 2.0);
-
-    auto img128_filtered = aplicarBilateral(img128_clahe.get(), 128, 128, 3.0, 50.0);
+    // Resize 128x128 -> CLAHE -> Bilateral (PreprocWorkspace::preprocesar)
+    const uint8_t* img128_filtered = ws.preprocesar(gris, ancho, alto);
+    if (!img128_filtered) {
+        std::lock_guard<std::mutex> lock(mtxPrint);
+        std::cerr << "\nError preprocesando imagen: " << ruta << "\n";
+        return;
+    }
 
     // ============================================================================
     // FASE 4 - Filtro Gaussiano (PROBADO Y REVERTIDO)
@@ -271,9 +303,9 @@ static void procesarImagen(
     // med.marcar("gaussiano");
     // auto img128_suave = aplicarFiltroGaussiano(img128.get(), 128, 128, 0.8);
 
-    auto mask128 = crearMascaraElipticaFija(128, 128);
+    const uint8_t* mask128 = PreprocWorkspace::mascara();
 
-    auto feat_base = extraerFeaturesDesde128(img128_filtered.get(), mask128.get());
+    auto feat_base = extraerFeaturesDesde128(img128_filtered, mask128);
 
     X_local.push_back(feat_base);
     y_local.push_back(etiqueta);
@@ -285,14 +317,21 @@ static void procesarImagen(
     // - Fotométrico (brillo, contraste): produce el MISMO LBP code → NO aporta diversidad
     // - Geométrico (rotación, traslación): produce DIFERENTES LBP codes → SÍ aporta diversidad
     //
-    // Genera 2 variaciones por imagen: rotación ±4°, traslación, zoom, flip
-    // Expectativa: Train 400→1200 muestras (3x), Test sin augmentation.
+    // Genera 4 variaciones por imagen: rotación ±4°, traslación, zoom (un warp cada una)
+    // Expectativa: Train 400→2000 muestras (5x), Test sin augmentation.
     if (aplicarAugmentation) {
-        auto variaciones = aumentarImagenGeometrico(img128_filtered.get(), 128, 128, "aug");
-
-        for (auto& var : variaciones) {
-            auto feat_aug = extraerFeaturesDesde128(var.first.get(), mask128.get());
-            X_local.push_back(feat_aug);
+        const ConfigAumentoGeometrico& cfgAug = configAumento();
+        static thread_local std::vector<uint8_t> bufAug;
+        bufAug.resize(static_cast<size_t>(cfgAug.variantes) * PreprocWorkspace::PIXELES);
+
+        // Semilla por carpeta/archivo: mismas variantes sin importar el hilo o la ruta base
+        const fs::path p(ruta);
+        const std::string clave = p.parent_path().filename().string() + "/" + p.filename().string();
+        const int nVar = aumentarGeometricoEnBuffer(img128_filtered, 128, 128, clave, cfgAug, bufAug.data());
+
+        for (int k = 0; k < nVar; ++k) {
+            auto feat_aug = extraerFeaturesDesde128(bufAug.data() + k * PreprocWorkspace::PIXELES, mask128);
+            X_local.push_back(std::move(feat_aug));
             y_local.push_back(etiqueta);
         }
     }
@@ -363,6 +402,10 @@ int main(int argc, char** argv) {
     const std::string outDir = resolverOutDir();
     asegurarDir(outDir);
 
+    // TRAZAS_TASA=1 -> una traza por corrida en TRAZAS_DIR (fases del hilo principal)
+    trazas::configurarDesdeEntorno("procesar_dataset", "TRAZAS_");
+    trazas::Span traza("procesar_dataset", makeRequestId());
+
     const std::string rutaDataset = resolverRutaDataset(argc, argv);
     const int componentesPCA = resolverPCA(argc, argv, 120);
     const int componentesLDA = resolverLDA(argc, argv, 40);  // 40 por defecto, o valor específico
@@ -370,6 +413,8 @@ int main(int argc, char** argv) {
     std::cout << "Dataset: " << rutaDataset << "\n";
     std::cout << "OUT_DIR: " << outDir << "\n";
     std::cout << "PCA: " << componentesPCA << " | LDA: " << componentesLDA << "\n";
+    std::cout << "Augmentation: " << configAumento().variantes << " variantes | semilla="
+              << configAumento().semilla << " | banco=" << configAumento().banco << "\n";
 
     std::vector<std::string> rutas;
     std::vector<int> etiquetas;
@@ -437,14 +482,21 @@ int main(int argc, char** argv) {
     // FASE 5: Augmentation GEOMÉTRICO ACTIVADO
     // Augmentation geométrico genera variaciones reales en espacio LBP (3x datos)
     // Rotación ±4°, traslación, zoom (sin flip) → diferentes códigos LBP
-    ejecutarConPoolHilos(rutas_train, etiquetas_train, X_train, y_train, true);
-    ejecutarConPoolHilos(rutas_test, etiquetas_test, X_test, y_test, false);  
+    {
+        trazas::Span s("extraccion_train");
+        ejecutarConPoolHilos(rutas_train, etiquetas_train, X_train, y_train, true);
+    }
+    {
+        trazas::Span s("extraccion_test");
+        ejecutarConPoolHilos(rutas_test, etiquetas_test, X_test, y_test, false);
+    }
 
     std::cout << "\nTrain muestras: " << X_train.size() << " | Test muestras: " << X_test.size() << "\n";
 
     // ============================================================================
     // Z-score standardization pre-PCA (corrige problema de escala)
     // ============================================================================
+    trazas::Span sZscore("zscore");
     const size_t numDims = X_train.empty() ? 0 : X_train[0].size();
     std::vector<double> media(numDims, 0.0);
     std::vector<double> std_dev(numDims, 0.0);
@@ -495,7 +547,10 @@ int main(int argc, char** argv) {
     }
     std::cout << "[OK] Guardado Z-score params: " << rutaZ << " (dims=" << zp.mean.size() << ")\n";
 
+    sZscore.terminar();
+
     // PCA fit SOLO con train
+    trazas::Span sPca("pca");
     ModeloPCA modeloPCA = entrenarPCA(X_train, componentesPCA);
     guardarModeloPCA(joinPath(outDir, "modelo_pca.dat"), modeloPCA);
 
@@ -507,8 +562,11 @@ int main(int argc, char** argv) {
     for (auto& v : Xpca_train) normalizarVector(v);
     for (auto& v : Xpca_test)  normalizarVector(v);
 
+    sPca.terminar();
+
     // Entrenar LDA con datos PCA y etiquetas de train
     // componentesLDA: -1 = max (numClases-1), o valor específico (ej: 50, 70)
+    trazas::Span sLda("lda");
     ModeloLDA modeloLDA = entrenarLDA(Xpca_train, y_train, ldaObjetivo);
     guardarModeloLDA(joinPath(outDir, "modelo_lda.dat"), modeloLDA);
 
@@ -520,8 +578,11 @@ int main(int argc, char** argv) {
     for (auto& v : Xlda_train) normalizarVector(v);
     for (auto& v : Xlda_test)  normalizarVector(v);
 
+    sLda.terminar();
+
     // Templates K=1 (coseno) desde TRAIN
     {
+        trazas::Span s("templates_umbral_eer");
         std::unordered_map<int, std::vector<double>> sum;
         std::unordered_map<int, int> count;
         for (size_t i = 0; i < Xlda_train.size(); ++i) {
@@ -609,6 +670,7 @@ int main(int argc, char** argv) {
     }
 
     // Guardar CSV separados (ahora con features LDA)
+    trazas::Span sCsv("guardar_csv");
     guardarCSV(joinPath(outDir, "caracteristicas_lda_train.csv"), Xlda_train, y_train, ';');
     guardarCSV(joinPath(outDir, "caracteristicas_lda_test.csv"),  Xlda_test,  y_test,  ';');
 
@@ -1,9 +1,11 @@
 // agregar_usuario_biometria.cpp - SINCRONIZADO CON FASE 6
 #include "cargar_imagen.h"
 #include "preprocesamiento/convertir_a_gris.h"
+#include "preprocesamiento/frontend_gris.h"
 #include "preprocesamiento/redimensionar_imagen.h"
 #include "preprocesamiento/clahe.h"
 #include "preprocesamiento/bilateral_filter.h"
+#include "preprocesamiento/preproc_workspace.h"
 #include "preprocesamiento/mejoras_preprocesamiento.h"
 #include "preprocesamiento/aumentar_dataset.h"
 #include "extraccion_caracteristicas/lbp.h"
@@ -20,6 +22,8 @@
 #include "admin/admin_config.h"
 #include "admin/admin_report.h"
 #include "utilidades/zscore_params.h"
+#include "utilidades/estadisticas_gris.h"
+#include "comun/trazas.h"
 
 #include <filesystem>
 #include <fstream>
@@ -57,35 +61,21 @@ static std::string vecSample10(const std::vector<double>& v) {
 static int exitCode(int c) { return c; }
 
 
-static GrayStats calcGrayStats(const uint8_t* img, int w, int h, int dark_thr=10, int bright_thr=245) {
+static GrayStats aGrayStats(const EstadisticasGris& e) {
     GrayStats s;
-    const int N = w*h;
-    if (!img || N <= 0) return s;
-
-    long long sum = 0;
-    long long sum2 = 0;
-    int c_dark = 0, c_bright = 0;
-
-    for (int i = 0; i < N; ++i) {
-        int v = (int)img[i];
-        sum += v;
-        sum2 += 1LL * v * v;
-        if (v < s.minv) s.minv = v;
-        if (v > s.maxv) s.maxv = v;
-        if (v <= dark_thr) c_dark++;
-        if (v >= bright_thr) c_bright++;
-    }
-
-    s.mean = (double)sum / (double)N;
-    double var = (double)sum2 / (double)N - s.mean * s.mean;
-    if (var < 0) var = 0;
-    s.stddev = std::sqrt(var);
-    s.pct_dark = 100.0 * (double)c_dark / (double)N;
-    s.pct_bright = 100.0 * (double)c_bright / (double)N;
-
+    s.mean = e.mean;
+    s.stddev = e.stddev;
+    s.minv = e.minv;
+    s.maxv = e.maxv;
+    s.pct_dark = e.pct_dark;
+    s.pct_bright = e.pct_bright;
     return s;
 }
 
+static GrayStats calcGrayStats(const uint8_t* img, int w, int h, int dark_thr=10, int bright_thr=245) {
+    return aGrayStats(calcularEstadisticasGris(img, w, h, dark_thr, bright_thr));
+}
+
 static double maskCoveragePct(const uint8_t* mask, int w, int h) {
     if (!mask || w <= 0 || h <= 0) return 0.0;
     const int N = w * h;
@@ -233,40 +223,7 @@ static bool qcGrayPass(const GrayStats& s, const QcThresholds& t, std::string& r
 static GrayStats calcGrayStatsMasked(const uint8_t* img, const uint8_t* mask, int w, int h,
                                      int dark_thr=10, int bright_thr=245)
 {
-    GrayStats s;
-    const int N = w*h;
-    if (!img || !mask || N <= 0) return s;
-
-    long long sum = 0, sum2 = 0;
-    int c_dark = 0, c_bright = 0;
-    int count = 0;
-
-    for (int i = 0; i < N; ++i) {
-        if (mask[i] == 0) continue;          // SOLO ROI
-        int v = (int)img[i];
-        sum += v;
-        sum2 += 1LL*v*v;
-        if (v < s.minv) s.minv = v;
-        if (v > s.maxv) s.maxv = v;
-        if (v <= dark_thr) c_dark++;
-        if (v >= bright_thr) c_bright++;
-        count++;
-    }
-
-    if (count <= 0) { // ROI vacía
-        s.mean = 0; s.stddev = 0; s.pct_dark = 100; s.pct_bright = 0;
-        s.minv = 0; s.maxv = 0;
-        return s;
-    }
-
-    s.mean = (double)sum / (double)count;
-    double var = (double)sum2 / (double)count - s.mean*s.mean;
-    if (var < 0) var = 0;
-    s.stddev = std::sqrt(var);
-    s.pct_dark = 100.0 * (double)c_dark / (double)count;
-    s.pct_bright = 100.0 * (double)c_bright / (double)count;
-
-    return s;
+    return aGrayStats(calcularEstadisticasGrisMasked(img, mask, w, h, dark_thr, bright_thr));
 }
 
 // ====================== PREPROCESAMIENTO DETALLADO ======================
@@ -289,7 +246,15 @@ static Imagen128 preprocesarHasta128(const uint8_t* imagenGris, int ancho, int a
         logBlank(log, rid);
     }
 
-    GrayStats s_original = calcGrayStats(imagenGris, ancho, alto, QC.dark_thr, QC.bright_thr);
+    // Etapas intermedias en los buffers del workspace del hilo (resize -> A,
+    // CLAHE A -> B); solo el resultado bilateral se guarda en la imagen base
+    static thread_local PreprocWorkspace ws;
+    uint8_t* img128 = ws.bufferA();
+    uint8_t* img128_clahe = ws.bufferB();
+
+    // Stats por etapa: solo para el reporte (LOG_DETAIL >= 2); el QC real es sobre la ROI
+    GrayStats s_original;
+    if (LOG_DETAIL >= 2) s_original = calcGrayStats(imagenGris, ancho, alto, QC.dark_thr, QC.bright_thr);
 
     // ============================================================================
     // TÉCNICA 1: REDIMENSIONAMIENTO DIRECTO A 128x128
@@ -297,11 +262,11 @@ static Imagen128 preprocesarHasta128(const uint8_t* imagenGris, int ancho, int a
     // Trabajamos DIRECTAMENTE con la imagen original
     // ============================================================================
     TimePoint t0 = tick();
-    auto img128 = redimensionarParaBiometria(imagenGris, ancho, alto, 128, 128);
+    if (!ws.redimensionar(imagenGris, ancho, alto, img128)) return out;
     auto ms_resize = msSince(t0);
 
     if (LOG_DETAIL >= 2) {
-        GrayStats s_128 = calcGrayStats(img128.get(), 128, 128, QC.dark_thr, QC.bright_thr);
+        GrayStats s_128 = calcGrayStats(img128, 128, 128, QC.dark_thr, QC.bright_thr);
 
         StatsComparison cmp;
         cmp.tecnica = "1. REDIMENSIONAMIENTO";
@@ -349,12 +314,12 @@ static Imagen128 preprocesarHasta128(const uint8_t* imagenGris, int ancho, int a
     // Mejora contraste local, realza texturas sutiles para LBP
     // ============================================================================
     t0 = tick();
-    auto img128_clahe = aplicarCLAHE(img128.get(), 128, 128, 8, 8, 2.0);
+    ws.clahe(img128, img128_clahe);
     auto ms_clahe = msSince(t0);
 
     if (LOG_DETAIL >= 2) {
-        GrayStats s_pre = calcGrayStats(img128.get(), 128, 128, QC.dark_thr, QC.bright_thr);
-        GrayStats s_post = calcGrayStats(img128_clahe.get(), 128, 128, QC.dark_thr, QC.bright_thr);
+        GrayStats s_pre = calcGrayStats(img128, 128, 128, QC.dark_thr, QC.bright_thr);
+        GrayStats s_post = calcGrayStats(img128_clahe, 128, 128, QC.dark_thr, QC.bright_thr);
 
         StatsComparison cmp;
         cmp.tecnica = "2. CLAHE";
@@ -408,11 +373,12 @@ static Imagen128 preprocesarHasta128(const uint8_t* imagenGris, int ancho, int a
     // Reduce ruido post-CLAHE sin destruir bordes ni texturas finas
     // ============================================================================
     t0 = tick();
-    out.img128 = aplicarBilateral(img128_clahe.get(), 128, 128, 3.0, 50.0);
+    out.img128 = std::make_unique<uint8_t[]>(PreprocWorkspace::PIXELES);
+    ws.bilateral(img128_clahe, out.img128.get());
     auto ms_bilateral = msSince(t0);
 
     if (LOG_DETAIL >= 2) {
-        GrayStats s_pre = calcGrayStats(img128_clahe.get(), 128, 128, QC.dark_thr, QC.bright_thr);
+        GrayStats s_pre = calcGrayStats(img128_clahe, 128, 128, QC.dark_thr, QC.bright_thr);
         GrayStats s_post = calcGrayStats(out.img128.get(), 128, 128, QC.dark_thr, QC.bright_thr);
 
         StatsComparison cmp;
@@ -468,11 +434,11 @@ static Imagen128 preprocesarHasta128(const uint8_t* imagenGris, int ancho, int a
     // Consistencia 100% entre todas las imágenes
     // ============================================================================
     t0 = tick();
-    out.mask128 = crearMascaraElipticaFija(128, 128);
+    out.mask128 = PreprocWorkspace::mascara();
     auto ms_mask = msSince(t0);
 
     if (LOG_DETAIL >= 2) {
-        double cov = maskCoveragePct(out.mask128.get(), 128, 128);
+        double cov = maskCoveragePct(out.mask128, 128, 128);
 
         logTechTitle(log, rid, "4. MASCARA ELIPTICA FIJA");
         logRawLine(log, rid, "Tipo:         Elipse fija (consistente)");
@@ -535,7 +501,7 @@ static Imagen128 preprocesarHasta128(const uint8_t* imagenGris, int ancho, int a
     // VALIDACIÓN FINAL: RESUMEN DE UMBRALES DEL PIPELINE
     // ============================================================================
     if (LOG_DETAIL >= 2) {
-        GrayStats s_final = calcGrayStatsMasked(out.img128.get(), out.mask128.get(), 128, 128, QC.dark_thr, QC.bright_thr);
+        GrayStats s_final = calcGrayStatsMasked(out.img128.get(), out.mask128, 128, 128, QC.dark_thr, QC.bright_thr);
         std::string qc_reason;
         bool qc_pass = qcGrayPass(s_final, QC, qc_reason);
         
@@ -816,84 +782,90 @@ static int procesarImagenesExtraerFeatures(std::ofstream& log, const Ctx& ctx,
         rep[i].name = fs::path(imagenes[i]).filename().string();
     }
 
-    std::vector<std::vector<double>> caracteristicas_global;
-    caracteristicas_global.reserve(imagenes.size() * 8);
+    // Fase A (paralela por imagen): load -> gris -> preproc -> QC -> aumentos.
+    // Fase B (paralela por variante): LBP de la base y de cada aumento, de todas las imágenes.
+    // Fase C (secuencial): logs, reportes y features en el orden de entrada (igual que la corrida serial).
+    struct ImagenEnCurso {
+        ImageReport local;
+        Imagen128 base;
+        std::vector<std::pair<std::unique_ptr<uint8_t[]>, std::string>> aumentadas;
+        std::vector<std::vector<double>> feats;   // [0] = base, [k] = aumento k (vacío = FAIL)
+        std::vector<long long> msFeats;
+        std::string errFeats;
+        std::string logFaseA;                     // log capturado en la fase A
+        bool aFeats = false;                      // llegó hasta la extracción LBP
+    };
 
-    for (int i = 0; i < (int)imagenes.size(); ++i) {
-        const auto& ruta = imagenes[i];
+    const int total = (int)imagenes.size();
+    std::vector<ImagenEnCurso> enCurso(imagenes.size());
 
-        ImageReport local;
+    auto prepararImagen = [&](int i, ImagenEnCurso& e) {
+        const auto& ruta = imagenes[i];
+        ImageReport& local = e.local;
         local.name = fs::path(ruta).filename().string();
 
         if (ctx.LOG_DETAIL >= 2) {
             logRawLine(log, ctx.rid, "============================================================");
             logRawLine(log, ctx.rid, "REPORTE POR IMAGEN");
             logRawLine(log, ctx.rid, "============================================================");
-            logRawLine(log, ctx.rid, "IMG " + std::to_string(i + 1) + "/" + std::to_string((int)imagenes.size()) +
+            logRawLine(log, ctx.rid, "IMG " + std::to_string(i + 1) + "/" + std::to_string(total) +
                                 " | " + local.name);
             logRawLine(log, ctx.rid, "ruta: " + ruta);
             logBlank(log, ctx.rid);
         }
 
-        // LOAD
+        // LOAD + GRAY (front end fusionado: decode -> gris -> pirámide por área)
+        static thread_local BufferGris bufGris;
         auto t_load0 = tick();
-        int w = 0, h = 0, c = 0;
-        unsigned char* imgRGB = cargarImagen(ruta, w, h, c, 3);
+        int w = 0, h = 0, wOrig = 0, hOrig = 0;
+        const uint8_t* gris = cargarGrisReducida(ruta, 128, 128, bufGris, w, h, wOrig, hOrig);
         local.ms_load = msSince(t_load0);
 
-        if (!imgRGB) {
+        if (!gris) {
             local.loadOk = false;
             local.err = "LOAD_FAIL:no_se_pudo_cargar";
-            rep[i] = local;
             logDet(log, ctx.rid, ctx.LOG_DETAIL, 1,
                    "[LOAD] decode=FAIL file=" + local.name + " ms=" + std::to_string(local.ms_load));
-            continue;
+            return;
         }
 
         local.loadOk = true;
         logDet(log, ctx.rid, ctx.LOG_DETAIL, 1,
                "[LOAD] decode=OK file=" + local.name +
-               " size=" + std::to_string(w) + "x" + std::to_string(h) +
-               " ch=3 ms=" + std::to_string(local.ms_load));
-
-        // GRAY
-        auto t_gray0 = tick();
-        auto gris = convertirAGris(imgRGB, w, h);
-        liberarImagen(imgRGB);
-        auto ms_gray = msSince(t_gray0);
+               " size=" + std::to_string(wOrig) + "x" + std::to_string(hOrig) +
+               " ms=" + std::to_string(local.ms_load));
 
         if (ctx.LOG_DETAIL >= 2) {
-            logTechTitle(log, ctx.rid, "Convertir a Gris");
-            logRawLine(log, ctx.rid, "Entrada: RGB (ch=3)");
-            logRawLine(log, ctx.rid, "Salida : GRAY  (ch=1) size=" + std::to_string(w) + "x" + std::to_string(h));
-            logRawLine(log, ctx.rid, "ms=" + std::to_string(ms_gray));
+            logTechTitle(log, ctx.rid, "Convertir a Gris + Reduccion por area");
+            logRawLine(log, ctx.rid, "Entrada: " + std::to_string(wOrig) + "x" + std::to_string(hOrig));
+            logRawLine(log, ctx.rid, "Salida : GRAY  (ch=1) size=" + std::to_string(w) + "x" + std::to_string(h) +
+                                (frontendPiramide() ? "" : " (legacy, sin piramide)"));
             logBlank(log, ctx.rid);
         }
 
         // PREPROC hasta 128
         auto t_pre0 = tick();
         try {
-            Imagen128 base = preprocesarHasta128(gris.get(), w, h, log, ctx.rid, ctx.LOG_DETAIL, local.name, ctx.QC);
+            e.base = preprocesarHasta128(gris, w, h, log, ctx.rid, ctx.LOG_DETAIL, local.name, ctx.QC);
             local.ms_preproc = msSince(t_pre0);
 
-            local.preprocOk = (base.img128 && base.mask128);
+            local.preprocOk = (e.base.img128 && e.base.mask128);
             if (!local.preprocOk) {
                 local.err = "PREPROC_FAIL:null_out";
                 local.augCount = 0;
-                rep[i] = local;
 
                 if (ctx.LOG_DETAIL >= 3) {
                     logTechTitle(log, ctx.rid, "AUMENTACION (opcional)");
                     logRawLine(log, ctx.rid, "No aplicada: PREPROC fallo (no hay imagen 128x128).");
                     logBlank(log, ctx.rid);
                 }
-                continue;
+                return;
             }
 
             // QC sobre ROI (imagen 128x128 procesada con máscara)
             auto t_qc0 = tick();
-            GrayStats s_roi = calcGrayStatsMasked(base.img128.get(), base.mask128.get(),
-                                                  base.w, base.h, ctx.QC.dark_thr, ctx.QC.bright_thr);
+            GrayStats s_roi = calcGrayStatsMasked(e.base.img128.get(), e.base.mask128,
+                                                  e.base.w, e.base.h, ctx.QC.dark_thr, ctx.QC.bright_thr);
             auto ms_qc = msSince(t_qc0);
 
             std::string qcReason;
@@ -930,10 +902,9 @@ static int procesarImagenesExtraerFeatures(std::ofstream& log, const Ctx& ctx,
 
                 if (ctx.QC_ENFORCE == 1) {
                     local.preprocOk = false;
-                    rep[i] = local;
                     logDet(log, ctx.rid, ctx.LOG_DETAIL, 1,
                            "[QC] file=" + local.name + " -> FAIL (QC_ENFORCE=1, se omite imagen)");
-                    continue;
+                    return;
                 }
                 logDet(log, ctx.rid, ctx.LOG_DETAIL, 1,
                        "[QC] file=" + local.name + " -> FAIL (QC_ENFORCE=0, se continúa)");
@@ -941,10 +912,10 @@ static int procesarImagenesExtraerFeatures(std::ofstream& log, const Ctx& ctx,
 
             // AUG
             auto t_aug0 = tick();
-            auto aumentadas128 = aumentarImagenFotometrica(base.img128.get(), base.w, base.h, ruta);
+            e.aumentadas = aumentarImagenFotometrica(e.base.img128.get(), e.base.w, e.base.h, ruta);
             auto ms_aug = msSince(t_aug0);
 
-            local.augCount = (int)aumentadas128.size();
+            local.augCount = (int)e.aumentadas.size();
 
             bool showAug =
                 (ctx.LOG_DETAIL >= 3) ||
@@ -959,16 +930,76 @@ static int procesarImagenesExtraerFeatures(std::ofstream& log, const Ctx& ctx,
                 logBlank(log, ctx.rid);
             }
 
+            e.feats.resize(1 + e.aumentadas.size());
+            e.msFeats.assign(1 + e.aumentadas.size(), 0);
+            e.aFeats = true;
+
+        } catch (const std::exception& ex) {
+            local.preprocOk = false;
+            local.err = std::string("EXC:") + ex.what();
+            logMensaje(log, ctx.rid, std::string("[EXCEPTION] file=") + local.name + " msg=" + ex.what());
+        } catch (...) {
+            local.preprocOk = false;
+            local.err = "EXC:desconocida";
+            logMensaje(log, ctx.rid, std::string("[EXCEPTION] file=") + local.name + " msg=desconocida");
+        }
+    };
+
+    // ---- Fase A ----
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int i = 0; i < total; ++i) {
+        LogCaptura captura;
+        prepararImagen(i, enCurso[i]);
+        enCurso[i].logFaseA = captura.tomar();
+    }
+
+    // ---- Fase B: una tarea por (imagen, variante) ----
+    std::vector<std::pair<int, int>> tareas;
+    for (int i = 0; i < total; ++i) {
+        for (int k = 0; k < (int)enCurso[i].feats.size(); ++k) tareas.emplace_back(i, k);
+    }
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int t = 0; t < (int)tareas.size(); ++t) {
+        auto& e = enCurso[tareas[t].first];
+        const int k = tareas[t].second;
+        const uint8_t* img = (k == 0) ? e.base.img128.get() : e.aumentadas[k - 1].first.get();
+
+        auto t_feat0 = tick();
+        try {
+            e.feats[k] = extraerFeaturesDesde128(img, e.base.mask128);
+        } catch (const std::exception& ex) {
+#pragma omp critical(FEATS_ERR)
+            if (e.errFeats.empty()) e.errFeats = ex.what();
+        } catch (...) {
+#pragma omp critical(FEATS_ERR)
+            if (e.errFeats.empty()) e.errFeats = "desconocida";
+        }
+        e.msFeats[k] = msSince(t_feat0);
+    }
+
+    // ---- Fase C: volcado en orden ----
+    std::vector<std::vector<double>> caracteristicas_global;
+    caracteristicas_global.reserve(imagenes.size() * 8);
+
+    for (int i = 0; i < total; ++i) {
+        auto& e = enCurso[i];
+        ImageReport& local = e.local;
+        logRaw(log, e.logFaseA);
+
+        if (e.aFeats && !e.errFeats.empty()) {
+            local.preprocOk = false;
+            local.err = "EXC:" + e.errFeats;
+            logMensaje(log, ctx.rid, "[EXCEPTION] file=" + local.name + " msg=" + e.errFeats);
+        } else if (e.aFeats) {
             // FEATS (LBP)
-            auto t_feat0 = tick();
             int feats = 0;
             int dims = 0;
 
             // Base
-            auto featBase = extraerFeaturesDesde128(base.img128.get(), base.mask128.get());
-            if (!featBase.empty()) {
-                dims = (int)featBase.size();
-                caracteristicas_global.push_back(std::move(featBase));
+            if (!e.feats[0].empty()) {
+                dims = (int)e.feats[0].size();
+                caracteristicas_global.push_back(std::move(e.feats[0]));
                 feats++;
 
                 if (ctx.LOG_DETAIL >= 3) {
@@ -979,35 +1010,22 @@ static int procesarImagenesExtraerFeatures(std::ofstream& log, const Ctx& ctx,
             }
 
             // Aumentos
-            for (int k = 0; k < (int)aumentadas128.size(); ++k) {
-                const auto& imgAum = aumentadas128[k].first;
-                auto f = extraerFeaturesDesde128(imgAum.get(), base.mask128.get());
-                if (!f.empty()) {
-                    if (dims == 0) dims = (int)f.size();
-                    caracteristicas_global.push_back(std::move(f));
+            for (size_t k = 1; k < e.feats.size(); ++k) {
+                if (!e.feats[k].empty()) {
+                    if (dims == 0) dims = (int)e.feats[k].size();
+                    caracteristicas_global.push_back(std::move(e.feats[k]));
                     feats++;
                 }
             }
 
-            local.ms_feats = msSince(t_feat0);
+            local.ms_feats = std::accumulate(e.msFeats.begin(), e.msFeats.end(), 0LL);
             local.featCount = feats;
             local.dims = dims;
 
-            logBloquePorImagen(log, ctx, i + 1, (int)imagenes.size(), ruta, local);
-
-            rep[i] = local;
-
-        } catch (const std::exception& e) {
-            local.preprocOk = false;
-            local.err = std::string("EXC:") + e.what();
-            rep[i] = local;
-            logMensaje(log, ctx.rid, std::string("[EXCEPTION] file=") + local.name + " msg=" + e.what());
-        } catch (...) {
-            local.preprocOk = false;
-            local.err = "EXC:desconocida";
-            rep[i] = local;
-            logMensaje(log, ctx.rid, std::string("[EXCEPTION] file=") + local.name + " msg=desconocida");
+            logBloquePorImagen(log, ctx, i + 1, total, imagenes[i], local);
         }
+
+        rep[i] = local;
     }
 
     // Resumen 7B por imagen
@@ -1528,11 +1546,17 @@ int main(int argc, char** argv) {
     ArgsBio a = parseArgsBio(argc, argv);
     Ctx ctx = loadCtxFromEnvAndArgs(a);
 
+    // Trazas: con --traza-padre (servidor) salen por stderr; si no, a TRAZAS_DIR según TRAZAS_TASA
+    trazas::configurarDesdeEntorno("agregar_usuario_biometria", "TRAZAS_");
+    if (!a.trazaPadre.empty()) trazas::continuarTrazaDe(a.trazaPadre);
+    trazas::Span traza("agregar_usuario_biometria", ctx.rid);
+
     auto log = crearLogStream(ctx.workDir);
     startupLogs(log, ctx);
 
     std::vector<std::string> imagenes;
     {
+        trazas::Span s("validar_work_dir");
         int rc = validarWorkDirYListarJpg(log, ctx, imagenes);
         if (rc != 0) return rc;
     }
@@ -1540,12 +1564,14 @@ int main(int argc, char** argv) {
     std::vector<ImageReport> rep;
     std::vector<std::vector<double>> nuevasCaracteristicas;
     {
+        trazas::Span s("extraer_caracteristicas");
         int rc = procesarImagenesExtraerFeatures(log, ctx, imagenes, rep, nuevasCaracteristicas);
         if (rc != 0) return rc;
     }
 
     std::vector<std::vector<double>> reducidas;
     {
+        trazas::Span s("pca_normalizar");
         int rc = aplicarPCAyNormalizar(log, ctx, nuevasCaracteristicas, reducidas);
         if (rc != 0) return rc;
     }
@@ -1553,6 +1579,7 @@ int main(int argc, char** argv) {
     int identificador_unico = 0;
     int id_usuario = 0;
     {
+        trazas::Span s("leer_ids");
         int rc = leerIds(log, ctx, identificador_unico, id_usuario);
         if (rc != 0) return rc;
     }
@@ -1561,16 +1588,19 @@ int main(int argc, char** argv) {
     std::vector<int> etiquetasExistentes;
     TemplateModel templates;
     {
+        trazas::Span s("cargar_base_modelo");
         int rc = cargarBaseYModelo(log, ctx, existentes, etiquetasExistentes, templates);
         if (rc != 0) return rc;
     }
 
+    trazas::Span sRegistro("registrar_entrenar_guardar");
     int rc = registrarEntrenarEvaluarGuardar(
         log, ctx,
         identificador_unico, id_usuario,
         reducidas,
         existentes, etiquetasExistentes, templates
     );
+    sRegistro.terminar();
     if (rc != 0) return rc;
 
     limpiezaTemporales(log, ctx, imagenes);
@@ -8,6 +8,7 @@
 #include <string>
 #include <numeric>
 #include <cmath>
+#include <algorithm>
 
 int main() {
     std::vector<std::vector<double>> X_total;
@@ -26,10 +27,16 @@ int main() {
 
     // Probar distintos valores de componentes PCA
     std::vector<int> componentes = { 35, 40, 45, 50, 55, 60, 65, 70, 95 };
+
+    // Un solo ajuste con el k maximo: los modelos menores son sus primeras componentes
+    const int kMax = *std::max_element(componentes.begin(), componentes.end());
+    std::cout << "\n🔧 Ajustando PCA con " << kMax << " componentes (se recorta para cada k)...\n";
+    ModeloPCA modeloMax = entrenarPCA(X_total, kMax);
+
     for (int n : componentes) {
         std::cout << "\n🔧 Generando PCA con " << n << " componentes...\n";
 
-        ModeloPCA modelo = entrenarPCA(X_total, n);
+        ModeloPCA modelo = recortarModeloPCA(modeloMax, n);
         std::string rutaModelo = "out/modelo_pca_" + std::to_string(n) + ".dat";
         guardarModeloPCA(rutaModelo, modelo);
 
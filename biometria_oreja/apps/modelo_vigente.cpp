@@ -0,0 +1,248 @@
+#include "modelo_vigente.h"
+#include "server_env.h"
+#include "utilidades/logger.h"
+#include "utilidades/lda_utils.h"
+#include "comun/metricas.h"
+#include "utilidades/pca_utils.h"
+#include "utilidades/zscore_params.h"
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Los que lee predecir; sin ellos no se publica
+const std::vector<std::string> REQUERIDOS = {
+    "zscore_params.dat", "modelo_pca.dat", "modelo_lda.dat", "templates_k1.csv"
+};
+// Se copian si existen (umbral y lo que sirve /oreja/sync/modelo)
+const std::vector<std::string> OPCIONALES = {
+    "umbral_eer.txt", "modelo_svm.svm", "umbral_svm.txt", "umbrales_metricas_tecnicas.csv"
+};
+
+// shared_ptr bajo mutex (no std::atomic<shared_ptr>: GCC 11 del Dockerfile no
+// lo tiene). El lock solo cubre la copia del puntero, nunca una prediccion
+std::mutex g_mtx_vigente;
+std::shared_ptr<const ModelSet> g_vigente;
+std::mutex g_mtx_recarga;
+uint64_t g_ultima_version = 0; // bajo g_mtx_recarga
+
+std::string dirSnapshots() {
+    static const std::string dir =
+        fs::absolute(getEnvStr("MODEL_SNAPSHOT_DIR", tmpDir() + "/modelo_snapshots")).lexically_normal().string();
+    return dir;
+}
+
+// MODEL_SNAPSHOT_DIR igual a MODEL_DIR o por encima de él: las instantáneas
+// (y su limpieza) pisarían el modelo de origen
+bool snapshotsPisanOrigen(const std::string& origen) {
+    // Resuelve symlinks y quita la barra final ("dir/" itera un componente vacío)
+    auto normal = [](const fs::path& p, std::error_code& ec) {
+        fs::path r = fs::weakly_canonical(fs::absolute(p, ec), ec);
+        return r.has_filename() ? r : r.parent_path();
+    };
+    std::error_code ec;
+    const fs::path snap = normal(dirSnapshots(), ec);
+    if (ec) return false;
+    const fs::path modelo = normal(origen, ec);
+    if (ec) return false;
+    auto s = snap.begin();
+    for (auto m = modelo.begin(); s != snap.end() && m != modelo.end(); ++s, ++m) {
+        if (*s != *m) return false;
+    }
+    return s == snap.end();
+}
+
+// Solo los v<N> que crea recargarModelo: nunca otra cosa del directorio
+void borrarSnapshotsAnteriores() {
+    std::error_code ec;
+    for (fs::directory_iterator it(dirSnapshots(), ec), fin; !ec && it != fin; it.increment(ec)) {
+        const std::string nombre = it->path().filename().string();
+        if (nombre.size() < 2 || nombre[0] != 'v' ||
+            nombre.find_first_not_of("0123456789", 1) != std::string::npos)
+            continue;
+        std::error_code ecDir;
+        if (it->is_directory(ecDir)) fs::remove_all(it->path(), ecDir);
+    }
+}
+
+bool cargarUmbralDesdeArchivo(const std::string& ruta, double& out) {
+    std::ifstream f(ruta);
+    if (!f.is_open()) return false;
+    std::string line;
+    while (std::getline(f, line)) {
+        if (line.rfind("threshold=", 0) == 0) {
+            try {
+                out = std::stod(line.substr(10));
+                return true;
+            } catch (...) {
+                return false;
+            }
+        }
+    }
+    return false;
+}
+
+// Filas "clase;v1;v2;..." -> cantidad y dimensión común (0 si varía)
+bool dimTemplates(const std::string& ruta, size_t& filas, size_t& dim) {
+    std::ifstream f(ruta);
+    if (!f.is_open()) return false;
+    filas = 0;
+    dim = 0;
+    std::string line;
+    while (std::getline(f, line)) {
+        if (line.empty()) continue;
+        size_t campos = 1;
+        for (char c : line) campos += (c == ';');
+        if (campos < 2) continue;
+        if (filas > 0 && campos - 1 != dim) return false;
+        dim = campos - 1;
+        ++filas;
+    }
+    return filas > 0;
+}
+
+bool validar(ModelSet& m, std::string& motivo) {
+    const std::string d = m.dir + "/";
+
+    ZScoreParams zp;
+    if (!cargarZScoreParams(d + "zscore_params.dat", zp, ';') || zp.mean.empty() ||
+        zp.mean.size() != zp.stdev.size()) {
+        motivo = "zscore_params.dat inválido";
+        return false;
+    }
+
+    const ModeloPCA pca = cargarModeloPCA(d + "modelo_pca.dat");
+    if (pca.componentes.empty() || pca.medias.size() != zp.mean.size()) {
+        motivo = "PCA dim=" + std::to_string(pca.medias.size()) + " != zscore dim=" + std::to_string(zp.mean.size());
+        return false;
+    }
+    for (const auto& c : pca.componentes) {
+        if (c.size() != pca.medias.size()) {
+            motivo = "modelo_pca.dat con componentes de distinta dimensión";
+            return false;
+        }
+    }
+
+    const ModeloLDA lda = cargarModeloLDA(d + "modelo_lda.dat");
+    if (lda.componentes.empty() || lda.mediaGlobal.size() != pca.componentes.size()) {
+        motivo = "LDA dim=" + std::to_string(lda.mediaGlobal.size()) +
+                 " != PCA salida=" + std::to_string(pca.componentes.size());
+        return false;
+    }
+
+    size_t filas = 0, dim = 0;
+    if (!dimTemplates(d + "templates_k1.csv", filas, dim)) {
+        motivo = "templates_k1.csv vacío o con filas de distinta dimensión";
+        return false;
+    }
+    if (dim != lda.componentes.size()) {
+        motivo = "templates_k1.csv dim=" + std::to_string(dim) +
+                 " != LDA salida=" + std::to_string(lda.componentes.size());
+        return false;
+    }
+
+    m.dimEntrada = zp.mean.size();
+    m.dimSalida = dim;
+    m.numTemplates = filas;
+    m.tieneUmbralEer = cargarUmbralDesdeArchivo(d + "umbral_eer.txt", m.umbralEer);
+    return true;
+}
+
+} // namespace
+
+std::shared_ptr<const ModelSet> modeloVigente() {
+    std::lock_guard<std::mutex> lock(g_mtx_vigente);
+    return g_vigente;
+}
+
+bool recargarModelo(const std::string& rid, std::string* error) {
+    static auto& hRecarga = metricas::etapa("recarga_modelo");
+    static auto& version = metricas::medidor("oreja_modelo_version", "Versión del modelo publicado");
+    static auto& rechazos = metricas::contador("oreja_modelo_recargas_rechazadas_total",
+                                               "Recargas de modelo descartadas por validación");
+
+    std::lock_guard<std::mutex> lock(g_mtx_recarga);
+    metricas::Temporizador t(hRecarga);
+
+    const std::string origen = getEnvStr("MODEL_DIR", "out");
+    std::string motivo;
+
+    if (snapshotsPisanOrigen(origen)) {
+        motivo = "MODEL_SNAPSHOT_DIR=" + dirSnapshots() + " coincide con MODEL_DIR=" + origen + " o lo contiene";
+        rechazos.inc();
+        LOGE("MODELO", rid, "Recarga rechazada: " + motivo);
+        if (error) *error = motivo;
+        return false;
+    }
+
+    if (g_ultima_version == 0) {
+        // Arranque: nadie lee aún instantáneas de una ejecución anterior
+        borrarSnapshotsAnteriores();
+    }
+
+    auto nuevo = std::make_unique<ModelSet>();
+    nuevo->version = g_ultima_version + 1;
+    nuevo->dir = dirSnapshots() + "/v" + std::to_string(nuevo->version);
+
+    bool ok = true;
+    {
+        std::error_code ec;
+        fs::create_directories(nuevo->dir, ec);
+        if (ec) {
+            motivo = "no se pudo crear " + nuevo->dir + ": " + ec.message();
+            ok = false;
+        }
+        for (const auto& a : REQUERIDOS) {
+            if (!ok) break;
+            fs::copy_file(origen + "/" + a, nuevo->dir + "/" + a, fs::copy_options::overwrite_existing, ec);
+            if (ec) {
+                motivo = "falta " + origen + "/" + a;
+                ok = false;
+            }
+        }
+        for (const auto& a : OPCIONALES) {
+            if (!ok) break;
+            if (fs::exists(origen + "/" + a))
+                fs::copy_file(origen + "/" + a, nuevo->dir + "/" + a, fs::copy_options::overwrite_existing, ec);
+        }
+    }
+    if (ok) ok = validar(*nuevo, motivo);
+
+    if (!ok) {
+        std::error_code ec;
+        fs::remove_all(nuevo->dir, ec);
+        rechazos.inc();
+        const auto actual = modeloVigente();
+        LOGW("MODELO", rid, "Recarga descartada (" + motivo + "); sigue " +
+                                (actual ? "v" + std::to_string(actual->version) : std::string("sin modelo")));
+        if (error) *error = motivo;
+        return false;
+    }
+
+    g_ultima_version = nuevo->version;
+    LOGI("MODELO", rid, "Modelo v" + std::to_string(nuevo->version) + " publicado: dir=" + nuevo->dir +
+                            " dim=" + std::to_string(nuevo->dimEntrada) + "->" + std::to_string(nuevo->dimSalida) +
+                            " templates=" + std::to_string(nuevo->numTemplates));
+    version.fijar((double)nuevo->version);
+
+    // Quien suelte la última referencia (este hilo o el último predecir en
+    // curso con esa versión) borra el directorio
+    std::shared_ptr<const ModelSet> publicado(nuevo.release(), [](const ModelSet* m) {
+        std::error_code ec;
+        fs::remove_all(m->dir, ec);
+        delete m;
+    });
+    {
+        std::lock_guard<std::mutex> lock(g_mtx_vigente);
+        g_vigente.swap(publicado);
+    }
+    // La anterior se suelta fuera del lock (su borrador puede tocar disco)
+    publicado.reset();
+    return true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Modelo con el que autentica el servidor. predecir lee sus archivos del disco
+// en cada solicitud, así que la instantánea es un directorio: copia versionada
+// de MODEL_DIR (MODEL_SNAPSHOT_DIR/v<N>) que nadie vuelve a escribir.
+// - Lectores: modeloVigente() copia el puntero bajo un mutex breve; no espera
+//   a una recarga en curso. La solicitud conserva su versión hasta terminar
+// - Escritor: recargarModelo() copia, valida y publica con un swap bajo mutex.
+//   La versión reemplazada se borra del disco al soltarla su último lector
+struct ModelSet {
+    uint64_t version = 0;
+    std::string dir;              // absoluto: predecir corre con cd /app
+    bool tieneUmbralEer = false;  // umbral_eer.txt (procesar_dataset)
+    double umbralEer = 0.0;
+    size_t dimEntrada = 0;        // z-score / PCA
+    size_t dimSalida = 0;         // LDA / templates
+    size_t numTemplates = 0;
+};
+
+// nullptr hasta la primera recarga válida
+std::shared_ptr<const ModelSet> modeloVigente();
+
+// MODEL_DIR -> instantánea nueva -> validación (archivos y dimensiones
+// encadenadas zscore -> PCA -> LDA -> templates) -> publicación.
+// Si no valida se descarta, la vigente sigue y devuelve false con el motivo.
+// Las recargas se serializan entre sí
+bool recargarModelo(const std::string& rid, std::string* error = nullptr);
@@ -19,11 +19,13 @@
 #include "preprocesamiento/redimensionar_imagen.h"
 #include "preprocesamiento/clahe.h"
 #include "preprocesamiento/bilateral_filter.h"
+#include "preprocesamiento/preproc_workspace.h"
 #include "extraccion_caracteristicas/lbp.h"
 #include "utilidades/normalizacion.h"
 #include "utilidades/pca_utils.h"
 #include "utilidades/svm_ova_utils.h"
 #include "utilidades/zscore_params.h"
+#include "utilidades/estadisticas_gris.h"
 #include "svm/svm_prediccion.h"
 
 namespace fs = std::filesystem;
@@ -35,8 +37,8 @@ static long long ms_since(const std::chrono::steady_clock::time_point& t0) {
 
 // ====== Reuso literal de tu pipeline ======
 struct Imagen128 {
-    std::unique_ptr<uint8_t[]> img128;
-    std::unique_ptr<uint8_t[]> mask128;
+    const uint8_t* img128 = nullptr;    // buffer del PreprocWorkspace del hilo
+    const uint8_t* mask128 = nullptr;   // máscara fija compartida
     int w = 128;
     int h = 128;
 };
@@ -51,12 +53,11 @@ static Imagen128 preprocesarHasta128(const uint8_t* imagenGris, int ancho, int a
     // 4. Máscara elíptica FIJA
     // ============================================================================
 
+    static thread_local PreprocWorkspace ws;
     Imagen128 out;
 
-    auto img128 = redimensionarParaBiometria(imagenGris, ancho, alto, 128, 128);
-    auto img128_clahe = aplicarCLAHE(img128.get(), 128, 128, 8, 8, 2.0);
-    out.img128 = aplicarBilateral(img128_clahe.get(), 128, 128, 3.0, 50.0);
-    out.mask128 = crearMascaraElipticaFija(128, 128);
+    out.img128 = ws.preprocesar(imagenGris, ancho, alto);
+    out.mask128 = PreprocWorkspace::mascara();
 
     return out;
 }
@@ -70,7 +71,7 @@ static std::vector<double> extraerFeaturesDesde128(const uint8_t* img128, const
 
 static std::vector<double> extraerCaracteristicas(const uint8_t* imagenGris, int ancho, int alto) {
     Imagen128 base = preprocesarHasta128(imagenGris, ancho, alto);
-    return extraerFeaturesDesde128(base.img128.get(), base.mask128.get());
+    return extraerFeaturesDesde128(base.img128, base.mask128);
 }
 
 static bool predecirTop1Top2(
@@ -116,31 +117,14 @@ struct GrayStats {
 };
 
 static GrayStats calcGrayStats(const uint8_t* img, int w, int h, int dark_thr=10, int bright_thr=245) {
+    const EstadisticasGris e = calcularEstadisticasGris(img, w, h, dark_thr, bright_thr);
     GrayStats s;
-    const int N = w*h;
-    if (!img || N <= 0) return s;
-
-    long long sum = 0;
-    long long sum2 = 0;
-    int c_dark = 0, c_bright = 0;
-
-    for (int i = 0; i < N; ++i) {
-        int v = (int)img[i];
-        sum += v;
-        sum2 += 1LL * v * v;
-        if (v < s.minv) s.minv = v;
-        if (v > s.maxv) s.maxv = v;
-        if (v <= dark_thr) c_dark++;
-        if (v >= bright_thr) c_bright++;
-    }
-
-    s.mean = (double)sum / (double)N;
-    double var = (double)sum2 / (double)N - s.mean * s.mean;
-    if (var < 0) var = 0;
-    s.stddev = std::sqrt(var);
-    s.pct_dark = 100.0 * (double)c_dark / (double)N;
-    s.pct_bright = 100.0 * (double)c_bright / (double)N;
-
+    s.mean = e.mean;
+    s.stddev = e.stddev;
+    s.pct_dark = e.pct_dark;
+    s.pct_bright = e.pct_bright;
+    s.minv = e.minv;
+    s.maxv = e.maxv;
     return s;
 }
 
@@ -1,17 +1,23 @@
 ﻿#include "utilidades/logger.h"
+#include "comun/trazas.h"
 
 #include "cargar_imagen.h"
 #include "preprocesamiento/convertir_a_gris.h"
+#include "preprocesamiento/frontend_gris.h"
 #include "preprocesamiento/mejoras_preprocesamiento.h"
 #include "preprocesamiento/redimensionar_imagen.h"
 #include "preprocesamiento/clahe.h"
 #include "preprocesamiento/bilateral_filter.h"
+#include "preprocesamiento/preproc_workspace.h"
 #include "extraccion_caracteristicas/lbp.h"
 #include "utilidades/normalizacion.h"
 #include "utilidades/pca_utils.h"
 #include "utilidades/lda_utils.h"
 #include "utilidades/zscore_params.h"
+#include "utilidades/estadisticas_gris.h"
 
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -31,6 +37,28 @@ static long long ms_since(const std::chrono::steady_clock::time_point& t0) {
     return duration_cast<milliseconds>(steady_clock::now() - t0).count();
 }
 
+static double seg_since(const std::chrono::steady_clock::time_point& t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Duración por etapa (segundos) para las métricas del servidor (/metrics):
+// se emite al final en stderr como una sola línea "METRICAS_ETAPAS k=v ..."
+struct TiemposEtapas {
+    double decode = 0.0;      // archivo -> gris reducida
+    double preproc = 0.0;     // resize + CLAHE + bilateral + máscara
+    double features = 0.0;    // LBP
+    double carga = 0.0;       // lectura de z-score, PCA, LDA y templates
+    double proyeccion = 0.0;  // z-score + PCA + LDA (+ normalizaciones), sin E/S
+    double scoring = 0.0;     // templates, sin E/S
+};
+
+static void emitirTiemposEtapas(const TiemposEtapas& t) {
+    std::cerr << std::fixed << std::setprecision(6)
+              << "METRICAS_ETAPAS decode=" << t.decode << " preproc=" << t.preproc
+              << " features=" << t.features << " carga_modelo=" << t.carga << " proyeccion=" << t.proyeccion
+              << " scoring=" << t.scoring << '\n';
+}
+
 // ====== Estructuras para logging detallado ======
 struct GrayStats {
     double mean = 0.0;
@@ -44,63 +72,19 @@ struct GrayStats {
     double rms_contrast = 0.0;       // RMS Contrast
 };
 
-// Entropía de Shannon (referencia: Shannon 1948, Pizer 1987)
-static double calcEntropy(const uint8_t* img, int w, int h) {
-    if (!img || w <= 0 || h <= 0) return 0.0;
-    
-    std::vector<int> hist(256, 0);
-    const int N = w * h;
-    
-    // Calcular histograma
-    for (int i = 0; i < N; ++i) hist[img[i]]++;
-    
-    // Calcular entropía: H = -Σ p(i) × log₂(p(i))
-    double entropy = 0.0;
-    for (int i = 0; i < 256; ++i) {
-        if (hist[i] > 0) {
-            double p = (double)hist[i] / N;
-            entropy -= p * std::log2(p);
-        }
-    }
-    return entropy;
-}
-
 static GrayStats calcGrayStats(const uint8_t* img, int w, int h, int dark_thr=10, int bright_thr=245) {
+    // Kernel de histograma compartido (una pasada); RMS contrast = stddev [Peli 1990]
+    const EstadisticasGris e = calcularEstadisticasGris(img, w, h, dark_thr, bright_thr);
     GrayStats s;
-    const int N = w * h;
-    if (!img || N <= 0) return s;
-
-    long long sum = 0, sum2 = 0;
-    int c_dark = 0, c_bright = 0;
-
-    for (int i = 0; i < N; ++i) {
-        int v = (int)img[i];
-        sum += v;
-        sum2 += 1LL * v * v;
-        if (v < s.minv) s.minv = v;
-        if (v > s.maxv) s.maxv = v;
-        if (v <= dark_thr) c_dark++;
-        if (v >= bright_thr) c_bright++;
-    }
-
-    s.mean = (double)sum / (double)N;
-    double var = (double)sum2 / (double)N - s.mean * s.mean;
-    if (var < 0) var = 0;
-    s.stddev = std::sqrt(var);
-    s.pct_dark = 100.0 * (double)c_dark / (double)N;
-    s.pct_bright = 100.0 * (double)c_bright / (double)N;
-    
-    // Métricas adicionales
-    s.entropy = calcEntropy(img, w, h);
-    
-    // Michelson Contrast: (max-min)/(max+min) [Michelson 1927, ISO 9241]
-    if (s.maxv + s.minv > 0) {
-        s.michelson_contrast = (double)(s.maxv - s.minv) / (double)(s.maxv + s.minv);
-    }
-    
-    // RMS Contrast = stddev [Peli 1990]
-    s.rms_contrast = s.stddev;
-
+    s.mean = e.mean;
+    s.stddev = e.stddev;
+    s.minv = e.minv;
+    s.maxv = e.maxv;
+    s.pct_dark = e.pct_dark;
+    s.pct_bright = e.pct_bright;
+    s.entropy = e.entropy;
+    s.michelson_contrast = e.michelson_contrast;
+    s.rms_contrast = e.stddev;
     return s;
 }
 
@@ -114,30 +98,32 @@ static double maskCoveragePct(const uint8_t* mask, int w, int h) {
     return 100.0 * (double)on / (double)N;
 }
 
+// Cada fase vuelca lo anterior: ante un crash se pierde como mucho la fase en curso
 static void logPhaseHeader(const std::string& title) {
-    std::cerr << "====================================================" << std::endl;
-    std::cerr << title << std::endl;
-    std::cerr << "====================================================" << std::endl;
+    std::cerr.flush();
+    std::cerr << "====================================================" << '\n';
+    std::cerr << title << '\n';
+    std::cerr << "====================================================" << '\n';
 }
 
 static void logMetrics(const std::string& fase, const GrayStats& s_in, const GrayStats& s_out, long long ms) {
-    std::cerr << fase << ":" << std::endl;
+    std::cerr << fase << ":" << '\n';
     std::cerr << "  Entrada  -> mean=" << std::fixed << std::setprecision(2) << s_in.mean
-              << " std=" << s_in.stddev << " min=" << s_in.minv << " max=" << s_in.maxv << std::endl;
+              << " std=" << s_in.stddev << " min=" << s_in.minv << " max=" << s_in.maxv << '\n';
     std::cerr << "  Salida   -> mean=" << std::fixed << std::setprecision(2) << s_out.mean
-              << " std=" << s_out.stddev << " min=" << s_out.minv << " max=" << s_out.maxv << std::endl;
+              << " std=" << s_out.stddev << " min=" << s_out.minv << " max=" << s_out.maxv << '\n';
     
     double delta_mean = s_out.mean - s_in.mean;
     double delta_std = s_out.stddev - s_in.stddev;
     
     std::cerr << "  Delta    -> mean=" << std::showpos << std::fixed << std::setprecision(2) << delta_mean
-              << " std=" << delta_std << std::noshowpos << " | " << ms << " ms" << std::endl;
+              << " std=" << delta_std << std::noshowpos << " | " << ms << " ms" << '\n';
 }
 
 // ====== Tu pipeline (según tu proyecto) ======
 struct Imagen128 {
-    std::unique_ptr<uint8_t[]> img128;
-    std::unique_ptr<uint8_t[]> mask128;
+    const uint8_t* img128 = nullptr;    // buffer del PreprocWorkspace del hilo
+    const uint8_t* mask128 = nullptr;   // máscara fija compartida
     int w = 128;
     int h = 128;
 };
@@ -147,6 +133,13 @@ static std::string getEnvStr(const char* k, const std::string& def) {
     return (v && *v) ? std::string(v) : def;
 }
 
+// Stats de diagnóstico por etapa (resize/CLAHE/bilateral) solo con AUDIT_MODE=1:
+// en producción cuestan tanto como el preprocesamiento y solo alimentan el log
+static bool auditoriaActiva() {
+    static const bool activa = (getEnvStr("AUDIT_MODE", "0") == "1");
+    return activa;
+}
+
 static Imagen128 preprocesarHasta128(const uint8_t* imagenGris, int ancho, int alto) {
     // ============================================================================
     // PIPELINE FASE 6 - SINCRONIZADO CON procesar_dataset.cpp
@@ -157,136 +150,160 @@ static Imagen128 preprocesarHasta128(const uint8_t* imagenGris, int ancho, int a
     // 4. Máscara elíptica FIJA (consistente entre todas las imágenes)
     // ============================================================================
 
+    // Etapas encadenadas en los buffers del workspace: resize -> A, CLAHE A -> B,
+    // bilateral B -> A (el resize ya no se necesita tras las stats de CLAHE)
+    static thread_local PreprocWorkspace ws;
+    uint8_t* img128 = ws.bufferA();
+    uint8_t* img128_clahe = ws.bufferB();
+
     Imagen128 out;
     auto t0 = std::chrono::steady_clock::now();
 
     logPhaseHeader("PREPROCESAMIENTO FASE 6 (PIPELINE COMPLETO)");
-    std::cerr << "Entrada: " << ancho << "x" << alto << " (escala de grises)" << std::endl;
-    std::cerr << std::endl;
+    std::cerr << "Entrada: " << ancho << "x" << alto << " (escala de grises)" << '\n';
+    std::cerr << '\n';
 
-    GrayStats s_original = calcGrayStats(imagenGris, ancho, alto);
+    const bool auditar = auditoriaActiva();
+    GrayStats s_original, s_resize, s_clahe, s_bilateral;
+    if (auditar) s_original = calcGrayStats(imagenGris, ancho, alto);
 
     // Paso 1: Resize directo a 128x128
     t0 = std::chrono::steady_clock::now();
-    auto img128 = redimensionarParaBiometria(imagenGris, ancho, alto, 128, 128);
+    if (!ws.redimensionar(imagenGris, ancho, alto, img128)) {
+        std::cerr << "ERROR: redimensionamiento fallido" << '\n';
+        return out;
+    }
     auto ms_resize = ms_since(t0);
     
-    GrayStats s_resize = calcGrayStats(img128.get(), 128, 128);
-    logMetrics("FASE 1: REDIMENSIONAMIENTO 128x128", s_original, s_resize, ms_resize);
+    if (auditar) {
+        s_resize = calcGrayStats(img128, 128, 128);
+        logMetrics("FASE 1: REDIMENSIONAMIENTO 128x128", s_original, s_resize, ms_resize);
+    } else {
+        std::cerr << "FASE 1: REDIMENSIONAMIENTO 128x128 | " << ms_resize << " ms" << '\n';
+    }
     
     // Validación: Relación de aspecto
     double aspect_ratio = (double)ancho / (double)alto;
     bool aspect_ok = (aspect_ratio >= 0.85 && aspect_ratio <= 1.15);
     std::cerr << "  Validación -> aspect_ratio=" << std::fixed << std::setprecision(2) << aspect_ratio
-              << " umbral=[0.85,1.15] " << (aspect_ok ? "✓ PASS" : "⚠ ADVERTENCIA") << std::endl;
-    std::cerr << std::endl;
+              << " umbral=[0.85,1.15] " << (aspect_ok ? "✓ PASS" : "⚠ ADVERTENCIA") << '\n';
+    std::cerr << '\n';
 
     // Paso 2: CLAHE (8×8 tiles, clipLimit=2.0)
     t0 = std::chrono::steady_clock::now();
-    auto img128_clahe = aplicarCLAHE(img128.get(), 128, 128, 8, 8, 2.0);
+    ws.clahe(img128, img128_clahe);
     auto ms_clahe = ms_since(t0);
     
-    GrayStats s_clahe = calcGrayStats(img128_clahe.get(), 128, 128);
-    logMetrics("FASE 2: CLAHE (Mejora de Contraste)", s_resize, s_clahe, ms_clahe);
-    
-    // ========== MÉTRICAS CUANTITATIVAS ACADÉMICAS ==========
-    // Referencia: Pizer et al. (1987) "Adaptive histogram equalization"
-    //             Zuiderveld (1994) "Contrast Limited AHE" - Graphics Gems IV
-    //             ISO/IEC 29794-1:2016 - Biometric sample quality
-    
-    // 1. RMS Contrast (Peli 1990) - Valor absoluto en escala [0-255]
-    std::cerr << "  MÉTRICAS CLAHE:" << std::endl;
-    std::cerr << "    RMS Contrast (Desv.Est): " << std::fixed << std::setprecision(2) << s_clahe.rms_contrast << std::endl;
-    std::cerr << "      Umbral ISO 29794-1: ≥30.0 (escala 0-255)" << std::endl;
-    bool rms_ok = (s_clahe.rms_contrast >= 30.0);
-    std::cerr << "      Resultado: " << (rms_ok ? "✓ PASS" : "⚠ BAJO CONTRASTE") << std::endl;
-    
-    // 2. Entropía de Shannon (Shannon 1948, Pizer 1987) - bits
-    double delta_entropy = s_clahe.entropy - s_resize.entropy;
-    std::cerr << "    Entropía Shannon: " << std::fixed << std::setprecision(2) 
-              << s_resize.entropy << " → " << s_clahe.entropy << " bits" << std::endl;
-    std::cerr << "      Ganancia: " << std::showpos << delta_entropy << std::noshowpos << " bits" << std::endl;
-    std::cerr << "      Umbral: >0 (debe aumentar)" << std::endl;
-    bool entropy_ok = (delta_entropy > 0.0);
-    std::cerr << "      Resultado: " << (entropy_ok ? "✓ PASS" : "⚠ NO MEJORA") << std::endl;
-    
-    // 3. Michelson Contrast (Michelson 1927, ISO 9241) - escala [0-1]
-    std::cerr << "    Michelson Contrast: " << std::fixed << std::setprecision(3) << s_clahe.michelson_contrast << std::endl;
-    std::cerr << "      Umbral: ≥0.70 (escala 0-1)" << std::endl;
-    bool michelson_ok = (s_clahe.michelson_contrast >= 0.70);
-    std::cerr << "      Resultado: " << (michelson_ok ? "✓ PASS" : "⚠ BAJO") << std::endl;
-    
-    // VEREDICTO FINAL
-    bool clahe_efectivo = (rms_ok && entropy_ok);
-    std::cerr << "  VALIDACIÓN CLAHE: " << (clahe_efectivo ? "✓ EFECTIVO" : "⚠ REQUIERE REVISIÓN") << std::endl;
-    std::cerr << std::endl;
+    if (auditar) {
+        s_clahe = calcGrayStats(img128_clahe, 128, 128);
+        logMetrics("FASE 2: CLAHE (Mejora de Contraste)", s_resize, s_clahe, ms_clahe);
+    
+        // ========== MÉTRICAS CUANTITATIVAS ACADÉMICAS ==========
+        // Referencia: Pizer et al. (1987) "Adaptive histogram equalization"
+        //             Zuiderveld (1994) "Contrast Limited AHE" - Graphics Gems IV
+        //             ISO/IEC 29794-1:2016 - Biometric sample quality
+    
+        // 1. RMS Contrast (Peli 1990) - Valor absoluto en escala [0-255]
+        std::cerr << "  MÉTRICAS CLAHE:" << '\n';
+        std::cerr << "    RMS Contrast (Desv.Est): " << std::fixed << std::setprecision(2) << s_clahe.rms_contrast << '\n';
+        std::cerr << "      Umbral ISO 29794-1: ≥30.0 (escala 0-255)" << '\n';
+        bool rms_ok = (s_clahe.rms_contrast >= 30.0);
+        std::cerr << "      Resultado: " << (rms_ok ? "✓ PASS" : "⚠ BAJO CONTRASTE") << '\n';
+    
+        // 2. Entropía de Shannon (Shannon 1948, Pizer 1987) - bits
+        double delta_entropy = s_clahe.entropy - s_resize.entropy;
+        std::cerr << "    Entropía Shannon: " << std::fixed << std::setprecision(2) 
+                  << s_resize.entropy << " → " << s_clahe.entropy << " bits" << '\n';
+        std::cerr << "      Ganancia: " << std::showpos << delta_entropy << std::noshowpos << " bits" << '\n';
+        std::cerr << "      Umbral: >0 (debe aumentar)" << '\n';
+        bool entropy_ok = (delta_entropy > 0.0);
+        std::cerr << "      Resultado: " << (entropy_ok ? "✓ PASS" : "⚠ NO MEJORA") << '\n';
+    
+        // 3. Michelson Contrast (Michelson 1927, ISO 9241) - escala [0-1]
+        std::cerr << "    Michelson Contrast: " << std::fixed << std::setprecision(3) << s_clahe.michelson_contrast << '\n';
+        std::cerr << "      Umbral: ≥0.70 (escala 0-1)" << '\n';
+        bool michelson_ok = (s_clahe.michelson_contrast >= 0.70);
+        std::cerr << "      Resultado: " << (michelson_ok ? "✓ PASS" : "⚠ BAJO") << '\n';
+    
+        // VEREDICTO FINAL
+        bool clahe_efectivo = (rms_ok && entropy_ok);
+        std::cerr << "  VALIDACIÓN CLAHE: " << (clahe_efectivo ? "✓ EFECTIVO" : "⚠ REQUIERE REVISIÓN") << '\n';
+        std::cerr << '\n';
+    } else {
+        std::cerr << "FASE 2: CLAHE | " << ms_clahe << " ms" << '\n';
+    }
 
     // Paso 3: Bilateral Filter (σ_space=3, σ_color=50)
     t0 = std::chrono::steady_clock::now();
-    out.img128 = aplicarBilateral(img128_clahe.get(), 128, 128, 3.0, 50.0);
+    ws.bilateral(img128_clahe, img128);
+    out.img128 = img128;
     auto ms_bilateral = ms_since(t0);
     
-    GrayStats s_bilateral = calcGrayStats(out.img128.get(), 128, 128);
-    logMetrics("FASE 3: FILTRO BILATERAL (Reducción de Ruido)", s_clahe, s_bilateral, ms_bilateral);
-    
-    // ========== MÉTRICAS CUANTITATIVAS BILATERAL ==========
-    // Referencia: Tomasi & Manduchi (1998) "Bilateral filtering for gray and color images"
-    //             Aurich & Weule (1995) "Non-linear gaussian filters"
-    
-    std::cerr << "  MÉTRICAS BILATERAL:" << std::endl;
-    
-    // 1. Reducción de Varianza (proxy de ruido)
-    double var_antes = s_clahe.stddev * s_clahe.stddev;
-    double var_despues = s_bilateral.stddev * s_bilateral.stddev;
-    double reduccion_var = var_antes - var_despues;
-    std::cerr << "    Reducción Varianza: " << std::fixed << std::setprecision(2) << reduccion_var << std::endl;
-    std::cerr << "      Umbral: ≥10.0 (escala 0-65025)" << std::endl;
-    bool var_ok = (reduccion_var >= 10.0);
-    std::cerr << "      Resultado: " << (var_ok ? "✓ PASS" : "⚠ BAJO") << std::endl;
-    
-    // 2. Preservación de Entropía (no debe caer drásticamente)
-    double ratio_entropy = s_bilateral.entropy / s_clahe.entropy;
-    std::cerr << "    Preservación Entropía: " << std::fixed << std::setprecision(3) << ratio_entropy << std::endl;
-    std::cerr << "      Umbral: ≥0.90 (debe preservar ≥90% de información)" << std::endl;
-    bool entropy_preserved = (ratio_entropy >= 0.90);
-    std::cerr << "      Resultado: " << (entropy_preserved ? "✓ PASS" : "⚠ PÉRDIDA EXCESIVA") << std::endl;
-    
-    // 3. Smoothness sin pérdida de bordes
-    std::cerr << "    RMS Post-Filtro: " << std::fixed << std::setprecision(2) << s_bilateral.rms_contrast << std::endl;
-    std::cerr << "      Umbral: ≥25.0 (debe mantener contraste de bordes)" << std::endl;
-    bool edges_ok = (s_bilateral.rms_contrast >= 25.0);
-    std::cerr << "      Resultado: " << (edges_ok ? "✓ PASS" : "⚠ SOBRE-SUAVIZADO") << std::endl;
-    
-    bool bilateral_ok = (var_ok && entropy_preserved && edges_ok);
-    std::cerr << "  VALIDACIÓN BILATERAL: " << (bilateral_ok ? "✓ EFECTIVO" : "⚠ REQUIERE REVISIÓN") << std::endl;
-    std::cerr << "  Nota: Bilateral elimina ruido preservando bordes (Tomasi & Manduchi 1998)" << std::endl;
-    std::cerr << std::endl;
+    if (auditar) {
+        s_bilateral = calcGrayStats(out.img128, 128, 128);
+        logMetrics("FASE 3: FILTRO BILATERAL (Reducción de Ruido)", s_clahe, s_bilateral, ms_bilateral);
+    
+        // ========== MÉTRICAS CUANTITATIVAS BILATERAL ==========
+        // Referencia: Tomasi & Manduchi (1998) "Bilateral filtering for gray and color images"
+        //             Aurich & Weule (1995) "Non-linear gaussian filters"
+    
+        std::cerr << "  MÉTRICAS BILATERAL:" << '\n';
+    
+        // 1. Reducción de Varianza (proxy de ruido)
+        double var_antes = s_clahe.stddev * s_clahe.stddev;
+        double var_despues = s_bilateral.stddev * s_bilateral.stddev;
+        double reduccion_var = var_antes - var_despues;
+        std::cerr << "    Reducción Varianza: " << std::fixed << std::setprecision(2) << reduccion_var << '\n';
+        std::cerr << "      Umbral: ≥10.0 (escala 0-65025)" << '\n';
+        bool var_ok = (reduccion_var >= 10.0);
+        std::cerr << "      Resultado: " << (var_ok ? "✓ PASS" : "⚠ BAJO") << '\n';
+    
+        // 2. Preservación de Entropía (no debe caer drásticamente)
+        double ratio_entropy = s_bilateral.entropy / s_clahe.entropy;
+        std::cerr << "    Preservación Entropía: " << std::fixed << std::setprecision(3) << ratio_entropy << '\n';
+        std::cerr << "      Umbral: ≥0.90 (debe preservar ≥90% de información)" << '\n';
+        bool entropy_preserved = (ratio_entropy >= 0.90);
+        std::cerr << "      Resultado: " << (entropy_preserved ? "✓ PASS" : "⚠ PÉRDIDA EXCESIVA") << '\n';
+    
+        // 3. Smoothness sin pérdida de bordes
+        std::cerr << "    RMS Post-Filtro: " << std::fixed << std::setprecision(2) << s_bilateral.rms_contrast << '\n';
+        std::cerr << "      Umbral: ≥25.0 (debe mantener contraste de bordes)" << '\n';
+        bool edges_ok = (s_bilateral.rms_contrast >= 25.0);
+        std::cerr << "      Resultado: " << (edges_ok ? "✓ PASS" : "⚠ SOBRE-SUAVIZADO") << '\n';
+    
+        bool bilateral_ok = (var_ok && entropy_preserved && edges_ok);
+        std::cerr << "  VALIDACIÓN BILATERAL: " << (bilateral_ok ? "✓ EFECTIVO" : "⚠ REQUIERE REVISIÓN") << '\n';
+        std::cerr << "  Nota: Bilateral elimina ruido preservando bordes (Tomasi & Manduchi 1998)" << '\n';
+        std::cerr << '\n';
+    } else {
+        std::cerr << "FASE 3: FILTRO BILATERAL | " << ms_bilateral << " ms" << '\n';
+    }
 
     // Paso 4: Máscara elíptica FIJA
     t0 = std::chrono::steady_clock::now();
-    out.mask128 = crearMascaraElipticaFija(128, 128);
+    out.mask128 = PreprocWorkspace::mascara();
     auto ms_mask = ms_since(t0);
     
-    double coverage = maskCoveragePct(out.mask128.get(), 128, 128);
+    double coverage = maskCoveragePct(out.mask128, 128, 128);
     bool coverage_ok = (coverage >= 50.0 && coverage <= 80.0);
     
-    std::cerr << "FASE 4: MASCARA ELIPTICA FIJA (ROI)" << std::endl;
-    std::cerr << "  Cobertura    -> " << std::fixed << std::setprecision(1) << coverage << "% del área total" << std::endl;
+    std::cerr << "FASE 4: MASCARA ELIPTICA FIJA (ROI)" << '\n';
+    std::cerr << "  Cobertura    -> " << std::fixed << std::setprecision(1) << coverage << "% del área total" << '\n';
     std::cerr << "  Validación   -> cobertura=" << std::fixed << std::setprecision(1) << coverage
-              << "% umbral=[50%,80%] " << (coverage_ok ? "✓ PASS" : "⚠ FUERA DE RANGO") << std::endl;
-    std::cerr << "  Tiempo       -> " << ms_mask << " ms" << std::endl;
-    std::cerr << std::endl;
+              << "% umbral=[50%,80%] " << (coverage_ok ? "✓ PASS" : "⚠ FUERA DE RANGO") << '\n';
+    std::cerr << "  Tiempo       -> " << ms_mask << " ms" << '\n';
+    std::cerr << '\n';
 
     // Resumen del pipeline
     long long total_ms = ms_resize + ms_clahe + ms_bilateral + ms_mask;
-    std::cerr << "RESUMEN PIPELINE:" << std::endl;
-    std::cerr << "  1. Resize       -> " << ms_resize << " ms" << std::endl;
-    std::cerr << "  2. CLAHE        -> " << ms_clahe << " ms" << std::endl;
-    std::cerr << "  3. Bilateral    -> " << ms_bilateral << " ms" << std::endl;
-    std::cerr << "  4. Máscara      -> " << ms_mask << " ms" << std::endl;
-    std::cerr << "  TOTAL          -> " << total_ms << " ms" << std::endl;
-    std::cerr << "====================================================" << std::endl;
-    std::cerr << std::endl;
+    std::cerr << "RESUMEN PIPELINE:" << '\n';
+    std::cerr << "  1. Resize       -> " << ms_resize << " ms" << '\n';
+    std::cerr << "  2. CLAHE        -> " << ms_clahe << " ms" << '\n';
+    std::cerr << "  3. Bilateral    -> " << ms_bilateral << " ms" << '\n';
+    std::cerr << "  4. Máscara      -> " << ms_mask << " ms" << '\n';
+    std::cerr << "  TOTAL          -> " << total_ms << " ms" << '\n';
+    std::cerr << "====================================================" << '\n';
+    std::cerr << '\n';
 
     return out;
 }
@@ -299,9 +316,19 @@ static std::vector<double> extraerFeaturesDesde128(const uint8_t* img128, const
     return calcularLBPMultiEscalaPorBloquesRobustoNorm(img128, mask128, 128, 128, 6, 6, 200, true);
 }
 
-static std::vector<double> extraerCaracteristicas(const uint8_t* imagenGris, int ancho, int alto) {
+static std::vector<double> extraerCaracteristicas(const uint8_t* imagenGris, int ancho, int alto, TiemposEtapas& tiempos) {
+    auto t0 = std::chrono::steady_clock::now();
+    trazas::Span sPreproc("preproc");
     Imagen128 base = preprocesarHasta128(imagenGris, ancho, alto);
-    return extraerFeaturesDesde128(base.img128.get(), base.mask128.get());
+    sPreproc.terminar();
+    tiempos.preproc = seg_since(t0);
+    if (!base.img128) return {};
+    t0 = std::chrono::steady_clock::now();
+    trazas::Span sFeatures("features");
+    auto caracteristicas = extraerFeaturesDesde128(base.img128, base.mask128);
+    sFeatures.terminar();
+    tiempos.features = seg_since(t0);
+    return caracteristicas;
 }
 
 struct TemplateModel {
@@ -384,14 +411,22 @@ static bool scoreTemplatesK1(const TemplateModel& tm,
 }
 
 int main(int argc, char** argv) {
+    // stdout/stderr van a archivos del request: sin flush por línea. cerr sigue
+    // sincronizado con stdio para compartir el buffer de stderr con el logger y
+    // las trazas (sin intercalado); el buffer se vuelca en cada fase y al salir
+    std::setvbuf(stderr, nullptr, _IOFBF, 1 << 16);
+    std::cerr.unsetf(std::ios::unitbuf);
+
     if (argc < 2) {
-        std::cerr << "ERROR: Uso: predecir <ruta_imagen> [--rid <id>] [--claim <id_usuario>]" << std::endl;
+        std::cerr << "ERROR: Uso: predecir <ruta_imagen> [--rid <id>] [--claim <id_usuario>] [--modelo-dir <dir>]" << '\n';
         return 1;
     }
 
     // ---- args compatibles (NO rompe al servidor) ----
     std::string rid = makeRequestId();
     int claimedId = -1;
+    std::string trazaPadre;
+    std::string modeloDir = "out"; // el servidor pasa la instantánea publicada (modelo_vigente.h)
 
     for (int i = 2; i < argc; ++i) {
         std::string a = argv[i];
@@ -399,75 +434,122 @@ int main(int argc, char** argv) {
             rid = argv[++i];
         } else if (a == "--claim" && i + 1 < argc) {
             try { claimedId = std::stoi(argv[++i]); } catch (...) { claimedId = -1; }
+        } else if (a == "--traza-padre" && i + 1 < argc) {
+            trazaPadre = argv[++i];
+        } else if (a == "--modelo-dir" && i + 1 < argc) {
+            modeloDir = argv[++i];
         }
     }
 
+    // Con --traza-padre (lo pasa el servidor si el rid salió muestreado) los spans
+    // van por stderr como "TRAZA_SPAN ..." y el servidor los une a su traza.
+    // Suelto: TRAZAS_TASA / TRAZAS_DIR / TRAZAS_FORMATO como cualquier herramienta
+    trazas::configurarDesdeEntorno("predecir", "TRAZAS_");
+    if (!trazaPadre.empty()) trazas::continuarTrazaDe(trazaPadre);
+    trazas::Span traza("predecir", rid);
+
     const std::string rutaImagen = argv[1];
 
-    std::cerr << "\n[PREDECIR] RID: " << rid << std::endl;
-    if (claimedId != -1) std::cerr << "Claim ID: " << claimedId << std::endl;
-    std::cerr << "Inicio predicción. ruta_imagen=" << rutaImagen << " cwd=" << fs::current_path().string() << std::endl;
-    std::cerr << std::endl;
+    std::cerr << "\n[PREDECIR] RID: " << rid << '\n';
+    if (claimedId != -1) std::cerr << "Claim ID: " << claimedId << '\n';
+    std::cerr << "Inicio predicción. ruta_imagen=" << rutaImagen << " cwd=" << fs::current_path().string() << '\n';
+    std::cerr << '\n';
 
     // 1) Validar archivo
     try {
         if (!fs::exists(rutaImagen)) {
-            std::cerr << "ERROR: Archivo NO existe: " << rutaImagen << std::endl;
+            std::cerr << "ERROR: Archivo NO existe: " << rutaImagen << '\n';
             return 2;
         }
         auto sz = fs::file_size(rutaImagen);
-        std::cerr << "Archivo OK size_bytes=" << sz << std::endl;
+        std::cerr << "Archivo OK size_bytes=" << sz << '\n';
     } catch (const std::exception& e) {
-        std::cerr << "ERROR: Error revisando archivo: " << e.what() << std::endl;
+        std::cerr << "ERROR: Error revisando archivo: " << e.what() << '\n';
         return 2;
     }
 
-    // 2) Cargar imagen
+    TiemposEtapas tiempos;
+
+    // 2-3) Cargar imagen + gris + reducción por área (front end fusionado)
     auto t0 = std::chrono::steady_clock::now();
-    int ancho = 0, alto = 0, canales = 0;
-    unsigned char* imgRGB = cargarImagen(rutaImagen.c_str(), ancho, alto, canales, 3);
-    if (!imgRGB) {
-        std::cerr << "ERROR: Error cargando imagen (cargarImagen devolvió null)" << std::endl;
+    trazas::Span sDecode("decode");
+    BufferGris bufGris;
+    int ancho = 0, alto = 0, anchoOrig = 0, altoOrig = 0;
+    const uint8_t* gris = cargarGrisReducida(rutaImagen, 128, 128, bufGris, ancho, alto, anchoOrig, altoOrig);
+    if (!gris) {
+        std::cerr << "ERROR: Error cargando imagen (cargarGrisReducida devolvió null)" << '\n';
         return 3;
     }
-    std::cerr << "Imagen cargada w=" << ancho << " h=" << alto 
-              << " canales_in=" << canales << " ms=" << ms_since(t0) << std::endl;
-
-    // 3) Gris
-    t0 = std::chrono::steady_clock::now();
-    auto gris = convertirAGris(imgRGB, ancho, alto);
-    delete[] imgRGB;
-    std::cerr << "Convertir a gris OK ms=" << ms_since(t0) << std::endl;
-    std::cerr << std::endl;
+    sDecode.terminar();
+    tiempos.decode = seg_since(t0);
+    std::cerr << "Imagen cargada w=" << anchoOrig << " h=" << altoOrig
+              << " -> gris " << ancho << "x" << alto << " ms=" << ms_since(t0) << '\n';
+    std::cerr << '\n';
 
     // 4) Extracción (prepro + LBP)
     t0 = std::chrono::steady_clock::now();
     logPhaseHeader("EXTRACCION DE CARACTERISTICAS");
-    std::cerr << "Método: LBP Multi-Scale (6x6 bloques, umbral=200)" << std::endl;
-    auto caracteristicas = extraerCaracteristicas(gris.get(), ancho, alto);
+    std::cerr << "Método: LBP Multi-Scale (6x6 bloques, umbral=200)" << '\n';
+    auto caracteristicas = extraerCaracteristicas(gris, ancho, alto, tiempos);
     if (caracteristicas.empty()) {
-        std::cerr << "ERROR: Error extrayendo características (vector vacío)" << std::endl;
+        std::cerr << "ERROR: Error extrayendo características (vector vacío)" << '\n';
         return 4;
     }
     auto ms_lbp = ms_since(t0);
-    std::cerr << "LBP OK dim=" << caracteristicas.size() << " ms=" << ms_lbp << std::endl;
-    std::cerr << "====================================================" << std::endl;
-    std::cerr << std::endl;
+    std::cerr << "LBP OK dim=" << caracteristicas.size() << " ms=" << ms_lbp << '\n';
+    std::cerr << "====================================================" << '\n';
+    std::cerr << '\n';
 
                    
-    const std::string rutaZ   = "out/zscore_params.dat";
+    const std::string rutaZ   = modeloDir + "/zscore_params.dat";
+    const std::string rutaPCA = modeloDir + "/modelo_pca.dat";
+    const std::string rutaLDA = modeloDir + "/modelo_lda.dat";
+    const std::string rutaTemplates = modeloDir + "/templates_k1.csv";
 
-    // 4.5) Z-score (obligatorio)
-    logPhaseHeader("NORMALIZACION Z-SCORE");
+    // 4.4) Carga del modelo: etapa propia para que proyeccion/scoring midan solo cómputo
+    logPhaseHeader("CARGA DE MODELO");
     t0 = std::chrono::steady_clock::now();
+    trazas::Span sCarga("carga_modelo");
     ZScoreParams zp;
     if (!fs::exists(rutaZ) || !cargarZScoreParams(rutaZ, zp, ';')) {
-        std::cerr << "ERROR: Z-score params NO disponibles: " << rutaZ << std::endl;
+        std::cerr << "ERROR: Z-score params NO disponibles: " << rutaZ << '\n';
         return 55;
     }
+    if (!fs::exists(rutaPCA)) {
+        std::cerr << "ERROR: Modelo PCA NO existe en: " << rutaPCA << '\n';
+        return 5;
+    }
+    ModeloPCA modeloPCA = cargarModeloPCA(rutaPCA);
+    if (!fs::exists(rutaLDA)) {
+        std::cerr << "ERROR: Modelo LDA NO existe en: " << rutaLDA << '\n';
+        return 7;
+    }
+    ModeloLDA modeloLDA = cargarModeloLDA(rutaLDA);
+    if (!fs::exists(rutaTemplates)) {
+        std::cerr << "ERROR: Templates NO existen en: " << rutaTemplates << '\n';
+        return 9;
+    }
+    TemplateModel tm;
+    if (!cargarTemplatesCSV(rutaTemplates, tm)) {
+        std::cerr << "ERROR: Error cargando templates (CSV inválido)" << '\n';
+        return 10;
+    }
+    sCarga.terminar();
+    tiempos.carga = seg_since(t0);
+    auto ms_carga = ms_since(t0);
+    std::cerr << "Z-score, PCA, LDA y templates cargados" << '\n';
+    std::cerr << "Tiempo       -> " << ms_carga << " ms" << '\n';
+    std::cerr << "====================================================" << '\n';
+    std::cerr << '\n';
+
+    // 4.5) Z-score (obligatorio)
+    logPhaseHeader("NORMALIZACION Z-SCORE");
+    t0 = std::chrono::steady_clock::now();
+    const auto t0Proyeccion = t0;
+    trazas::Span sProyeccion("proyeccion");
     if (caracteristicas.size() != zp.mean.size()) {
         std::cerr << "ERROR: DIM_MISMATCH Z-score: feat_dim=" << caracteristicas.size()
-                  << " z_dim=" << zp.mean.size() << std::endl;
+                  << " z_dim=" << zp.mean.size() << '\n';
         return 56;
     }
     
@@ -478,7 +560,7 @@ int main(int argc, char** argv) {
     double std_before = std::sqrt(var_before > 0 ? var_before : 0);
     
     if (!aplicarZScore(caracteristicas, zp)) {
-        std::cerr << "ERROR: Error aplicando Z-score." << std::endl;
+        std::cerr << "ERROR: Error aplicando Z-score." << '\n';
         return 57;
     }
     
@@ -489,31 +571,24 @@ int main(int argc, char** argv) {
     double std_after = std::sqrt(var_after > 0 ? var_after : 0);
     
     auto ms_zscore = ms_since(t0);
-    std::cerr << "Parámetros: mean[dataset], std[dataset] para cada dimensión" << std::endl;
-    std::cerr << "Dimensión    -> " << caracteristicas.size() << " features" << std::endl;
+    std::cerr << "Parámetros: mean[dataset], std[dataset] para cada dimensión" << '\n';
+    std::cerr << "Dimensión    -> " << caracteristicas.size() << " features" << '\n';
     std::cerr << "Antes        -> mean=" << std::fixed << std::setprecision(4) << mean_before 
-              << " std=" << std_before << std::endl;
+              << " std=" << std_before << '\n';
     std::cerr << "Después      -> mean=" << std::fixed << std::setprecision(4) << mean_after 
-              << " std=" << std_after << std::endl;
-    std::cerr << "Validación   -> mean≈0 std≈1 ✓ NORMALIZADO" << std::endl;
-    std::cerr << "Tiempo       -> " << ms_zscore << " ms" << std::endl;
-    std::cerr << "====================================================" << std::endl;
-    std::cerr << std::endl;
+              << " std=" << std_after << '\n';
+    std::cerr << "Validación   -> mean≈0 std≈1 ✓ NORMALIZADO" << '\n';
+    std::cerr << "Tiempo       -> " << ms_zscore << " ms" << '\n';
+    std::cerr << "====================================================" << '\n';
+    std::cerr << '\n';
 
     // 5) PCA
-    const std::string rutaPCA = "out/modelo_pca.dat";
-
     logPhaseHeader("REDUCCION DIMENSIONAL PCA");
     t0 = std::chrono::steady_clock::now();
-    if (!fs::exists(rutaPCA)) {
-        std::cerr << "ERROR: Modelo PCA NO existe en: " << rutaPCA << std::endl;
-        return 5;
-    }
-    ModeloPCA modeloPCA = cargarModeloPCA(rutaPCA);
     int dim_in = caracteristicas.size();
     auto reducidas = aplicarPCAConModelo({ caracteristicas }, modeloPCA);
     if (reducidas.empty() || reducidas[0].empty()) {
-        std::cerr << "ERROR: Error aplicando PCA (resultado vacío)" << std::endl;
+        std::cerr << "ERROR: Error aplicando PCA (resultado vacío)" << '\n';
         return 6;
     }
     int dim_out = reducidas[0].size();
@@ -521,104 +596,92 @@ int main(int argc, char** argv) {
     
     double reduccion_pct = 100.0 * (1.0 - (double)dim_out / (double)dim_in);
     
-    std::cerr << "Entrada      -> " << dim_in << " dimensiones" << std::endl;
-    std::cerr << "Salida       -> " << dim_out << " componentes principales" << std::endl;
+    std::cerr << "Entrada      -> " << dim_in << " dimensiones" << '\n';
+    std::cerr << "Salida       -> " << dim_out << " componentes principales" << '\n';
     std::cerr << "Reducción    -> " << std::fixed << std::setprecision(1) << reduccion_pct << "% (de "
-              << dim_in << " a " << dim_out << ")" << std::endl;
+              << dim_in << " a " << dim_out << ")" << '\n';
     
     if (dim_out >= 100 && dim_out <= 140) {
-        std::cerr << "Validación   -> dim_out en rango recomendado [100,140] ✓ PASS" << std::endl;
+        std::cerr << "Validación   -> dim_out en rango recomendado [100,140] ✓ PASS" << '\n';
     } else if (dim_out > 140) {
-        std::cerr << "Validación   -> dim_out=" << dim_out << " > 140 ⚠ RIESGO OVERFITTING" << std::endl;
+        std::cerr << "Validación   -> dim_out=" << dim_out << " > 140 ⚠ RIESGO OVERFITTING" << '\n';
     } else {
-        std::cerr << "Validación   -> dim_out=" << dim_out << " < 100 ⚠ PÉRDIDA DE INFORMACIÓN" << std::endl;
+        std::cerr << "Validación   -> dim_out=" << dim_out << " < 100 ⚠ PÉRDIDA DE INFORMACIÓN" << '\n';
     }
     
-    std::cerr << "Tiempo       -> " << ms_pca << " ms" << std::endl;
-    std::cerr << "====================================================" << std::endl;
-    std::cerr << std::endl;
+    std::cerr << "Tiempo       -> " << ms_pca << " ms" << '\n';
+    std::cerr << "====================================================" << '\n';
+    std::cerr << '\n';
 
     // 6) Normalización L2 (PCA)
     logPhaseHeader("NORMALIZACION L2 (PCA)");
     t0 = std::chrono::steady_clock::now();
     for (auto& v : reducidas) normalizarVector(v);
     auto ms_norm_pca = ms_since(t0);
-    std::cerr << "Vectores PCA normalizados (L2)" << std::endl;
-    std::cerr << "Tiempo       -> " << ms_norm_pca << " ms" << std::endl;
-    std::cerr << "====================================================" << std::endl;
-    std::cerr << std::endl;
+    std::cerr << "Vectores PCA normalizados (L2)" << '\n';
+    std::cerr << "Tiempo       -> " << ms_norm_pca << " ms" << '\n';
+    std::cerr << "====================================================" << '\n';
+    std::cerr << '\n';
 
     // 7) LDA
-    const std::string rutaLDA = "out/modelo_lda.dat";
     logPhaseHeader("REDUCCION DISCRIMINANTE LDA");
     t0 = std::chrono::steady_clock::now();
-    if (!fs::exists(rutaLDA)) {
-        std::cerr << "ERROR: Modelo LDA NO existe en: " << rutaLDA << std::endl;
-        return 7;
-    }
-    ModeloLDA modeloLDA = cargarModeloLDA(rutaLDA);
     auto lda = aplicarLDAConModelo(reducidas, modeloLDA);
     if (lda.empty() || lda[0].empty()) {
-        std::cerr << "ERROR: Error aplicando LDA (resultado vacío)" << std::endl;
+        std::cerr << "ERROR: Error aplicando LDA (resultado vacío)" << '\n';
         return 8;
     }
     auto ms_lda = ms_since(t0);
-    std::cerr << "Entrada      -> " << dim_out << " dims (PCA)" << std::endl;
-    std::cerr << "Salida       -> " << lda[0].size() << " dims (LDA)" << std::endl;
-    std::cerr << "Tiempo       -> " << ms_lda << " ms" << std::endl;
-    std::cerr << "====================================================" << std::endl;
-    std::cerr << std::endl;
+    std::cerr << "Entrada      -> " << dim_out << " dims (PCA)" << '\n';
+    std::cerr << "Salida       -> " << lda[0].size() << " dims (LDA)" << '\n';
+    std::cerr << "Tiempo       -> " << ms_lda << " ms" << '\n';
+    std::cerr << "====================================================" << '\n';
+    std::cerr << '\n';
 
     // 8) Normalización L2 (LDA)
     logPhaseHeader("NORMALIZACION L2 (LDA)");
     t0 = std::chrono::steady_clock::now();
     for (auto& v : lda) normalizarVector(v);
     auto ms_norm_lda = ms_since(t0);
-    std::cerr << "Vectores LDA normalizados (L2)" << std::endl;
-    std::cerr << "Tiempo       -> " << ms_norm_lda << " ms" << std::endl;
-    std::cerr << "====================================================" << std::endl;
-    std::cerr << std::endl;
+    sProyeccion.terminar();
+    tiempos.proyeccion = seg_since(t0Proyeccion);
+    std::cerr << "Vectores LDA normalizados (L2)" << '\n';
+    std::cerr << "Tiempo       -> " << ms_norm_lda << " ms" << '\n';
+    std::cerr << "====================================================" << '\n';
+    std::cerr << '\n';
 
     // 9) Templates (coseno, K=1)
-    const std::string rutaTemplates = "out/templates_k1.csv";
     logPhaseHeader("TEMPLATES POR USUARIO (COSENO, K=1)");
     t0 = std::chrono::steady_clock::now();
-    if (!fs::exists(rutaTemplates)) {
-        std::cerr << "ERROR: Templates NO existen en: " << rutaTemplates << std::endl;
-        return 9;
-    }
-
-    TemplateModel tm;
-    if (!cargarTemplatesCSV(rutaTemplates, tm)) {
-        std::cerr << "ERROR: Error cargando templates (CSV inválido)" << std::endl;
-        return 10;
-    }
-
+    trazas::Span sScoring("scoring");
     int clase = -1;
     double s1 = 0.0, s2 = 0.0, s_claimed = 0.0;
     if (!scoreTemplatesK1(tm, lda[0], claimedId, clase, s1, s2, s_claimed)) {
-        std::cerr << "ERROR: Error puntuando templates" << std::endl;
+        std::cerr << "ERROR: Error puntuando templates" << '\n';
         return 11;
     }
 
     double margen = s1 - s2;
     auto ms_tpl = ms_since(t0);
+    sScoring.terminar();
+    tiempos.scoring = seg_since(t0);
 
-    std::cerr << "  Top-1        -> Clase " << clase << " (score=" << std::fixed << std::setprecision(4) << s1 << ")" << std::endl;
-    std::cerr << "  Top-2        -> score=" << std::fixed << std::setprecision(4) << s2 << std::endl;
-    std::cerr << "  Score claim  -> " << std::fixed << std::setprecision(4) << s_claimed << std::endl;
-    std::cerr << "  Margen       -> " << std::fixed << std::setprecision(4) << margen << " (s1-s2)" << std::endl;
-    std::cerr << "  Tiempo       -> " << ms_tpl << " ms" << std::endl;
-    std::cerr << "====================================================" << std::endl;
-    std::cerr << std::endl;
+    std::cerr << "  Top-1        -> Clase " << clase << " (score=" << std::fixed << std::setprecision(4) << s1 << ")" << '\n';
+    std::cerr << "  Top-2        -> score=" << std::fixed << std::setprecision(4) << s2 << '\n';
+    std::cerr << "  Score claim  -> " << std::fixed << std::setprecision(4) << s_claimed << '\n';
+    std::cerr << "  Margen       -> " << std::fixed << std::setprecision(4) << margen << " (s1-s2)" << '\n';
+    std::cerr << "  Tiempo       -> " << ms_tpl << " ms" << '\n';
+    std::cerr << "====================================================" << '\n';
+    std::cerr << '\n';
 
     // Resumen final
     logPhaseHeader("RESUMEN FINAL - AUTENTICACION");
-    std::cerr << "Usuario Predicho: " << clase << std::endl;
-    std::cerr << "Score Top-1:       " << std::fixed << std::setprecision(4) << s1 << std::endl;
-    std::cerr << "Score Claim:       " << std::fixed << std::setprecision(4) << s_claimed << std::endl;
-    std::cerr << "Pipeline Total:    " << (ms_lbp + ms_zscore + ms_pca + ms_norm_pca + ms_lda + ms_norm_lda + ms_tpl) << " ms" << std::endl;
-    std::cerr << "===================================================" << std::endl;
+    std::cerr << "Usuario Predicho: " << clase << '\n';
+    std::cerr << "Score Top-1:       " << std::fixed << std::setprecision(4) << s1 << '\n';
+    std::cerr << "Score Claim:       " << std::fixed << std::setprecision(4) << s_claimed << '\n';
+    std::cerr << "Pipeline Total:    " << (ms_lbp + ms_carga + ms_zscore + ms_pca + ms_norm_pca + ms_lda + ms_norm_lda + ms_tpl) << " ms" << '\n';
+    std::cerr << "===================================================" << '\n';
+    emitirTiemposEtapas(tiempos);
 
     // IMPORTANTÍSIMO:
     // stdout: clase;score_top1;score_claimed
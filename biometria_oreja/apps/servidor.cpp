@@ -7,43 +7,62 @@
 #include <string>
 #include <algorithm>
 #include <cstdlib>
+#include <memory>
 #include <mutex>
 #include <vector>
 #include <sstream>
 #include <cctype>
 #include <cstdio>
+#include <cstring>
 #include <array>
-#include <shared_mutex>
 #include <ctime>
 #include <iomanip>
 
 #include "utilidades/logger.h"
+#include "comun/trazas.h"
+#include "comun/feature_codec.h"
+#include "comun/metricas.h"
+#include "comun/cola_auditoria.h"
 #include "server_utils.h"
 #include "server_env.h"
 #include "proc_utils.h"
 #include "exit_map.h"
 #include "report_format.h"
+#include "comun/sync_bulk.h"
+#include "comun/metricas_http.h"
+#include "modelo_vigente.h"
 
 using json = nlohmann::json;
 namespace fs = std::filesystem;
 
 // ===================== Config =====================
 #if defined(_WIN32)
-static constexpr const char *BASE_URL = "http://localhost:3001";
+static constexpr const char *BASE_URL_DEFAULT = "http://localhost:3001";
 static constexpr const char *CMD_AGREGAR_USUARIO = "agregar_usuario.exe";
 static constexpr const char *CMD_AGREGAR_USUARIO_BIOMETRIA = "agregar_usuario_biometria.exe";
 static constexpr const char *CMD_PREDECIR = "predecir.exe";
 #else
 // Ajusta si tu PostgREST en local está en otro host/puerto dentro del docker network
-static constexpr const char *BASE_URL = "http://biometria_api:3000";
+static constexpr const char *BASE_URL_DEFAULT = "http://biometria_api:3000";
 static constexpr const char *CMD_AGREGAR_USUARIO = "./agregar_usuario";
 static constexpr const char *CMD_AGREGAR_USUARIO_BIOMETRIA = "./agregar_usuario_biometria";
 static constexpr const char *CMD_PREDECIR = "./predecir";
 #endif
 
-// Lectores: autenticación (muchos a la vez)
-// Escritor: registro biométrico / reentreno (uno a la vez)
-static std::shared_mutex g_model_rw;
+// POSTGREST_URL (docker-compose) tiene prioridad: permite apuntar a un stub local
+// en pruebas de carga (ver apps/carga/stub_postgrest.cpp)
+static const std::string &baseUrl()
+{
+    static const std::string url = getEnvStr("POSTGREST_URL", BASE_URL_DEFAULT);
+    return url;
+}
+
+// Registro biométrico: reescribe templates_k1.csv en MODEL_DIR y republica el
+// modelo, uno a la vez. La autenticación no lo toma (usa modeloVigente())
+static std::mutex g_registro_mtx;
+
+// Auditoría de validaciones: encolada, se escribe en BD en segundo plano
+static std::unique_ptr<auditoria::Cola> g_audit;
 
 #ifndef _WIN32
 #include <sys/wait.h>
@@ -54,9 +73,44 @@ static std::shared_mutex g_model_rw;
 #define pclose _pclose
 #endif
 
+// Transporte de la cola de auditoría: POST en bloque (body array) a PostgREST
+static auditoria::Envio enviarValidaciones(const std::string &cuerpo, size_t filas)
+{
+    static const std::string endpoint = "/validaciones_biometricas";
+    httplib::Client cli(baseUrl());
+    cli.set_connection_timeout(2, 0);
+    cli.set_read_timeout(5, 0);
+    cli.set_write_timeout(5, 0);
+
+    const httplib::Headers headers = {{"Prefer", "return=minimal"}};
+    auto r = metricas_http::medirBD("POST", endpoint, [&]
+                     { return cli.Post(endpoint.c_str(), headers, cuerpo, "application/json"); });
+    if (!r || r->status >= 500)
+        return auditoria::Envio::Reintentar;
+    if (r->status >= 400)
+    {
+        LOGE("AUDIT", "", "BD ERROR: POST " + endpoint + " status=" + std::to_string(r->status) +
+                              " body=" + r->body.substr(0, 300));
+        return auditoria::Envio::Descartar;
+    }
+    LOGD("AUDIT", "", "BD: POST " + endpoint + " status=" + std::to_string(r->status) +
+                          " filas=" + std::to_string(filas));
+    return auditoria::Envio::Ok;
+}
+
+static void logAuditoria(auditoria::Nivel nivel, const std::string &msg)
+{
+    if (nivel == auditoria::Nivel::Error)
+        LOGE("AUDIT", "", msg);
+    else if (nivel == auditoria::Nivel::Aviso)
+        LOGW("AUDIT", "", msg);
+    else
+        LOGI("AUDIT", "", msg);
+}
+
 static httplib::Client makeClient()
 {
-    httplib::Client cli(BASE_URL);
+    httplib::Client cli(baseUrl());
     cli.set_connection_timeout(5, 0);
     cli.set_read_timeout(20, 0);
     cli.set_write_timeout(20, 0);
@@ -143,42 +197,62 @@ static bool tryGetEnvDouble(const std::string &name, double &out)
     }
 }
 
-static bool cargarUmbralDesdeArchivo(const std::string &ruta, double &out)
+// Features de un item de sync: "vector_features_b64" (blob FV en base64, ver feature_codec.h)
+// o, por compatibilidad, "vector_features" como array JSON de doubles
+static bool leerFeaturesSync(const json &item, std::vector<double> &features)
 {
-    std::ifstream f(ruta);
-    if (!f.is_open())
-        return false;
-    std::string line;
-    while (std::getline(f, line))
+    if (item.contains("vector_features_b64") && item["vector_features_b64"].is_string())
     {
-        if (line.rfind("threshold=", 0) == 0)
+        std::vector<uint8_t> blob;
+        return decodificarBase64(item["vector_features_b64"].get_ref<const std::string &>(), blob) &&
+               desempaquetarFeatures(blob.data(), blob.size(), features);
+    }
+    if (item.contains("vector_features"))
+    {
+        try
         {
-            try
-            {
-                out = std::stod(line.substr(10));
-                return true;
-            }
-            catch (...)
-            {
-                return false;
-            }
+            features = item["vector_features"].get<std::vector<double>>();
+            return true;
+        }
+        catch (...)
+        {
+            return false;
         }
     }
     return false;
 }
 
-static std::string vectorToByteArray(const std::vector<double> &vec)
+// predecir reporta la duración de sus etapas en stderr:
+// "METRICAS_ETAPAS decode=0.004 preproc=0.016 features=0.003 carga_modelo=0.110 proyeccion=0.010 scoring=0.001"
+static constexpr const char *METRICAS_ETAPAS = "METRICAS_ETAPAS ";
+
+static void observarEtapasPredecir(const std::string &linea)
 {
-    std::stringstream ss;
-    ss << "\\x";
-    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(vec.data());
-    size_t numBytes = vec.size() * sizeof(double);
-    for (size_t i = 0; i < numBytes; ++i)
+    std::istringstream ss(linea.substr(std::strlen(METRICAS_ETAPAS)));
+    std::string kv;
+    while (ss >> kv)
     {
-        ss << std::hex << std::setw(2) << std::setfill('0')
-           << static_cast<int>(bytes[i]);
+        const auto eq = kv.find('=');
+        if (eq == std::string::npos)
+            continue;
+        try
+        {
+            metricas::etapa(kv.substr(0, eq)).observar(std::stod(kv.substr(eq + 1)));
+        }
+        catch (...)
+        {
+        }
     }
-    return ss.str();
+}
+
+// Un hijo lanzado con --traza-padre deja sus spans en stderr ("TRAZA_SPAN ...");
+// se unen a la traza del hilo que atiende la solicitud
+static void importarTrazasDe(const std::string &rutaStderr)
+{
+    std::ifstream f(rutaStderr);
+    std::string linea;
+    while (std::getline(f, linea))
+        trazas::importarLinea(linea);
 }
 
 static std::string nowUtcIso()
@@ -194,10 +268,29 @@ int main()
 {
     // Para defensa técnica, usa DEBUG. Para “normal”, INFO.
     setLogLevel(LOG_DEBUG);
+    // LOG_FORMAT=json -> JSON lines (ts, level, tag, rid, thread, msg) para ingesta
+    if (getEnvStr("LOG_FORMAT", "text") == "json")
+        setLogFormat(LOG_FORMAT_JSON);
     // Si quieres persistir logs a archivo (montado con /app/out):
     // setLogFile("/app/out/log_servidor.txt");
+    // TRAZAS_TASA=0.01 -> 1% de los rid trazados en TRAZAS_DIR (Chrome trace; TRAZAS_FORMATO=otlp)
+    trazas::configurarDesdeEntorno("servidor", "TRAZAS_");
+
+    // Primera instantánea de MODEL_DIR; sin modelo válido /oreja/autenticar responde 503
+    // hasta un registro o POST /oreja/modelo/recargar
+    recargarModelo("arranque");
+
+    {
+        auditoria::Config auditCfg;
+        auditCfg.rutaSpool = getEnvStr("AUDIT_SPOOL", tmpDir() + "/audit_validaciones.jsonl");
+        auditCfg.maxLote = (size_t)std::max(1.0, getEnvDouble("AUDIT_BATCH_MAX", 64));
+        auditCfg.flushMs = (int)std::max(10.0, getEnvDouble("AUDIT_FLUSH_MS", 500));
+        g_audit = std::make_unique<auditoria::Cola>(auditCfg, enviarValidaciones, logAuditoria);
+    }
 
     httplib::Server servidor;
+    // GET /metrics (Prometheus) + duración/espera en cola de cada solicitud
+    metricas_http::instrumentarServidorHttp(servidor);
 
     // --------------------- GET / ---------------------
     servidor.Get("/", [](const httplib::Request &req, httplib::Response &res)
@@ -414,7 +507,7 @@ int main()
         {
             httplib::Client cli = makeClient();
             const std::string url = "/usuarios?id_usuario=eq." + std::to_string(id_usuario);
-            auto r = cli.Get(url.c_str());
+            auto r = metricas_http::medirBD("GET", url, [&] { return cli.Get(url.c_str()); });
 
             if (!r) {
                 LOGW("USUARIOS", rid, "BD WARN: sin respuesta verificando " + url);
@@ -507,7 +600,7 @@ int main()
             httplib::Client cli = makeClient();
             const std::string urlUsuario = "/usuarios?identificador_unico=eq." + identificador;
 
-            auto r = cli.Get(urlUsuario.c_str());
+            auto r = metricas_http::medirBD("GET", urlUsuario, [&] { return cli.Get(urlUsuario.c_str()); });
             if (!r) {
                 LOGE("OREJA", rid, "BD ERROR: sin respuesta consultando " + urlUsuario + " -> 500");
                 res.status = 500;
@@ -616,7 +709,19 @@ int main()
         LOGI("OREJA", rid, "EXEC: stdout=" + outStd + " stderr=" + outErr);
         LOGD("OREJA", rid, "EXEC: cmd=" + cmd);
 
-        int exit_code = systemExitCode(std::system(cmd.c_str()));
+        static auto& etapaRegistro = metricas::etapa("proceso_registro");
+        int exit_code = 0;
+        std::unique_lock<std::mutex> registro_lock(g_registro_mtx);
+        {
+            trazas::Span span("proceso_registro");
+            const std::string padre = trazas::spanActual();
+            if (!padre.empty())
+                cmd.insert(cmd.find(" 1> " + outStd), " --traza-padre " + padre);
+            metricas::Temporizador t(etapaRegistro);
+            exit_code = systemExitCode(std::system(cmd.c_str()));
+            if (!padre.empty())
+                importarTrazasDe(outErr);
+        }
         LOGI("OREJA", rid, "EXEC: agregar_usuario_biometria terminó exit_code=" + std::to_string(exit_code));
 
 
@@ -731,6 +836,12 @@ int main()
                         " id_usuario=" + std::to_string(id_usuario) +
                         " imgs=" + std::to_string(req.files.size()));
 
+        // Las autenticaciones en curso terminan con la versión anterior
+        std::string errorModelo;
+        if (!recargarModelo(rid, &errorModelo))
+            LOGW("OREJA", rid, "Registro guardado pero el modelo no se republicó: " + errorModelo);
+        registro_lock.unlock();
+
         res.status = 200;
         res.set_content("Credencial biométrica registrada correctamente.", "text/plain");
 
@@ -799,7 +910,7 @@ int main()
                       int id_usuario_real = -1;
                       {
                           const std::string urlUsuario = "/usuarios?identificador_unico=eq." + etiqueta;
-                          auto r = cli.Get(urlUsuario.c_str());
+                          auto r = metricas_http::medirBD("GET", urlUsuario, [&] { return cli.Get(urlUsuario.c_str()); });
                           if (!r)
                           {
                               LOGE("OREJA", rid, "BD ERROR: sin respuesta consultando usuario -> 500");
@@ -857,7 +968,7 @@ int main()
                               "/credenciales_biometricas?id_usuario=eq." + std::to_string(id_usuario_real) +
                               "&tipo_biometria=eq.oreja&estado=eq.activo";
 
-                          auto r = cli.Get(urlCred.c_str());
+                          auto r = metricas_http::medirBD("GET", urlCred, [&] { return cli.Get(urlCred.c_str()); });
                           if (!r)
                           {
                               LOGE("OREJA", rid, "BD ERROR: sin respuesta consultando credenciales -> 500");
@@ -898,7 +1009,17 @@ int main()
                           LOGI("OREJA", rid, "Credencial OK: oreja activa encontrada para id_usuario=" + std::to_string(id_usuario_real));
                       }
 
-                      std::shared_lock<std::shared_mutex> model_read_lock(g_model_rw);
+                      // Instantánea del modelo: sin espera aunque haya un registro en curso;
+                      // predecir y el umbral usan esta versión hasta el final
+                      const std::shared_ptr<const ModelSet> modelo = modeloVigente();
+                      if (!modelo)
+                      {
+                          LOGE("OREJA", rid, "Sin modelo publicado (ver arranque / POST /oreja/modelo/recargar) -> 503");
+                          res.status = 503;
+                          res.set_content("Modelo biometrico no disponible", "text/plain");
+                          return;
+                      }
+                      LOGI("OREJA", rid, "Modelo v" + std::to_string(modelo->version) + " dir=" + modelo->dir);
 
                       // 3) Ejecutar predecir
 
@@ -907,16 +1028,27 @@ int main()
 
                       // stdout -> prediccion (clase;score_top1;score_claimed)
                       // stderr -> log del predecir
+                      // Si la solicitud se está trazando, predecir cuelga sus spans de este
+                      trazas::Span spanPredecir("proceso_predecir");
+                      const std::string trazaPadre = trazas::spanActual();
                       const std::string comando =
                           std::string("cd /app && ") + CMD_PREDECIR + " " + rutaImagen +
                           " --rid " + rid +
                           " --claim " + etiqueta +
+                          " --modelo-dir " + modelo->dir +
+                          (trazaPadre.empty() ? "" : " --traza-padre " + trazaPadre) +
                           " 1> " + outPred +
                           " 2> " + outLog;
 
                       LOGI("OREJA", rid, "EXEC: predecir stdout=" + outPred + " stderr=" + outLog);
                       LOGI("OREJA", rid, "EXEC: ejecutar predecir cmd=" + comando);
-                      int exit_code = systemExitCode(std::system(comando.c_str()));
+                      static auto &etapaProceso = metricas::etapa("proceso_predecir");
+                      int exit_code = 0;
+                      {
+                          metricas::Temporizador t(etapaProceso);
+                          exit_code = systemExitCode(std::system(comando.c_str()));
+                      }
+                      spanPredecir.terminar();
                       LOGI("OREJA", rid, "EXEC: predecir finalizó exit_code=" + std::to_string(exit_code));
 
                       // Mostrar stderr completo en docker logs (para debugging y tutores)
@@ -927,6 +1059,10 @@ int main()
                           LOGI("OREJA", rid, "========== STDERR PREDECIR (PIPELINE COMPLETO) ==========");
                           while (std::getline(stderrFile, line))
                           {
+                              if (line.rfind(METRICAS_ETAPAS, 0) == 0)
+                                  observarEtapasPredecir(line);
+                              if (trazas::importarLinea(line))
+                                  continue;
                               LOGI("OREJA", rid, line);
                           }
                           LOGI("OREJA", rid, "========== FIN STDERR PREDECIR ==========");
@@ -1026,23 +1162,17 @@ int main()
                       //
                       // Puedes configurar con variable de entorno: UMBRAL_AUTENTICACION
                       // O pasar como parámetro query: ?umbral=0.5
-                      // Si no hay env, usa umbral_eer.txt generado por procesar_dataset
+                      // Si no hay env, usa umbral_eer.txt (generado por procesar_dataset) de la instantánea
                       double UMBRAL_VERIFICACION = 0.5;
                       double envUmbral = 0.0;
                       if (tryGetEnvDouble("UMBRAL_AUTENTICACION", envUmbral))
                       {
                           UMBRAL_VERIFICACION = envUmbral;
                       }
-                      else
+                      else if (modelo->tieneUmbralEer)
                       {
-                          const std::string modelDir = getEnvStr("MODEL_DIR", "out");
-                          const std::string rutaUmbral = modelDir + "/umbral_eer.txt";
-                          double fileUmbral = 0.0;
-                          if (cargarUmbralDesdeArchivo(rutaUmbral, fileUmbral))
-                          {
-                              UMBRAL_VERIFICACION = fileUmbral;
-                              LOGI("OREJA", rid, "Umbral EER cargado desde archivo: " + rutaUmbral + " -> " + std::to_string(UMBRAL_VERIFICACION));
-                          }
+                          UMBRAL_VERIFICACION = modelo->umbralEer;
+                          LOGI("OREJA", rid, "Umbral EER del modelo v" + std::to_string(modelo->version) + " -> " + std::to_string(UMBRAL_VERIFICACION));
                       }
 
                       if (req.has_param("umbral"))
@@ -1080,22 +1210,16 @@ int main()
                                " pasaUmbral=" + std::string(pasaUmbral ? "si" : "no") +
                                " autenticado=" + std::string(autenticado ? "si" : "no"));
 
-                      // 6) Registrar validación (mejor esfuerzo)
+                      // 6) Registrar validación (mejor esfuerzo, asíncrono: no agrega latencia)
                       {
+                          // resultado: columna de migracion_validaciones_resultado.sql
                           json validacion = {
                               {"id_usuario", id_usuario_real},
                               {"tipo_biometria", "oreja"},
                               {"resultado", autenticado ? "exito" : "fallo"}};
 
-                          auto r = cli.Post("/validaciones_biometricas", validacion.dump(), "application/json");
-                          if (!r)
-                          {
-                              LOGW("OREJA", rid, "BD WARN: no se pudo registrar validación (SIN_RESPUESTA)");
-                          }
-                          else
-                          {
-                              LOGI("OREJA", rid, "BD: POST /validaciones_biometricas status=" + std::to_string(r->status));
-                          }
+                          g_audit->registrar(validacion.dump());
+                          LOGD("OREJA", rid, "AUDIT: validación encolada");
                       }
 
                       json respuesta = {
@@ -1127,7 +1251,8 @@ int main()
                   });
 
     // --------------------- POST /oreja/sync/push ---------------------
-    // Body JSON: { uuid_dispositivo, caracteristicas: [{id_usuario,id_credencial?,vector_features[],dimension}] }
+    // Body JSON: { uuid_dispositivo, caracteristicas: [{id_usuario,id_credencial?,id_muestra_cliente?,vector_features_b64|vector_features[],dimension}] }
+    // Inserción en bloque e idempotente: reenviar el mismo lote no duplica filas.
     servidor.Post("/oreja/sync/push", [](const httplib::Request &req, httplib::Response &res)
                   {
         const std::string rid = makeRequestId();
@@ -1164,44 +1289,70 @@ int main()
             {"total", (int)items.size()}
         };
 
-        httplib::Client cli = makeClient();
-        httplib::Headers headers = { {"Prefer", "return=representation"} };
+        // 1) Validar y armar filas (todas con las mismas claves: PostgREST lo exige en bulk)
+        std::vector<json> filas;
+        std::vector<int> indiceFila;          // fila -> índice en items
+        json resultados = json::array();
+        filas.reserve(items.size());
 
-        int procesados = 0;
-        for (const auto& item : items) {
-            if (!item.contains("id_usuario") || !item.contains("vector_features") || !item.contains("dimension")) {
-                continue;
+        for (size_t i = 0; i < items.size(); ++i) {
+            const auto& item = items[i];
+            json resultado = {{"indice", (int)i}};
+            if (item.contains("id_muestra_cliente")) resultado["id_muestra_cliente"] = item["id_muestra_cliente"];
+
+            std::vector<double> features;
+            if (!item.contains("id_usuario") || !item.contains("dimension")) {
+                resultado["error"] = "faltan id_usuario/dimension";
+            } else if (!leerFeaturesSync(item, features)) {
+                resultado["error"] = "vector_features inválido";
             }
+            resultados.push_back(resultado);
+            if (resultado.contains("error")) continue;
+
+            const int idCredencial = item.value("id_credencial", 0);
+
+            json fila;
+            fila["id_usuario"] = item["id_usuario"].get<int>();
+            fila["id_credencial"] = idCredencial > 0 ? json(idCredencial) : json(nullptr);
+            fila["vector_features"] = vectorAByteaHex(features);
+            fila["dimension"] = item["dimension"].get<int>();
+            fila["origen"] = "mobile";
+            fila["uuid_dispositivo"] = uuidDispositivo;
+            fila["id_muestra_cliente"] = item.contains("id_muestra_cliente") && !item["id_muestra_cliente"].is_null()
+                                             ? json(item["id_muestra_cliente"].is_string()
+                                                        ? item["id_muestra_cliente"].get<std::string>()
+                                                        : item["id_muestra_cliente"].dump())
+                                             : json(nullptr);
+            filas.push_back(std::move(fila));
+            indiceFila.push_back((int)i);
+        }
 
-            int idUsuario = item["id_usuario"].get<int>();
-            int idCredencial = item.value("id_credencial", 0);
-            int dimension = item["dimension"].get<int>();
+        // 2) Inserción en bloque (chunks) con aislamiento de filas inválidas
+        httplib::Client cli = makeClient();
+        const size_t chunk = (size_t)std::max(1.0, getEnvDouble("SYNC_CHUNK", 50));
+        auto insertados = sync_bulk::insertar(cli, "caracteristicas_oreja", filas, chunk,
+                                              [&rid](sync_bulk::Nivel nivel, const std::string &msg)
+                                              {
+                                                  if (nivel == sync_bulk::Nivel::Aviso) LOGW("SYNC", rid, "BD WARN: " + msg);
+                                                  else LOGI("SYNC", rid, "BD: " + msg);
+                                              });
 
-            std::vector<double> features;
-            try { features = item["vector_features"].get<std::vector<double>>(); }
-            catch (...) { continue; }
-
-            json payload;
-            payload["id_usuario"] = idUsuario;
-            if (idCredencial > 0) payload["id_credencial"] = idCredencial;
-            payload["vector_features"] = vectorToByteArray(features);
-            payload["dimension"] = dimension;
-            payload["origen"] = "mobile";
-            payload["uuid_dispositivo"] = uuidDispositivo;
-
-            auto r = cli.Post("/caracteristicas_oreja", headers, payload.dump(), "application/json");
-            if (r && r->status == 201) {
+        int procesados = 0;
+        for (size_t f = 0; f < filas.size(); ++f) {
+            json& resultado = resultados[indiceFila[f]];
+            if (insertados[f].idCaracteristica >= 0) {
+                resultado["id_caracteristica"] = insertados[f].idCaracteristica;
+                response["ids_procesados"].push_back(insertados[f].idCaracteristica);
                 procesados++;
-                try {
-                    json data = json::parse(r->body);
-                    if (data.is_array() && !data.empty() && data[0].contains("id_caracteristica")) {
-                        response["ids_procesados"].push_back(data[0]["id_caracteristica"]);
-                    }
-                } catch (...) {}
+            } else {
+                resultado["error"] = insertados[f].error;
             }
         }
 
         response["procesados"] = procesados;
+        response["fallidos"] = (int)items.size() - procesados;
+        response["resultados"] = std::move(resultados);
+        LOGI("SYNC", rid, "SYNC: push procesados=" + std::to_string(procesados) + "/" + std::to_string(items.size()));
         res.status = 200;
         res.set_content(response.dump(4), "application/json"); });
 
@@ -1228,7 +1379,7 @@ int main()
         {
             std::string url = "/usuarios";
             if (!desde.empty()) url += "?updated_at=gt." + desde;
-            auto r = cli.Get(url.c_str());
+            auto r = metricas_http::medirBD("GET", url, [&] { return cli.Get(url.c_str()); });
             if (r && r->status == 200) {
                 try {
                     json data = json::parse(r->body);
@@ -1252,7 +1403,7 @@ int main()
         {
             std::string url = "/credenciales_biometricas";
             if (!desde.empty()) url += "?updated_at=gt." + desde;
-            auto r = cli.Get(url.c_str());
+            auto r = metricas_http::medirBD("GET", url, [&] { return cli.Get(url.c_str()); });
             if (r && r->status == 200) {
                 try {
                     json data = json::parse(r->body);
@@ -1276,6 +1427,29 @@ int main()
         res.status = response["ok"].get<bool>() ? 200 : 502;
         res.set_content(response.dump(4), "application/json"); });
 
+    // --------------------- POST /oreja/modelo/recargar ---------------------
+    // Tras un reentreno fuera del servidor (procesar_dataset): publica lo que hay
+    // en MODEL_DIR si valida. Las autenticaciones no se detienen durante la carga
+    servidor.Post("/oreja/modelo/recargar", [](const httplib::Request &req, httplib::Response &res)
+                  {
+        const std::string rid = makeRequestId();
+        LOG_SCOPE("MODELO", rid, "POST /oreja/modelo/recargar");
+        logRequestBasics("MODELO", rid, req);
+
+        std::string error;
+        std::lock_guard<std::mutex> lock(g_registro_mtx);
+        const bool ok = recargarModelo(rid, &error);
+        const auto modelo = modeloVigente();
+
+        json j = {{"ok", ok}, {"rid", rid}};
+        if (modelo) {
+            j["version"] = modelo->version;
+            j["templates"] = modelo->numTemplates;
+        }
+        if (!ok) j["error"] = error;
+        res.status = ok ? 200 : 422;
+        res.set_content(j.dump(4), "application/json"); });
+
     // --------------------- GET /oreja/sync/modelo ---------------------
     // Query: ?archivo=<nombre>
     servidor.Get("/oreja/sync/modelo", [](const httplib::Request &req, httplib::Response &res)
@@ -1301,7 +1475,10 @@ int main()
             return;
         }
 
-        const std::string modelDir = getEnvStr("MODEL_DIR", "out");
+        // Desde la instantánea publicada: archivos consistentes entre sí aunque
+        // haya un registro reescribiendo MODEL_DIR
+        const auto modelo = modeloVigente();
+        const std::string modelDir = modelo ? modelo->dir : getEnvStr("MODEL_DIR", "out");
         const std::string path = modelDir + "/" + archivo;
         if (!fs::exists(path)) {
             res.status = 404;
@@ -1369,7 +1546,7 @@ int main()
         httplib::Client cli = makeClient();
         const std::string urlUsuario = "/usuarios?identificador_unico=eq." + identificador;
 
-        auto r = cli.Get(urlUsuario.c_str());
+        auto r = metricas_http::medirBD("GET", urlUsuario, [&] { return cli.Get(urlUsuario.c_str()); });
         if (!r) {
             LOGE("USUARIOS", rid, repFAIL("Sin respuesta de BD en GET /usuarios"));
             LOGE("USUARIOS", rid, repKeyVal("url", urlUsuario));
@@ -1460,7 +1637,7 @@ int main()
         json update = { {"estado", "eliminado"} };
         const std::string urlPatch = "/usuarios?id_usuario=eq." + std::to_string(id_usuario);
 
-        auto p = cli.Patch(urlPatch.c_str(), update.dump(), "application/json");
+        auto p = metricas_http::medirBD("PATCH", urlPatch, [&] { return cli.Patch(urlPatch.c_str(), update.dump(), "application/json"); });
         if (!p) {
             LOGE("USUARIOS", rid, repFAIL("Sin respuesta de BD en PATCH /usuarios"));
             LOGE("USUARIOS", rid, repKeyVal("url", urlPatch));
@@ -1550,7 +1727,7 @@ int main()
         httplib::Client cli = makeClient();
         const std::string urlUsuario = "/usuarios?identificador_unico=eq." + identificador;
 
-        auto r = cli.Get(urlUsuario.c_str());
+        auto r = metricas_http::medirBD("GET", urlUsuario, [&] { return cli.Get(urlUsuario.c_str()); });
         if (!r) {
             LOGE("USUARIOS", rid, repFAIL("Sin respuesta de BD en GET /usuarios"));
             LOGE("USUARIOS", rid, repKeyVal("url", urlUsuario));
@@ -1641,7 +1818,7 @@ int main()
         json update = { {"estado", "activo"} };
         const std::string urlPatch = "/usuarios?id_usuario=eq." + std::to_string(id_usuario);
 
-        auto p = cli.Patch(urlPatch.c_str(), update.dump(), "application/json");
+        auto p = metricas_http::medirBD("PATCH", urlPatch, [&] { return cli.Patch(urlPatch.c_str(), update.dump(), "application/json"); });
         if (!p) {
             LOGE("USUARIOS", rid, repFAIL("Sin respuesta de BD en PATCH /usuarios"));
             LOGE("USUARIOS", rid, repKeyVal("url", urlPatch));
@@ -1685,5 +1862,7 @@ int main()
 
     LOGI("OREJA", "", "Servidor biometria oreja escuchando en 0.0.0.0:8085");
     servidor.listen("0.0.0.0", 8085);
+
+    g_audit.reset(); // drena validaciones pendientes (BD o spool)
     return 0;
 }
@@ -1,9 +1,40 @@
 #include "metricas/curva_aprendizaje.h"
 #include <vector>
 #include <string>
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
 
-int main() {
-    //std::vector<int> clases = { 5, 10, 15, 20, 25, 30, 35, 40, 45, 50 };
-    //generarCurvaAprendizaje("out/caracteristicas_pca_40.csv", clases, 3, "out/curva_aprendizaje.csv");
-    return 0;
+// Uso: curva_aprendizaje [features.csv] [salida.csv] [repeticiones] [hilos] [tasas] [Cs]
+//   tasas / Cs: listas separadas por coma (ej: 0.01,0.05). Con mas de un
+//   valor se hace barrido de hiperparametros ademas de K.
+// Relanzar con la misma salida retoma los ensayos que faltan.
+static std::vector<double> parsearLista(const char* texto) {
+    std::vector<double> valores;
+    std::stringstream ss(texto);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) valores.push_back(std::atof(item.c_str()));
+    }
+    return valores;
+}
+
+int main(int argc, char** argv) {
+    ConfigBarrido cfg;
+    cfg.clases_a_usar = { 5, 10, 15, 20, 25, 30, 35, 40, 45, 50 };
+
+    const std::string entrada = (argc > 1) ? argv[1] : "out/caracteristicas_pca_40.csv";
+    const std::string salida = (argc > 2) ? argv[2] : "out/curva_aprendizaje.csv";
+    if (argc > 3) cfg.repeticiones = std::max(1, std::atoi(argv[3]));
+    if (argc > 4) cfg.hilos = std::atoi(argv[4]);
+    if (argc > 5) cfg.tasas = parsearLista(argv[5]);
+    if (argc > 6) cfg.Cs = parsearLista(argv[6]);
+
+    if (cfg.tasas.empty() || cfg.Cs.empty()) {
+        std::cerr << "Listas de tasas/C vacias\n";
+        return 1;
+    }
+
+    return ejecutarBarridoSVM(entrada, cfg, salida) ? 0 : 1;
 }
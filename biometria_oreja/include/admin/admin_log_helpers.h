@@ -21,6 +21,22 @@ void logRawLine(std::ofstream& log, const std::string& rid, const std::string& m
 void logBlank(std::ofstream& log, const std::string& rid);
 
 void logMensaje(std::ofstream& log, const std::string& rid, const std::string& msg);
+
+// Captura por hilo: mientras el objeto vive, logRaw() de ese hilo acumula en
+// memoria en vez de escribir (trabajo en paralelo que luego se vuelca en orden)
+class LogCaptura {
+public:
+    LogCaptura();
+    ~LogCaptura();
+    LogCaptura(const LogCaptura&) = delete;
+    LogCaptura& operator=(const LogCaptura&) = delete;
+
+    std::string tomar();   // devuelve lo acumulado y vacía el buffer
+
+private:
+    std::string buf_;
+    std::string* prev_ = nullptr;
+};
 void logBlank(std::ofstream& log);
 
 // Decoradores
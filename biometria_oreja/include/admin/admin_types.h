@@ -73,7 +73,7 @@ struct GrayStats {
 
 struct Imagen128 {
     std::unique_ptr<uint8_t[]> img128;
-    std::unique_ptr<uint8_t[]> mask128;
+    const uint8_t* mask128 = nullptr;   // PreprocWorkspace::mascara() (compartida)
     int w = 128;
     int h = 128;
 };
@@ -135,4 +135,5 @@ struct HoldoutMeta {
 struct ArgsBio {
     std::string rid = "no-rid";
     bool debug = false;
+    std::string trazaPadre; // --traza-padre: span del servidor (trazas por stderr)
 };
@@ -1,14 +1,39 @@
-/* #ifndef CURVA_APRENDIZAJE_H
+#ifndef CURVA_APRENDIZAJE_H
 #define CURVA_APRENDIZAJE_H
 
 #include <string>
 #include <vector>
 
+// Barrido de ensayos independientes (K clases x tasa x C x repeticion).
+// Cada ensayo elige K clases, divide por indices (entrenamiento/prueba por
+// clase) y entrena entrenarSVMOVA. Los ensayos corren en paralelo y cada
+// uno se agrega al CSV de salida al terminar: si el proceso se interrumpe,
+// la siguiente ejecucion con la misma salida retoma los pendientes.
+struct ConfigBarrido {
+    std::vector<int> clases_a_usar;
+    std::vector<double> tasas = { 0.05 };
+    std::vector<double> Cs = { 0.0001 };
+    int epocas = 7000;
+    double tolerancia = 1e-4;
+    int repeticiones = 3;
+    int entrenamiento_por_clase = 30;
+    int prueba_por_clase = 12;
+    int hilos = 0;                      // 0 = hardware_concurrency - 1
+    unsigned int seed_base = 123;
+};
+
+// Ejecuta (o retoma) el barrido. Escribe una fila por ensayo en rutaSalidaCSV
+// y el promedio/desviacion por (K, tasa, C) en <salida>_resumen.csv
+bool ejecutarBarridoSVM(const std::string& rutaCSV,
+    const ConfigBarrido& cfg,
+    const std::string& rutaSalidaCSV);
+
+// Curva de aprendizaje clasica: barrido solo sobre K con tasa/C fijos
 void generarCurvaAprendizaje(const std::string& rutaCSV,
     const std::vector<int>& clases_a_usar,
     int repeticiones,
     const std::string& rutaSalidaCSV,
-    unsigned int seed_base = 123);
+    unsigned int seed_base = 123,
+    int hilos = 0);
 
 #endif
- */
\ No newline at end of file
@@ -6,12 +6,73 @@
 #include <string>
 #include <cstdint>
 
+// Transformación afín 2x3 (origen -> destino):
+//   x' = a*x + b*y + tx
+//   y' = c*x + d*y + ty
+// Mismas convenciones que rotarImagen/trasladarImagen/escalarImagen/flipHorizontal
+// (centro en (ancho/2, alto/2) enteros) para poder encadenarlas en un solo warp.
+struct TransformacionAfin {
+    double a = 1.0, b = 0.0, tx = 0.0;
+    double c = 0.0, d = 1.0, ty = 0.0;
+
+    static TransformacionAfin rotacion(int ancho, int alto, double grados);
+    static TransformacionAfin traslacion(double dx, double dy);
+    static TransformacionAfin escala(int ancho, int alto, double factor);
+    static TransformacionAfin espejoHorizontal(int ancho);
+
+    // Aplica *this y después siguiente
+    TransformacionAfin luego(const TransformacionAfin& siguiente) const;
+    TransformacionAfin inversa() const;
+};
+
+// Compone la lista en orden (pasos[0] primero)
+TransformacionAfin componerTransformaciones(const std::vector<TransformacionAfin>& pasos);
+
+// Mapa de muestreo bilineal precalculado para una transformación y un tamaño.
+// Por píxel destino: índice de (x0, y0) en el origen y 4 pesos en punto fijo
+// (suman 1 << 14; todos 0 fuera de la imagen -> píxel 0). Reutilizable para
+// todas las imágenes del mismo tamaño.
+struct MapaWarp {
+    int ancho = 0;
+    int alto = 0;
+    std::vector<int32_t> offset;
+    std::vector<uint16_t> w00, w10, w01, w11;
+};
+
+void construirMapaWarp(const TransformacionAfin& t, int ancho, int alto, MapaWarp& mapa);
+void aplicarMapaWarp(const uint8_t* img, const MapaWarp& mapa, uint8_t* salida);
+
+// Warp directo (mapa temporal por hilo)
+void aplicarTransformacion(const uint8_t* img, int ancho, int alto, const TransformacionAfin& t, uint8_t* salida);
+
 // FASE 4 - Data Augmentation Geométrico (NO fotométrico)
+// Cada variante = rotación -> traslación -> zoom (flip opcional antes) en UN warp.
+struct ConfigAumentoGeometrico {
+    int variantes = 4;
+    double rotacionMax = 4.0;       // grados, uniforme [-r, r]
+    int traslacionMax = 1;          // píxeles, entero uniforme [-t, t]
+    double zoomMax = 0.01;          // factor uniforme [1-z, 1+z]
+    bool flip = false;              // espejo con probabilidad 0.5
+    // 0: flujo aleatorio por hilo (depende del reparto entre hilos).
+    // != 0: determinista por imagen, semilla ^ hash(nombreBase)
+    uint32_t semilla = 0;
+    // > 0: banco fijo de N transformaciones (muestreado una vez) con mapas
+    // compartidos por tamaño; cada imagen elige cfg.variantes distintas.
+    // 0: transformación continua nueva por variante.
+    int banco = 0;
+};
+
+// Escribe las variantes consecutivas (ancho*alto bytes cada una) en salida,
+// que debe tener cfg.variantes * ancho * alto bytes. Devuelve cuántas escribió.
+int aumentarGeometricoEnBuffer(const uint8_t* original, int ancho, int alto,
+    const std::string& nombreBase, const ConfigAumentoGeometrico& cfg, uint8_t* salida);
+
 // Genera variaciones geométricas consistentes de una imagen para aumentar dataset
 std::vector<std::pair<std::unique_ptr<uint8_t[]>, std::string>>
-aumentarImagenGeometrico(const uint8_t* original, int ancho, int alto, const std::string& nombreBase);
+aumentarImagenGeometrico(const uint8_t* original, int ancho, int alto, const std::string& nombreBase,
+    const ConfigAumentoGeometrico& cfg = ConfigAumentoGeometrico());
 
-// Transformaciones geométricas individuales
+// Transformaciones geométricas individuales (una pasada cada una)
 std::unique_ptr<uint8_t[]> rotarImagen(const uint8_t* img, int ancho, int alto, double angulo_grados);
 std::unique_ptr<uint8_t[]> trasladarImagen(const uint8_t* img, int ancho, int alto, int dx, int dy);
 std::unique_ptr<uint8_t[]> escalarImagen(const uint8_t* img, int ancho, int alto, double factor);
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 // Bilateral Filter (filtro bilateral)
 // Reduce ruido preservando bordes, ideal para preprocesar antes de extraer features
@@ -17,4 +18,19 @@
 std::unique_ptr<uint8_t[]> aplicarBilateral(const uint8_t* imagen, int ancho, int alto,
                                              double sigmaSpace, double sigmaColor);
 
+// Kernel espacial + tabla de pesos de color, calculados una vez para (sigmaSpace, sigmaColor)
+struct KernelBilateral {
+    int radio = 0;
+    std::vector<double> espacial;   // (2*radio+1)^2
+    double color[256] = {};
+
+    KernelBilateral() = default;
+    KernelBilateral(double sigmaSpace, double sigmaColor);
+    bool valido() const { return radio > 0; }
+};
+
+// Igual que aplicarBilateral, escribiendo en salida (ancho*alto bytes, distinta de imagen)
+bool aplicarBilateral(const uint8_t* imagen, int ancho, int alto,
+                      const KernelBilateral& kernel, uint8_t* salida);
+
 #endif
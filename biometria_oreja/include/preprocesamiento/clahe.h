@@ -17,4 +17,10 @@
 std::unique_ptr<uint8_t[]> aplicarCLAHE(const uint8_t* imagen, int ancho, int alto,
                                          int tilesX, int tilesY, double clipLimit);
 
+// Igual, escribiendo en salida (ancho*alto bytes, distinta de imagen).
+// luts: espacio de trabajo de tilesX*tilesY tablas
+bool aplicarCLAHE(const uint8_t* imagen, int ancho, int alto,
+                  int tilesX, int tilesY, double clipLimit,
+                  uint8_t* salida, uint8_t (*luts)[256]);
+
 #endif
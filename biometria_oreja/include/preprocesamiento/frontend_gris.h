@@ -0,0 +1,40 @@
+#ifndef FRONTEND_GRIS_H
+#define FRONTEND_GRIS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Front end fusionado para fotos de celular (8-12 MP) -> gris reducido:
+//   1) decodifica a 1 canal si el archivo ya es gris (si no, RGB)
+//   2) RGB -> gris (mismos pesos y redondeo que convertirAGris) en la misma
+//      pasada que la primera reducción por área 2x2
+//   3) más reducciones 2x2 (pirámide) mientras la mitad siga >= tamaño objetivo
+// El resample final (redimensionarParaBiometria) queda con escala < 2:
+// sin aliasing y sin recorrer megapíxeles con el bicúbico.
+//
+// La pirámide es opt-in (OREJA_FRONTEND=piramide): cambia las features, así que
+// dataset, modelo, umbrales y servidor deben usar el mismo front end. Por
+// defecto gris a resolución completa, como el modelo publicado en models/.
+
+// Buffers reutilizables entre imágenes (uno por hilo)
+struct BufferGris {
+    std::vector<uint8_t> a;
+    std::vector<uint8_t> b;
+};
+
+// Devuelve la imagen gris (apunta dentro de buf) o nullptr si no se pudo decodificar.
+// anchoOrig/altoOrig: tamaño del archivo; ancho/alto: tamaño de la salida.
+const uint8_t* cargarGrisReducida(const std::string& ruta, int anchoObj, int altoObj, BufferGris& buf,
+                                  int& ancho, int& alto, int& anchoOrig, int& altoOrig);
+
+// Igual, desde píxeles ya decodificados (canales = 1 o 3)
+const uint8_t* grisReducidaDesde(const uint8_t* pixeles, int anchoOrig, int altoOrig, int canales,
+                                 int anchoObj, int altoObj, BufferGris& buf, int& ancho, int& alto);
+
+// Reducción por área 2x2: salida de (ancho/2)x(alto/2), redondeo hacia abajo
+void reducirArea2x(const uint8_t* src, int ancho, int alto, uint8_t* dst);
+
+bool frontendPiramide();
+
+#endif
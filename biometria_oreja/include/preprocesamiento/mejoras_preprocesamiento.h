@@ -17,6 +17,7 @@ std::unique_ptr<uint8_t[]> redimensionarMascaraSimple(const uint8_t* imagen, int
 
 // Crea una máscara elíptica fija y consistente (FASE 1 - Solución 1A)
 std::unique_ptr<uint8_t[]> crearMascaraElipticaFija(int ancho, int alto);
+void crearMascaraElipticaFija(int ancho, int alto, uint8_t* mascara);
 
 // FASE 4 - Filtro Gaussiano consistente para reducir ruido de alta frecuencia
 std::unique_ptr<uint8_t[]> aplicarFiltroGaussiano(const uint8_t* imagen, int ancho, int alto, double sigma);
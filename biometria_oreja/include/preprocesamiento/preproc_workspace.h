@@ -0,0 +1,49 @@
+#ifndef PREPROC_WORKSPACE_H
+#define PREPROC_WORKSPACE_H
+
+#include "preprocesamiento/bilateral_filter.h"
+
+#include <cstdint>
+
+// Espacio de trabajo del preprocesamiento a 128x128 (FASE 6):
+//   resize -> CLAHE (8x8, clip 2.0) -> bilateral (σs=3, σc=50) + máscara fija
+// Reúne lo que antes se reservaba en cada imagen: buffers ping-pong, LUTs de
+// CLAHE, kernel/tabla del bilateral. La máscara elíptica es constante y se
+// comparte entre todos los workspaces. Uno por hilo (no es thread-safe):
+//   static thread_local PreprocWorkspace ws;
+// Resultado idéntico a redimensionarParaBiometria + aplicarCLAHE + aplicarBilateral.
+class PreprocWorkspace {
+public:
+    static constexpr int LADO = 128;
+    static constexpr int PIXELES = LADO * LADO;
+
+    PreprocWorkspace();
+
+    // Etapas sueltas (para medir/auditar cada una). salida: PIXELES bytes
+    bool redimensionar(const uint8_t* gris, int ancho, int alto, uint8_t* salida) const;
+    bool clahe(const uint8_t* img128, uint8_t* salida);
+    bool bilateral(const uint8_t* img128, uint8_t* salida) const;
+
+    // Pipeline completo. salida == nullptr: escribe en un buffer interno
+    // (válido hasta la siguiente llamada). Devuelve nullptr si falla.
+    const uint8_t* preprocesar(const uint8_t* gris, int ancho, int alto, uint8_t* salida = nullptr);
+
+    // Buffers ping-pong para encadenar etapas sin reservar memoria
+    uint8_t* bufferA() { return a; }
+    uint8_t* bufferB() { return b; }
+
+    // Máscara elíptica fija 128x128 (calculada una vez por proceso)
+    static const uint8_t* mascara();
+
+private:
+    static constexpr int TILES = 8;
+    static constexpr double CLIP_LIMIT = 2.0;
+
+    uint8_t a[PIXELES];
+    uint8_t b[PIXELES];
+    uint8_t resultado[PIXELES];
+    uint8_t luts[TILES * TILES][256];
+    KernelBilateral kernel;
+};
+
+#endif
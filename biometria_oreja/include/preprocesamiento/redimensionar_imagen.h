@@ -6,4 +6,7 @@
 
 std::unique_ptr<uint8_t[]> redimensionarParaBiometria(const uint8_t* imagen, int anchoOrig, int altoOrig, int anchoObj = 128, int altoObj = 128);
 
+// Igual, escribiendo en salida (anchoObj*altoObj bytes)
+bool redimensionarParaBiometria(const uint8_t* imagen, int anchoOrig, int altoOrig, uint8_t* salida, int anchoObj = 128, int altoObj = 128);
+
 #endif
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Kernel único de estadísticas de imagen en gris (QC, logs y análisis).
+// Una pasada arma el histograma de 256 bins; todas las métricas salen del histograma.
+
+struct EstadisticasGris {
+    long long n = 0;                  // píxeles considerados (ROI si hay máscara)
+    double mean = 0.0;
+    double stddev = 0.0;              // = RMS contrast (Peli 1990)
+    int minv = 255;
+    int maxv = 0;
+    double pct_dark = 0.0;            // % de píxeles <= dark_thr
+    double pct_bright = 0.0;          // % de píxeles >= bright_thr
+    double entropy = 0.0;             // Shannon (bits)
+    double michelson_contrast = 0.0;  // (max-min)/(max+min)
+};
+
+// Histograma en una pasada (4 sub-histogramas: sin dependencia entre stores consecutivos)
+void histogramaGris(const uint8_t* img, size_t n, uint32_t hist[256]);
+void histogramaGrisMasked(const uint8_t* img, const uint8_t* mask, size_t n, uint32_t hist[256]);
+
+EstadisticasGris estadisticasDesdeHistograma(const uint32_t hist[256], int dark_thr = 10, int bright_thr = 245);
+
+EstadisticasGris calcularEstadisticasGris(const uint8_t* img, int w, int h,
+                                          int dark_thr = 10, int bright_thr = 245);
+
+// Solo píxeles con mask != 0. ROI vacía: n = 0, pct_dark = 100, min = max = 0
+EstadisticasGris calcularEstadisticasGrisMasked(const uint8_t* img, const uint8_t* mask, int w, int h,
+                                                int dark_thr = 10, int bright_thr = 245);
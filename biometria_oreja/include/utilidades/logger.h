@@ -1,30 +1,62 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <atomic>
 #include <string>
-#include <fstream>
-#include <mutex>
 #include <chrono>
 
+#include "comun/trazas.h"
+
 enum LogLevel {
     LOG_DEBUG = 0,
     LOG_INFO  = 1,
     LOG_WARN  = 2,
-    LOG_ERROR = 3
+    LOG_ERROR = 3,
+    LOG_OFF   = 4      // solo para setLogLevel: no se registra nada
+};
+
+enum LogFormat {
+    LOG_FORMAT_TEXT = 0,   // "[INFO] [TAG] [rid] mensaje" (docker logs)
+    LOG_FORMAT_JSON = 1    // una línea JSON por registro: ts, level, tag, rid, thread, msg
 };
 
+// Nivel DEBUG removible en compilación: -DOREJA_LOG_DEBUG=0 (opción CMake OREJA_LOG_DEBUG)
+#ifndef OREJA_LOG_DEBUG
+#define OREJA_LOG_DEBUG 1
+#endif
+
+// Backend asíncrono:
+// - cada hilo encola en su propio anillo SPSC (sin mutex compartido en el camino
+//   caliente: el lock del anillo solo compite con el cierre)
+// - un hilo escritor drena los anillos, formatea y escribe en bloque
+// - si el anillo de un hilo se llena, el registro se descarta y se informa el total
+namespace logger_detail {
+extern std::atomic<int> g_min_level;
+}
+
+// Chequeo barato (sin lock): los macros lo usan ANTES de armar el mensaje
+inline bool logEnabled(LogLevel level) {
+    return (int)level >= logger_detail::g_min_level.load(std::memory_order_relaxed);
+}
+
 // Config
 void setLogLevel(LogLevel level);
-void setLogFile(const std::string& path);   // opcional: si no se llama, log solo a stdout
+LogLevel getLogLevel();
+void setLogFormat(LogFormat format);
+void setLogFile(const std::string& path);   // opcional: si no se llama, log solo a stderr
 std::string makeRequestId();
 
-// Log principal
+// Bloquea hasta que todo lo encolado antes de la llamada esté escrito
+void flushLogs();
+
+// Log principal (encola; el formateo y la escritura ocurren en el hilo escritor)
 void logMessage(LogLevel level,
                 const std::string& tag,
                 const std::string& rid,
                 const std::string& msg);
 
-// Scope RAII: mide duración y deja log de entrada/salida del bloque
+// Scope RAII: mide duración y deja log de entrada/salida del bloque.
+// También abre un span de traza (raíz si el hilo no tiene una y el rid sale muestreado)
 class LogScope {
 public:
     LogScope(const std::string& tag,
@@ -37,13 +69,21 @@ private:
     std::string rid_;
     std::string name_;
     std::chrono::steady_clock::time_point t0_;
+    trazas::Span span_;
 };
 
-// Macros cómodos
-#define LOGD(tag, rid, msg) logMessage(LOG_DEBUG, tag, rid, msg)
-#define LOGI(tag, rid, msg) logMessage(LOG_INFO,  tag, rid, msg)
-#define LOGW(tag, rid, msg) logMessage(LOG_WARN,  tag, rid, msg)
-#define LOGE(tag, rid, msg) logMessage(LOG_ERROR, tag, rid, msg)
+// Macros cómodos: msg solo se evalúa (concatenaciones incluidas) si el nivel está activo
+#define LOG_AT(level, tag, rid, msg) \
+    do { if (logEnabled(level)) logMessage(level, tag, rid, msg); } while (0)
+
+#if OREJA_LOG_DEBUG
+#define LOGD(tag, rid, msg) LOG_AT(LOG_DEBUG, tag, rid, msg)
+#else
+#define LOGD(tag, rid, msg) do { if (false) logMessage(LOG_DEBUG, tag, rid, msg); } while (0)
+#endif
+#define LOGI(tag, rid, msg) LOG_AT(LOG_INFO,  tag, rid, msg)
+#define LOGW(tag, rid, msg) LOG_AT(LOG_WARN,  tag, rid, msg)
+#define LOGE(tag, rid, msg) LOG_AT(LOG_ERROR, tag, rid, msg)
 
 #define LOG_SCOPE(tag, rid, name) LogScope _logscope_##__LINE__(tag, rid, name)
 
@@ -12,6 +12,10 @@ struct ModeloPCA {
 // Entrena modelo PCA completo (media + componentes)
 ModeloPCA entrenarPCA(const std::vector<std::vector<double>>& datos, int numComponentes);
 
+// Primeros numComponentes de un modelo ya entrenado. Las componentes se
+// extraen en orden (deflacion), asi que equivale a entrenarPCA con ese k
+ModeloPCA recortarModeloPCA(const ModeloPCA& modelo, int numComponentes);
+
 // Proyecta datos usando un modelo PCA existente
 std::vector<std::vector<double>> aplicarPCAConModelo(
     const std::vector<std::vector<double>>& datos,
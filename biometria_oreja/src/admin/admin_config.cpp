@@ -27,6 +27,7 @@ ArgsBio parseArgsBio(int argc, char** argv) {
         std::string s = argv[i];
         if (s == "--rid" && i + 1 < argc) a.rid = argv[++i];
         else if (s == "--debug") a.debug = true;
+        else if (s == "--traza-padre" && i + 1 < argc) a.trazaPadre = argv[++i];
     }
     return a;
 }
@@ -19,7 +19,27 @@ std::string mkLine(const std::string& rid, const std::string& msg) {
     return std::string("[BIO] [rid=") + rid + "] " + msg;
 }
 
+static thread_local std::string* g_captura = nullptr;
+
+LogCaptura::LogCaptura() : prev_(g_captura) {
+    g_captura = &buf_;
+}
+
+LogCaptura::~LogCaptura() {
+    g_captura = prev_;
+}
+
+std::string LogCaptura::tomar() {
+    std::string out;
+    out.swap(buf_);
+    return out;
+}
+
 void logRaw(std::ofstream& log, const std::string& text) {
+    if (g_captura) {
+        *g_captura += text;
+        return;
+    }
 #pragma omp critical(LOG_WRITE_BIO)
     {
         if (log.is_open()) {
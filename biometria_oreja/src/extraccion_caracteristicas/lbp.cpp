@@ -85,16 +85,16 @@
     }
 
     static inline int mapaLBPUniforme(uint8_t codigo) {
-        static std::array<int, 256> tabla;
-        static bool inicializado = false;
-        if (!inicializado) {
-            tabla.fill(58);
+        // Static local: inicialización única y thread-safe (se llama desde hilos OpenMP)
+        static const std::array<int, 256> tabla = [] {
+            std::array<int, 256> t;
+            t.fill(58);
             int bin = 0;
             for (int i = 0; i < 256; ++i) {
-                if (contarTransiciones(static_cast<uint8_t>(i)) <= 2) tabla[i] = bin++;
+                if (contarTransiciones(static_cast<uint8_t>(i)) <= 2) t[i] = bin++;
             }
-            inicializado = true;
-        }
+            return t;
+        }();
         return tabla[codigo];
     }
 
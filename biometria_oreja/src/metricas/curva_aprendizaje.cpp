@@ -1,173 +1,331 @@
-﻿/* #include "metricas/curva_aprendizaje.h"
+﻿#include "metricas/curva_aprendizaje.h"
 
 #include "svm/svm_entrenamiento.h"
 #include "svm/svm_prediccion.h"
 #include "metricas/svm_metricas.h"
-#include "utilidades/dividir_dataset.h"
 #include "svm/cargar_csv.h"
 
 #include <vector>
 #include <map>
+#include <set>
 #include <random>
 #include <fstream>
-#include <set>
+#include <sstream>
 #include <string>
 #include <algorithm>
 #include <numeric>
 #include <iostream>
 #include <filesystem>
 #include <iomanip>
+#include <cmath>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <tuple>
 
 namespace fs = std::filesystem;
 
-static void asegurarDirectorio(const std::string& rutaArchivo) {
-    fs::create_directories(fs::path(rutaArchivo).parent_path());
+namespace {
+
+const char* kCabeceraEnsayos = "num_clases,tasa,C,rep,accuracy,f1_macro,balanced_acc,mcc";
+
+struct Ensayo {
+    int num_clases;
+    double tasa;
+    double C;
+    int rep;
+};
+
+struct ResultadoEnsayo {
+    Ensayo e;
+    double accuracy = 0.0;
+    double f1_macro = 0.0;
+    double balanced_acc = 0.0;
+    double mcc = 0.0;
+};
+
+// tasa/C se escriben con precision fija para que la clave sobreviva el CSV
+std::string claveEnsayo(int num_clases, double tasa, double C, int rep) {
+    std::ostringstream ss;
+    ss << num_clases << "|" << std::setprecision(10) << tasa << "|" << C << "|" << rep;
+    return ss.str();
+}
+
+std::string claveEnsayo(const Ensayo& e) {
+    return claveEnsayo(e.num_clases, e.tasa, e.C, e.rep);
+}
+
+void escribirFila(std::ostream& out, const ResultadoEnsayo& r) {
+    out << r.e.num_clases << ","
+        << std::setprecision(10) << std::defaultfloat << r.e.tasa << "," << r.e.C << ","
+        << r.e.rep << ","
+        << std::fixed << std::setprecision(6)
+        << r.accuracy << "," << r.f1_macro << ","
+        << r.balanced_acc << "," << r.mcc << "\n";
 }
 
-static void escribirResumen(const std::string& rutaBase,
-    const std::vector<int>& ks,
-    const std::vector<double>& acc_mean,
-    const std::vector<double>& acc_std,
-    const std::vector<double>& f1_mean,
-    const std::vector<double>& f1_std,
-    const std::vector<double>& bacc_mean,
-    const std::vector<double>& bacc_std,
-    const std::vector<double>& mcc_mean,
-    const std::vector<double>& mcc_std) {
+// Lee los ensayos ya completados. false si el archivo existe con otro formato
+bool leerCheckpoint(const std::string& ruta, std::vector<ResultadoEnsayo>& hechos, bool& vacio) {
+    hechos.clear();
+    vacio = true;
+
+    std::ifstream in(ruta);
+    if (!in) return true;
+
+    std::string linea;
+    if (!std::getline(in, linea)) return true;
+    if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+    if (linea.empty()) return true;
+    vacio = false;
+    if (linea != kCabeceraEnsayos) return false;
+
+    while (std::getline(in, linea)) {
+        if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+        std::vector<std::string> campos;
+        std::stringstream ss(linea);
+        std::string campo;
+        while (std::getline(ss, campo, ',')) campos.push_back(campo);
+        // Fila truncada por una interrupcion a mitad de escritura: se repite
+        if (campos.size() != 8) continue;
+
+        try {
+            ResultadoEnsayo r;
+            r.e.num_clases = std::stoi(campos[0]);
+            r.e.tasa = std::stod(campos[1]);
+            r.e.C = std::stod(campos[2]);
+            r.e.rep = std::stoi(campos[3]);
+            r.accuracy = std::stod(campos[4]);
+            r.f1_macro = std::stod(campos[5]);
+            r.balanced_acc = std::stod(campos[6]);
+            r.mcc = std::stod(campos[7]);
+            hechos.push_back(r);
+        }
+        catch (...) {
+            continue;
+        }
+    }
+    return true;
+}
+
+// Un ensayo solo copia las filas de su propio train/test (K * (ent + pru)),
+// la seleccion de clases y el split se hacen sobre indices
+ResultadoEnsayo ejecutarEnsayo(const Ensayo& e,
+    const std::vector<std::vector<double>>& X,
+    const std::map<int, std::vector<size_t>>& porClase,
+    const std::vector<int>& clases_disponibles,
+    const ConfigBarrido& cfg) {
+    // Misma semilla para todos los (tasa, C) de un (K, rep): comparaciones pareadas
+    std::mt19937 gen(cfg.seed_base + e.rep + e.num_clases * 9973);
+    auto clases = clases_disponibles;
+    std::shuffle(clases.begin(), clases.end(), gen);
+    clases.resize(e.num_clases);
+
+    std::vector<std::vector<double>> X_train, X_test;
+    std::vector<int> y_train, y_test;
+    X_train.reserve((size_t)e.num_clases * cfg.entrenamiento_por_clase);
+    X_test.reserve((size_t)e.num_clases * cfg.prueba_por_clase);
+
+    for (int k = 0; k < e.num_clases; ++k) {
+        std::vector<size_t> idx = porClase.at(clases[k]);
+        std::shuffle(idx.begin(), idx.end(), gen);
+        for (int j = 0; j < cfg.entrenamiento_por_clase; ++j) {
+            X_train.push_back(X[idx[j]]);
+            y_train.push_back(k);
+        }
+        for (int j = 0; j < cfg.prueba_por_clase; ++j) {
+            X_test.push_back(X[idx[cfg.entrenamiento_por_clase + j]]);
+            y_test.push_back(k);
+        }
+    }
+
+    ModeloSVM modelo = entrenarSVMOVA(X_train, y_train, e.tasa, cfg.epocas, e.C, cfg.tolerancia);
+    std::vector<int> y_pred;
+    y_pred.reserve(y_test.size());
+    for (const auto& feat : X_test) y_pred.push_back(predecirPersona(feat, modelo));
+
+    ResultadosMetricas m = calcularMetricasAvanzadas(y_test, y_pred, e.num_clases);
+
+    ResultadoEnsayo r;
+    r.e = e;
+    r.accuracy = m.accuracy;
+    r.f1_macro = m.f1_macro;
+    r.balanced_acc = m.balanced_accuracy;
+    r.mcc = m.mcc;
+    return r;
+}
+
+void escribirResumen(const std::string& rutaBase,
+    const ConfigBarrido& cfg,
+    const std::vector<ResultadoEnsayo>& hechos) {
     const std::string ruta = fs::path(rutaBase).replace_filename(
         fs::path(rutaBase).stem().string() + "_resumen.csv"
     ).string();
     std::ofstream out(ruta);
     if (!out) return;
-    out << "num_clases,acc_mean,acc_std,f1_macro_mean,f1_macro_std,balanced_acc_mean,balanced_acc_std,mcc_mean,mcc_std\n";
-    out << std::fixed << std::setprecision(6);
-    for (size_t i = 0; i < ks.size(); ++i) {
-        out << ks[i] << ","
-            << acc_mean[i] << "," << acc_std[i] << ","
-            << f1_mean[i] << "," << f1_std[i] << ","
-            << bacc_mean[i] << "," << bacc_std[i] << ","
-            << mcc_mean[i] << "," << mcc_std[i] << "\n";
+
+    auto media = [](const std::vector<double>& v) {
+        if (v.empty()) return 0.0;
+        double s = std::accumulate(v.begin(), v.end(), 0.0);
+        return s / v.size();
+        };
+    auto stddev = [&](const std::vector<double>& v) {
+        if (v.size() < 2) return 0.0;
+        double mu = media(v), acc = 0.0;
+        for (double x : v) { double d = x - mu; acc += d * d; }
+        return std::sqrt(acc / (v.size() - 1));
+        };
+
+    std::map<std::string, const ResultadoEnsayo*> porClave;
+    for (const auto& r : hechos) porClave[claveEnsayo(r.e)] = &r;
+
+    out << "num_clases,tasa,C,repeticiones,acc_mean,acc_std,f1_macro_mean,f1_macro_std,balanced_acc_mean,balanced_acc_std,mcc_mean,mcc_std\n";
+    for (int num_clases : cfg.clases_a_usar) {
+        for (double tasa : cfg.tasas) {
+            for (double C : cfg.Cs) {
+                std::vector<double> accs, f1s, baccs, mccs;
+                for (int rep = 0; rep < cfg.repeticiones; ++rep) {
+                    auto it = porClave.find(claveEnsayo(num_clases, tasa, C, rep));
+                    if (it == porClave.end()) continue;
+                    accs.push_back(it->second->accuracy);
+                    f1s.push_back(it->second->f1_macro);
+                    baccs.push_back(it->second->balanced_acc);
+                    mccs.push_back(it->second->mcc);
+                }
+                out << num_clases << "," << std::setprecision(10) << std::defaultfloat
+                    << tasa << "," << C << "," << accs.size() << ","
+                    << std::fixed << std::setprecision(6)
+                    << media(accs) << "," << stddev(accs) << ","
+                    << media(f1s) << "," << stddev(f1s) << ","
+                    << media(baccs) << "," << stddev(baccs) << ","
+                    << media(mccs) << "," << stddev(mccs) << "\n";
+            }
+        }
     }
 }
 
-void generarCurvaAprendizaje(const std::string& rutaCSV,
-    const std::vector<int>& clases_a_usar,
-    int repeticiones,
-    const std::string& rutaSalidaCSV,
-    unsigned int seed_base) {
+} // namespace
+
+bool ejecutarBarridoSVM(const std::string& rutaCSV,
+    const ConfigBarrido& cfg,
+    const std::string& rutaSalidaCSV) {
     std::vector<std::vector<double>> X;
     std::vector<int> y;
     if (!cargarCSV(rutaCSV, X, y, ';')) {
         std::cerr << "No se pudo cargar el archivo " << rutaCSV << "\n";
-        return;
+        return false;
     }
 
-    // Agrupar por clase
-    std::map<int, std::vector<const std::vector<double>*>> porClasePtr;
-    for (size_t i = 0; i < y.size(); ++i) porClasePtr[y[i]].push_back(&X[i]);
+    // Agrupar por clase (indices, sin copiar filas)
+    std::map<int, std::vector<size_t>> porClase;
+    for (size_t i = 0; i < y.size(); ++i) porClase[y[i]].push_back(i);
 
-    asegurarDirectorio(rutaSalidaCSV);
-    std::ofstream salida(rutaSalidaCSV);
-    if (!salida) {
-        std::cerr << "No se pudo abrir salida: " << rutaSalidaCSV << "\n";
-        return;
+    const int soporteMinimo = cfg.entrenamiento_por_clase + cfg.prueba_por_clase;
+    std::vector<int> clases_disponibles;
+    for (const auto& kv : porClase) {
+        if ((int)kv.second.size() >= soporteMinimo) clases_disponibles.push_back(kv.first);
     }
-    salida << "num_clases,rep,accuracy,f1_macro,balanced_acc,mcc\n";
-    salida << std::fixed << std::setprecision(6);
-
-    // Acumuladores para resumen por K
-    std::vector<double> acc_mean, acc_std, f1_mean, f1_std, bacc_mean, bacc_std, mcc_mean, mcc_std;
-    acc_mean.reserve(clases_a_usar.size());
-    acc_std.reserve(clases_a_usar.size());
-    f1_mean.reserve(clases_a_usar.size());
-    f1_std.reserve(clases_a_usar.size());
-    bacc_mean.reserve(clases_a_usar.size());
-    bacc_std.reserve(clases_a_usar.size());
-    mcc_mean.reserve(clases_a_usar.size());
-    mcc_std.reserve(clases_a_usar.size());
-
-    for (int num_clases : clases_a_usar) {
-        std::vector<double> accs, f1s, baccs, mccs;
-        accs.reserve(repeticiones);
-        f1s.reserve(repeticiones);
-        baccs.reserve(repeticiones);
-        mccs.reserve(repeticiones);
-
-        // Armar lista de clases con mínimo soporte (>= 42 si vas a 30 train + 12 test)
-        std::vector<int> clases_disponibles;
-        for (const auto& kv : porClasePtr) {
-            if ((int)kv.second.size() >= 42) clases_disponibles.push_back(kv.first);
-        }
+
+    // Retomar: ensayos ya presentes en la salida no se repiten
+    std::error_code ec;
+    const fs::path carpeta = fs::path(rutaSalidaCSV).parent_path();
+    if (!carpeta.empty()) fs::create_directories(carpeta, ec);
+    std::vector<ResultadoEnsayo> hechos;
+    bool vacio = true;
+    if (!leerCheckpoint(rutaSalidaCSV, hechos, vacio)) {
+        std::cerr << "La salida " << rutaSalidaCSV << " tiene otro formato; "
+            << "use otra ruta o eliminela para empezar de cero\n";
+        return false;
+    }
+    std::set<std::string> completados;
+    for (const auto& r : hechos) completados.insert(claveEnsayo(r.e));
+
+    std::vector<Ensayo> pendientes;
+    for (int num_clases : cfg.clases_a_usar) {
         if ((int)clases_disponibles.size() < num_clases) {
             std::cerr << "No hay suficientes clases con soporte para K=" << num_clases << "\n";
-            acc_mean.push_back(0); acc_std.push_back(0);
-            f1_mean.push_back(0);  f1_std.push_back(0);
-            bacc_mean.push_back(0); bacc_std.push_back(0);
-            mcc_mean.push_back(0);  mcc_std.push_back(0);
             continue;
         }
-
-        for (int rep = 0; rep < repeticiones; ++rep) {
-            std::mt19937 gen(seed_base + rep + num_clases * 9973);
-            auto clases = clases_disponibles;
-            std::shuffle(clases.begin(), clases.end(), gen);
-            clases.resize(num_clases);
-
-            // Re-etiquetar a 0..K-1 y construir X_sel/y_sel
-            std::map<int, int> remap;
-            for (int k = 0; k < num_clases; ++k) remap[clases[k]] = k;
-
-            std::vector<std::vector<double>> X_sel;
-            std::vector<int> y_sel;
-            for (int c : clases) {
-                for (const auto* ptr : porClasePtr[c]) {
-                    X_sel.push_back(*ptr);
-                    y_sel.push_back(remap[c]);
+        for (double tasa : cfg.tasas)
+            for (double C : cfg.Cs)
+                for (int rep = 0; rep < cfg.repeticiones; ++rep) {
+                    Ensayo e{ num_clases, tasa, C, rep };
+                    if (!completados.count(claveEnsayo(e))) pendientes.push_back(e);
                 }
-            }
+    }
 
-            // Split estratificado (mantén tus parámetros 30/12 o cámbialos aquí)
-            std::vector<std::vector<double>> X_train, X_test;
-            std::vector<int> y_train, y_test;
-            dividirEstratificado(X_sel, y_sel, X_train, y_train, X_test, y_test, 30, 12);
-
-            // Entrenar y evaluar
-            ModeloSVM modelo = entrenarSVMOVA(X_train, y_train, 0.05, 7000, 0.0001, 1e-4);
-            std::vector<int> y_pred;
-            y_pred.reserve(y_test.size());
-            for (const auto& feat : X_test) y_pred.push_back(predecirPersona(feat, modelo));
-
-            ResultadosMetricas m = calcularMetricasAvanzadas(y_test, y_pred, num_clases);
-            accs.push_back(m.accuracy);
-            f1s.push_back(m.f1_macro);
-            baccs.push_back(m.balanced_accuracy);
-            mccs.push_back(m.mcc);
-
-            salida << num_clases << "," << rep << ","
-                << m.accuracy << "," << m.f1_macro << ","
-                << m.balanced_accuracy << "," << m.mcc << "\n";
-        }
+    std::ofstream salida(rutaSalidaCSV, std::ios::app);
+    if (!salida) {
+        std::cerr << "No se pudo abrir salida: " << rutaSalidaCSV << "\n";
+        return false;
+    }
+    if (vacio) {
+        salida << kCabeceraEnsayos << "\n" << std::flush;
+    } else {
+        // Una corrida cortada a mitad de linea: la siguiente fila no debe pegarse a ella
+        std::ifstream previo(rutaSalidaCSV, std::ios::binary);
+        char ultimo = '\n';
+        if (previo.seekg(-1, std::ios::end)) previo.get(ultimo);
+        if (ultimo != '\n') salida << "\n" << std::flush;
+    }
 
-        auto media = [](const std::vector<double>& v) {
-            if (v.empty()) return 0.0;
-            double s = std::accumulate(v.begin(), v.end(), 0.0);
-            return s / v.size();
-            };
-        auto stddev = [&](const std::vector<double>& v) {
-            if (v.size() < 2) return 0.0;
-            double mu = media(v), acc = 0.0;
-            for (double x : v) { double d = x - mu; acc += d * d; }
-            return std::sqrt(acc / (v.size() - 1));
-            };
-
-        acc_mean.push_back(media(accs));  acc_std.push_back(stddev(accs));
-        f1_mean.push_back(media(f1s));    f1_std.push_back(stddev(f1s));
-        bacc_mean.push_back(media(baccs)); bacc_std.push_back(stddev(baccs));
-        mcc_mean.push_back(media(mccs));  mcc_std.push_back(stddev(mccs));
+    size_t numHilos = cfg.hilos > 0 ? (size_t)cfg.hilos : 0;
+    if (numHilos == 0) {
+        const unsigned int hw = std::thread::hardware_concurrency();
+        numHilos = (hw == 0) ? 1 : (hw > 1 ? (hw - 1) : 1);
     }
+    numHilos = std::max<size_t>(1, std::min(numHilos, pendientes.size()));
+
+    std::cout << "Barrido: " << completados.size() << " ensayos retomados, "
+        << pendientes.size() << " pendientes, " << numHilos << " hilos\n";
+
+    std::atomic<size_t> siguiente{ 0 };
+    std::mutex mtxSalida;
+    size_t terminados = 0;
+
+    auto worker = [&]() {
+        while (true) {
+            size_t i = siguiente.fetch_add(1, std::memory_order_relaxed);
+            if (i >= pendientes.size()) break;
+
+            ResultadoEnsayo r = ejecutarEnsayo(pendientes[i], X, porClase, clases_disponibles, cfg);
+
+            // Checkpoint: la fila queda en disco antes de tomar el siguiente ensayo
+            std::lock_guard<std::mutex> lock(mtxSalida);
+            escribirFila(salida, r);
+            salida.flush();
+            hechos.push_back(r);
+            ++terminados;
+            std::cout << "Ensayo " << terminados << "/" << pendientes.size()
+                << " K=" << r.e.num_clases << " tasa=" << r.e.tasa << " C=" << r.e.C
+                << " rep=" << r.e.rep << " acc=" << std::fixed << std::setprecision(4)
+                << r.accuracy << std::defaultfloat << std::endl;
+        }
+    };
+
+    std::vector<std::thread> hilos;
+    hilos.reserve(numHilos);
+    for (size_t t = 0; t < numHilos; ++t) hilos.emplace_back(worker);
+    for (auto& h : hilos) h.join();
 
     salida.close();
-    escribirResumen(rutaSalidaCSV, clases_a_usar, acc_mean, acc_std, f1_mean, f1_std, bacc_mean, bacc_std, mcc_mean, mcc_std);
-    std::cout << "Curva de aprendizaje exportada: " << rutaSalidaCSV << "\n";
+    escribirResumen(rutaSalidaCSV, cfg, hechos);
+    std::cout << "Barrido exportado: " << rutaSalidaCSV << "\n";
+    return true;
+}
+
+void generarCurvaAprendizaje(const std::string& rutaCSV,
+    const std::vector<int>& clases_a_usar,
+    int repeticiones,
+    const std::string& rutaSalidaCSV,
+    unsigned int seed_base,
+    int hilos) {
+    ConfigBarrido cfg;
+    cfg.clases_a_usar = clases_a_usar;
+    cfg.repeticiones = repeticiones;
+    cfg.seed_base = seed_base;
+    cfg.hilos = hilos;
+
+    if (ejecutarBarridoSVM(rutaCSV, cfg, rutaSalidaCSV)) {
+        std::cout << "Curva de aprendizaje exportada: " << rutaSalidaCSV << "\n";
+    }
 }
- */
\ No newline at end of file
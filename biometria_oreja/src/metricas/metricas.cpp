@@ -1,8 +1,10 @@
 ﻿#include "metricas/metricas.h"
+#include "utilidades/estadisticas_gris.h"
 #include <vector>
 #include <cmath>
 #include <iostream>
 #include <numeric>
+#include <algorithm>
 
 std::pair<double, double> calcularPSNR_SNR(const uint8_t* ref, const uint8_t* res, int ancho, int alto) {
     const int total = ancho * alto;
@@ -19,17 +21,9 @@ std::pair<double, double> calcularPSNR_SNR(const uint8_t* ref, const uint8_t* re
 }
 
 double calcularEntropia(const uint8_t* imagen, int ancho, int alto) {
-    std::vector<int> hist(256, 0);
-    const int total = ancho * alto;
-    for (int i = 0; i < total; ++i) hist[imagen[i]]++;
-    double entropia = 0.0;
-    for (int h : hist) {
-        if (h > 0) {
-            const double p = static_cast<double>(h) / total;
-            entropia -= p * std::log2(p);
-        }
-    }
-    return entropia;
+    uint32_t hist[256];
+    histogramaGris(imagen, (size_t)std::max(0, ancho * alto), hist);
+    return estadisticasDesdeHistograma(hist).entropy;
 }
 
 double calcularSSIM(const uint8_t* img1, const uint8_t* img2, int ancho, int alto) {
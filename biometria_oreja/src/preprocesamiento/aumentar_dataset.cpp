@@ -6,6 +6,9 @@
 #include <algorithm>
 #include <random>
 #include <cstring> 
+#include <map>
+#include <mutex>
+#include <tuple>
 
 namespace {
 
@@ -203,37 +206,272 @@ std::unique_ptr<uint8_t[]> flipHorizontal(const uint8_t* img, int ancho, int alt
     return salida;
 }
 
+// ============================================================================
+// TRANSFORMACIONES AFINES + WARP FUSIONADO
+// ============================================================================
+// Encadenar rotarImagen -> trasladarImagen -> escalarImagen son 3 pasadas,
+// 3 reservas y 3 interpolaciones. Componiendo las matrices se muestrea el
+// original una sola vez por píxel.
+
+TransformacionAfin TransformacionAfin::rotacion(int ancho, int alto, double grados) {
+    const double rad = grados * M_PI / 180.0;
+    const double cs = std::cos(rad);
+    const double sn = std::sin(rad);
+    const double cx = ancho / 2;
+    const double cy = alto / 2;
+
+    TransformacionAfin t;
+    t.a = cs;  t.b = -sn; t.tx = cx - cs * cx + sn * cy;
+    t.c = sn;  t.d = cs;  t.ty = cy - sn * cx - cs * cy;
+    return t;
+}
+
+TransformacionAfin TransformacionAfin::traslacion(double dx, double dy) {
+    TransformacionAfin t;
+    t.tx = dx;
+    t.ty = dy;
+    return t;
+}
+
+TransformacionAfin TransformacionAfin::escala(int ancho, int alto, double factor) {
+    const double cx = ancho / 2;
+    const double cy = alto / 2;
+
+    TransformacionAfin t;
+    t.a = factor; t.tx = cx * (1.0 - factor);
+    t.d = factor; t.ty = cy * (1.0 - factor);
+    return t;
+}
+
+TransformacionAfin TransformacionAfin::espejoHorizontal(int ancho) {
+    TransformacionAfin t;
+    t.a = -1.0;
+    t.tx = ancho - 1;
+    return t;
+}
+
+TransformacionAfin TransformacionAfin::luego(const TransformacionAfin& s) const {
+    TransformacionAfin r;
+    r.a = s.a * a + s.b * c;
+    r.b = s.a * b + s.b * d;
+    r.c = s.c * a + s.d * c;
+    r.d = s.c * b + s.d * d;
+    r.tx = s.a * tx + s.b * ty + s.tx;
+    r.ty = s.c * tx + s.d * ty + s.ty;
+    return r;
+}
+
+TransformacionAfin TransformacionAfin::inversa() const {
+    const double det = a * d - b * c;
+    TransformacionAfin r;
+    if (std::fabs(det) < 1e-12) return r;
+    r.a = d / det;
+    r.b = -b / det;
+    r.c = -c / det;
+    r.d = a / det;
+    r.tx = -(r.a * tx + r.b * ty);
+    r.ty = -(r.c * tx + r.d * ty);
+    return r;
+}
+
+TransformacionAfin componerTransformaciones(const std::vector<TransformacionAfin>& pasos) {
+    TransformacionAfin t;
+    for (const auto& p : pasos) t = t.luego(p);
+    return t;
+}
+
+// Pesos bilineales con 7 bits de fracción: w00+w10+w01+w11 = 128*128 = 1 << 14
+void construirMapaWarp(const TransformacionAfin& t, int ancho, int alto, MapaWarp& mapa) {
+    const size_t n = static_cast<size_t>(ancho) * alto;
+    mapa.ancho = ancho;
+    mapa.alto = alto;
+    mapa.offset.assign(n, 0);
+    mapa.w00.assign(n, 0);
+    mapa.w10.assign(n, 0);
+    mapa.w01.assign(n, 0);
+    mapa.w11.assign(n, 0);
+    if (ancho < 2 || alto < 2) return;
+
+    // Coordenadas en punto fijo (1/128 px) desplazadas a positivo: el cast
+    // trunca = floor, sin llamar a std::floor/lround por píxel
+    constexpr double SESGO = 65536.0;
+    constexpr int SESGO_Q = 65536 * 128;
+
+    // Transformación inversa (del destino al origen)
+    const TransformacionAfin inv = t.inversa();
+    for (int y = 0; y < alto; ++y) {
+        for (int x = 0; x < ancho; ++x) {
+            const double src_x = std::clamp(inv.a * x + inv.b * y + inv.tx, -SESGO, SESGO);
+            const double src_y = std::clamp(inv.c * x + inv.d * y + inv.ty, -SESGO, SESGO);
+
+            const int sxq = static_cast<int>((src_x + SESGO) * 128.0 + 0.5) - SESGO_Q;
+            const int syq = static_cast<int>((src_y + SESGO) * 128.0 + 0.5) - SESGO_Q;
+            const int x0 = sxq >> 7;
+            const int y0 = syq >> 7;
+
+            // Mismo criterio de borde que rotarImagen/escalarImagen
+            if (x0 < 0 || x0 >= ancho - 1 || y0 < 0 || y0 >= alto - 1) continue;
+
+            const int qx = sxq & 127;
+            const int qy = syq & 127;
+
+            const size_t i = static_cast<size_t>(y) * ancho + x;
+            mapa.offset[i] = y0 * ancho + x0;
+            mapa.w00[i] = static_cast<uint16_t>((128 - qx) * (128 - qy));
+            mapa.w10[i] = static_cast<uint16_t>(qx * (128 - qy));
+            mapa.w01[i] = static_cast<uint16_t>((128 - qx) * qy);
+            mapa.w11[i] = static_cast<uint16_t>(qx * qy);
+        }
+    }
+}
+
+// Sin ramas: fuera de la imagen los pesos son 0 y offset apunta a (0,0)
+void aplicarMapaWarp(const uint8_t* img, const MapaWarp& mapa, uint8_t* salida) {
+    const int n = mapa.ancho * mapa.alto;
+    if (mapa.ancho < 2 || mapa.alto < 2) {
+        std::fill(salida, salida + n, 0);
+        return;
+    }
+
+    const int W = mapa.ancho;
+    const int32_t* off = mapa.offset.data();
+    const uint16_t* w00 = mapa.w00.data();
+    const uint16_t* w10 = mapa.w10.data();
+    const uint16_t* w01 = mapa.w01.data();
+    const uint16_t* w11 = mapa.w11.data();
+
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+    for (int i = 0; i < n; ++i) {
+        const uint8_t* p = img + off[i];
+        const uint32_t v = w00[i] * p[0] + w10[i] * p[1] + w01[i] * p[W] + w11[i] * p[W + 1];
+        salida[i] = static_cast<uint8_t>(v >> 14);
+    }
+}
+
+void aplicarTransformacion(const uint8_t* img, int ancho, int alto, const TransformacionAfin& t, uint8_t* salida) {
+    static thread_local MapaWarp mapa;
+    construirMapaWarp(t, ancho, alto, mapa);
+    aplicarMapaWarp(img, mapa, salida);
+}
+
 // ============================================================================
 // AUGMENTATION GEOMÉTRICO ALEATORIO (4 variaciones por imagen)
 // ============================================================================
 // Objetivo: Mejorar generalización con variabilidad real, evitando overfit
 // Rangos conservadores para no deformar la identidad:
-//   - rotación:  ±6°
-//   - traslación: ±2 px
-//   - zoom:      0.98–1.02
+//   - rotación:  ±4°
+//   - traslación: ±1 px
+//   - zoom:      0.99–1.01
 // ============================================================================
-std::vector<std::pair<std::unique_ptr<uint8_t[]>, std::string>>
-aumentarImagenGeometrico(const uint8_t* original, int ancho, int alto, const std::string& nombreBase) {
-    std::vector<std::pair<std::unique_ptr<uint8_t[]>, std::string>> out;
-    out.reserve(4);
+namespace {
+
+    // FNV-1a: estable entre compiladores (std::hash no lo es)
+    uint32_t hashNombre(const std::string& s) {
+        uint32_t h = 2166136261u;
+        for (unsigned char ch : s) {
+            h ^= ch;
+            h *= 16777619u;
+        }
+        return h;
+    }
 
-    static thread_local std::mt19937 gen{ 12345u };
-    std::uniform_real_distribution<double> rot_dist(-4.0, 4.0);
-    std::uniform_int_distribution<int> shift_dist(-1, 1);
-    std::uniform_real_distribution<double> zoom_dist(0.99, 1.01);
+    // Mismo orden de sorteo que la versión por pasadas (ang, dx, dy, zoom)
+    TransformacionAfin sortearTransformacion(int ancho, int alto, const ConfigAumentoGeometrico& cfg, std::mt19937& gen) {
+        std::uniform_real_distribution<double> rot_dist(-cfg.rotacionMax, cfg.rotacionMax);
+        std::uniform_int_distribution<int> shift_dist(-cfg.traslacionMax, cfg.traslacionMax);
+        std::uniform_real_distribution<double> zoom_dist(1.0 - cfg.zoomMax, 1.0 + cfg.zoomMax);
 
-    for (int i = 0; i < 4; ++i) {
         const double ang = rot_dist(gen);
         const int dx = shift_dist(gen);
         const int dy = shift_dist(gen);
         const double zoom = zoom_dist(gen);
 
-        auto temp1 = rotarImagen(original, ancho, alto, ang);
-        auto temp2 = trasladarImagen(temp1.get(), ancho, alto, dx, dy);
-        auto final = escalarImagen(temp2.get(), ancho, alto, zoom);
+        std::vector<TransformacionAfin> pasos;
+        pasos.reserve(4);
+        if (cfg.flip && std::bernoulli_distribution(0.5)(gen)) {
+            pasos.push_back(TransformacionAfin::espejoHorizontal(ancho));
+        }
+        pasos.push_back(TransformacionAfin::rotacion(ancho, alto, ang));
+        pasos.push_back(TransformacionAfin::traslacion(dx, dy));
+        pasos.push_back(TransformacionAfin::escala(ancho, alto, zoom));
+        return componerTransformaciones(pasos);
+    }
+
+    // Banco de mapas compartido entre hilos, uno por (tamaño, configuración)
+    using ClaveBanco = std::tuple<int, int, int, double, int, double, bool, uint32_t>;
 
-        out.emplace_back(std::move(final), nombreBase + "_aug" + std::to_string(i + 1));
+    std::shared_ptr<const std::vector<MapaWarp>> bancoMapas(int ancho, int alto, const ConfigAumentoGeometrico& cfg) {
+        static std::mutex mtx;
+        static std::map<ClaveBanco, std::shared_ptr<const std::vector<MapaWarp>>> bancos;
+
+        const ClaveBanco clave{ ancho, alto, cfg.banco, cfg.rotacionMax, cfg.traslacionMax,
+                                cfg.zoomMax, cfg.flip, cfg.semilla };
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = bancos.find(clave);
+        if (it != bancos.end()) return it->second;
+
+        std::mt19937 gen{ cfg.semilla != 0 ? cfg.semilla : 12345u };
+        auto mapas = std::make_shared<std::vector<MapaWarp>>(static_cast<size_t>(cfg.banco));
+        for (auto& m : *mapas) {
+            construirMapaWarp(sortearTransformacion(ancho, alto, cfg, gen), ancho, alto, m);
+        }
+        bancos.emplace(clave, mapas);
+        return mapas;
     }
 
-    return out;
 }
+
+int aumentarGeometricoEnBuffer(const uint8_t* original, int ancho, int alto,
+    const std::string& nombreBase, const ConfigAumentoGeometrico& cfg, uint8_t* salida) {
+    if (!original || !salida || ancho <= 0 || alto <= 0 || cfg.variantes <= 0) return 0;
+
+    static thread_local std::mt19937 genHilo{ 12345u };
+    std::mt19937 genImagen{ cfg.semilla ^ hashNombre(nombreBase) };
+    std::mt19937& gen = (cfg.semilla != 0) ? genImagen : genHilo;
+
+    const size_t pixeles = static_cast<size_t>(ancho) * alto;
+
+    if (cfg.banco > 0) {
+        // Variantes distintas del banco (Fisher-Yates parcial sobre índices)
+        const auto mapas = bancoMapas(ancho, alto, cfg);
+        const int n = std::min(cfg.variantes, cfg.banco);
+        static thread_local std::vector<int> indices;
+        indices.resize(static_cast<size_t>(cfg.banco));
+        for (int i = 0; i < cfg.banco; ++i) indices[i] = i;
+        for (int i = 0; i < n; ++i) {
+            std::uniform_int_distribution<int> pick(i, cfg.banco - 1);
+            std::swap(indices[i], indices[pick(gen)]);
+            aplicarMapaWarp(original, (*mapas)[indices[i]], salida + i * pixeles);
+        }
+        return n;
+    }
+
+    for (int i = 0; i < cfg.variantes; ++i) {
+        aplicarTransformacion(original, ancho, alto,
+            sortearTransformacion(ancho, alto, cfg, gen), salida + i * pixeles);
+    }
+    return cfg.variantes;
+}
+
+std::vector<std::pair<std::unique_ptr<uint8_t[]>, std::string>>
+aumentarImagenGeometrico(const uint8_t* original, int ancho, int alto, const std::string& nombreBase,
+    const ConfigAumentoGeometrico& cfg) {
+    std::vector<std::pair<std::unique_ptr<uint8_t[]>, std::string>> out;
+    if (cfg.variantes <= 0) return out;
+
+    const size_t pixeles = static_cast<size_t>(ancho) * alto;
+    static thread_local std::vector<uint8_t> buffer;
+    buffer.resize(pixeles * cfg.variantes);
+
+    const int n = aumentarGeometricoEnBuffer(original, ancho, alto, nombreBase, cfg, buffer.data());
+    out.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        auto img = std::make_unique<uint8_t[]>(pixeles);
+        std::memcpy(img.get(), buffer.data() + i * pixeles, pixeles);
+        out.emplace_back(std::move(img), nombreBase + "_aug" + std::to_string(i + 1));
+    }
+
+    return out;
+}
\ No newline at end of file
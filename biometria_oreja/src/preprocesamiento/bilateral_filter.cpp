@@ -26,6 +26,21 @@ namespace {
     }
 }
 
+KernelBilateral::KernelBilateral(double sigmaSpace, double sigmaColor) {
+    if (sigmaSpace <= 0 || sigmaColor <= 0) return;
+
+    // Radio del kernel (típicamente 2-3 veces sigma)
+    radio = static_cast<int>(std::ceil(3.0 * sigmaSpace));
+    if (radio < 1) radio = 1;
+
+    // Pre-calcular kernel espacial
+    espacial.resize((2 * radio + 1) * (2 * radio + 1));
+    calcularKernelEspacial(sigmaSpace, radio, espacial.data());
+
+    // Pre-calcular tabla de pesos de color (evita std::exp en loop interno)
+    calcularTablaPesosColor(sigmaColor, color);
+}
+
 std::unique_ptr<uint8_t[]> aplicarBilateral(const uint8_t* imagen, int ancho, int alto,
                                              double sigmaSpace, double sigmaColor) {
     if (!imagen || ancho <= 0 || alto <= 0 || sigmaSpace <= 0 || sigmaColor <= 0) {
@@ -33,21 +48,20 @@ std::unique_ptr<uint8_t[]> aplicarBilateral(const uint8_t* imagen, int ancho, in
     }
 
     auto salida = std::make_unique<uint8_t[]>(ancho * alto);
+    const KernelBilateral kernel(sigmaSpace, sigmaColor);
+    aplicarBilateral(imagen, ancho, alto, kernel, salida.get());
+    return salida;
+}
 
-    // Radio del kernel (típicamente 2-3 veces sigma)
-    int radio = static_cast<int>(std::ceil(3.0 * sigmaSpace));
-    if (radio < 1) radio = 1;
-
-    // Pre-calcular kernel espacial
-    int kernelSize = (2 * radio + 1) * (2 * radio + 1);
-    auto kernelEspacial = std::make_unique<double[]>(kernelSize);
-    calcularKernelEspacial(sigmaSpace, radio, kernelEspacial.get());
-
-    // Pre-calcular tabla de pesos de color (evita std::exp en loop interno)
-    double tablaPesosColor[256];
-    calcularTablaPesosColor(sigmaColor, tablaPesosColor);
+bool aplicarBilateral(const uint8_t* imagen, int ancho, int alto,
+                      const KernelBilateral& kernel, uint8_t* salida) {
+    if (!imagen || !salida || ancho <= 0 || alto <= 0 || !kernel.valido()) {
+        return false;
+    }
 
-    const double* kEsp = kernelEspacial.get();
+    const int radio = kernel.radio;
+    const double* kEsp = kernel.espacial.data();
+    const double* tablaPesosColor = kernel.color;
     const int kernelWidth = 2 * radio + 1;
 
     // Aplicar filtro bilateral con OpenMP
@@ -98,5 +112,5 @@ std::unique_ptr<uint8_t[]> aplicarBilateral(const uint8_t* imagen, int ancho, in
         }
     }
 
-    return salida;
+    return true;
 }
@@ -108,13 +108,24 @@ std::unique_ptr<uint8_t[]> aplicarCLAHE(const uint8_t* imagen, int ancho, int al
     // Crear imagen de salida
     auto salida = std::make_unique<uint8_t[]>(ancho * alto);
 
+    // Crear LUTs para cada tile
+    auto luts = std::make_unique<uint8_t[][256]>(tilesX * tilesY);
+
+    aplicarCLAHE(imagen, ancho, alto, tilesX, tilesY, clipLimit, salida.get(), luts.get());
+    return salida;
+}
+
+bool aplicarCLAHE(const uint8_t* imagen, int ancho, int alto,
+                  int tilesX, int tilesY, double clipLimit,
+                  uint8_t* salida, uint8_t (*luts)[256]) {
+    if (!imagen || !salida || !luts || ancho <= 0 || alto <= 0 || tilesX <= 0 || tilesY <= 0) {
+        return false;
+    }
+
     // Calcular dimensiones de cada tile
     int tileW = (ancho + tilesX - 1) / tilesX;
     int tileH = (alto + tilesY - 1) / tilesY;
 
-    // Crear LUTs para cada tile
-    auto luts = std::make_unique<uint8_t[][256]>(tilesX * tilesY);
-
     // Procesar cada tile
     for (int tileY_idx = 0; tileY_idx < tilesY; ++tileY_idx) {
         for (int tileX_idx = 0; tileX_idx < tilesX; ++tileX_idx) {
@@ -210,5 +221,5 @@ std::unique_ptr<uint8_t[]> aplicarCLAHE(const uint8_t* imagen, int ancho, int al
         }
     }
 
-    return salida;
+    return true;
 }
@@ -0,0 +1,132 @@
+#include "preprocesamiento/frontend_gris.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+constexpr float WR = 0.35f, WG = 0.45f, WB = 0.20f;   // = convertirAGris
+constexpr int PIXELES_MIN_OMP = 1 << 16;
+
+inline uint8_t grisDe(const uint8_t* p) {
+    float g = WR * p[0] + WG * p[1] + WB * p[2];
+    return static_cast<uint8_t>(std::clamp(std::round(g), 0.0f, 255.0f));
+}
+
+// Siguiente nivel de la pirámide: la mitad todavía cubre el objetivo
+inline bool conviene2x(int ancho, int alto, int anchoObj, int altoObj) {
+    return frontendPiramide() && ancho / 2 >= anchoObj && alto / 2 >= altoObj;
+}
+
+void grisCompleto(const uint8_t* rgb, int ancho, int alto, uint8_t* dst) {
+    const int n = ancho * alto;
+#pragma omp parallel for schedule(static) if (n > PIXELES_MIN_OMP)
+    for (int y = 0; y < alto; ++y) {
+        const uint8_t* s = rgb + (size_t)y * ancho * 3;
+        uint8_t* d = dst + (size_t)y * ancho;
+        for (int x = 0; x < ancho; ++x) d[x] = grisDe(s + 3 * x);
+    }
+}
+
+// RGB -> gris + 2x2 en una pasada (el gris de cada píxel es idéntico al de convertirAGris)
+void grisReducido2x(const uint8_t* rgb, int ancho, int alto, uint8_t* dst) {
+    const int aw = ancho / 2, ah = alto / 2;
+#pragma omp parallel for schedule(static) if (aw * ah > PIXELES_MIN_OMP)
+    for (int y = 0; y < ah; ++y) {
+        const uint8_t* f0 = rgb + (size_t)(2 * y) * ancho * 3;
+        const uint8_t* f1 = f0 + (size_t)ancho * 3;
+        uint8_t* d = dst + (size_t)y * aw;
+        for (int x = 0; x < aw; ++x) {
+            const int s = grisDe(f0 + 6 * x) + grisDe(f0 + 6 * x + 3) +
+                          grisDe(f1 + 6 * x) + grisDe(f1 + 6 * x + 3);
+            d[x] = static_cast<uint8_t>((s + 2) >> 2);
+        }
+    }
+}
+
+} // namespace
+
+bool frontendPiramide() {
+    static const bool piramide = [] {
+        const char* v = std::getenv("OREJA_FRONTEND");
+        return v && std::string(v) == "piramide";
+    }();
+    return piramide;
+}
+
+void reducirArea2x(const uint8_t* src, int ancho, int alto, uint8_t* dst) {
+    const int aw = ancho / 2, ah = alto / 2;
+#pragma omp parallel for schedule(static) if (aw * ah > PIXELES_MIN_OMP)
+    for (int y = 0; y < ah; ++y) {
+        const uint8_t* f0 = src + (size_t)(2 * y) * ancho;
+        const uint8_t* f1 = f0 + ancho;
+        uint8_t* d = dst + (size_t)y * aw;
+        for (int x = 0; x < aw; ++x) {
+            const int s = f0[2 * x] + f0[2 * x + 1] + f1[2 * x] + f1[2 * x + 1];
+            d[x] = static_cast<uint8_t>((s + 2) >> 2);
+        }
+    }
+}
+
+const uint8_t* grisReducidaDesde(const uint8_t* pixeles, int anchoOrig, int altoOrig, int canales,
+                                 int anchoObj, int altoObj, BufferGris& buf, int& ancho, int& alto) {
+    ancho = alto = 0;
+    if (!pixeles || anchoOrig <= 0 || altoOrig <= 0 || (canales != 1 && canales != 3)) return nullptr;
+
+    int w = anchoOrig, h = altoOrig;
+    const uint8_t* actual = pixeles;
+
+    // Nivel 0: pasar a gris en buf.a (fusionado con la primera reducción si corresponde)
+    if (conviene2x(w, h, anchoObj, altoObj)) {
+        buf.a.resize((size_t)(w / 2) * (h / 2));
+        if (canales == 3) grisReducido2x(actual, w, h, buf.a.data());
+        else reducirArea2x(actual, w, h, buf.a.data());
+        w /= 2;
+        h /= 2;
+    } else {
+        buf.a.resize((size_t)w * h);
+        if (canales == 3) grisCompleto(actual, w, h, buf.a.data());
+        else std::copy(actual, actual + (size_t)w * h, buf.a.begin());
+    }
+    actual = buf.a.data();
+
+    // Pirámide: ping-pong entre a y b
+    std::vector<uint8_t>* destino = &buf.b;
+    while (conviene2x(w, h, anchoObj, altoObj)) {
+        destino->resize((size_t)(w / 2) * (h / 2));
+        reducirArea2x(actual, w, h, destino->data());
+        w /= 2;
+        h /= 2;
+        actual = destino->data();
+        destino = (destino == &buf.b) ? &buf.a : &buf.b;
+    }
+
+    ancho = w;
+    alto = h;
+    return actual;
+}
+
+const uint8_t* cargarGrisReducida(const std::string& ruta, int anchoObj, int altoObj, BufferGris& buf,
+                                  int& ancho, int& alto, int& anchoOrig, int& altoOrig) {
+    ancho = alto = anchoOrig = altoOrig = 0;
+
+    // Archivo ya en gris (o gris+alfa): decodificar a 1 canal, sin pasar por RGB
+    int w = 0, h = 0, comp = 0;
+    const int pedir = (stbi_info(ruta.c_str(), &w, &h, &comp) && comp <= 2) ? 1 : 3;
+
+    unsigned char* datos = stbi_load(ruta.c_str(), &w, &h, &comp, pedir);
+    if (!datos) {
+        std::cerr << "Error al cargar la imagen: " << ruta << std::endl;
+        return nullptr;
+    }
+
+    anchoOrig = w;
+    altoOrig = h;
+    const uint8_t* out = grisReducidaDesde(datos, w, h, pedir, anchoObj, altoObj, buf, ancho, alto);
+    stbi_image_free(datos);
+    return out;
+}
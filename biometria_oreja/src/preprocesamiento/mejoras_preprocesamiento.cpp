@@ -147,7 +147,12 @@ std::unique_ptr<uint8_t[]> redimensionarMascaraSimple(const uint8_t* imagen, int
 // ============================================================================
 std::unique_ptr<uint8_t[]> crearMascaraElipticaFija(int ancho, int alto) {
     auto mascara = std::make_unique<uint8_t[]>(ancho * alto);
-    std::fill(mascara.get(), mascara.get() + ancho * alto, 0);
+    crearMascaraElipticaFija(ancho, alto, mascara.get());
+    return mascara;
+}
+
+void crearMascaraElipticaFija(int ancho, int alto, uint8_t* mascara) {
+    std::fill(mascara, mascara + ancho * alto, 0);
 
     // Centro de la elipse
     float cx = ancho * 0.5f;
@@ -169,8 +174,6 @@ std::unique_ptr<uint8_t[]> crearMascaraElipticaFija(int ancho, int alto) {
             }
         }
     }
-
-    return mascara;
 }
 
 // ============================================================================
@@ -0,0 +1,34 @@
+#include "preprocesamiento/preproc_workspace.h"
+#include "preprocesamiento/redimensionar_imagen.h"
+#include "preprocesamiento/clahe.h"
+#include "preprocesamiento/mejoras_preprocesamiento.h"
+
+PreprocWorkspace::PreprocWorkspace() : kernel(3.0, 50.0) {}
+
+bool PreprocWorkspace::redimensionar(const uint8_t* gris, int ancho, int alto, uint8_t* salida) const {
+    return redimensionarParaBiometria(gris, ancho, alto, salida, LADO, LADO);
+}
+
+bool PreprocWorkspace::clahe(const uint8_t* img128, uint8_t* salida) {
+    return aplicarCLAHE(img128, LADO, LADO, TILES, TILES, CLIP_LIMIT, salida, luts);
+}
+
+bool PreprocWorkspace::bilateral(const uint8_t* img128, uint8_t* salida) const {
+    return aplicarBilateral(img128, LADO, LADO, kernel, salida);
+}
+
+const uint8_t* PreprocWorkspace::preprocesar(const uint8_t* gris, int ancho, int alto, uint8_t* salida) {
+    uint8_t* destino = salida ? salida : resultado;
+    if (!redimensionar(gris, ancho, alto, a)) return nullptr;
+    if (!clahe(a, b)) return nullptr;
+    if (!bilateral(b, destino)) return nullptr;
+    return destino;
+}
+
+const uint8_t* PreprocWorkspace::mascara() {
+    static const struct MascaraFija {
+        uint8_t px[PIXELES];
+        MascaraFija() { crearMascaraElipticaFija(LADO, LADO, px); }
+    } fija;
+    return fija.px;
+}
@@ -28,6 +28,13 @@ std::unique_ptr<uint8_t[]> redimensionarParaBiometria(const uint8_t* imagen, int
     if (!imagen || anchoOrig <= 0 || altoOrig <= 0 || anchoObj <= 0 || altoObj <= 0) return nullptr;
 
     auto salida = std::make_unique<uint8_t[]>(anchoObj * altoObj);
+    redimensionarParaBiometria(imagen, anchoOrig, altoOrig, salida.get(), anchoObj, altoObj);
+    return salida;
+}
+
+bool redimensionarParaBiometria(const uint8_t* imagen, int anchoOrig, int altoOrig,
+    uint8_t* salida, int anchoObj, int altoObj) {
+    if (!imagen || !salida || anchoOrig <= 0 || altoOrig <= 0 || anchoObj <= 0 || altoObj <= 0) return false;
 
     float ratioOrig = static_cast<float>(anchoOrig) / altoOrig;
     float ratioObj = static_cast<float>(anchoObj) / altoObj;
@@ -37,8 +44,8 @@ std::unique_ptr<uint8_t[]> redimensionarParaBiometria(const uint8_t* imagen, int
         // Redimensionamiento directo usando interpolación bicúbica
         float escala = static_cast<float>(anchoOrig) / anchoObj;
 
-        std::for_each(EXEC_POLICY, salida.get(), salida.get() + anchoObj * altoObj, [&](uint8_t& px) {
-            int idx = &px - salida.get();
+        std::for_each(EXEC_POLICY, salida, salida + anchoObj * altoObj, [&](uint8_t& px) {
+            int idx = &px - salida;
             int x = idx % anchoObj;
             int y = idx / anchoObj;
 
@@ -72,10 +79,10 @@ std::unique_ptr<uint8_t[]> redimensionarParaBiometria(const uint8_t* imagen, int
         int offsetX = (anchoObj - nuevoAncho) / 2;
         int offsetY = (altoObj - nuevoAlto) / 2;
 
-        std::fill(salida.get(), salida.get() + anchoObj * altoObj, 0);
+        std::fill(salida, salida + anchoObj * altoObj, 0);
 
-        std::for_each(std::execution::par, salida.get(), salida.get() + anchoObj * altoObj, [&](uint8_t& px) {
-            int idx = &px - salida.get();
+        std::for_each(std::execution::par, salida, salida + anchoObj * altoObj, [&](uint8_t& px) {
+            int idx = &px - salida;
             int x = idx % anchoObj;
             int y = idx / anchoObj;
 
@@ -104,5 +111,5 @@ std::unique_ptr<uint8_t[]> redimensionarParaBiometria(const uint8_t* imagen, int
             });
     }
 
-    return salida;
+    return true;
 }
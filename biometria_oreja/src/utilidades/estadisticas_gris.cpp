@@ -0,0 +1,98 @@
+#include "utilidades/estadisticas_gris.h"
+
+#include <cmath>
+#include <cstring>
+
+void histogramaGris(const uint8_t* img, size_t n, uint32_t hist[256]) {
+    uint32_t h[4][256];
+    std::memset(h, 0, sizeof(h));
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        ++h[0][img[i]];
+        ++h[1][img[i + 1]];
+        ++h[2][img[i + 2]];
+        ++h[3][img[i + 3]];
+    }
+    for (; i < n; ++i) ++h[0][img[i]];
+
+    for (int v = 0; v < 256; ++v) hist[v] = h[0][v] + h[1][v] + h[2][v] + h[3][v];
+}
+
+void histogramaGrisMasked(const uint8_t* img, const uint8_t* mask, size_t n, uint32_t hist[256]) {
+    // Bin 256 = fuera de ROI (sin saltos en el bucle)
+    uint32_t h[4][257];
+    std::memset(h, 0, sizeof(h));
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        ++h[0][mask[i] ? img[i] : 256];
+        ++h[1][mask[i + 1] ? img[i + 1] : 256];
+        ++h[2][mask[i + 2] ? img[i + 2] : 256];
+        ++h[3][mask[i + 3] ? img[i + 3] : 256];
+    }
+    for (; i < n; ++i) ++h[0][mask[i] ? img[i] : 256];
+
+    for (int v = 0; v < 256; ++v) hist[v] = h[0][v] + h[1][v] + h[2][v] + h[3][v];
+}
+
+EstadisticasGris estadisticasDesdeHistograma(const uint32_t hist[256], int dark_thr, int bright_thr) {
+    EstadisticasGris s;
+
+    long long n = 0, sum = 0, sum2 = 0, c_dark = 0, c_bright = 0;
+    for (int v = 0; v < 256; ++v) {
+        const long long c = hist[v];
+        if (c == 0) continue;
+        n += c;
+        sum += c * v;
+        sum2 += c * v * v;
+        if (v < s.minv) s.minv = v;
+        s.maxv = v;
+        if (v <= dark_thr) c_dark += c;
+        if (v >= bright_thr) c_bright += c;
+    }
+
+    s.n = n;
+    if (n == 0) return s;
+
+    s.mean = (double)sum / (double)n;
+    double var = (double)sum2 / (double)n - s.mean * s.mean;
+    if (var < 0) var = 0;
+    s.stddev = std::sqrt(var);
+    s.pct_dark = 100.0 * (double)c_dark / (double)n;
+    s.pct_bright = 100.0 * (double)c_bright / (double)n;
+
+    for (int v = 0; v < 256; ++v) {
+        if (hist[v] > 0) {
+            const double p = (double)hist[v] / (double)n;
+            s.entropy -= p * std::log2(p);
+        }
+    }
+
+    if (s.maxv + s.minv > 0) {
+        s.michelson_contrast = (double)(s.maxv - s.minv) / (double)(s.maxv + s.minv);
+    }
+    return s;
+}
+
+EstadisticasGris calcularEstadisticasGris(const uint8_t* img, int w, int h, int dark_thr, int bright_thr) {
+    if (!img || w <= 0 || h <= 0) return EstadisticasGris{};
+    uint32_t hist[256];
+    histogramaGris(img, (size_t)w * h, hist);
+    return estadisticasDesdeHistograma(hist, dark_thr, bright_thr);
+}
+
+EstadisticasGris calcularEstadisticasGrisMasked(const uint8_t* img, const uint8_t* mask, int w, int h,
+                                                int dark_thr, int bright_thr) {
+    if (!img || !mask || w <= 0 || h <= 0) return EstadisticasGris{};
+    uint32_t hist[256];
+    histogramaGrisMasked(img, mask, (size_t)w * h, hist);
+
+    EstadisticasGris s = estadisticasDesdeHistograma(hist, dark_thr, bright_thr);
+    if (s.n == 0) {
+        s.pct_dark = 100.0;
+        s.minv = 0;
+        s.maxv = 0;
+    }
+    return s;
+}
@@ -1,37 +1,67 @@
 #include "utilidades/logger.h"
-#include <iostream>
-#include <iomanip>
-#include <sstream>
-#include <random>
-#include <thread>
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
 #include <ctime>
-#include <mutex>
 #include <fstream>
-#include <chrono>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
 
-static std::mutex g_log_mutex;
-static LogLevel g_level = LOG_INFO;
-static std::ofstream g_file;
-static bool g_file_enabled = false;
+namespace logger_detail {
+std::atomic<int> g_min_level{LOG_INFO};
+}
 
-static std::string nowTs() {
-    using namespace std::chrono;
-    auto now = system_clock::now();
-    auto t = system_clock::to_time_t(now);
+namespace {
 
-    std::tm tm{};
-#if defined(_WIN32)
-    localtime_s(&tm, &t);
-#else
-    localtime_r(&t, &tm);
-#endif
+struct LogRecord {
+    uint64_t seq = 0;
+    LogLevel level = LOG_INFO;
+    std::chrono::system_clock::time_point ts;
+    uint32_t thread = 0;
+    std::string tag;
+    std::string rid;
+    std::string msg;
+};
 
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
-}
+// Anillo SPSC: productor = hilo dueño, consumidor = hilo escritor
+constexpr size_t kRingSize = 1024;   // potencia de 2
+
+struct LogRing {
+    std::array<LogRecord, kRingSize> slots;
+    std::atomic<size_t> head{0};     // lo avanza el productor
+    std::atomic<size_t> tail{0};     // lo avanza el escritor
+    std::atomic<bool> alive{true};   // false cuando el hilo dueño termina
+    uint32_t thread = 0;
+    // Chequeo de stopped_ + push atómicos frente al drenado final de stop().
+    // Sin contención salvo en el cierre: solo lo toman el dueño y stop()
+    std::mutex pushMutex;
 
-static const char* levelStr(LogLevel lv) {
+    bool push(LogRecord&& r) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= kRingSize) return false;
+        slots[h & (kRingSize - 1)] = std::move(r);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t pending() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+    }
+
+    void drain(std::vector<LogRecord>& out) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        const size_t h = head.load(std::memory_order_acquire);
+        for (; t < h; ++t) out.push_back(std::move(slots[t & (kRingSize - 1)]));
+        tail.store(t, std::memory_order_release);
+    }
+};
+
+const char* levelStr(LogLevel lv) {
     switch (lv) {
         case LOG_DEBUG: return "DEBUG";
         case LOG_INFO:  return "INFO";
@@ -41,86 +71,364 @@ static const char* levelStr(LogLevel lv) {
     }
 }
 
-void setLogLevel(LogLevel level) {
-    std::lock_guard<std::mutex> lk(g_log_mutex);
-    g_level = level;
+void appendJsonString(std::string& out, const std::string& s) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    out += '"';
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            default:
+                if (c < 0x20) {
+                    out += "\\u00";
+                    out += kHex[c >> 4];
+                    out += kHex[c & 15];
+                } else {
+                    out += (char)c;
+                }
+        }
+    }
+    out += '"';
 }
 
-void setLogFile(const std::string& path) {
-    std::lock_guard<std::mutex> lk(g_log_mutex);
-    if (g_file.is_open()) g_file.close();
-    g_file.open(path, std::ios::app);
-    g_file_enabled = g_file.is_open();
-}
+class LogWriter {
+public:
+    static LogWriter& instance() {
+        // Nunca se destruye: hilos que loguean durante el cierre no tocan memoria liberada
+        static LogWriter* w = [] {
+            auto* p = new LogWriter();
+            std::atexit([] { LogWriter::instance().stop(); });
+            return p;
+        }();
+        return *w;
+    }
 
-std::string makeRequestId() {
-    // corto pero suficiente para defensa
-    static thread_local std::mt19937 rng((unsigned)std::chrono::high_resolution_clock::now().time_since_epoch().count());
-    std::uniform_int_distribution<int> dist(0, 15);
+    void submit(LogRecord&& r) {
+        LogRing& ring = localRing();
+        r.seq = seq_.fetch_add(1, std::memory_order_relaxed);
+        r.thread = ring.thread;
 
-    std::ostringstream oss;
-    oss << std::hex;
-    for (int i = 0; i < 12; ++i) oss << dist(rng);
-    return oss.str();
-}
+        const LogLevel level = r.level;
+        {
+            std::unique_lock<std::mutex> pk(ring.pushMutex);
+            if (stopped_.load(std::memory_order_acquire)) {
+                // Escritor detenido (atexit): escritura directa
+                pk.unlock();
+                std::vector<LogRecord> one;
+                one.push_back(std::move(r));
+                std::lock_guard<std::mutex> lk(outMutex_);
+                writeBatch(one);
+                return;
+            }
 
-void logMessage(LogLevel level,
-                const std::string& tag,
-                const std::string& rid,
-                const std::string& msg) {
-    std::lock_guard<std::mutex> lk(g_log_mutex);
+            if (!ring.push(std::move(r))) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                pk.unlock();
+                cv_.notify_one();
+                return;
+            }
+        }
+        if (level >= LOG_WARN || ring.pending() >= kRingSize / 2) cv_.notify_one();
+    }
+
+    void setFormat(LogFormat f) {
+        std::lock_guard<std::mutex> lk(outMutex_);
+        format_ = f;
+    }
+
+    void setFile(const std::string& path) {
+        std::lock_guard<std::mutex> lk(outMutex_);
+        if (file_.is_open()) file_.close();
+        file_.open(path, std::ios::app);
+        fileEnabled_ = file_.is_open();
+    }
 
-    if (level < g_level) return;
+    void flush() {
+        std::unique_lock<std::mutex> lk(mtx_);
+        if (stopped_.load(std::memory_order_acquire)) return;
+        const uint64_t target = ++flushRequested_;
+        cv_.notify_one();
+        cvDone_.wait(lk, [&] { return flushDone_ >= target || stopped_.load(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            if (stopping_) return;
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        if (thread_.joinable()) thread_.join();
+
+        // Lo que se encoló entre el último drenado y stopped_ = true. Con el
+        // pushMutex de cada anillo, un productor o ya encoló (se drena acá) o
+        // ve stopped_ y escribe directo: ningún registro queda en un anillo
+        std::vector<LogRecord> rest;
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            for (auto& r : rings_) {
+                std::lock_guard<std::mutex> pk(r->pushMutex);
+                r->drain(rest);
+            }
+        }
+        std::sort(rest.begin(), rest.end(),
+                  [](const LogRecord& a, const LogRecord& b) { return a.seq < b.seq; });
+        if (!rest.empty()) {
+            std::lock_guard<std::mutex> lk(outMutex_);
+            writeBatch(rest);
+        }
+    }
+
+private:
+    LogWriter() : thread_(&LogWriter::loop, this) {}
 
-    // Prefijo SOLO para la primera linea
-    std::ostringstream prefix;
-    prefix << "[" << levelStr(level) << "]"
-        << " [" << tag << "] ";
+    // El anillo vive mientras lo use el hilo o tenga registros sin escribir
+    struct LocalRing {
+        std::shared_ptr<LogRing> ring;
+        ~LocalRing() {
+            if (ring) ring->alive.store(false, std::memory_order_release);
+        }
+    };
 
-    const std::string pfx = prefix.str();
+    LogRing& localRing() {
+        static thread_local LocalRing local;
+        if (!local.ring) {
+            local.ring = std::make_shared<LogRing>();
+            local.ring->thread = nextThread_.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lk(mtx_);
+            rings_.push_back(local.ring);
+        }
+        return *local.ring;
+    }
 
-    // Si msg tiene saltos de linea, las siguientes lineas NO repiten prefijo:
-    // se imprimen alineadas con espacios del mismo ancho que el prefijo.
-    std::istringstream iss(msg);
-    std::string linePart;
-    bool first = true;
+    void loop() {
+        std::vector<LogRecord> batch;
+        std::vector<std::shared_ptr<LogRing>> rings;
 
-    std::ostringstream out;
+        for (;;) {
+            uint64_t flushTarget = 0;
+            bool finish = false;
+            {
+                std::unique_lock<std::mutex> lk(mtx_);
+                cv_.wait_for(lk, std::chrono::milliseconds(20),
+                             [&] { return stopping_ || flushRequested_ > flushDone_; });
+                flushTarget = flushRequested_;
+                finish = stopping_;
 
-    while (std::getline(iss, linePart)) {
-        if (first) {
-            out << pfx << linePart << "\n";
-            first = false;
-        } else {
-            out << std::string(pfx.size(), ' ') << linePart << "\n";
+                // Anillos de hilos terminados y ya vacíos
+                rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                            [](const std::shared_ptr<LogRing>& r) {
+                                                return !r->alive.load(std::memory_order_acquire) && r->pending() == 0;
+                                            }),
+                             rings_.end());
+                rings = rings_;
+            }
+
+            batch.clear();
+            for (auto& r : rings) r->drain(batch);
+            std::sort(batch.begin(), batch.end(),
+                      [](const LogRecord& a, const LogRecord& b) { return a.seq < b.seq; });
+
+            const uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+            if (dropped > 0) {
+                LogRecord aviso;
+                aviso.level = LOG_WARN;
+                aviso.ts = std::chrono::system_clock::now();
+                aviso.tag = "LOGGER";
+                aviso.msg = "anillo lleno: " + std::to_string(dropped) + " registros descartados";
+                batch.push_back(std::move(aviso));
+            }
+
+            if (!batch.empty()) {
+                std::lock_guard<std::mutex> lk(outMutex_);
+                writeBatch(batch);
+            }
+
+            {
+                std::lock_guard<std::mutex> lk(mtx_);
+                if (flushTarget > flushDone_) flushDone_ = flushTarget;
+                if (finish) stopped_.store(true, std::memory_order_release);
+            }
+            cvDone_.notify_all();
+            if (finish) break;
         }
     }
 
-    // Caso especial: msg vacio (para que igual salga algo)
-    if (first) {
-        out << pfx << "\n";
+    // Timestamp cacheado por segundo (el formateo con strftime es lo caro)
+    void appendTimestamp(std::string& out, std::chrono::system_clock::time_point tp) {
+        using namespace std::chrono;
+        const auto ms = duration_cast<milliseconds>(tp.time_since_epoch()).count();
+        const std::time_t sec = (std::time_t)(ms / 1000);
+        if (sec != cachedSec_) {
+            std::tm tm{};
+#if defined(_WIN32)
+            gmtime_s(&tm, &sec);
+#else
+            gmtime_r(&sec, &tm);
+#endif
+            char buf[32];
+            std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
+            cachedTs_ = buf;
+            cachedSec_ = sec;
+        }
+        char frac[8];
+        std::snprintf(frac, sizeof(frac), ".%03dZ", (int)(ms % 1000));
+        out += cachedTs_;
+        out += frac;
+    }
+
+    void appendJson(std::string& out, const LogRecord& r) {
+        out += "{\"ts\":\"";
+        appendTimestamp(out, r.ts);
+        out += "\",\"level\":\"";
+        out += levelStr(r.level);
+        out += "\",\"tag\":";
+        appendJsonString(out, r.tag);
+        out += ",\"rid\":";
+        appendJsonString(out, r.rid);
+        out += ",\"thread\":";
+        out += std::to_string(r.thread);
+        out += ",\"msg\":";
+        appendJsonString(out, r.msg);
+        out += "}\n";
     }
 
-    // stdout/stderr (docker logs)
-    std::cerr << out.str();
-    std::cerr.flush();
+    // Prefijo SOLO para la primera línea; las siguientes se alinean con espacios
+    void appendText(std::string& out, const LogRecord& r) {
+        std::string pfx;
+        pfx.reserve(32 + r.tag.size() + r.rid.size());
+        pfx += '[';
+        pfx += levelStr(r.level);
+        pfx += "] [";
+        pfx += r.tag;
+        pfx += "] ";
+        if (!r.rid.empty()) {
+            pfx += '[';
+            pfx += r.rid;
+            pfx += "] ";
+        }
+
+        size_t start = 0;
+        bool first = true;
+        while (start <= r.msg.size()) {
+            size_t end = r.msg.find('\n', start);
+            if (end == std::string::npos) end = r.msg.size();
+            if (!first && start == r.msg.size()) break;  // '\n' final sin contenido
+
+            if (first) out += pfx;
+            else out.append(pfx.size(), ' ');
+            out.append(r.msg, start, end - start);
+            out += '\n';
 
-    // archivo opcional
-    if (g_file_enabled) {
-        g_file << out.str();
-        g_file.flush();
+            first = false;
+            start = end + 1;
+        }
+    }
+
+    // Requiere outMutex_
+    void writeBatch(const std::vector<LogRecord>& batch) {
+        buffer_.clear();
+        for (const auto& r : batch) {
+            if (format_ == LOG_FORMAT_JSON) appendJson(buffer_, r);
+            else appendText(buffer_, r);
+        }
+
+        // stderr (docker logs): una sola escritura por lote
+        std::fwrite(buffer_.data(), 1, buffer_.size(), stderr);
+        std::fflush(stderr);
+
+        if (fileEnabled_) {
+            file_.write(buffer_.data(), (std::streamsize)buffer_.size());
+            file_.flush();
+        }
     }
+
+    std::mutex mtx_;                       // registro de anillos + control del hilo
+    std::condition_variable cv_;
+    std::condition_variable cvDone_;
+    std::vector<std::shared_ptr<LogRing>> rings_;
+    bool stopping_ = false;
+    std::atomic<bool> stopped_{false};
+    uint64_t flushRequested_ = 0;
+    uint64_t flushDone_ = 0;
+
+    std::atomic<uint64_t> seq_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint32_t> nextThread_{1};
+
+    std::mutex outMutex_;                  // salida (escritor, setters y modo directo)
+    LogFormat format_ = LOG_FORMAT_TEXT;
+    std::ofstream file_;
+    bool fileEnabled_ = false;
+    std::string buffer_;
+    std::time_t cachedSec_ = -1;
+    std::string cachedTs_;
+
+    std::thread thread_;
+};
+
+} // namespace
+
+void setLogLevel(LogLevel level) {
+    logger_detail::g_min_level.store((int)level, std::memory_order_relaxed);
+}
+
+LogLevel getLogLevel() {
+    return (LogLevel)logger_detail::g_min_level.load(std::memory_order_relaxed);
+}
+
+void setLogFormat(LogFormat format) {
+    LogWriter::instance().setFormat(format);
+}
+
+void setLogFile(const std::string& path) {
+    LogWriter::instance().setFile(path);
+}
+
+void flushLogs() {
+    LogWriter::instance().flush();
+}
+
+std::string makeRequestId() {
+    // corto pero suficiente para defensa
+    static thread_local std::mt19937_64 rng(std::random_device{}() ^
+        (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    static constexpr char kHex[] = "0123456789abcdef";
+
+    uint64_t v = rng();
+    std::string id(12, '0');
+    for (int i = 0; i < 12; ++i, v >>= 4) id[i] = kHex[v & 15];
+    return id;
+}
+
+void logMessage(LogLevel level,
+                const std::string& tag,
+                const std::string& rid,
+                const std::string& msg) {
+    if (!logEnabled(level)) return;
+
+    LogRecord r;
+    r.level = level;
+    r.ts = std::chrono::system_clock::now();
+    r.tag = tag;
+    r.rid = rid;
+    r.msg = msg;
+    LogWriter::instance().submit(std::move(r));
 }
 
 
 LogScope::LogScope(const std::string& tag,
                    const std::string& rid,
                    const std::string& name)
-    : tag_(tag), rid_(rid), name_(name), t0_(std::chrono::steady_clock::now()) {
-    logMessage(LOG_INFO, tag_, rid_, "BEGIN " + name_);
+    : tag_(tag), rid_(rid), name_(name), t0_(std::chrono::steady_clock::now()), span_(name, rid) {
+    if (logEnabled(LOG_INFO)) logMessage(LOG_INFO, tag_, rid_, "BEGIN " + name_);
 }
 
 LogScope::~LogScope() {
+    if (!logEnabled(LOG_INFO)) return;
     auto t1 = std::chrono::steady_clock::now();
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0_).count();
     logMessage(LOG_INFO, tag_, rid_, "END " + name_ + " duration_ms=" + std::to_string(ms));
@@ -209,6 +209,14 @@ ModeloPCA entrenarPCA(const std::vector<std::vector<double>>& datos, int numComp
     return modelo;
 }
 
+ModeloPCA recortarModeloPCA(const ModeloPCA& modelo, int numComponentes) {
+    ModeloPCA recortado;
+    recortado.medias = modelo.medias;
+    const size_t k = std::min(modelo.componentes.size(), (size_t)std::max(0, numComponentes));
+    recortado.componentes.assign(modelo.componentes.begin(), modelo.componentes.begin() + k);
+    return recortado;
+}
+
 std::vector<std::vector<double>> aplicarPCAConModelo(
     const std::vector<std::vector<double>>& datos,
     const ModeloPCA& modelo
@@ -26,13 +26,16 @@ public:
     //     {
     //       "id_usuario": 1,
     //       "id_credencial": 5,
-    //       "vector_features": [0.1, 0.2, ...],
+    //       "id_muestra_cliente": "42",  // id local: reenviar el lote no duplica filas
+    //       "vector_features_b64": "RlYBCJgQAAA...",  // blob FV (utils/feature_codec.h)
+    //       // o, formato legado: "vector_features": [0.1, 0.2, ...],
     //       "dimension": 39
     //     },
     //     ...
     //   ]
     // }
-    // Response: {"ok": true, "ids_procesados": [1, 2, 3], "procesados": 3, "total": 3}
+    // Response: {"ok": true, "ids_procesados": [1, 2, 3], "procesados": 3, "fallidos": 0, "total": 3,
+    //            "resultados": [{"indice": 0, "id_muestra_cliente": "42", "id_caracteristica": 1}, ...]}
     json syncPush(const json& body);
 
     // ========================================================================
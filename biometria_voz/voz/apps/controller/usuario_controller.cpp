@@ -4,10 +4,40 @@
 #include <chrono>
 #include <regex>
 #include "../../utils/config.h"
+#include "../../utils/http_helpers.h"
 #include "../../external/httplib.h"
 
 namespace fs = std::filesystem;
 
+namespace {
+
+// Transporte de la cola de auditoria: POST en bloque (body array) a PostgREST
+auditoria::Envio enviarValidaciones(const std::string& cuerpo, size_t filas) {
+    static const std::string endpoint = "/validaciones_biometricas";
+    auto [host, port] = obtenerPostgRESTConfig();
+    httplib::Client cli(host.c_str(), port);
+
+    // CRITICO: keep_alive=false (igual que HttpHelpers) y timeouts cortos
+    cli.set_keep_alive(false);
+    cli.set_connection_timeout(2, 0);
+    cli.set_read_timeout(5, 0);
+    cli.set_write_timeout(5, 0);
+
+    HttpHelpers::MedicionBD medicion("POST", endpoint);
+    auto res = cli.Post(endpoint.c_str(), {{"Prefer", "return=minimal"}}, cuerpo, "application/json");
+    medicion.fin(res);
+
+    if (!res || res->status >= 500) return auditoria::Envio::Reintentar;
+    if (res->status >= 400) {
+        std::cerr << "! Auditoria: POST " << endpoint << " status " << res->status << " (" << filas
+                  << " filas): " << res->body.substr(0, 300) << std::endl;
+        return auditoria::Envio::Descartar;
+    }
+    return auditoria::Envio::Ok;
+}
+
+} // namespace
+
 UsuarioController::UsuarioController() {
 
     // ✅ USAR RUTAS DESDE CONFIG.H
@@ -23,6 +53,29 @@ UsuarioController::UsuarioController() {
     authService = std::make_unique<AutenticacionService>(modelPath, mappingPath);
     registerService = std::make_unique<RegistrarService>(mappingPath, trainDataPath);
     listService = std::make_unique<ListarService>(mappingPath);
+    auditoria::Config auditCfg;
+    auditCfg.rutaSpool = obtenerRutaBase() + "audit/validaciones_pendientes.jsonl";
+    auditService = std::make_unique<auditoria::Cola>(auditCfg, enviarValidaciones);
+
+    // Reentreno fuera de la solicitud: entrena en su hilo y publica con swap de instantanea
+    reentreno = std::make_unique<ReentrenoService>(
+        [this] {
+            std::lock_guard<std::mutex> lock(mtxModelo);
+            return registerService->entrenarModelo();
+        },
+        [this](std::string& error) {
+            std::lock_guard<std::mutex> lock(mtxModelo);
+            bool publicado = authService->recargar(modelPath, "", &error);
+            listService->recargarDatos("");
+            return publicado;
+        });
+
+    // Registros cuyo reentreno se perdio (caida o parada con la cola llena):
+    // una pasada de arranque entrena lo que falte
+    if (registerService->hayClasesSinEntrenar()) {
+        std::cout << "-> Dataset con clases sin entrenar: reentreno de arranque encolado" << std::endl;
+        reentreno->encolar("arranque");
+    }
 
     // MOSTRAR RUTAS CONFIGURADAS
     std::cout << "-> Rutas configuradas:" << std::endl;
@@ -40,12 +93,21 @@ UsuarioController::~UsuarioController() {
     catch (...) {}
 }
 
-json UsuarioController::autenticar(const std::string& audioPath, const std::string& identificador, int idFrase,
+json UsuarioController::autenticar(const AudioDecodificado& audio, const std::string& identificador, int idFrase,
                                         const std::string& ipCliente, const std::string& userAgent) {
     json response;
 
+    // Auditoria de todo intento, exitoso o no, sobre el usuario RECLAMADO
+    json validacion;
+    validacion["id_usuario"] = nullptr;
+    validacion["tipo_biometria"] = "voz";
+    validacion["resultado"] = "error";
+    validacion["ip_cliente"] = ipCliente.substr(0, 45);
+    validacion["dispositivo"] = userAgent.substr(0, 200);
+
     try {
-        auto resultado = authService->autenticar(audioPath, identificador, idFrase);
+        auto resultado = authService->autenticar(audio, identificador, idFrase);
+        if (resultado.idUsuarioBD >= 0) validacion["id_usuario"] = resultado.idUsuarioBD;
 
         response["success"] = resultado.exito;
 
@@ -58,6 +120,7 @@ json UsuarioController::autenticar(const std::string& audioPath, const std::stri
             // 1. SVM autentico correctamente
             // 2. El identificador proporcionado coincide con el detectado
             bool autenticadoFinal = resultado.autenticado && identificadorCoincide;
+            validacion["resultado"] = autenticadoFinal ? "exito" : "fallo";
             
             response["authenticated"] = autenticadoFinal;
             response["access"] = autenticadoFinal;
@@ -101,6 +164,9 @@ json UsuarioController::autenticar(const std::string& audioPath, const std::stri
         response["error"] = std::string("Excepcion en controlador: ") + e.what();
     }
 
+    // Asincrono: no agrega latencia ni puede fallar la respuesta
+    auditService->registrar(validacion.dump());
+
     return response;
 }
 
@@ -124,21 +190,10 @@ json UsuarioController::registrarUsuario(const std::string& nombre,
             std::cout << "-> Usuario registrado: " << nombre
                 << " (ID: " << resultado.userId << ")" << std::endl;
 
-            // ENTRENAR MODELO UNA SOLA VEZ AQUÍ
-            std::cout << "&  Reentrenando modelo de voz..." << std::endl;
-            auto resultadoEntrenamiento = registerService->entrenarModelo();
-
-            if (!resultadoEntrenamiento.exito) {
-                response["warning"] = "Registro completado, pero fallo el entrenamiento";
-                response["train_error"] = resultadoEntrenamiento.error;
-            }
-            else {
-                response["training_message"] = resultadoEntrenamiento.mensaje;
-                response["num_classes"] = resultadoEntrenamiento.numClases;
-
-                // RECARGAR CONFIGURACIÓN DESPUeS DEL ENTRENAMIENTO
-                recargarConfiguracion();
-            }
+            // El modelo se reentrena en segundo plano (GET /voz/reentreno/:id)
+            uint64_t idReentreno = reentreno->encolar(std::to_string(resultado.userId));
+            response["reentreno"] = {{"id", idReentreno}, {"estado", "pendiente"}};
+            std::cout << "&  Reentreno encolado (trabajo " << idReentreno << ")" << std::endl;
         }
         else {
             response["error"] = resultado.error;
@@ -159,7 +214,11 @@ json UsuarioController::entrenarModelo() {
     try {
         std::cout << "-> Iniciando entrenamiento del modelo..." << std::endl;
 
-        auto resultado = registerService->entrenarModelo();
+        ResultadoEntrenamientoModelo resultado;
+        {
+            std::lock_guard<std::mutex> lock(mtxModelo);
+            resultado = registerService->entrenarModelo();
+        }
 
         response["success"] = resultado.exito;
 
@@ -168,7 +227,9 @@ json UsuarioController::entrenarModelo() {
             response["num_classes"] = resultado.numClases;
 
             // Recargar configuración
-            recargarConfiguracion();
+            if (!recargarConfiguracion()) {
+                response["warning"] = "Modelo entrenado pero rechazado al publicar; sigue el anterior";
+            }
 
             std::cout << "-> Modelo entrenado con " << resultado.numClases
                 << " clases" << std::endl;
@@ -224,6 +285,7 @@ json UsuarioController::eliminarUsuario(int userId) {
     json response;
 
     try {
+        std::lock_guard<std::mutex> lock(mtxModelo);
         bool exito = listService->eliminarUsuario(userId);
 
         if (exito) {
@@ -232,8 +294,7 @@ json UsuarioController::eliminarUsuario(int userId) {
             response["user_id"] = userId;
 
             // Recargar servicios para actualizar modelos en memoria
-            authService->recargarModelo(modelPath);
-            authService->recargarMapeos(mappingPath);
+            authService->recargar(modelPath, mappingPath);
         } else {
             response["success"] = false;
             response["error"] = "No se pudo eliminar el usuario";
@@ -254,22 +315,12 @@ json UsuarioController::registrarBiometria(const std::string& cedula, const std:
         // Delegar al servicio de registro usando registerService directamente
         json resultado = registerService->registrarBiometriaPorCedula(cedula, audioPaths);
         
-        // Si el registro fue exitoso, entrenar modelo
+        // Features ya en el dataset: se responde sin esperar el entrenamiento.
+        // Registros cercanos se agrupan en una sola pasada (GET /voz/reentreno/:id)
         if (resultado["success"] == true) {
-            std::cout << std::endl << std::string(70, '-') << std::endl;
-            std::cout << "-> COMIENZA ETAPA DE ENTRENAMIENTO DEL MODELO SVM..." << std::endl;
-            auto resultadoEntrenamiento = registerService->entrenarModelo();
-            
-            if (!resultadoEntrenamiento.exito) {
-                resultado["warning"] = "Biometria registrada pero fallo el entrenamiento";
-                resultado["train_error"] = resultadoEntrenamiento.error;
-            } else {
-                resultado["training_message"] = resultadoEntrenamiento.mensaje;
-                resultado["num_classes"] = resultadoEntrenamiento.numClases;
-                
-                // Recargar configuración
-                recargarConfiguracion();
-            }
+            uint64_t idReentreno = reentreno->encolar(cedula);
+            resultado["reentreno"] = {{"id", idReentreno}, {"estado", "pendiente"}};
+            std::cout << "-> Reentreno del modelo SVM encolado (trabajo " << idReentreno << ")" << std::endl;
         }
         
         return resultado;
@@ -283,12 +334,35 @@ json UsuarioController::registrarBiometria(const std::string& cedula, const std:
     }
 }
 
-void UsuarioController::recargarConfiguracion() {
+json UsuarioController::estadoReentreno(uint64_t id) {
+    json trabajo;
+    if (!reentreno->estado(id, trabajo)) {
+        return {{"success", false}, {"error", "Trabajo de reentreno no encontrado"}};
+    }
+    trabajo["success"] = true;
+    return trabajo;
+}
+
+json UsuarioController::resumenReentreno() {
+    json resumen = reentreno->resumen();
+    resumen["success"] = true;
+    return resumen;
+}
+
+bool UsuarioController::recargarConfiguracion() {
     std::cout << "-> Recargando configuración en todos los servicios..." << std::endl;
 
-    authService->recargarModelo(modelPath);
-    authService->recargarMapeos("");  // Ahora lee de metadata.json
+    // Mismo candado que el reentreno: auth y listado se publican juntos
+    std::lock_guard<std::mutex> lock(mtxModelo);
+    // Si el modelo nuevo no valida, autenticacion sigue con la instantanea anterior
+    std::string error;
+    bool publicado = authService->recargar(modelPath, "", &error);  // mapeos desde metadata.json
     listService->recargarDatos("");   // Ahora lee de metadata.json
 
-    std::cout << "-> Configuración recargada exitosamente" << std::endl;
+    if (publicado) {
+        std::cout << "-> Configuración recargada exitosamente" << std::endl;
+    } else {
+        std::cerr << "! Modelo nuevo rechazado: " << error << std::endl;
+    }
+    return publicado;
 }
@@ -3,12 +3,16 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <random>
 #include "../service/autenticacion_service.h"
 #include "../service/listar_service.h"
 #include "../service/registrar_service.h"
+#include "../service/reentreno_service.h"
 #include "../../external/json.hpp"
+#include "comun/cola_auditoria.h"
 
 using json = nlohmann::json;
 
@@ -17,6 +21,12 @@ private:
     std::unique_ptr<AutenticacionService> authService;
     std::unique_ptr<RegistrarService> registerService;
     std::unique_ptr<ListarService> listService;
+    std::unique_ptr<auditoria::Cola> auditService;
+
+    // Escrituras del modelo en disco (reentreno, eliminacion) una a la vez
+    std::mutex mtxModelo;
+    // Ultimo miembro: se destruye primero (su hilo usa los servicios de arriba)
+    std::unique_ptr<ReentrenoService> reentreno;
 
     // Configuración
     std::string modelPath;
@@ -29,16 +39,18 @@ public:
     ~UsuarioController();
 
     // Endpoints principales
-    json autenticar(const std::string& audioPath, const std::string& identificador, int idFrase, 
+    json autenticar(const AudioDecodificado& audio, const std::string& identificador, int idFrase, 
                     const std::string& ipCliente = "127.0.0.1", const std::string& userAgent = "");
     json registrarUsuario(const std::string& nombre, const std::vector<std::string>& audiosPaths);
     json registrarBiometria(const std::string& cedula, const std::vector<std::string>& audioPaths);
     json listarUsuarios();
     json eliminarUsuario(int userId);
     json entrenarModelo();
+    json estadoReentreno(uint64_t id);
+    json resumenReentreno();
     
-    // Utilidades
-    void recargarConfiguracion();
+    // Utilidades: false si el modelo nuevo no valido (sigue el anterior)
+    bool recargarConfiguracion();
 };
 
 #endif
\ No newline at end of file
@@ -3,10 +3,13 @@
 #include "../../core/pipeline/audio_pipeline.h"
 #include "../../core/classification/svm.h"
 #include "../../core/process_dataset/dataset.h"
+#include "comun/feature_codec.h"
 #include "../../external/json.hpp"
 #include <memory>
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <random>
 #include <fstream>
@@ -43,6 +46,30 @@ static void set_last_error(const std::string& error) {
     }
 }
 
+// UUID v4 del dispositivo, persistido en config_sync la primera vez: junto con el
+// id local forma la clave de idempotencia del sync (los ids de SQLite se repiten
+// entre dispositivos y tras reinstalar)
+static std::string uuid_dispositivo() {
+    std::string uuid = g_state->db->obtenerConfigSync("uuid_dispositivo");
+    if (!uuid.empty()) return uuid;
+
+    std::random_device rd;
+    std::mt19937_64 rng((static_cast<uint64_t>(rd()) << 32) ^ rd());
+    uint64_t alto = rng(), bajo = rng();
+    alto = (alto & 0xFFFFFFFFFFFF0FFFULL) | 0x0000000000004000ULL;  // version 4
+    bajo = (bajo & 0x3FFFFFFFFFFFFFFFULL) | 0x8000000000000000ULL;  // variante RFC 4122
+
+    char buf[37];
+    std::snprintf(buf, sizeof(buf), "%08x-%04x-%04x-%04x-%012llx",
+                  static_cast<unsigned>(alto >> 32), static_cast<unsigned>((alto >> 16) & 0xFFFF),
+                  static_cast<unsigned>(alto & 0xFFFF), static_cast<unsigned>(bajo >> 48),
+                  static_cast<unsigned long long>(bajo & 0xFFFFFFFFFFFFULL));
+    uuid = buf;
+    g_state->db->guardarConfigSync("uuid_dispositivo", uuid);
+    std::cout << "-> UUID dispositivo generado: " << uuid << std::endl;
+    return uuid;
+}
+
 static bool check_initialized() {
     if (!g_state || !g_state->initialized) {
         set_last_error("Libreria no inicializada. Llamar voz_mobile_init() primero");
@@ -77,6 +104,7 @@ extern "C" int voz_mobile_init(const char* db_path,
             return -1;
         }
         std::cout << "-> Base de datos SQLite conectada correctamente" << std::endl;
+        uuid_dispositivo();
 
         // Configurar rutas
         g_state->modelPath = model_path;
@@ -169,10 +197,21 @@ extern "C" int voz_mobile_crear_usuario(const char* identificador) {
     if (!check_initialized()) return -1;
 
     try {
+        // Usuario + credencial (y sus filas de cola) en un solo commit
+        SQLiteAdapter::Transaccion tx(*g_state->db);
         int idUsuario = g_state->db->insertarUsuario(identificador);
-        if (idUsuario > 0) {
-            // Crear credencial biometrica de voz
-            g_state->db->insertarCredencial(idUsuario, "voz");
+        if (idUsuario <= 0) {
+            set_last_error("Error creando usuario");
+            return -1;
+        }
+        // Sin credencial de voz el usuario no sirve: rollback de ambos
+        if (g_state->db->insertarCredencial(idUsuario, "voz") <= 0) {
+            set_last_error("Error creando credencial de voz");
+            return -1;
+        }
+        if (!tx.confirmar()) {
+            set_last_error("Error confirmando usuario y credencial");
+            return -1;
         }
         return idUsuario;
     } catch (const std::exception& e) {
@@ -297,7 +336,8 @@ extern "C" int voz_mobile_registrar_biometria(const char* identificador,
         // 1. Verificar usuario
         auto usuario = g_state->db->obtenerUsuarioPorIdentificador(identificador);
         if (!usuario.has_value()) {
-            // Crear usuario si no existe
+            // Crear usuario si no existe (usuario + credencial en un solo commit)
+            SQLiteAdapter::Transaccion tx(*g_state->db);
             int idUsuario = g_state->db->insertarUsuario(identificador);
             if (idUsuario <= 0) {
                 set_last_error("Error creando usuario");
@@ -307,7 +347,13 @@ extern "C" int voz_mobile_registrar_biometria(const char* identificador,
                 return -1;
             }
             
-            g_state->db->insertarCredencial(idUsuario, "voz");
+            if (g_state->db->insertarCredencial(idUsuario, "voz") <= 0 || !tx.confirmar()) {
+                set_last_error("Error creando credencial de voz");
+                response["success"] = false;
+                response["error"] = "Error creando credencial de voz";
+                std::strncpy(resultado_json, response.dump().c_str(), buffer_size - 1);
+                return -1;
+            }
             usuario = g_state->db->obtenerUsuarioPorId(idUsuario);
         }
 
@@ -500,15 +546,20 @@ extern "C" int voz_mobile_sync_push(const char* server_url, char* resultado_json
 
         std::cout << "-> Enviando " << caracteristicas.size() << " caracteristicas al servidor" << std::endl;
 
-        // Construir payload JSON
+        // Construir payload JSON. id_muestra_cliente = <uuid>:<id local>, unico
+        // aunque otro dispositivo (o una reinstalacion) repita el id de SQLite
+        const std::string uuid = uuid_dispositivo();
         json payload = json::array();
         for (const auto& car : caracteristicas) {
             json item;
             item["id_usuario"] = car.id_usuario;
             item["id_credencial"] = car.id_credencial;
-            item["vector_features"] = car.vector_features;
+            // Blob FV float64 en base64: ~2x menos que el array JSON, sin perdida
+            auto blob = empaquetarFeatures(car.vector_features, false);
+            item["vector_features_b64"] = codificarBase64(blob.data(), blob.size());
+            item["id_muestra_cliente"] = uuid + ":" + std::to_string(car.id_caracteristica);
             item["dimension"] = car.dimension;
-            item["uuid_dispositivo"] = car.uuid_dispositivo;
+            item["uuid_dispositivo"] = uuid;
             payload.push_back(item);
         }
 
@@ -26,11 +26,18 @@ bool SQLiteAdapter::conectar() {
         return false;
     }
     
+    // WAL: lecturas no bloquean escrituras y cada commit es un append al -wal.
+    // synchronous=NORMAL: fsync solo en checkpoint (seguro ante crash de la app)
+    sqlite3_exec(db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+    sqlite3_exec(db, "PRAGMA synchronous=NORMAL;", nullptr, nullptr, nullptr);
+    sqlite3_busy_timeout(db, 2000);
+
     conectado = true;
     return inicializarEsquema();
 }
 
 void SQLiteAdapter::desconectar() {
+    finalizarSentencias();
     if (db) {
         sqlite3_close(db);
         db = nullptr;
@@ -44,6 +51,69 @@ void SQLiteAdapter::verificarConexion() {
     }
 }
 
+// ============================================================================
+// CACHE DE SENTENCIAS Y TRANSACCIONES
+// ============================================================================
+
+SentenciaPreparada SQLiteAdapter::preparar(const std::string& sql) {
+    auto it = cacheSentencias.find(sql);
+    if (it != cacheSentencias.end()) {
+        return SentenciaPreparada(it->second);
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "! Error preparando SQL: " << sqlite3_errmsg(db) << std::endl;
+        return SentenciaPreparada();
+    }
+    cacheSentencias.emplace(sql, stmt);
+    return SentenciaPreparada(stmt);
+}
+
+void SQLiteAdapter::finalizarSentencias() {
+    for (auto& [sql, stmt] : cacheSentencias) {
+        sqlite3_finalize(stmt);
+    }
+    cacheSentencias.clear();
+}
+
+// Mismo nombre en todos los niveles: SQLite resuelve ROLLBACK TO / RELEASE contra
+// el SAVEPOINT mas reciente con ese nombre, y RAII garantiza el orden LIFO
+SQLiteAdapter::Transaccion::Transaccion(SQLiteAdapter& adapter)
+    : db(adapter.db), anidada(false), activa(false), terminada(false) {
+    adapter.verificarConexion();
+    // autocommit != 0 -> no hay transaccion abierta
+    anidada = !sqlite3_get_autocommit(db);
+    const char* sql = anidada ? "SAVEPOINT tx_anidada;" : "BEGIN IMMEDIATE;";
+    activa = (sqlite3_exec(db, sql, nullptr, nullptr, nullptr) == SQLITE_OK);
+    if (!activa) {
+        std::cerr << "! Error abriendo transaccion: " << sqlite3_errmsg(db) << std::endl;
+    }
+}
+
+SQLiteAdapter::Transaccion::~Transaccion() {
+    if (!activa || terminada) return;
+    if (anidada) {
+        sqlite3_exec(db, "ROLLBACK TO tx_anidada; RELEASE tx_anidada;", nullptr, nullptr, nullptr);
+    } else {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+    }
+}
+
+bool SQLiteAdapter::Transaccion::confirmar() {
+    if (terminada) return true;
+    if (!activa) return false;
+    terminada = true;
+    const char* sql = anidada ? "RELEASE tx_anidada;" : "COMMIT;";
+    if (sqlite3_exec(db, sql, nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "! Error en " << sql << " " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_exec(db, anidada ? "ROLLBACK TO tx_anidada; RELEASE tx_anidada;" : "ROLLBACK;",
+                     nullptr, nullptr, nullptr);
+        return false;
+    }
+    return true;
+}
+
 bool SQLiteAdapter::inicializarEsquema() {
     const char* sql = R"(
         CREATE TABLE IF NOT EXISTS usuarios (
@@ -79,6 +149,15 @@ bool SQLiteAdapter::inicializarEsquema() {
             FOREIGN KEY (id_credencial) REFERENCES credenciales_biometricas(id_credencial)
         );
 
+        CREATE TABLE IF NOT EXISTS cola_sincronizacion (
+            id_sync INTEGER PRIMARY KEY AUTOINCREMENT,
+            tabla TEXT NOT NULL,
+            accion TEXT NOT NULL,
+            datos_json TEXT NOT NULL,
+            fecha_creacion DATETIME DEFAULT CURRENT_TIMESTAMP,
+            sincronizado INTEGER DEFAULT 0
+        );
+
         CREATE TABLE IF NOT EXISTS config_sync (
             clave TEXT PRIMARY KEY,
             valor TEXT NOT NULL
@@ -109,6 +188,9 @@ bool SQLiteAdapter::inicializarEsquema() {
 
         CREATE INDEX IF NOT EXISTS idx_caracteristicas_sincronizado 
             ON caracteristicas_hablantes(sincronizado);
+
+        CREATE INDEX IF NOT EXISTS idx_cola_sincronizado 
+            ON cola_sincronizacion(sincronizado);
     )";
 
     char* errMsg = nullptr;
@@ -135,8 +217,9 @@ std::optional<Usuario> SQLiteAdapter::obtenerUsuarioPorIdentificador(
     std::string sql = "SELECT id_usuario, identificador_unico, estado, "
                       "fecha_registro FROM usuarios WHERE identificador_unico = ?";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return std::nullopt;
     }
     
@@ -149,11 +232,9 @@ std::optional<Usuario> SQLiteAdapter::obtenerUsuarioPorIdentificador(
         u.estado = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
         u.fecha_registro = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
         
-        sqlite3_finalize(stmt);
         return u;
     }
     
-    sqlite3_finalize(stmt);
     return std::nullopt;
 }
 
@@ -163,8 +244,9 @@ std::optional<Usuario> SQLiteAdapter::obtenerUsuarioPorId(int idUsuario) {
     std::string sql = "SELECT id_usuario, identificador_unico, estado, "
                       "fecha_registro FROM usuarios WHERE id_usuario = ?";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return std::nullopt;
     }
     
@@ -177,22 +259,22 @@ std::optional<Usuario> SQLiteAdapter::obtenerUsuarioPorId(int idUsuario) {
         u.estado = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
         u.fecha_registro = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
         
-        sqlite3_finalize(stmt);
         return u;
     }
     
-    sqlite3_finalize(stmt);
     return std::nullopt;
 }
 
 int SQLiteAdapter::insertarUsuario(const std::string& identificador, 
                                    const std::string& estado) {
     verificarConexion();
+    Transaccion tx(*this);  // usuario + cola_sincronizacion: un solo commit
     
     std::string sql = "INSERT INTO usuarios (identificador_unico, estado) VALUES (?, ?)";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return -1;
     }
     
@@ -200,12 +282,10 @@ int SQLiteAdapter::insertarUsuario(const std::string& identificador,
     sqlite3_bind_text(stmt, 2, estado.c_str(), -1, SQLITE_TRANSIENT);
     
     if (sqlite3_step(stmt) != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
         return -1;
     }
     
     int idUsuario = static_cast<int>(sqlite3_last_insert_rowid(db));
-    sqlite3_finalize(stmt);
     
     // Encolar para sincronizacion
     json datos;
@@ -215,18 +295,22 @@ int SQLiteAdapter::insertarUsuario(const std::string& identificador,
     datos["identificador_unico"] = identificador;
     datos["estado"] = estado;
     
-    registrarEnColaSincronizacion("usuarios", "INSERT", datos);
+    if (!registrarEnColaSincronizacion("usuarios", "INSERT", datos) || !tx.confirmar()) {
+        return -1;
+    }
     
     return idUsuario;
 }
 
 bool SQLiteAdapter::actualizarEstadoUsuario(int idUsuario, const std::string& estado) {
     verificarConexion();
+    Transaccion tx(*this);
     
     std::string sql = "UPDATE usuarios SET estado = ? WHERE id_usuario = ?";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return false;
     }
     
@@ -234,7 +318,6 @@ bool SQLiteAdapter::actualizarEstadoUsuario(int idUsuario, const std::string& es
     sqlite3_bind_int(stmt, 2, idUsuario);
     
     bool exito = (sqlite3_step(stmt) == SQLITE_DONE);
-    sqlite3_finalize(stmt);
     
     if (exito) {
         json datos;
@@ -243,7 +326,7 @@ bool SQLiteAdapter::actualizarEstadoUsuario(int idUsuario, const std::string& es
         datos["id_usuario"] = idUsuario;
         datos["estado"] = estado;
         
-        registrarEnColaSincronizacion("usuarios", "UPDATE", datos);
+        exito = registrarEnColaSincronizacion("usuarios", "UPDATE", datos) && tx.confirmar();
     }
     
     return exito;
@@ -256,8 +339,9 @@ std::vector<Usuario> SQLiteAdapter::listarUsuarios() {
     std::string sql = "SELECT id_usuario, identificador_unico, estado, "
                       "fecha_registro FROM usuarios";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return usuarios;
     }
     
@@ -270,7 +354,6 @@ std::vector<Usuario> SQLiteAdapter::listarUsuarios() {
         usuarios.push_back(u);
     }
     
-    sqlite3_finalize(stmt);
     return usuarios;
 }
 
@@ -287,8 +370,9 @@ std::optional<CredencialBiometrica> SQLiteAdapter::obtenerCredencialPorUsuario(
                       "fecha_registro FROM credenciales_biometricas "
                       "WHERE id_usuario = ? AND tipo_biometria = ?";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return std::nullopt;
     }
     
@@ -303,22 +387,22 @@ std::optional<CredencialBiometrica> SQLiteAdapter::obtenerCredencialPorUsuario(
         c.estado = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
         c.fecha_registro = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
         
-        sqlite3_finalize(stmt);
         return c;
     }
     
-    sqlite3_finalize(stmt);
     return std::nullopt;
 }
 
 int SQLiteAdapter::insertarCredencial(int idUsuario, const std::string& tipoBiometria) {
     verificarConexion();
+    Transaccion tx(*this);
     
     std::string sql = "INSERT INTO credenciales_biometricas (id_usuario, tipo_biometria) "
                       "VALUES (?, ?)";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return -1;
     }
     
@@ -326,12 +410,10 @@ int SQLiteAdapter::insertarCredencial(int idUsuario, const std::string& tipoBiom
     sqlite3_bind_text(stmt, 2, tipoBiometria.c_str(), -1, SQLITE_TRANSIENT);
     
     if (sqlite3_step(stmt) != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
         return -1;
     }
     
     int idCredencial = static_cast<int>(sqlite3_last_insert_rowid(db));
-    sqlite3_finalize(stmt);
     
     json datos;
     datos["tabla"] = "credenciales_biometricas";
@@ -340,7 +422,9 @@ int SQLiteAdapter::insertarCredencial(int idUsuario, const std::string& tipoBiom
     datos["id_usuario"] = idUsuario;
     datos["tipo_biometria"] = tipoBiometria;
     
-    registrarEnColaSincronizacion("credenciales_biometricas", "INSERT", datos);
+    if (!registrarEnColaSincronizacion("credenciales_biometricas", "INSERT", datos) || !tx.confirmar()) {
+        return -1;
+    }
     
     return idCredencial;
 }
@@ -356,8 +440,9 @@ std::vector<FraseDinamica> SQLiteAdapter::obtenerFrasesActivas() {
     std::string sql = "SELECT id_frase, frase, categoria, activa "
                       "FROM frases_dinamicas WHERE activa = 1";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return frases;
     }
     
@@ -370,7 +455,6 @@ std::vector<FraseDinamica> SQLiteAdapter::obtenerFrasesActivas() {
         frases.push_back(f);
     }
     
-    sqlite3_finalize(stmt);
     return frases;
 }
 
@@ -380,8 +464,9 @@ std::optional<FraseDinamica> SQLiteAdapter::obtenerFrasePorId(int idFrase) {
     std::string sql = "SELECT id_frase, frase, categoria, activa "
                       "FROM frases_dinamicas WHERE id_frase = ?";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return std::nullopt;
     }
     
@@ -394,11 +479,9 @@ std::optional<FraseDinamica> SQLiteAdapter::obtenerFrasePorId(int idFrase) {
         f.categoria = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
         f.activa = sqlite3_column_int(stmt, 3) == 1;
         
-        sqlite3_finalize(stmt);
         return f;
     }
     
-    sqlite3_finalize(stmt);
     return std::nullopt;
 }
 
@@ -408,8 +491,9 @@ int SQLiteAdapter::insertarFrase(const std::string& frase,
     
     std::string sql = "INSERT INTO frases_dinamicas (frase, categoria) VALUES (?, ?)";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return -1;
     }
     
@@ -417,12 +501,10 @@ int SQLiteAdapter::insertarFrase(const std::string& frase,
     sqlite3_bind_text(stmt, 2, categoria.c_str(), -1, SQLITE_TRANSIENT);
     
     if (sqlite3_step(stmt) != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
         return -1;
     }
     
     int idFrase = static_cast<int>(sqlite3_last_insert_rowid(db));
-    sqlite3_finalize(stmt);
     
     return idFrase;
 }
@@ -434,12 +516,14 @@ int SQLiteAdapter::insertarFrase(const std::string& frase,
 int SQLiteAdapter::insertarValidacion(int idCredencial, const std::string& resultado,
                                       double confianza) {
     verificarConexion();
+    Transaccion tx(*this);
     
     std::string sql = "INSERT INTO validaciones_biometricas "
                       "(id_credencial, resultado, confianza) VALUES (?, ?, ?)";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return -1;
     }
     
@@ -448,12 +532,10 @@ int SQLiteAdapter::insertarValidacion(int idCredencial, const std::string& resul
     sqlite3_bind_double(stmt, 3, confianza);
     
     if (sqlite3_step(stmt) != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
         return -1;
     }
     
     int idValidacion = static_cast<int>(sqlite3_last_insert_rowid(db));
-    sqlite3_finalize(stmt);
     
     json datos;
     datos["tabla"] = "validaciones_biometricas";
@@ -463,7 +545,9 @@ int SQLiteAdapter::insertarValidacion(int idCredencial, const std::string& resul
     datos["resultado"] = resultado;
     datos["confianza"] = confianza;
     
-    registrarEnColaSincronizacion("validaciones_biometricas", "INSERT", datos);
+    if (!registrarEnColaSincronizacion("validaciones_biometricas", "INSERT", datos) || !tx.confirmar()) {
+        return -1;
+    }
     
     return idValidacion;
 }
@@ -472,15 +556,16 @@ int SQLiteAdapter::insertarValidacion(int idCredencial, const std::string& resul
 // SINCRONIZACION
 // ============================================================================
 
-void SQLiteAdapter::registrarEnColaSincronizacion(const std::string& tabla,
+bool SQLiteAdapter::registrarEnColaSincronizacion(const std::string& tabla,
                                                    const std::string& accion,
                                                    const json& datos) {
     std::string sql = "INSERT INTO cola_sincronizacion (tabla, accion, datos_json) "
                       "VALUES (?, ?, ?)";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        return;
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
+        return false;
     }
     
     std::string datosStr = datos.dump();
@@ -489,8 +574,7 @@ void SQLiteAdapter::registrarEnColaSincronizacion(const std::string& tabla,
     sqlite3_bind_text(stmt, 2, accion.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(stmt, 3, datosStr.c_str(), -1, SQLITE_TRANSIENT);
     
-    sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    return sqlite3_step(stmt) == SQLITE_DONE;
 }
 
 json SQLiteAdapter::obtenerColaSincronizacion() {
@@ -501,8 +585,9 @@ json SQLiteAdapter::obtenerColaSincronizacion() {
                       "FROM cola_sincronizacion WHERE sincronizado = 0 "
                       "ORDER BY fecha_creacion ASC";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return cola;
     }
     
@@ -519,7 +604,6 @@ json SQLiteAdapter::obtenerColaSincronizacion() {
         cola.push_back(item);
     }
     
-    sqlite3_finalize(stmt);
     return cola;
 }
 
@@ -528,15 +612,15 @@ bool SQLiteAdapter::marcarComoSincronizado(int idSync) {
     
     std::string sql = "UPDATE cola_sincronizacion SET sincronizado = 1 WHERE id_sync = ?";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return false;
     }
     
     sqlite3_bind_int(stmt, 1, idSync);
     
     bool exito = (sqlite3_step(stmt) == SQLITE_DONE);
-    sqlite3_finalize(stmt);
     
     return exito;
 }
@@ -546,8 +630,9 @@ int SQLiteAdapter::contarPendientesSincronizacion() {
     
     std::string sql = "SELECT COUNT(*) FROM cola_sincronizacion WHERE sincronizado = 0";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return 0;
     }
     
@@ -556,7 +641,6 @@ int SQLiteAdapter::contarPendientesSincronizacion() {
         count = sqlite3_column_int(stmt, 0);
     }
     
-    sqlite3_finalize(stmt);
     return count;
 }
 
@@ -633,8 +717,9 @@ void SQLiteAdapter::guardarConfigSync(const std::string& clave, const std::strin
     
     std::string sql = "INSERT OR REPLACE INTO config_sync (clave, valor) VALUES (?, ?)";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         throw std::runtime_error("Error preparando INSERT config_sync");
     }
     
@@ -642,11 +727,8 @@ void SQLiteAdapter::guardarConfigSync(const std::string& clave, const std::strin
     sqlite3_bind_text(stmt, 2, valor.c_str(), -1, SQLITE_TRANSIENT);
     
     if (sqlite3_step(stmt) != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
         throw std::runtime_error("Error guardando configuracion sync");
     }
-    
-    sqlite3_finalize(stmt);
 }
 
 std::string SQLiteAdapter::obtenerConfigSync(const std::string& clave) {
@@ -654,8 +736,9 @@ std::string SQLiteAdapter::obtenerConfigSync(const std::string& clave) {
     
     std::string sql = "SELECT valor FROM config_sync WHERE clave = ?";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         throw std::runtime_error("Error preparando SELECT config_sync");
     }
     
@@ -666,7 +749,6 @@ std::string SQLiteAdapter::obtenerConfigSync(const std::string& clave) {
         valor = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
     }
     
-    sqlite3_finalize(stmt);
     return valor;
 }
 
@@ -674,6 +756,13 @@ std::string SQLiteAdapter::obtenerConfigSync(const std::string& clave) {
 // CARACTERISTICAS HABLANTES
 // ============================================================================
 
+// Mismo texto en el insert individual y en el lote: una sola sentencia en cache
+static const std::string SQL_INSERT_CARACTERISTICA = R"(
+        INSERT INTO caracteristicas_hablantes 
+        (id_usuario, id_credencial, vector_features, dimension, uuid_dispositivo, sincronizado)
+        VALUES (?, ?, ?, ?, ?, 0)
+    )";
+
 int SQLiteAdapter::insertarCaracteristicaLocal(int idUsuario, int idCredencial,
                                                 const std::vector<double>& features,
                                                 const std::string& uuidDispositivo) {
@@ -683,34 +772,82 @@ int SQLiteAdapter::insertarCaracteristicaLocal(int idUsuario, int idCredencial,
     size_t blobSize = features.size() * sizeof(double);
     const uint8_t* blobData = reinterpret_cast<const uint8_t*>(features.data());
     
-    std::string sql = R"(
-        INSERT INTO caracteristicas_hablantes 
-        (id_usuario, id_credencial, vector_features, dimension, uuid_dispositivo, sincronizado)
-        VALUES (?, ?, ?, ?, ?, 0)
-    )";
-    
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(SQL_INSERT_CARACTERISTICA);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         throw std::runtime_error("Error preparando INSERT caracteristicas_hablantes");
     }
     
     sqlite3_bind_int(stmt, 1, idUsuario);
     sqlite3_bind_int(stmt, 2, idCredencial);
-    sqlite3_bind_blob(stmt, 3, blobData, blobSize, SQLITE_TRANSIENT);
+    sqlite3_bind_blob(stmt, 3, blobData, static_cast<int>(blobSize), SQLITE_STATIC);  // vive hasta el step
     sqlite3_bind_int(stmt, 4, static_cast<int>(features.size()));
     sqlite3_bind_text(stmt, 5, uuidDispositivo.c_str(), -1, SQLITE_TRANSIENT);
     
     if (sqlite3_step(stmt) != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
         throw std::runtime_error("Error insertando caracteristica local");
     }
     
     int idCaracteristica = static_cast<int>(sqlite3_last_insert_rowid(db));
-    sqlite3_finalize(stmt);
     
     return idCaracteristica;
 }
 
+int SQLiteAdapter::insertarCaracteristicaLocal(int idUsuario, int idCredencial,
+                                                const std::vector<float>& features,
+                                                const std::string& uuidDispositivo) {
+    std::vector<double> ancho(features.begin(), features.end());
+    return insertarCaracteristicaLocal(idUsuario, idCredencial, ancho, uuidDispositivo);
+}
+
+std::vector<int> SQLiteAdapter::insertarCaracteristicasLocales(int idUsuario, int idCredencial,
+                                                               const std::vector<std::vector<double>>& lista,
+                                                               const std::string& uuidDispositivo) {
+    verificarConexion();
+    Transaccion tx(*this);  // un solo commit (un fsync) para todo el lote
+
+    auto sentencia = preparar(SQL_INSERT_CARACTERISTICA);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
+        throw std::runtime_error("Error preparando INSERT caracteristicas_hablantes");
+    }
+
+    // Lo comun se enlaza una vez; por fila solo cambian el BLOB y la dimension
+    sqlite3_bind_int(stmt, 1, idUsuario);
+    sqlite3_bind_int(stmt, 2, idCredencial);
+    sqlite3_bind_text(stmt, 5, uuidDispositivo.c_str(), -1, SQLITE_TRANSIENT);
+
+    std::vector<int> ids;
+    ids.reserve(lista.size());
+    for (const auto& features : lista) {
+        sqlite3_bind_blob(stmt, 3, features.data(), static_cast<int>(features.size() * sizeof(double)),
+                          SQLITE_STATIC);  // vive hasta el step
+        sqlite3_bind_int(stmt, 4, static_cast<int>(features.size()));
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            // tx sin confirmar: el destructor deshace las filas ya insertadas
+            throw std::runtime_error(std::string("Error insertando caracteristica ") +
+                                     std::to_string(ids.size()) + ": " + sqlite3_errmsg(db));
+        }
+        ids.push_back(static_cast<int>(sqlite3_last_insert_rowid(db)));
+        sqlite3_reset(stmt);  // conserva los binds
+    }
+
+    if (!tx.confirmar()) {
+        throw std::runtime_error("Error confirmando caracteristicas locales");
+    }
+    return ids;
+}
+
+std::vector<int> SQLiteAdapter::insertarCaracteristicasLocales(int idUsuario, int idCredencial,
+                                                               const std::vector<std::vector<float>>& lista,
+                                                               const std::string& uuidDispositivo) {
+    std::vector<std::vector<double>> anchos;
+    anchos.reserve(lista.size());
+    for (const auto& features : lista) anchos.emplace_back(features.begin(), features.end());
+    return insertarCaracteristicasLocales(idUsuario, idCredencial, anchos, uuidDispositivo);
+}
+
 std::vector<CaracteristicaHablante> SQLiteAdapter::obtenerCaracteristicasPendientes() {
     verificarConexion();
     
@@ -724,8 +861,9 @@ std::vector<CaracteristicaHablante> SQLiteAdapter::obtenerCaracteristicasPendien
         WHERE sincronizado = 0
     )";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         throw std::runtime_error("Error preparando SELECT caracteristicas pendientes");
     }
     
@@ -752,7 +890,6 @@ std::vector<CaracteristicaHablante> SQLiteAdapter::obtenerCaracteristicasPendien
         caracteristicas.push_back(car);
     }
     
-    sqlite3_finalize(stmt);
     return caracteristicas;
 }
 
@@ -761,15 +898,15 @@ bool SQLiteAdapter::marcarCaracteristicaSincronizada(int idCaracteristica) {
     
     std::string sql = "UPDATE caracteristicas_hablantes SET sincronizado = 1 WHERE id_caracteristica = ?";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         return false;
     }
     
     sqlite3_bind_int(stmt, 1, idCaracteristica);
     
     bool exito = (sqlite3_step(stmt) == SQLITE_DONE);
-    sqlite3_finalize(stmt);
     
     return exito;
 }
@@ -787,8 +924,9 @@ std::vector<CaracteristicaHablante> SQLiteAdapter::obtenerCaracteristicasPorUsua
         WHERE id_usuario = ?
     )";
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    auto sentencia = preparar(sql);
+    sqlite3_stmt* stmt = sentencia.get();
+    if (!stmt) {
         throw std::runtime_error("Error preparando SELECT caracteristicas por usuario");
     }
     
@@ -817,7 +955,6 @@ std::vector<CaracteristicaHablante> SQLiteAdapter::obtenerCaracteristicasPorUsua
         caracteristicas.push_back(car);
     }
     
-    sqlite3_finalize(stmt);
     return caracteristicas;
 }
 
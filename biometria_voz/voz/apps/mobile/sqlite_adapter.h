@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <unordered_map>
 
 #include "../../external/sqlite3.h"
 #include "../../external/json.hpp"
@@ -56,18 +57,69 @@ struct CaracteristicaHablante {
     int sincronizado;
 };
 
+// ============================================================================
+// Sentencia del cache: al salir de scope se resetea (libera el lock de lectura)
+// ============================================================================
+
+class SentenciaPreparada {
+public:
+    explicit SentenciaPreparada(sqlite3_stmt* s = nullptr) : stmt(s) {}
+    ~SentenciaPreparada() {
+        if (stmt) {
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+        }
+    }
+
+    SentenciaPreparada(const SentenciaPreparada&) = delete;
+    SentenciaPreparada& operator=(const SentenciaPreparada&) = delete;
+
+    sqlite3_stmt* get() const { return stmt; }
+
+private:
+    sqlite3_stmt* stmt;
+};
+
 // ============================================================================
 // Adaptador SQLite para App Movil
 // ============================================================================
+// - WAL + synchronous=NORMAL: un commit no hace fsync del archivo principal
+// - Sentencias preparadas cacheadas por SQL (se finalizan al desconectar)
+// - Fila de datos + fila de cola_sincronizacion en la misma transaccion
 
 class SQLiteAdapter {
+public:
+    // Transaccion RAII: rollback si no se llama confirmar().
+    // Anidable: dentro de otra abre un SAVEPOINT; sin confirmar deshace solo su
+    // parte y la externa decide segun el resultado de la operacion
+    class Transaccion {
+    public:
+        explicit Transaccion(SQLiteAdapter& adapter);
+        ~Transaccion();
+
+        Transaccion(const Transaccion&) = delete;
+        Transaccion& operator=(const Transaccion&) = delete;
+
+        // false si no se pudo abrir o el COMMIT/RELEASE fallo (todo deshecho)
+        bool confirmar();
+
+    private:
+        sqlite3* db;
+        bool anidada;
+        bool activa;
+        bool terminada;
+    };
+
 private:
     sqlite3* db;
     std::string dbPath;
     bool conectado;
+    std::unordered_map<std::string, sqlite3_stmt*> cacheSentencias;
 
     void verificarConexion();
-    void registrarEnColaSincronizacion(const std::string& tabla, 
+    SentenciaPreparada preparar(const std::string& sql);
+    void finalizarSentencias();
+    bool registrarEnColaSincronizacion(const std::string& tabla, 
                                        const std::string& accion,
                                        const json& datos);
 
@@ -135,6 +187,19 @@ public:
     int insertarCaracteristicaLocal(int idUsuario, int idCredencial, 
                                     const std::vector<double>& features,
                                     const std::string& uuidDispositivo = "");
+    // Build float32 (VOZ_AUDIO_FLOAT32): el BLOB se guarda siempre en float64,
+    // el mismo formato que lee la sincronizacion sin importar la precision
+    int insertarCaracteristicaLocal(int idUsuario, int idCredencial, 
+                                    const std::vector<float>& features,
+                                    const std::string& uuidDispositivo = "");
+    // Lote: una sentencia preparada y un solo BEGIN/COMMIT. Todo o nada (lanza
+    // si una fila falla). Retorna los ids en el orden de la lista
+    std::vector<int> insertarCaracteristicasLocales(int idUsuario, int idCredencial,
+                                                    const std::vector<std::vector<double>>& lista,
+                                                    const std::string& uuidDispositivo = "");
+    std::vector<int> insertarCaracteristicasLocales(int idUsuario, int idCredencial,
+                                                    const std::vector<std::vector<float>>& lista,
+                                                    const std::string& uuidDispositivo = "");
     std::vector<CaracteristicaHablante> obtenerCaracteristicasPendientes();
     bool marcarCaracteristicaSincronizada(int idCaracteristica);
     std::vector<CaracteristicaHablante> obtenerCaracteristicasPorUsuario(int idUsuario);
@@ -1,6 +1,8 @@
 ﻿#include <utility>
 #include "autenticacion_service.h"
 #include "../../utils/http_helpers.h"
+#include "comun/metricas.h"
+#include "comun/trazas.h"
 #include "../../external/httplib.h"
 #include "../../external/json.hpp"
 #include "../../core/pipeline/audio_pipeline.h"
@@ -20,27 +22,52 @@ namespace fs = std::filesystem;
 // Normalización está en core/classification/svm_utils.cpp
 
 AutenticacionService::AutenticacionService(const std::string& modelPath,
-    const std::string& mappingPath) {
-    recargarModelo(modelPath);
-    recargarMapeos(mappingPath);  // mappingPath ahora se ignora, usa metadata.json
+    const std::string& mappingPath)
+    : actual(std::make_shared<const ModelSet>()) {
+    recargar(modelPath, mappingPath);  // mappingPath ahora se ignora, usa metadata.json
 }
 
-void AutenticacionService::recargarModelo(const std::string& modelPath) {
+static ModeloSVM cargarModelo(const std::string& modelPath) {
     // Cargar modelo modular si es un directorio
     if (fs::is_directory(modelPath)) {
         // Cargar modelo modular desde directorio
-        modelo = cargarModeloModular(modelPath);
+        return cargarModeloModular(modelPath);
     } else if (fs::exists(modelPath)) {
         // Fallback: cargar modelo monolítico antiguo (compatibilidad)
-        modelo = cargarModeloSVM(modelPath);
+        ModeloSVM modelo = cargarModeloSVM(modelPath);
         std::cout << "-> Modelo SVM monolítico cargado: " << modelo.clases.size() << " clases" << std::endl;
-    } else {
-        std::cout << "! Modelo no encontrado: " << modelPath << std::endl;
+        return modelo;
     }
+    std::cout << "! Modelo no encontrado: " << modelPath << std::endl;
+    return ModeloSVM{};
 }
 
-void AutenticacionService::recargarMapeos(const std::string& mappingPath) {
-    mapeoUsuarios.clear();
+// Coherencia interna + dimension que produce el pipeline actual. Sin clases
+// solo es valido si metadata.json tampoco tiene (se elimino el ultimo usuario)
+static bool validarModelo(const ModeloSVM& modelo, const std::map<int, std::string>& mapeo,
+    std::string& motivo) {
+    const size_t n = modelo.clases.size();
+    if (n == 0) {
+        if (mapeo.empty()) return true;
+        motivo = "modelo sin clases";
+        return false;
+    }
+    if (modelo.pesosPorClase.size() != n || modelo.biasPorClase.size() != n) {
+        motivo = "pesos/bias no coinciden con " + std::to_string(n) + " clases";
+        return false;
+    }
+    int esperada = CONFIG_MFCC.totalFeatures * (CONFIG_SVM.usarExpansionPolinomial ? 2 : 1);
+    for (const auto& w : modelo.pesosPorClase) {
+        if (w.size() != static_cast<size_t>(esperada)) {
+            motivo = "dimension " + std::to_string(w.size()) + " != " + std::to_string(esperada) + " del pipeline";
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::map<int, std::string> cargarMapeos(const std::string& mappingPath) {
+    std::map<int, std::string> mapeoUsuarios;
 
     // Cargar desde metadata.json (fuente de verdad)
     std::string metadataPath = obtenerRutaModelo() + "metadata.json";
@@ -81,14 +108,42 @@ void AutenticacionService::recargarMapeos(const std::string& mappingPath) {
             mapeo.close();
         }
     }
+    return mapeoUsuarios;
+}
+
+bool AutenticacionService::recargar(const std::string& modelPath, const std::string& mappingPath,
+    std::string* error) {
+    std::lock_guard<std::mutex> lock(mtxRecarga);
+
+    // Se arma fuera de la vista de los lectores; autenticar sigue con la actual
+    auto nuevo = std::make_shared<ModelSet>();
+    nuevo->modelo = cargarModelo(modelPath);
+    nuevo->mapeoUsuarios = cargarMapeos(mappingPath);
+
+    std::string motivo;
+    if (!validarModelo(nuevo->modelo, nuevo->mapeoUsuarios, motivo)) {
+        std::cerr << "! Recarga descartada (" << motivo << "), se mantiene modelo v"
+                  << instantanea()->version << std::endl;
+        if (error) *error = motivo;
+        return false;
+    }
+
+    nuevo->version = instantanea()->version + 1;
+    {
+        std::lock_guard<std::mutex> lock(mtxActual);
+        actual = std::shared_ptr<const ModelSet>(std::move(nuevo));
+    }
+    std::cout << "-> Modelo v" << instantanea()->version << " publicado ("
+              << instantanea()->modelo.clases.size() << " clases)" << std::endl;
+    return true;
 }
 
-bool AutenticacionService::procesarAudio(const std::string& audioPath, std::vector<AudioSample>& features) {
+bool AutenticacionService::procesarAudio(const AudioDecodificado& audio, std::vector<AudioSample>& features) {
     features.clear();
 
     // USAR PIPELINE CENTRALIZADO
     std::vector<std::vector<AudioSample>> todasFeatures;
-    if (!procesarAudioCompleto(audioPath, todasFeatures) || todasFeatures.empty()) {
+    if (!procesarAudioCompleto(audio, todasFeatures) || todasFeatures.empty()) {
         return false;
     }
 
@@ -121,6 +176,12 @@ bool AutenticacionService::procesarAudio(const std::string& audioPath, std::vect
     return true;
 }
 ResultadoAutenticacion AutenticacionService::autenticar(const std::string& audioPath, const std::string& identificador, int idFrase) {
+    // Si no decodifica, el audio vacio falla en procesarAudio (tras validar identificador)
+    AudioDecodificado audio = decodificarAudio(audioPath).value_or(AudioDecodificado{});
+    return autenticar(audio, identificador, idFrase);
+}
+
+ResultadoAutenticacion AutenticacionService::autenticar(const AudioDecodificado& audio, const std::string& identificador, int idFrase) {
     ResultadoAutenticacion resultado;
     auto inicio = std::chrono::high_resolution_clock::now();
 
@@ -162,6 +223,7 @@ ResultadoAutenticacion AutenticacionService::autenticar(const std::string& audio
                     return resultado;
                 }
                 
+                resultado.idUsuarioBD = usuarios[0].value("id_usuario", -1);
                 std::cout << "[DEBUG] Identificador validado OK" << std::endl;
             } catch (const std::exception& e) {
                 std::cerr << "[ERROR] Error parsing JSON: " << e.what() << std::endl;
@@ -173,7 +235,10 @@ ResultadoAutenticacion AutenticacionService::autenticar(const std::string& audio
             std::cout << "[DEBUG] === FIN VALIDACION IDENTIFICADOR ===" << std::endl;
         }
         
-        // 2. Verificar modelo
+        // 2. Verificar modelo. Una sola lectura de la instantanea: una recarga
+        // concurrente no cambia el modelo a mitad de la solicitud
+        const std::shared_ptr<const ModelSet> snap = instantanea();
+        const ModeloSVM& modelo = snap->modelo;
         if (modelo.clases.empty()) {
             resultado.exito = false;
             resultado.error = "No hay modelo entrenado";
@@ -182,16 +247,22 @@ ResultadoAutenticacion AutenticacionService::autenticar(const std::string& audio
 
         // Procesar audio
         std::vector<AudioSample> features;
-        if (!procesarAudio(audioPath, features)) {
+        if (!procesarAudio(audio, features)) {
             resultado.exito = false;
             resultado.error = "Error procesando audio";
             return resultado;
         }
         
+        static auto& hScoring = metricas::etapa("scoring");
+        auto inicioScoring = std::chrono::steady_clock::now();
+        trazas::Span sScoring("scoring");
+
         int idPredecido = predecirHablante(features, modelo);
 
         // Obtener scores
         auto scores = obtenerScores(features, modelo);
+        sScoring.terminar();
+        hScoring.observar(std::chrono::duration<double>(std::chrono::steady_clock::now() - inicioScoring).count());
 
         // ========================================================================
         // DEBUGGING: Imprimir TOP 5 scores para identificar confusiones
@@ -298,8 +369,8 @@ ResultadoAutenticacion AutenticacionService::autenticar(const std::string& audio
         // Construir resultado
         resultado.exito = true;
         resultado.userId = idPredecido;
-        resultado.userName = mapeoUsuarios.count(idPredecido) ?
-            mapeoUsuarios[idPredecido] : "Desconocido";
+        auto itNombre = snap->mapeoUsuarios.find(idPredecido);
+        resultado.userName = itNombre != snap->mapeoUsuarios.end() ? itNombre->second : "Desconocido";
         resultado.confianza = confianza;
         resultado.autenticado = autenticado;
 
@@ -333,7 +404,7 @@ ResultadoAutenticacion AutenticacionService::autenticar(const std::string& audio
             std::cout << "   * Frase esperada: \"" << resultado.fraseEsperada << "\"" << std::endl;
 
             // OBTENER TRANSCRIPCIÓN
-            resultado.transcripcionDetectada = obtenerTranscripcion(audioPath);
+            resultado.transcripcionDetectada = obtenerTranscripcion(audio.muestras, audio.sampleRate);
             std::cout << "   * Transcripcion detectada: \"" << resultado.transcripcionDetectada << "\"" << std::endl;
 
             // Calcular similitud
@@ -1,17 +1,22 @@
 ﻿#ifndef AUTENTICACION_SERVICE_H
 #define AUTENTICACION_SERVICE_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include "../../utils/config.h"
 #include "../../core/classification/svm.h"
+#include "../../core/pipeline/audio_pipeline.h"
 #include "../service/frases_service.h"
 struct ResultadoAutenticacion {
     bool exito;
     bool autenticado;
     int userId;
+    int idUsuarioBD = -1;  // id_usuario del identificador reclamado (-1: sin validar)
     std::string userName;
     double confianza;
     int tiempoProcesamiento;
@@ -26,21 +31,42 @@ struct ResultadoAutenticacion {
 };
 
 
-class AutenticacionService {
-private:
+// Instantanea inmutable de lo que usa la autenticacion. Nunca se modifica:
+// una recarga arma otra, la valida y la publica con un swap bajo mutex (RCU).
+// Las solicitudes en curso conservan la suya hasta terminar.
+struct ModelSet {
     ModeloSVM modelo;
     std::map<int, std::string> mapeoUsuarios;
+    uint64_t version = 0;
+};
+
+class AutenticacionService {
+private:
+    // shared_ptr bajo mutex (no std::atomic<shared_ptr>: GCC 10 de bullseye no lo
+    // tiene). El lock solo cubre la copia del puntero, nunca una autenticacion
+    mutable std::mutex mtxActual;
+    std::shared_ptr<const ModelSet> actual;
+    std::mutex mtxRecarga;  // solo entre escritores
     FrasesService frasesService;
 
 public:
     AutenticacionService(const std::string& modelPath, const std::string& mappingPath);
 
     ResultadoAutenticacion autenticar(const std::string& audioPath, const std::string& identificador = "", int idFrase = -1);
-    void recargarModelo(const std::string& modelPath);
-    void recargarMapeos(const std::string& mappingPath);
+    // Audio ya decodificado: el mismo PCM alimenta MFCC y ASR (sin releer el archivo)
+    ResultadoAutenticacion autenticar(const AudioDecodificado& audio, const std::string& identificador = "", int idFrase = -1);
+
+    // Carga modelo + mapeos en una instantanea nueva y la publica si es valida.
+    // Si no lo es, se conserva la actual y devuelve false (motivo en error)
+    bool recargar(const std::string& modelPath, const std::string& mappingPath, std::string* error = nullptr);
+
+    std::shared_ptr<const ModelSet> instantanea() const {
+        std::lock_guard<std::mutex> lock(mtxActual);
+        return actual;
+    }
 
 private:
-    bool procesarAudio(const std::string& audioPath, std::vector<AudioSample>& features);
+    bool procesarAudio(const AudioDecodificado& audio, std::vector<AudioSample>& features);
 };
 
 #endif
\ No newline at end of file
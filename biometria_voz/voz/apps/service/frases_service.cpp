@@ -1,11 +1,345 @@
 #include "frases_service.h"
 #include "../../utils/http_helpers.h"
-#include <random>
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+#include <unordered_map>
 
 using namespace HttpHelpers;
 
+namespace {
+
+constexpr int LIMITE_USOS_DEFAULT = 150;
+constexpr auto INTERVALO_FLUSH = std::chrono::seconds(2);      // usos pendientes -> BD
+constexpr auto INTERVALO_REFRESCO = std::chrono::seconds(15);  // cambios por updated_at
+constexpr auto INTERVALO_RECARGA = std::chrono::minutes(5);    // recarga completa (borrados)
+constexpr int FLUSH_MAX_USOS = 20;                             // flush anticipado
+constexpr auto ESPERA_MAX_REINTENTO = std::chrono::minutes(2); // backoff con la BD caida
+
+const char* SELECT_FRASES = "/textos_dinamicos_audio?select=id_texto,frase,estado_texto,contador_usos,limite_usos,updated_at";
+
+int enteroONulo(const nlohmann::json& fila, const char* campo, int porDefecto) {
+    auto it = fila.find(campo);
+    return (it != fila.end() && it->is_number_integer()) ? it->get<int>() : porDefecto;
+}
+
+struct FraseEnPool {
+    int idTexto = 0;
+    std::string frase;
+    int contadorUsos = 0;  // BD + usos locales aun no enviados
+    int limiteUsos = LIMITE_USOS_DEFAULT;
+};
+
+// Pool compartido por todas las instancias de FrasesService (controller y
+// autenticacion). Con varios procesos, cada uno ve el contador de la BD mas
+// sus usos locales: el exceso sobre limite_usos queda acotado por el lote.
+class PoolFrases {
+public:
+    static PoolFrases& instancia() {
+        static PoolFrases pool;
+        return pool;
+    }
+
+    // En la destruccion estatica no se hace HTTP (los estaticos del cliente
+    // pueden ya no existir): el ultimo envio lo hace detenerConEnvio()
+    ~PoolFrases() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            detener = true;
+            sinEnvioFinal = true;
+        }
+        cv.notify_all();
+        if (hilo.joinable()) hilo.join();
+    }
+
+    // Apagado ordenado: ultimo envio de usos y fin del hilo. Idempotente
+    void detenerConEnvio() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            detener = true;
+        }
+        cv.notify_all();
+        if (hilo.joinable()) hilo.join();
+    }
+
+    // Primer uso: carga sincronica (las siguientes las hace el hilo de fondo)
+    bool asegurarCargado() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (cargado) return true;
+        }
+        std::lock_guard<std::mutex> lockCarga(mtxCarga);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (cargado) return true;
+        }
+        return recargarCompleto();
+    }
+
+    std::optional<FraseEnPool> elegir() {
+        static thread_local std::mt19937 gen(std::random_device{}());
+
+        bool flushYa = false;
+        FraseEnPool elegida;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (elegibles.empty()) return std::nullopt;
+
+            std::uniform_int_distribution<size_t> dis(0, elegibles.size() - 1);
+            FraseEnPool& f = elegibles[dis(gen)];
+            ++f.contadorUsos;
+            ++pendientes[f.idTexto];
+            ++totalPendiente;
+            elegida = f;
+
+            // Agotada: sale del pool ya; la BD la desactiva en el proximo flush
+            if (f.contadorUsos >= f.limiteUsos) {
+                quitarSinLock(f.idTexto);
+                flushYa = true;
+            }
+            flushYa = flushYa || totalPendiente >= FLUSH_MAX_USOS;
+        }
+        if (flushYa) cv.notify_one();
+        return elegida;
+    }
+
+    void quitar(int idTexto) {
+        std::lock_guard<std::mutex> lock(mtx);
+        quitarSinLock(idTexto);
+    }
+
+    // Altas/reactivaciones: el hilo refresca en la proxima vuelta
+    void solicitarRefresco() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!cargado) return;  // la carga inicial ya la vera
+            ultimoRefresco = {};
+        }
+        cv.notify_one();
+    }
+
+private:
+    PoolFrases() : hilo(&PoolFrases::bucle, this) {}
+
+    void bucle() {
+        for (;;) {
+            bool terminar = false;
+            bool enviar = false;
+            bool refrescar = false;
+            bool recargar = false;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                // En backoff el lote lleno no despierta: solo el intervalo normal
+                cv.wait_for(lock, INTERVALO_FLUSH, [this] {
+                    return detener || ultimoRefresco == Reloj::time_point{} ||
+                           (totalPendiente >= FLUSH_MAX_USOS && Reloj::now() >= proximoEnvio);
+                });
+                terminar = detener;
+                auto ahora = Reloj::now();
+                enviar = terminar ? !sinEnvioFinal : ahora >= proximoEnvio;
+                if (cargado) {
+                    recargar = ahora - ultimaRecarga >= INTERVALO_RECARGA;
+                    refrescar = ahora - ultimoRefresco >= INTERVALO_REFRESCO;
+                }
+            }
+
+            if (enviar) enviarUsos();
+            if (terminar) break;
+
+            std::lock_guard<std::mutex> lockCarga(mtxCarga);
+            if (recargar) {
+                recargarCompleto();
+            } else if (refrescar) {
+                refrescarIncremental();
+            }
+        }
+    }
+
+    bool recargarCompleto() {
+        auto res = hacerGET(std::string(SELECT_FRASES) + "&estado_texto=eq.activo", 15);
+        nlohmann::json filas;
+        if (!procesarResponseGET(res, filas) || !filas.is_array()) {
+            std::cerr << "! FrasesService: no se pudo cargar el pool de frases" << std::endl;
+            std::lock_guard<std::mutex> lock(mtx);
+            ultimoRefresco = Reloj::now();  // reintento en el proximo intervalo
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mtx);
+        elegibles.clear();
+        indice.clear();
+        for (const auto& fila : filas) aplicarFilaSinLock(fila);
+
+        cargado = true;
+        ultimaRecarga = ultimoRefresco = Reloj::now();
+        std::cout << "-> FrasesService: pool cargado (" << elegibles.size() << " frases elegibles)" << std::endl;
+        return true;
+    }
+
+    void refrescarIncremental() {
+        std::string marca;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            marca = marcaUpdatedAt;
+        }
+        if (marca.empty()) {
+            recargarCompleto();
+            return;
+        }
+
+        // gte: filas con el mismo updated_at que la marca se reaplican (idempotente)
+        auto res = hacerGET(std::string(SELECT_FRASES) + "&updated_at=gte." + marca, 15);
+        nlohmann::json filas;
+        bool ok = procesarResponseGET(res, filas) && filas.is_array();
+
+        std::lock_guard<std::mutex> lock(mtx);
+        ultimoRefresco = Reloj::now();
+        if (!ok) return;
+        for (const auto& fila : filas) aplicarFilaSinLock(fila);
+    }
+
+    void enviarUsos() {
+        std::unordered_map<int, int> lote;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (pendientes.empty()) return;
+            lote.swap(pendientes);
+            totalPendiente = 0;
+        }
+
+        nlohmann::json usos = nlohmann::json::array();
+        for (const auto& [id, n] : lote) usos.push_back({{"id_texto", id}, {"usos", n}});
+
+        auto res = hacerPOST("/rpc/sumar_usos_frases", {{"p_usos", usos}}, 5);
+        nlohmann::json filas;
+        bool ok = res && res->status == 200;
+        if (ok) {
+            try {
+                filas = nlohmann::json::parse(res->body);
+            } catch (...) {
+                filas = nlohmann::json::array();
+            }
+        }
+        // 4xx: error de datos, reintentar el mismo lote no lo arregla
+        bool rechazado = res && res->status >= 400 && res->status < 500;
+
+        std::lock_guard<std::mutex> lock(mtx);
+        if (ok || rechazado) {
+            esperaReintento = INTERVALO_FLUSH;
+            proximoEnvio = {};
+        }
+        if (rechazado) {
+            std::cerr << "! FrasesService: contador de usos rechazado (" << res->status << "), se descartan "
+                      << lote.size() << " frases: " << res->body.substr(0, 200) << std::endl;
+            return;
+        }
+        if (!ok) {
+            // Se devuelven a pendientes: ningun uso se pierde mientras viva el proceso.
+            // Backoff exponencial: con la BD caida no se reintenta en cada uso
+            for (const auto& [id, n] : lote) {
+                pendientes[id] += n;
+                totalPendiente += n;
+            }
+            proximoEnvio = Reloj::now() + esperaReintento;
+            std::cerr << "! FrasesService: no se pudo enviar contador de usos ("
+                      << (res ? std::to_string(res->status) : std::string("sin respuesta"))
+                      << "), se reintenta en "
+                      << std::chrono::duration_cast<std::chrono::seconds>(esperaReintento).count() << " s"
+                      << std::endl;
+            esperaReintento = std::min<Reloj::duration>(esperaReintento * 2, ESPERA_MAX_REINTENTO);
+            return;
+        }
+
+        if (!filas.is_array()) return;
+        for (const auto& fila : filas) {
+            if (fila.value("estado_texto", std::string()) != "activo") {
+                std::cout << "# Frase ID " << enteroONulo(fila, "id_texto", 0)
+                          << " desactivada automaticamente (limite alcanzado)" << std::endl;
+            }
+            aplicarFilaSinLock(fila);
+        }
+    }
+
+    // Fila de la BD -> pool (alta, actualizacion o baja segun estado y usos)
+    void aplicarFilaSinLock(const nlohmann::json& fila) {
+        int id = enteroONulo(fila, "id_texto", -1);
+        if (id < 0) return;
+
+        auto itMarca = fila.find("updated_at");
+        if (itMarca != fila.end() && itMarca->is_string() && itMarca->get<std::string>() > marcaUpdatedAt) {
+            marcaUpdatedAt = itMarca->get<std::string>();
+        }
+
+        auto itPend = pendientes.find(id);
+        int contador = enteroONulo(fila, "contador_usos", 0) + (itPend != pendientes.end() ? itPend->second : 0);
+        int limite = enteroONulo(fila, "limite_usos", LIMITE_USOS_DEFAULT);
+        bool activa = fila.value("estado_texto", std::string("activo")) == "activo";
+
+        if (!activa || contador >= limite) {
+            quitarSinLock(id);
+            return;
+        }
+
+        auto it = indice.find(id);
+        if (it == indice.end()) {
+            // Filas del RPC no traen "frase": si no estaba en el pool, entra en el proximo refresco
+            if (!fila.contains("frase") || !fila["frase"].is_string()) return;
+            indice[id] = elegibles.size();
+            elegibles.push_back({id, fila["frase"].get<std::string>(), contador, limite});
+            return;
+        }
+
+        FraseEnPool& f = elegibles[it->second];
+        if (fila.contains("frase") && fila["frase"].is_string()) f.frase = fila["frase"].get<std::string>();
+        f.contadorUsos = contador;
+        f.limiteUsos = limite;
+    }
+
+    void quitarSinLock(int idTexto) {
+        auto it = indice.find(idTexto);
+        if (it == indice.end()) return;
+
+        size_t pos = it->second;
+        indice.erase(it);
+        if (pos + 1 != elegibles.size()) {
+            elegibles[pos] = std::move(elegibles.back());
+            indice[elegibles[pos].idTexto] = pos;
+        }
+        elegibles.pop_back();
+    }
+
+    using Reloj = std::chrono::steady_clock;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<FraseEnPool> elegibles;
+    std::unordered_map<int, size_t> indice;      // id_texto -> posicion en elegibles
+    std::unordered_map<int, int> pendientes;     // id_texto -> usos sin enviar
+    int totalPendiente = 0;
+    std::string marcaUpdatedAt;                  // mayor updated_at visto (ISO, comparable)
+    bool cargado = false;
+    bool detener = false;
+    bool sinEnvioFinal = false;                  // destruccion estatica: sin HTTP
+    Reloj::time_point proximoEnvio{};            // backoff tras un envio fallido
+    Reloj::duration esperaReintento{INTERVALO_FLUSH};
+    Reloj::time_point ultimoRefresco{Reloj::now()};
+    Reloj::time_point ultimaRecarga{};
+
+    std::mutex mtxCarga;  // una sola carga/refresco a la vez (HTTP fuera de mtx)
+    std::thread hilo;
+};
+
+} // namespace
+
+void FrasesService::detenerEnvioUsos() {
+    PoolFrases::instancia().detenerConEnvio();
+}
+
 nlohmann::json FrasesService::insertarFrase(const std::string& frase) {
     nlohmann::json body;
     body["frase"] = frase;
@@ -18,6 +352,7 @@ nlohmann::json FrasesService::insertarFrase(const std::string& frase) {
     if (procesarResponsePOST(res, output)) {
         response["success"] = true;
         response["message"] = "Frase agregada";
+        PoolFrases::instancia().solicitarRefresco();
         response["data"] = output;
     } else {
         response["success"] = false;
@@ -52,67 +387,28 @@ nlohmann::json FrasesService::obtenerTodas() {
 }
 
 nlohmann::json FrasesService::obtenerFraseAleatoria() {
-    // Obtener todas las frases activas
-    auto res = hacerGET("/textos_dinamicos_audio?estado_texto=eq.activo", 15);
-
-    nlohmann::json todasFrases;
-    if (!procesarResponseGET(res, todasFrases)) {
+    auto& pool = PoolFrases::instancia();
+    if (!pool.asegurarCargado()) {
         nlohmann::json error;
         error["success"] = false;
         error["error"] = "Error al obtener frases";
         return error;
     }
 
-    // Filtrar frases que NO hayan alcanzado el limite de usos
-    nlohmann::json frasesDisponibles = nlohmann::json::array();
-    for (const auto& frase : todasFrases) {
-        int contadorActual = frase.value("contador_usos", 0);
-        int limiteUsos = frase.value("limite_usos", 150);
-        
-        if (contadorActual < limiteUsos) {
-            frasesDisponibles.push_back(frase);
-        }
-    }
-
-    if (frasesDisponibles.empty()) {
+    auto elegida = pool.elegir();
+    if (!elegida) {
         nlohmann::json error;
         error["success"] = false;
         error["error"] = "No hay frases disponibles (todas alcanzaron el limite de usos)";
         return error;
     }
 
-    // Generador aleatorio
-    std::mt19937 gen(std::chrono::steady_clock::now().time_since_epoch().count());
-    std::uniform_int_distribution<> dis(0, frasesDisponibles.size() - 1);
-    int index = dis(gen);
-
-    int idTexto = frasesDisponibles[index]["id_texto"];
-    int contadorActual = frasesDisponibles[index].value("contador_usos", 0);
-    int limiteUsos = frasesDisponibles[index].value("limite_usos", 150);
-
-    // Incrementar contador de usos
-    nlohmann::json updateBody;
-    updateBody["contador_usos"] = contadorActual + 1;
-    
-    // Si alcanza el limite, desactivar automaticamente
-    if ((contadorActual + 1) >= limiteUsos) {
-        updateBody["estado_texto"] = "desactivado";
-        std::cout << "# Frase ID " << idTexto << " desactivada automaticamente (limite alcanzado)" << std::endl;
-    }
-
-    std::string urlUpdate = "/textos_dinamicos_audio?id_texto=eq." + std::to_string(idTexto);
-    auto resUpdate = hacerPATCH(urlUpdate, updateBody, 15);
-
-    if (!procesarResponseNoContent(resUpdate)) {
-        std::cerr << "! Warning: No se pudo actualizar contador de frase ID " << idTexto << std::endl;
-    }
-
     nlohmann::json response;
     response["success"] = true;
-    response["frase"] = frasesDisponibles[index]["frase"];
-    response["id_texto"] = idTexto;
-    response["contador_usos"] = contadorActual + 1;
-    response["limite_usos"] = limiteUsos;
+    response["frase"] = elegida->frase;
+    response["id_texto"] = elegida->idTexto;
+    response["contador_usos"] = elegida->contadorUsos;
+    response["limite_usos"] = elegida->limiteUsos;
     return response;
 }
 
@@ -127,6 +423,11 @@ nlohmann::json FrasesService::actualizarEstadoFrase(int id_texto, int activo) {
     if (procesarResponseNoContent(res)) {
         response["success"] = true;
         response["message"] = (activo == 1) ? "Frase activada" : "Frase desactivada";
+        if (activo == 1) {
+            PoolFrases::instancia().solicitarRefresco();
+        } else {
+            PoolFrases::instancia().quitar(id_texto);
+        }
     } else {
         response["success"] = false;
         response["message"] = "Error al actualizar estado";
@@ -174,6 +475,7 @@ nlohmann::json FrasesService::eliminarFrase(int id_texto) {
     if (procesarResponseNoContent(res)) {
         response["success"] = true;
         response["message"] = "Frase eliminada correctamente";
+        PoolFrases::instancia().quitar(id_texto);
     } else {
         response["success"] = false;
         response["message"] = "Error al eliminar frase";
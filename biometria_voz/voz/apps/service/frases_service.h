@@ -3,6 +3,12 @@
 #include <vector>
 #include "../../external/json.hpp"
 
+// obtenerFraseAleatoria() no consulta la tabla en cada llamada: usa un pool
+// compartido en memoria (todas las instancias) con las frases elegibles.
+// - Carga completa al primer uso; luego refresco incremental por updated_at
+// - Eleccion O(1) sobre un vector denso (quitar = swap con el ultimo)
+// - Los usos se acumulan localmente y un hilo de fondo los envia en lote a
+//   /rpc/sumar_usos_frases (incremento atomico en la BD, ver schema.sql)
 class FrasesService {
 public:
     nlohmann::json insertarFrase(const std::string& frase);
@@ -11,4 +17,8 @@ public:
     nlohmann::json actualizarEstadoFrase(int id_texto, int activo);
     nlohmann::json obtenerFrasePorId(int id);
     nlohmann::json eliminarFrase(int id_texto);
+
+    // Al apagar el servidor (antes de salir de main): envia los usos
+    // pendientes y detiene el hilo de fondo
+    static void detenerEnvioUsos();
 };
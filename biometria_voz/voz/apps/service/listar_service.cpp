@@ -1,6 +1,7 @@
 ﻿#include "listar_service.h"
 #include "../../external/json.hpp"
 #include "../../core/classification/svm.h"
+#include "../../core/pipeline/feature_cache.h"
 #include <fstream>
 #include <sstream>
 #include <filesystem>
@@ -122,6 +123,9 @@ bool ListarService::eliminarUsuario(int userId) {
         std::cout << "   & Usuario " << userId << " eliminado exitosamente" << std::endl;
         std::cout << "   & Clases restantes: " << clases.size() << std::endl;
 
+        // Features cacheadas de sus audios de registro: no deben sobrevivir al usuario
+        purgarCacheUsuario(userId);
+
         // 7. Recargar datos en memoria desde metadata.json
         recargarDatos("");  // El path ya no importa, ahora lee de metadata.json
 
@@ -0,0 +1,215 @@
+#include "reentreno_service.h"
+#include "comun/metricas.h"
+#include "comun/trazas.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX  // Evitar conflicto con std::min/std::max
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+
+namespace {
+
+metricas::Medidor& medidorPendientes() {
+    static auto& m = metricas::medidor("voz_reentreno_pendientes", "Registros esperando una pasada de reentreno");
+    return m;
+}
+
+// Baja prioridad solo para este hilo: la autenticacion no compite con el entrenamiento
+void bajarPrioridadHilo(int nice) {
+#ifdef _WIN32
+    (void)nice;
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__linux__)
+    // En Linux la prioridad es por hilo (tid), no por proceso
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), nice) != 0) {
+        std::cerr << "! Reentreno: no se pudo bajar la prioridad del hilo" << std::endl;
+    }
+#else
+    (void)nice;
+#endif
+}
+
+} // namespace
+
+ReentrenoService::ReentrenoService(FuncionEntrenar entrenarFn, FuncionPublicar publicarFn,
+                                   ConfigReentreno cfg)
+    : entrenar(std::move(entrenarFn)), publicar(std::move(publicarFn)), config(std::move(cfg)) {
+    if (const char* v = std::getenv("VOZ_REENTRENO_AGRUPAR_MS")) config.agruparMs = std::max(0, std::atoi(v));
+    if (config.maxHistorial == 0) config.maxHistorial = 1;
+
+    hilo = std::thread(&ReentrenoService::bucle, this);
+}
+
+ReentrenoService::~ReentrenoService() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        detener = true;
+    }
+    cv.notify_all();
+    if (hilo.joinable()) hilo.join();
+}
+
+uint64_t ReentrenoService::encolar(const std::string& identificador) {
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        id = siguienteId++;
+        Trabajo& t = trabajos[id];
+        t.identificador = identificador;
+        t.encolado = std::chrono::steady_clock::now();
+        pendientes.push_back(id);
+    }
+    medidorPendientes().sumar(1);
+    cv.notify_one();
+    return id;
+}
+
+void ReentrenoService::bucle() {
+    bajarPrioridadHilo(config.nice);
+
+    for (;;) {
+        std::vector<uint64_t> lote;
+        uint64_t pasada = 0;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this] { return detener || !pendientes.empty(); });
+            if (detener) break;
+
+            // Ventana de agrupacion: un pico de registros se entrena una sola vez
+            cv.wait_for(lock, std::chrono::milliseconds(config.agruparMs), [this] { return detener; });
+            if (detener) break;
+
+            lote.swap(pendientes);
+            pasada = ++pasadas;
+            entrenando = true;
+            for (uint64_t id : lote) {
+                Trabajo& t = trabajos[id];
+                t.estado = Estado::Entrenando;
+                t.pasada = pasada;
+                t.lote = lote.size();
+            }
+        }
+        medidorPendientes().sumar(-static_cast<double>(lote.size()));
+
+        ejecutarPasada(pasada, lote);
+    }
+}
+
+void ReentrenoService::ejecutarPasada(uint64_t pasada, const std::vector<uint64_t>& lote) {
+    static auto& hPasada = metricas::etapa("reentreno");
+    static auto& hLote = metricas::histograma("voz_reentreno_lote", "Registros cubiertos por una pasada de reentreno",
+                                              {}, {1, 2, 4, 8, 16, 32, 64});
+
+    std::cout << "\n-> Reentreno: pasada " << pasada << " para " << lote.size() << " registro(s)" << std::endl;
+    hLote.observar(static_cast<double>(lote.size()));
+
+    trazas::Span traza("reentreno", trazas::nuevoRid());
+    metricas::Temporizador t(hPasada);
+
+    ResultadoEntrenamientoModelo resultado;
+    try {
+        resultado = entrenar();
+    } catch (const std::exception& e) {
+        resultado.exito = false;
+        resultado.error = std::string("Excepcion: ") + e.what();
+    }
+
+    std::string errorPublicar;
+    bool publicado = resultado.exito && publicar(errorPublicar);
+    traza.terminar();
+
+    const char* etiqueta = publicado ? "ok" : (resultado.exito ? "rechazado" : "error");
+    metricas::contador("voz_reentreno_pasadas_total", "Pasadas de reentreno por resultado", {{"resultado", etiqueta}})
+        .inc();
+
+    if (publicado) {
+        std::cout << "-> Reentreno: pasada " << pasada << " publicada (" << resultado.numClases << " clases)"
+                  << std::endl;
+    } else {
+        std::cerr << "! Reentreno: pasada " << pasada << " sin publicar: "
+                  << (resultado.exito ? errorPublicar : resultado.error) << std::endl;
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    auto fin = std::chrono::steady_clock::now();
+    for (uint64_t id : lote) {
+        auto it = trabajos.find(id);
+        if (it == trabajos.end()) continue;
+        Trabajo& tr = it->second;
+        tr.estado = publicado ? Estado::Completado : Estado::Fallido;
+        tr.mensaje = publicado ? resultado.mensaje
+                               : (resultado.exito ? "Modelo entrenado pero rechazado: " + errorPublicar
+                                                  : resultado.error);
+        tr.numClases = resultado.numClases;
+        tr.fin = fin;
+        terminados.push_back(id);
+    }
+    entrenando = false;
+    podarHistorial();
+}
+
+// Llamar con mtx tomado
+void ReentrenoService::podarHistorial() {
+    while (terminados.size() > config.maxHistorial) {
+        trabajos.erase(terminados.front());
+        terminados.pop_front();
+    }
+}
+
+const char* ReentrenoService::nombreEstado(Estado e) {
+    switch (e) {
+        case Estado::Pendiente: return "pendiente";
+        case Estado::Entrenando: return "entrenando";
+        case Estado::Completado: return "completado";
+        case Estado::Fallido: return "fallido";
+    }
+    return "desconocido";
+}
+
+json ReentrenoService::aJson(uint64_t id, const Trabajo& t) const {
+    json j;
+    j["id"] = id;
+    j["identificador"] = t.identificador;
+    j["estado"] = nombreEstado(t.estado);
+    if (t.pasada > 0) {
+        j["pasada"] = t.pasada;
+        j["lote"] = t.lote;
+    }
+    if (t.estado == Estado::Completado || t.estado == Estado::Fallido) {
+        j["message"] = t.mensaje;
+        j["num_classes"] = t.numClases;
+        j["segundos"] = std::chrono::duration<double>(t.fin - t.encolado).count();
+    }
+    return j;
+}
+
+bool ReentrenoService::estado(uint64_t id, json& salida) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = trabajos.find(id);
+    if (it == trabajos.end()) return false;
+    salida = aJson(id, it->second);
+    return true;
+}
+
+json ReentrenoService::resumen() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    json j;
+    j["pendientes"] = pendientes.size();
+    j["entrenando"] = entrenando;
+    j["pasadas"] = pasadas;
+    if (!terminados.empty()) {
+        uint64_t ultimo = terminados.back();
+        j["ultimo"] = aJson(ultimo, trabajos.at(ultimo));
+    }
+    return j;
+}
@@ -0,0 +1,94 @@
+#ifndef REENTRENO_SERVICE_H
+#define REENTRENO_SERVICE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "registrar_service.h"
+#include "../../external/json.hpp"
+
+// =============================================================================
+// REENTRENO EN SEGUNDO PLANO (registro de biometria de voz)
+// - encolar() solo anota el trabajo: el registro responde apenas las features
+//   quedan en el dataset, sin esperar el entrenamiento
+// - Un hilo de baja prioridad junta lo pendiente (ventana agruparMs) y hace UNA
+//   pasada incremental para todo el lote; luego publica el modelo (swap de
+//   instantanea en AutenticacionService). Lo que llega durante una pasada va
+//   a la siguiente
+// - Una pasada entrena toda clase del dataset que falte en el modelo: si falla
+//   o el proceso se detiene, la siguiente pasada recupera esas clases (al
+//   arrancar, UsuarioController encola una si el dataset tiene clases de mas)
+// =============================================================================
+
+struct ConfigReentreno {
+    int agruparMs = 2000;        // espera tras el primer pendiente (VOZ_REENTRENO_AGRUPAR_MS)
+    int nice = 10;               // prioridad del hilo en Linux; en Windows BELOW_NORMAL
+    size_t maxHistorial = 256;   // trabajos terminados consultables por id
+};
+
+class ReentrenoService {
+public:
+    using FuncionEntrenar = std::function<ResultadoEntrenamientoModelo()>;
+    using FuncionPublicar = std::function<bool(std::string& error)>;
+
+    ReentrenoService(FuncionEntrenar entrenar, FuncionPublicar publicar,
+                     ConfigReentreno config = ConfigReentreno());
+    ~ReentrenoService();  // termina la pasada en curso; no empieza otra
+
+    ReentrenoService(const ReentrenoService&) = delete;
+    ReentrenoService& operator=(const ReentrenoService&) = delete;
+
+    // Id del trabajo para consultar su estado
+    uint64_t encolar(const std::string& identificador);
+
+    // false si el id no existe o ya salio del historial
+    bool estado(uint64_t id, nlohmann::json& salida) const;
+
+    // Pendientes, en curso y ultima pasada
+    nlohmann::json resumen() const;
+
+private:
+    enum class Estado { Pendiente, Entrenando, Completado, Fallido };
+
+    struct Trabajo {
+        std::string identificador;
+        Estado estado = Estado::Pendiente;
+        uint64_t pasada = 0;
+        size_t lote = 0;
+        std::string mensaje;
+        int numClases = 0;
+        std::chrono::steady_clock::time_point encolado{};
+        std::chrono::steady_clock::time_point fin{};
+    };
+
+    void bucle();
+    void ejecutarPasada(uint64_t pasada, const std::vector<uint64_t>& lote);
+    void podarHistorial();
+    static const char* nombreEstado(Estado e);
+    nlohmann::json aJson(uint64_t id, const Trabajo& t) const;
+
+    FuncionEntrenar entrenar;
+    FuncionPublicar publicar;
+    ConfigReentreno config;
+
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::map<uint64_t, Trabajo> trabajos;
+    std::vector<uint64_t> pendientes;
+    std::deque<uint64_t> terminados;  // orden de fin, para podar
+    uint64_t siguienteId = 1;
+    uint64_t pasadas = 0;
+    bool entrenando = false;
+    bool detener = false;
+
+    std::thread hilo;
+};
+
+#endif // REENTRENO_SERVICE_H
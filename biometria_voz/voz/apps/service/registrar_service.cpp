@@ -4,6 +4,7 @@
 #include "../../external/httplib.h"
 #include "../../external/json.hpp"
 #include "../../core/pipeline/audio_pipeline.h"
+#include "../../core/pipeline/feature_cache.h"
 #include "../../core/classification/svm.h"
 #include "../../core/classification/training/svm_training.h" 
 #include "../../core/process_dataset/dataset.h"
@@ -114,7 +115,7 @@ bool RegistrarService::procesarAudio(const std::string& audioPath, std::vector<A
     features.clear();
 
     std::vector<std::vector<AudioSample>> todasFeatures;
-    if (!procesarAudioCompleto(audioPath, todasFeatures) || todasFeatures.empty()) {
+    if (!procesarAudioConCache(audioPath, todasFeatures) || todasFeatures.empty()) {
         std::cerr << "   ! Pipeline fallo: no se generaron features" << std::endl;
         return false;
     }
@@ -150,6 +151,7 @@ ResultadoRegistro RegistrarService::registrarUsuario(const std::string& nombre,
     resultado.totalAudios = audiosPaths.size();
 
     std::vector<std::vector<AudioSample>> featuresList;
+    std::vector<uint64_t> clavesCache;  // audios del usuario en la cache de features
     
     std::cout << "\n" << std::string(70, '-') << std::endl;
     std::cout << "PROCESAMIENTO DE AUDIOS" << std::endl;
@@ -162,7 +164,10 @@ ResultadoRegistro RegistrarService::registrarUsuario(const std::string& nombre,
         std::cout << "\n[" << (i+1) << "/" << audiosPaths.size() << "] Procesando audio..." << std::endl;
         
         std::vector<std::vector<AudioSample>> audioFeatures;
-        if (!procesarAudioCompleto(path, audioFeatures) || audioFeatures.empty()) {
+        uint64_t clave = 0;
+        const bool ok = procesarAudioConCache(path, audioFeatures, &clave);
+        clavesCache.push_back(clave);
+        if (!ok || audioFeatures.empty()) {
             std::cerr << "   ! Audio rechazado\n" << std::endl;
             resultado.audiosFallidos++;
             continue;
@@ -191,6 +196,8 @@ ResultadoRegistro RegistrarService::registrarUsuario(const std::string& nombre,
         return resultado;
     }
 
+    std::unique_lock<std::mutex> lockDataset(mtxDataset);
+
     // Obtener nuevo ID
     int nuevoId = obtenerSiguienteId();
     resultado.userId = nuevoId;
@@ -203,6 +210,7 @@ ResultadoRegistro RegistrarService::registrarUsuario(const std::string& nombre,
         resultado.error = "No se pudo agregar ejemplos al dataset";
         return resultado;
     }
+    asociarCacheUsuario(nuevoId, clavesCache);
 
     // Ya no actualizamos speaker_mapping.txt (deprecated)
     // El mapeo se gestiona automáticamente en metadata.json durante el entrenamiento
@@ -223,7 +231,11 @@ ResultadoEntrenamientoModelo RegistrarService::entrenarModelo() {
         std::vector<std::vector<AudioSample>> X_train;
         std::vector<int> y_train;
 
-        if (!cargarDatasetBinario(trainDataPath, X_train, y_train)) {
+        std::unique_lock<std::mutex> lockDataset(mtxDataset);
+        bool datasetCargado = cargarDatasetBinario(trainDataPath, X_train, y_train);
+        lockDataset.unlock();  // los registros siguen mientras se entrena
+
+        if (!datasetCargado) {
             resultado.exito = false;
             resultado.error = "No se pudo cargar las caracteristicas de las clases";
             return resultado;
@@ -296,18 +308,22 @@ ResultadoEntrenamientoModelo RegistrarService::entrenarModelo() {
             // Crear set de clases existentes en el modelo
             std::set<int> clases_existentes(modelo_actual.clases.begin(), modelo_actual.clases.end());
             
-            // Detectar clases nuevas (presentes en dataset pero NO en modelo)
-            int clase_nueva = -1;
+            // Detectar clases nuevas (presentes en dataset pero NO en modelo).
+            // Varios registros agrupados por el reentreno en segundo plano
+            // se entrenan todos en esta pasada
+            std::vector<int> clases_nuevas;
             for (const auto& [clase, count] : ejemplos_por_clase) {
                 if (clases_existentes.find(clase) == clases_existentes.end()) {
-                    clase_nueva = clase;
-                    break;
+                    clases_nuevas.push_back(clase);
                 }
             }
 
-            if (clase_nueva == -1) {
-                resultado.exito = false;
-                resultado.error = "No se encontro una clase nueva para entrenar incrementalmente";
+            if (clases_nuevas.empty()) {
+                // Ya cubiertas por una pasada anterior (el reentreno agrupado lee
+                // el dataset completo, incluidos registros encolados despues)
+                resultado.exito = true;
+                resultado.mensaje = "Modelo al dia: sin clases nuevas";
+                resultado.numClases = static_cast<int>(modelo_actual.clases.size());
                 return resultado;
             }
 
@@ -315,25 +331,31 @@ ResultadoEntrenamientoModelo RegistrarService::entrenarModelo() {
             std::cout << "   Total ejemplos: " << X_train.size() << std::endl;
             std::cout << "   Clases detectadas: " << num_clases_dataset << std::endl;
             std::cout << "   Clases en modelo existente: " << modelo_actual.clases.size() << std::endl;
-            std::cout << "   Nueva clase detectada: " << clase_nueva << std::endl;
+            std::cout << "   Clases nuevas detectadas: " << clases_nuevas.size() << std::endl;
             std::cout << "   Dimension: " << X_train[0].size() << " features" << std::endl;
             
             // Mostrar distribucion por clase
             std::cout << "\n-> Distribucion por clase:" << std::endl;
             for (const auto& [clase, count] : ejemplos_por_clase) {
+                bool nueva = std::find(clases_nuevas.begin(), clases_nuevas.end(), clase) != clases_nuevas.end();
                 std::cout << "   Clase " << clase << ": " << count << " ejemplos" 
-                          << (clase == clase_nueva ? " <-- NUEVA" : "") << std::endl;
+                          << (nueva ? " <-- NUEVA" : "") << std::endl;
             }
 
-            // Entrenar SOLO esa clase con balance inteligente
-            if (!entrenarClaseIncremental(modeloBase, X_train, y_train, clase_nueva)) {
-                resultado.exito = false;
-                resultado.error = "No se pudo entrenar la clase incremental";
-                return resultado;
+            // Entrenar SOLO las clases nuevas con balance inteligente
+            // (cada una actualiza metadata.json antes de la siguiente)
+            for (int clase_nueva : clases_nuevas) {
+                if (!entrenarClaseIncremental(modeloBase, X_train, y_train, clase_nueva)) {
+                    resultado.exito = false;
+                    resultado.error = "No se pudo entrenar la clase incremental " + std::to_string(clase_nueva);
+                    return resultado;
+                }
             }
 
             resultado.exito = true;
-            resultado.mensaje = "Usuario agregado incrementalmente (balanceado)";
+            resultado.mensaje = clases_nuevas.size() == 1
+                ? "Usuario agregado incrementalmente (balanceado)"
+                : std::to_string(clases_nuevas.size()) + " usuarios agregados incrementalmente (balanceado)";
             
             // Contar clases totales desde metadata
             int num_clases_total, dimension;
@@ -344,7 +366,7 @@ ResultadoEntrenamientoModelo RegistrarService::entrenarModelo() {
                 resultado.numClases = 0; // Error al leer metadata
             }
 
-            std::cout << "\n-> Clase " << clase_nueva << " agregada. Total: "
+            std::cout << "\n-> " << clases_nuevas.size() << " clase(s) agregada(s). Total: "
                       << resultado.numClases << " clases" << std::endl;
         }
 
@@ -356,6 +378,39 @@ ResultadoEntrenamientoModelo RegistrarService::entrenarModelo() {
     return resultado;
 }
 
+bool RegistrarService::hayClasesSinEntrenar() {
+    std::set<int> clasesDataset;
+    {
+        std::lock_guard<std::mutex> lockDataset(mtxDataset);
+        std::ifstream in(trainDataPath, std::ios::binary);
+        if (!in.is_open()) return false;
+
+        // Formato por muestra: [dim:int][features:AudioSample*dim][label:int]
+        int dim;
+        while (in.read(reinterpret_cast<char*>(&dim), sizeof(int))) {
+            if (dim <= 0 || dim > 10000) break;
+            in.seekg(static_cast<std::streamoff>(sizeof(AudioSample)) * dim, std::ios::cur);
+            int label;
+            if (!in.read(reinterpret_cast<char*>(&label), sizeof(int))) break;
+            clasesDataset.insert(label);
+        }
+    }
+    if (clasesDataset.empty()) return false;
+
+    std::string modeloBase = obtenerRutaModelo();
+    if (!fs::exists(modeloBase + "metadata.json")) return true;
+
+    int numClases = 0, dimension = 0;
+    std::vector<int> clasesModelo;
+    if (!cargarMetadata(modeloBase, numClases, dimension, clasesModelo)) return false;
+
+    std::set<int> enModelo(clasesModelo.begin(), clasesModelo.end());
+    for (int clase : clasesDataset) {
+        if (!enModelo.count(clase)) return true;
+    }
+    return false;
+}
+
 json RegistrarService::registrarUsuarioCompleto(const std::string& nombre, const std::vector<std::string>& audioPaths) {
     std::cout << "\n========================================" << std::endl;
     std::cout << "  REGISTRO COMPLETO DE USUARIO" << std::endl;
@@ -367,13 +422,17 @@ json RegistrarService::registrarUsuarioCompleto(const std::string& nombre, const
 
     try {
         std::vector<std::vector<AudioSample>> featuresList;
+        std::vector<uint64_t> clavesCache;  // audios del usuario en la cache de features
         int audiosExitosos = 0;
         int audiosFallidos = 0;
 
         // Procesar cada audio
         for (size_t i = 0; i < audioPaths.size(); ++i) {
             std::vector<std::vector<AudioSample>> audioFeatures;
-            if (!procesarAudioCompleto(audioPaths[i], audioFeatures) || audioFeatures.empty()) {
+            uint64_t clave = 0;
+            const bool ok = procesarAudioConCache(audioPaths[i], audioFeatures, &clave);
+            clavesCache.push_back(clave);
+            if (!ok || audioFeatures.empty()) {
                 audiosFallidos++;
                 std::cerr << "   # Error procesando audio " << (i+1) << std::endl;
                 continue;
@@ -395,6 +454,8 @@ json RegistrarService::registrarUsuarioCompleto(const std::string& nombre, const
             return response;
         }
 
+        std::unique_lock<std::mutex> lockDataset(mtxDataset);
+
         // Obtener nuevo ID
         int nuevoId = obtenerSiguienteId();
         
@@ -406,6 +467,7 @@ json RegistrarService::registrarUsuarioCompleto(const std::string& nombre, const
             response["error"] = "No se pudo agregar muestras al dataset";
             return response;
         }
+        asociarCacheUsuario(nuevoId, clavesCache);
 
         // Actualizar mapeo en memoria
         mapeoUsuarios[nuevoId] = nombre;
@@ -512,13 +574,17 @@ json RegistrarService::registrarBiometriaPorCedula(const std::string& cedula, co
         
         // 2. Procesar audios
         std::vector<std::vector<AudioSample>> featuresList;
+        std::vector<uint64_t> clavesCache;  // audios del usuario en la cache de features
         int audiosExitosos = 0;
         int audiosFallidos = 0;
 
         // Procesar cada audio
         for (size_t i = 0; i < audioPaths.size(); ++i) {
             std::vector<std::vector<AudioSample>> audioFeatures;
-            if (!procesarAudioCompleto(audioPaths[i], audioFeatures) || audioFeatures.empty()) {
+            uint64_t clave = 0;
+            const bool ok = procesarAudioConCache(audioPaths[i], audioFeatures, &clave);
+            clavesCache.push_back(clave);
+            if (!ok || audioFeatures.empty()) {
                 audiosFallidos++;
                 std::cerr << "   # Error procesando audio " << (i+1) << std::endl;
                 continue;
@@ -545,14 +611,17 @@ json RegistrarService::registrarBiometriaPorCedula(const std::string& cedula, co
         // Agregar muestras al dataset
         std::vector<int> labels(featuresList.size(), nuevoId);
         
+        std::unique_lock<std::mutex> lockDataset(mtxDataset);
         if (!agregarMuestrasDataset(trainDataPath, featuresList, labels)) {
             response["success"] = false;
             response["error"] = "No se pudo agregar muestras al dataset";
             return response;
         }
+        asociarCacheUsuario(nuevoId, clavesCache);
 
         // Actualizar mapeo usando cedula como nombre
         mapeoUsuarios[nuevoId] = cedula;
+        lockDataset.unlock();
 
         // 4. Registrar credencial en la base de datos (ANTES de entrenar)
         std::cout << "\n[DEBUG] === REGISTRO DE CREDENCIAL EN BD ===" << std::endl;
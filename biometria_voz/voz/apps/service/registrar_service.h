@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
 #include "../../external/json.hpp"
 #include "../../utils/config.h"
 
@@ -40,9 +41,14 @@ public:
     json registrarBiometriaPorCedula(const std::string& cedula, 
                                      const std::vector<std::string>& audioPaths);
 
-    // Entrenar modelo (llamar DESPUÉS de registrar)
+    // Entrenar modelo (llamar DESPUÉS de registrar). Incremental: entrena en una
+    // sola pasada todas las clases del dataset que aun no estan en el modelo
     ResultadoEntrenamientoModelo entrenarModelo();
 
+    // true si el dataset tiene clases que el modelo publicado no tiene (registro
+    // cuyo reentreno no llego a correr). Solo lee etiquetas, no features
+    bool hayClasesSinEntrenar();
+
     // Legacy (mantener compatibilidad)
     ResultadoRegistro registrarUsuario(const std::string& nombre, 
                                        const std::vector<std::string>& audiosPaths);
@@ -51,6 +57,7 @@ private:
     std::string mappingPath;
     std::string trainDataPath;
     std::map<int, std::string> mapeoUsuarios;
+    std::mutex mtxDataset;  // registros concurrentes escriben el dataset; el reentreno lo lee
 
     void cargarMapeos();
     bool procesarAudio(const std::string& audioPath, std::vector<AudioSample>& features);
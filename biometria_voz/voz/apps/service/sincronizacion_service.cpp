@@ -1,5 +1,7 @@
 #include "sincronizacion_service.h"
 #include "../../utils/http_helpers.h"
+#include "comun/feature_codec.h"
+#include "comun/sync_bulk.h"
 #include "../../external/httplib.h"
 #include <iostream>
 #include <sstream>
@@ -26,56 +28,88 @@ json SincronizacionService::recibirCaracteristicas(const json& items,
     response["ids_procesados"] = json::array();
     
     try {
-        int procesados = 0;
+        // 1) Validar y armar filas. En bulk PostgREST exige las mismas claves en
+        //    todas las filas, por eso los opcionales van como null
+        std::vector<json> filas;
+        std::vector<size_t> indiceFila;   // fila -> indice en items
+        json resultados = json::array();
         
-        for (const auto& item : items) {
+        for (size_t i = 0; i < items.size(); ++i) {
+            const auto& item = items[i];
+            json resultado = {{"indice", i}};
+            
             try {
                 // Validar campos requeridos
-                if (!item.contains("id_usuario") || !item.contains("vector_features") || 
-                    !item.contains("dimension")) {
+                if (!item.contains("id_usuario") || !item.contains("dimension") ||
+                    (!item.contains("vector_features_b64") && !item.contains("vector_features"))) {
                     std::cerr << "# Item invalido, faltan campos requeridos" << std::endl;
+                    resultado["error"] = "faltan campos requeridos";
+                    resultados.push_back(resultado);
                     continue;
                 }
                 
-                int idUsuario = item["id_usuario"];
-                int idCredencial = item.value("id_credencial", 0);
-                std::vector<double> features = item["vector_features"];
-                int dimension = item["dimension"];
+                std::string idMuestra;
+                if (item.contains("id_muestra_cliente") && !item["id_muestra_cliente"].is_null()) {
+                    idMuestra = item["id_muestra_cliente"].is_string()
+                                    ? item["id_muestra_cliente"].get<std::string>()
+                                    : item["id_muestra_cliente"].dump();
+                    resultado["id_muestra_cliente"] = idMuestra;
+                }
                 
-                // Convertir vector a BYTEA
-                std::string vectorBytes = vectorToByteArray(features);
+                int idCredencial = item.value("id_credencial", 0);
+
+                // Formato compacto (blob FV en base64) o array JSON legado
+                std::vector<double> features;
+                if (item.contains("vector_features_b64")) {
+                    std::vector<uint8_t> blob;
+                    if (!decodificarBase64(item["vector_features_b64"].get<std::string>(), blob) ||
+                        !desempaquetarFeatures(blob.data(), blob.size(), features)) {
+                        std::cerr << "# Item invalido, vector_features_b64 corrupto" << std::endl;
+                        resultado["error"] = "vector_features_b64 corrupto";
+                        resultados.push_back(resultado);
+                        continue;
+                    }
+                } else {
+                    features = item["vector_features"].get<std::vector<double>>();
+                }
                 
-                // Construir JSON para insercion
                 json caracteristica;
-                caracteristica["id_usuario"] = idUsuario;
-                if (idCredencial > 0) {
-                    caracteristica["id_credencial"] = idCredencial;
-                }
-                caracteristica["vector_features"] = vectorBytes;
-                caracteristica["dimension"] = dimension;
+                caracteristica["id_usuario"] = item["id_usuario"].get<int>();
+                caracteristica["id_credencial"] = idCredencial > 0 ? json(idCredencial) : json(nullptr);
+                caracteristica["vector_features"] = vectorToByteArray(features);
+                caracteristica["dimension"] = item["dimension"].get<int>();
                 caracteristica["origen"] = "mobile";
                 caracteristica["uuid_dispositivo"] = uuidDispositivo;
+                caracteristica["id_muestra_cliente"] = idMuestra.empty() ? json(nullptr) : json(idMuestra);
                 
-                // Insertar en PostgreSQL via PostgREST
-                auto res = hacerPOST("/caracteristicas_hablantes", caracteristica);
-                
-                if (res && res->status == 201) {
-                    // PostgREST retorna el registro insertado con Prefer=return=representation
-                    json resultado = json::parse(res->body);
-                    if (resultado.is_array() && !resultado.empty()) {
-                        int idCaracteristica = resultado[0]["id_caracteristica"];
-                        response["ids_procesados"].push_back(idCaracteristica);
-                        procesados++;
-                        std::cout << "   @ Caracteristica insertada: ID=" << idCaracteristica 
-                                  << " Usuario=" << idUsuario << std::endl;
-                    }
-                } else {
-                    std::cerr << "# Error insertando caracteristica: " 
-                              << (res ? std::to_string(res->status) : "sin respuesta") << std::endl;
-                }
+                filas.push_back(std::move(caracteristica));
+                indiceFila.push_back(i);
                 
             } catch (const std::exception& e) {
                 std::cerr << "# Error procesando item: " << e.what() << std::endl;
+                resultado["error"] = e.what();
+            }
+            resultados.push_back(resultado);
+        }
+        
+        // 2) Insercion en bloque (chunks) en caracteristicas_hablantes; claves
+        //    repetidas, reintento fila por fila e idempotencia en comun/sync_bulk
+        auto cli = crearClientePostgREST(15);
+        const auto insertados = sync_bulk::insertar(cli, "caracteristicas_hablantes", filas, TAM_LOTE_SYNC,
+            [](sync_bulk::Nivel nivel, const std::string& msg) {
+                if (nivel == sync_bulk::Nivel::Aviso) std::cerr << "# Sync: " << msg << std::endl;
+                else std::cout << "   Sync: " << msg << std::endl;
+            });
+        
+        int procesados = 0;
+        for (size_t f = 0; f < filas.size(); ++f) {
+            json& resultado = resultados[indiceFila[f]];
+            if (insertados[f].idCaracteristica >= 0) {
+                resultado["id_caracteristica"] = insertados[f].idCaracteristica;
+                response["ids_procesados"].push_back(insertados[f].idCaracteristica);
+                procesados++;
+            } else {
+                resultado["error"] = insertados[f].error;
             }
         }
         
@@ -83,7 +117,9 @@ json SincronizacionService::recibirCaracteristicas(const json& items,
                   << " caracteristicas correctamente" << std::endl;
         
         response["procesados"] = procesados;
+        response["fallidos"] = (int)items.size() - procesados;
         response["total"] = items.size();
+        response["resultados"] = std::move(resultados);
         
     } catch (const std::exception& e) {
         std::cerr << "! Error recibiendo caracteristicas: " << e.what() << std::endl;
@@ -238,42 +274,17 @@ std::vector<uint8_t> SincronizacionService::obtenerModeloActualizado(const std::
 
 std::string SincronizacionService::vectorToByteArray(const std::vector<double>& vec) {
     // Convertir vector<double> a string hexadecimal para BYTEA de PostgreSQL
-    std::stringstream ss;
-    ss << "\\x";
-    
-    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(vec.data());
-    size_t numBytes = vec.size() * sizeof(double);
-    
-    for (size_t i = 0; i < numBytes; ++i) {
-        ss << std::hex << std::setw(2) << std::setfill('0') 
-           << static_cast<int>(bytes[i]);
-    }
-    
-    return ss.str();
+    return vectorAByteaHex(vec);
 }
 
 std::vector<double> SincronizacionService::byteArrayToVector(const std::string& byteArray) {
     // Convertir string hexadecimal de BYTEA a vector<double>
     // Formato esperado: \xAABBCC...
     
-    if (byteArray.size() < 2 || byteArray.substr(0, 2) != "\\x") {
+    std::vector<double> result;
+    if (!byteaHexAVector(byteArray, result)) {
         throw std::runtime_error("Formato BYTEA invalido");
     }
     
-    std::string hexData = byteArray.substr(2); // Remover \x
-    
-    std::vector<uint8_t> bytes;
-    for (size_t i = 0; i < hexData.length(); i += 2) {
-        std::string byteStr = hexData.substr(i, 2);
-        uint8_t byte = static_cast<uint8_t>(std::stoi(byteStr, nullptr, 16));
-        bytes.push_back(byte);
-    }
-    
-    // Convertir bytes a doubles
-    size_t numDoubles = bytes.size() / sizeof(double);
-    std::vector<double> result(numDoubles);
-    
-    std::memcpy(result.data(), bytes.data(), bytes.size());
-    
     return result;
 }
@@ -14,9 +14,10 @@ public:
     // ========================================================================
     // Mobile envia sus vectores pendientes
     // ========================================================================
-    // Recibe JSON con array de {id_usuario, id_credencial, vector_features[], dimension, uuid_dispositivo}
-    // Inserta en caracteristicas_hablantes (PostgreSQL)
-    // Retorna {ok, ids_procesados[]}
+    // Recibe JSON con array de {id_usuario, id_credencial, id_muestra_cliente, vector_features_b64 | vector_features[], dimension}
+    // Inserta en caracteristicas_hablantes en lotes (POST con body array), idempotente
+    // por (uuid_dispositivo, id_muestra_cliente): reenviar el mismo lote no duplica
+    // Retorna {ok, ids_procesados[], procesados, fallidos, resultados[{indice, id_caracteristica | error}]}
     json recibirCaracteristicas(const json& items, const std::string& uuidDispositivo);
     
     // ========================================================================
@@ -34,6 +35,8 @@ public:
     std::vector<uint8_t> obtenerModeloActualizado(const std::string& cedula);
     
 private:
+    static constexpr size_t TAM_LOTE_SYNC = 50;
+    
     // Convertir vector<double> a BYTEA para PostgreSQL
     std::string vectorToByteArray(const std::vector<double>& vec);
     
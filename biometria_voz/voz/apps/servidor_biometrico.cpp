@@ -5,10 +5,13 @@
 #include <chrono>
 #include "controller/usuario_controller.h"
 #include "../utils/http_helpers.h"
+#include "comun/metricas_http.h"
 #include "../external/httplib.h"
 #include "../external/json.hpp"
 #include "controller/frases_controller.h"
 #include "../utils/config.h"  
+#include "../core/asr/motor_asr.h"
+#include "../core/pipeline/audio_pipeline.h"
 
 using json = nlohmann::json;
 namespace fs = std::filesystem;
@@ -60,6 +63,12 @@ int main() {
     auto usuarioController = std::make_unique<UsuarioController>();
     auto frasesController = std::make_unique<FrasesController>();
 
+    // VOZ_TRAZAS_TASA=0.01 -> 1% de las solicitudes trazadas en VOZ_TRAZAS_DIR
+    trazas::configurarDesdeEntorno("voz_servidor_biometrico", "VOZ_TRAZAS_");
+
+    // Cargar el motor ASR al arrancar (no en la primera autenticacion)
+    obtenerMotorASR();
+
     // CREAR SERVIDOR HTTP
     httplib::Server svr;
 
@@ -91,16 +100,10 @@ int main() {
             std::cout << "-> Identificador: " << identificador << std::endl;
             std::cout << "-> ID Frase: " << idFrase << std::endl;
 
-            // Guardar archivo temporal
-            std::string tempPath = guardarArchivoTemporal(audioFile, "auth");
-            if (tempPath.empty()) {
-                json error;
-                error["success"] = false;
-                error["error"] = "Error al guardar archivo temporal";
-                res.status = 500;
-                res.set_content(error.dump(), "application/json; charset=utf-8");
-                return;
-            }
+            // Decodificar en memoria una sola vez (sin archivo temporal):
+            // el mismo PCM se usa para MFCC y para la transcripcion
+            AudioDecodificado audio =
+                decodificarAudio(audioFile.content, audioFile.filename).value_or(AudioDecodificado{});
             
             // Extraer IP del cliente
             std::string ipCliente = req.get_header_value("X-Forwarded-For");
@@ -109,7 +112,7 @@ int main() {
             std::string userAgent = req.get_header_value("User-Agent");
             
             // Autenticar (el servicio valida si el identificador existe)
-            json result = usuarioController->autenticar(tempPath, identificador, idFrase, ipCliente, userAgent);
+            json result = usuarioController->autenticar(audio, identificador, idFrase, ipCliente, userAgent);
             
             // Log resultado
             if (result["success"] == true && result["authenticated"] == true) {
@@ -120,9 +123,6 @@ int main() {
                 std::cout << "-> AUTENTICACION DENEGADA" << std::endl;
             }
             std::cout << std::string(60, '=') << "\n" << std::endl;
-            
-            // Limpiar temporal
-            fs::remove(tempPath);
 
             res.set_content(result.dump(), "application/json; charset=utf-8");
 
@@ -222,6 +222,27 @@ int main() {
 
 
 
+    // GET /voz/reentreno/:id - Estado del reentreno encolado por un registro
+    svr.Get("/voz/reentreno/:id", [&usuarioController](const httplib::Request& req, httplib::Response& res) {
+        try {
+            uint64_t id = std::stoull(req.path_params.at("id"));
+            json result = usuarioController->estadoReentreno(id);
+            res.status = result["success"] == true ? 200 : 404;
+            res.set_content(result.dump(), "application/json; charset=utf-8");
+        } catch (const std::exception&) {
+            json error;
+            error["success"] = false;
+            error["error"] = "Id de reentreno invalido";
+            res.status = 400;
+            res.set_content(error.dump(), "application/json; charset=utf-8");
+        }
+    });
+
+    // GET /voz/reentreno - Pendientes, pasada en curso y ultimo resultado
+    svr.Get("/voz/reentreno", [&usuarioController](const httplib::Request&, httplib::Response& res) {
+        res.set_content(usuarioController->resumenReentreno().dump(), "application/json; charset=utf-8");
+    });
+
     // GET /voz/usuarios - Listar usuarios
     svr.Get("/voz/usuarios", [&usuarioController](const httplib::Request&, httplib::Response& res) {
         std::cout << "\n" << std::string(60, '-') << std::endl;
@@ -473,13 +494,17 @@ int main() {
     });
 
     // CONFIGURACIÓN CORS Y OPTIONS
-    // Configurar CORS para permitir peticiones desde cualquier origen
-    svr.set_pre_routing_handler([](const httplib::Request&, httplib::Response& res) {
+    // Configurar CORS para permitir peticiones desde cualquier origen.
+    // Va encadenado a la instrumentacion (GET /metrics, latencias y cola HTTP)
+    metricas_http::Opciones instrumentacion;
+    instrumentacion.trazaPorSolicitud = true;  // rid en X-Request-Id y raiz de traza por solicitud
+    instrumentacion.preRuteo = [](const httplib::Request&, httplib::Response& res) {
         res.set_header("Access-Control-Allow-Origin", "*");
         res.set_header("Access-Control-Allow-Methods", "GET, POST, PATCH, DELETE, OPTIONS");
         res.set_header("Access-Control-Allow-Headers", "Content-Type");
         return httplib::Server::HandlerResponse::Unhandled;
-    });
+    };
+    metricas_http::instrumentarServidorHttp(svr, instrumentacion);
 
     // Manejar peticiones OPTIONS (preflight CORS)
     svr.Options(".*", [](const httplib::Request&, httplib::Response& res) {
@@ -489,5 +514,6 @@ int main() {
     // INICIAR SERVIDOR
     std::cout << "\n-> Servidor biometrico de la voz activo en http://0.0.0.0:8081 \n"  << std::endl;
     svr.listen("0.0.0.0", 8081);
+    FrasesService::detenerEnvioUsos();  // ultimo envio de usos antes de los destructores estaticos
     return 0;
 }
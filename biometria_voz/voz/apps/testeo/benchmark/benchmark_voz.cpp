@@ -0,0 +1,169 @@
+// ============================================================================
+// MICRO-BENCHMARKS DEL PIPELINE DE VOZ
+// ============================================================================
+// Cada etapa (VAD, STFT, MFCC, pipeline completo, scoring SVM, carga de
+// modelo) medida por separado sobre fixtures sinteticos deterministas: no
+// hace falta dataset ni modelo entrenado.
+//
+// Uso: voz_benchmark [--filtro=mfcc] [--json=bench.json] [--base=bench_prev.json]
+//   Para aceptar una optimizacion: correr la rama base con --json=base.json
+//   y la rama nueva con --base=base.json (codigo 2 si hay regresion)
+//
+// Target opcional: cmake -DVOZ_BENCHMARK=ON -DCMAKE_BUILD_TYPE=Release
+// ============================================================================
+#include "comun/micro_benchmark.h"
+
+#include <cmath>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+#include "../../../core/pipeline/audio_pipeline.h"
+#include "../../../core/pipeline/pipeline_streaming.h"
+#include "../../../core/preprocessing/preprocesar.h"
+#include "../../../core/segmentation/stft.h"
+#include "../../../core/features/mfcc.h"
+#include "../../../core/classification/svm.h"
+#include "../../../utils/config.h"
+
+namespace fs = std::filesystem;
+
+static constexpr int SAMPLE_RATE = 16000;
+static constexpr double DURACION_SEG = 3.0;
+static constexpr int NUM_HABLANTES = 50;
+static constexpr size_t BLOQUE_STREAMING = 4096;
+
+/**
+ * Voz sintetica: tramos sonoros (f0 ~120 Hz, 10 armonicos, modulacion
+ * silabica de 4 Hz) separados por silencios, con ruido de fondo
+ * Semilla fija: mismo PCM en cada corrida
+ */
+static std::vector<AudioSample> vozSintetica(int sampleRate, double segundos) {
+    const size_t n = static_cast<size_t>(sampleRate * segundos);
+    std::vector<AudioSample> pcm(n);
+    std::mt19937 gen(11);
+    std::normal_distribution<double> ruido(0.0, 0.002);
+
+    for (size_t i = 0; i < n; ++i) {
+        const double t = static_cast<double>(i) / sampleRate;
+        // 0.6 s de voz / 0.25 s de silencio
+        const bool sonoro = std::fmod(t, 0.85) < 0.6;
+        double s = 0.0;
+        if (sonoro) {
+            const double f0 = 120.0 + 15.0 * std::sin(2.0 * M_PI * 0.7 * t);
+            const double envolvente = 0.5 + 0.5 * std::sin(2.0 * M_PI * 4.0 * t);
+            for (int h = 1; h <= 10; ++h) {
+                s += std::sin(2.0 * M_PI * f0 * h * t) / h;
+            }
+            s *= 0.15 * envolvente;
+        }
+        pcm[i] = static_cast<AudioSample>(s + ruido(gen));
+    }
+    return pcm;
+}
+
+int main(int argc, char* argv[]) {
+    SuiteBenchmark suite("voz", argc, argv);
+#ifdef NDEBUG
+    suite.anotar("build", "release");
+#else
+    suite.anotar("build", "debug");
+#endif
+    suite.anotar("precision", sizeof(AudioSample) == sizeof(float) ? "float" : "double");
+
+    CONFIG_PREP.verbose = false;
+
+    // ===== Fixtures =====
+    const auto pcm = vozSintetica(SAMPLE_RATE, DURACION_SEG);
+    const double muestras = static_cast<double>(pcm.size());
+
+    const auto voz = applyVAD(pcm, SAMPLE_RATE);
+    const auto espectrograma = applySTFT(voz, SAMPLE_RATE);
+    const auto mfcc = extractMFCC(espectrograma, SAMPLE_RATE);
+    const auto features = extraerFeatures(pcm, SAMPLE_RATE);
+    if (voz.empty() || espectrograma.empty() || mfcc.empty() || !features) {
+        std::cerr << "! Fixture sintetico invalido (VAD/STFT/MFCC vacio)" << std::endl;
+        return 1;
+    }
+    const double frames = static_cast<double>(espectrograma.size());
+
+    // Modelo OVA aleatorio con la dimension real de las features
+    std::mt19937 gen(42);
+    std::normal_distribution<double> normal(0.0, 0.1);
+    ModeloSVM modelo;
+    modelo.dimensionCaracteristicas = static_cast<int>(features->size());
+    for (int c = 0; c < NUM_HABLANTES; ++c) {
+        std::vector<AudioSample> w(features->size());
+        for (auto& v : w) v = static_cast<AudioSample>(normal(gen));
+        modelo.clases.push_back(c + 1);
+        modelo.pesosPorClase.push_back(std::move(w));
+        modelo.biasPorClase.push_back(0.0);
+        modelo.plattAPorClase.push_back(1.0);
+        modelo.plattBPorClase.push_back(0.0);
+        modelo.thresholdsPorClase.push_back(0.0);
+    }
+
+    const fs::path dirModelo = fs::temp_directory_path() / "voz_benchmark_modelo";
+    fs::create_directories(dirModelo);
+    const std::string rutaModelo = dirModelo.string() + "/";
+    if (!guardarModeloModular(rutaModelo, modelo)) {
+        std::cerr << "! No se pudo guardar el modelo de prueba en " << rutaModelo << std::endl;
+        return 1;
+    }
+
+    // ===== Preprocesamiento =====
+    suite.agregar("vad/applyVAD_3s", "muestra", muestras, [&] {
+        noOptimizar(applyVAD(pcm, SAMPLE_RATE));
+    });
+    suite.agregar("vad/streaming_3s", "muestra", muestras, [&] {
+        VADStreaming<AudioSample> vad(SAMPLE_RATE);
+        std::vector<AudioSample> salida;
+        for (size_t i = 0; i < pcm.size(); i += BLOQUE_STREAMING) {
+            vad.procesar(pcm.data() + i, std::min(BLOQUE_STREAMING, pcm.size() - i), salida);
+        }
+        vad.finalizar(salida);
+        noOptimizar(salida);
+    });
+    suite.agregar("preproc/normalizeRMS_3s", "muestra", muestras, [&] {
+        noOptimizar(normalizeRMS(voz, CONFIG_PREP.normalizationTargetRMS));
+    });
+
+    // ===== Features =====
+    suite.agregar("stft/applySTFT", "frame", frames, [&] {
+        noOptimizar(applySTFT(voz, SAMPLE_RATE));
+    });
+    suite.agregar("mfcc/extractMFCC", "frame", frames, [&] {
+        noOptimizar(extractMFCC(espectrograma, SAMPLE_RATE));
+    });
+    suite.agregar("mfcc/estadisticas", "frame", static_cast<double>(mfcc.size()), [&] {
+        noOptimizar(calcularEstadisticasMFCC(mfcc));
+    });
+    suite.agregar("pipeline/extraerFeatures_3s", "muestra", muestras, [&] {
+        noOptimizar(extraerFeatures(pcm, SAMPLE_RATE));
+    });
+    suite.agregar("pipeline/streaming_3s", "muestra", muestras, [&] {
+        ExtractorFeaturesStreaming extractor(SAMPLE_RATE);
+        for (size_t i = 0; i < pcm.size(); i += BLOQUE_STREAMING) {
+            extractor.agregar(pcm.data() + i, std::min(BLOQUE_STREAMING, pcm.size() - i));
+        }
+        noOptimizar(extractor.finalizar());
+    });
+
+    // ===== Scoring =====
+    suite.agregar("svm/obtenerScores_50", "clase", NUM_HABLANTES, [&] {
+        noOptimizar(obtenerScores(*features, modelo));
+    });
+    suite.agregar("svm/predecirHablante_50", "clase", NUM_HABLANTES, [&] {
+        noOptimizar(predecirHablante(*features, modelo));
+    });
+
+    // ===== Carga de modelo =====
+    suite.agregar("modelo/cargarModeloModular_50", "modelo", 1.0, [&] {
+        noOptimizar(cargarModeloModular(rutaModelo));
+    });
+
+    const int rc = suite.ejecutar();
+    std::error_code ec;
+    fs::remove_all(dirModelo, ec);
+    return rc;
+}
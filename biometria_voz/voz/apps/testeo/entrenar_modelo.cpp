@@ -1,6 +1,7 @@
 ﻿#include "../../utils/config.h"
 #include "../../core/classification/svm.h"
 #include "../../core/process_dataset/dataset.h"
+#include "comun/trazas.h"
 #include <iostream>
 #include <chrono>
 #include <filesystem>
@@ -201,6 +202,10 @@ int main(int argc, char *argv[])
     std::cout << "*  ENTRENAMIENTO SVM - SISTEMA BIOMETRICO DE VOZ  *" << std::endl;
     std::cout << std::string(70, '*') << std::endl;
 
+    // VOZ_TRAZAS_TASA=1 -> traza de la corrida (fases del hilo principal) en VOZ_TRAZAS_DIR
+    trazas::configurarDesdeEntorno("voz_entrenar_modelo", "VOZ_TRAZAS_");
+    trazas::Span traza("voz_entrenar_modelo", trazas::nuevoRid());
+
     // CONFIGURACION DE RUTAS
     std::string rutaTrain = obtenerRutaDatasetTrain();
     std::string rutaTest = obtenerRutaDatasetTest();
@@ -222,6 +227,7 @@ int main(int argc, char *argv[])
     std::vector<int> y_train, y_test;
 
     ProfilerEtapa profilerCarga("Carga_Datasets");
+    trazas::Span spanCarga("carga_datasets");
     std::thread monitorThreadCarga;
 
     if (CONFIG_PROFILING.habilitado)
@@ -244,6 +250,7 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    spanCarga.terminar();
     MetricasRendimiento metricasCarga;
     if (CONFIG_PROFILING.habilitado)
     {
@@ -330,7 +337,9 @@ int main(int argc, char *argv[])
         monitorThreadEntrenamiento = std::thread(monitorearRecursos, &profilerEntrenamiento);
     }
 
+    trazas::Span spanEntrenamiento("entrenamiento_svm");
     ModeloSVM modelo = entrenarSVMOVA(X_train, y_train);
+    spanEntrenamiento.terminar();
 
     MetricasRendimiento metricasEntrenamiento;
     if (CONFIG_PROFILING.habilitado)
@@ -368,8 +377,11 @@ int main(int argc, char *argv[])
         monitorThreadEvaluacion = std::thread(monitorearRecursos, &profilerEvaluacion);
     }
 
-    evaluarModeloCompleto(X_train, y_train, modelo, "ENTRENAMIENTO");
-    evaluarModeloCompleto(X_test, y_test, modelo, "PRUEBA");
+    {
+        trazas::Span spanEvaluacion("evaluacion");
+        evaluarModeloCompleto(X_train, y_train, modelo, "ENTRENAMIENTO");
+        evaluarModeloCompleto(X_test, y_test, modelo, "PRUEBA");
+    }
 
     MetricasRendimiento metricasEvaluacion;
     if (CONFIG_PROFILING.habilitado)
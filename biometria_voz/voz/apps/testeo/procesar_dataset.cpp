@@ -16,6 +16,7 @@
 #include <omp.h>
 #include "../../utils/config.h"
 #include "../../core/process_dataset/dataset.h"
+#include "../../core/process_dataset/dataset_shards.h"
 #include "../../core/pipeline/audio_pipeline.h"
 #include <numeric>
 
@@ -163,21 +164,18 @@ void monitorearRecursos(ProfilerEtapa* profiler) {
 }
 
 /**
- * Estructura para muestra de audio procesada
+ * Audio del split (train o test). Las features viven en el almacen de shards;
+ * aca solo se guarda la identidad del contenido
  */
 struct AudioSampleData {
     fs::path path;
     int etiqueta;
-    std::vector<AudioSample> features;
-    bool procesado;
+    uint64_t hash = 0;
+    uint64_t bytes = 0;
+    bool legible = false;
 
     AudioSampleData(const fs::path& p, int e)
-        : path(p), etiqueta(e), procesado(false) {
-        features.reserve(CONFIG_MFCC.totalFeatures);
-    }
-
-    AudioSampleData(const fs::path& p, int e, std::vector<AudioSample>&& f)
-        : path(p), etiqueta(e), features(std::move(f)), procesado(true) {
+        : path(p), etiqueta(e) {
     }
 };
 
@@ -350,15 +348,29 @@ void dividirTrainTest(
         << testSamples.size() << " test" << std::endl;
 }
 
+// HASH DE CONTENIDO (decide que audios hay que procesar)
+
+void hashearArchivos(std::vector<AudioSampleData*>& samples) {
+    const int total = static_cast<int>(samples.size());
+
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int i = 0; i < total; ++i) {
+        auto* s = samples[i];
+        s->legible = hashArchivo(s->path, s->hash, s->bytes);
+    }
+}
+
 // PROCESAMIENTO PARALELO USANDO PIPELINE
+// Cada thread escribe en su propio shard apenas termina un audio: una caida
+// solo pierde los audios en curso, y al relanzar se saltan los ya indexados
 
-void procesarMuestrasParalelo(
-    std::vector<AudioSampleData>& samples,
-    const std::string& tipo,
+void procesarPendientes(
+    const std::vector<AudioSampleData*>& pendientes,
+    AlmacenShards& almacen,
     EstadisticasProcesamiento& stats,
     MetricasRendimiento* metricas = nullptr) {
 
-    std::cout << "\n-> Procesando " << samples.size() << " archivos [" << tipo << "]"
+    std::cout << "\n-> Procesando " << pendientes.size() << " archivos nuevos o modificados"
         << std::endl;
 
     // Informar modo de procesamiento
@@ -375,7 +387,7 @@ void procesarMuestrasParalelo(
     }
 
     // Profiling
-    ProfilerEtapa profiler("Procesamiento_" + tipo);
+    ProfilerEtapa profiler("Procesamiento");
     std::thread monitorThread;
 
     if (CONFIG_PROFILING.habilitado) {
@@ -383,58 +395,49 @@ void procesarMuestrasParalelo(
         monitorThread = std::thread(monitorearRecursos, &profiler);
     }
 
-    int total = static_cast<int>(samples.size());
+    int total = static_cast<int>(pendientes.size());
     std::atomic<int> procesados{ 0 };
 
-#pragma omp parallel for schedule(dynamic)
-    for (int i = 0; i < total; ++i) {
-        //  USAR PIPELINE: Una sola llamada procesa todo
+#pragma omp parallel
+    {
+        // Buffer por thread: se reutiliza entre audios
         std::vector<std::vector<AudioSample>> allFeatures;
-        bool exito = procesarAudioCompleto(samples[i].path, allFeatures);
+        const int worker = omp_get_thread_num();
 
-        if (exito && !allFeatures.empty()) {
-            stats.totalExitosos++;
-            stats.audiosCrudos++;
-            stats.muestrasGeneradas += static_cast<int>(allFeatures.size());
+#pragma omp for schedule(dynamic)
+        for (int i = 0; i < total; ++i) {
+            const AudioSampleData& s = *pendientes[i];
 
-#pragma omp critical
-            {
-                stats.muestrasPorHablante[samples[i].etiqueta] +=
-                    static_cast<int>(allFeatures.size());
-
-                // Expandir samples con todas las muestras generadas
-                for (size_t v = 0; v < allFeatures.size(); ++v) {
-                    samples.emplace_back(
-                        samples[i].path,
-                        samples[i].etiqueta,
-                        std::move(allFeatures[v])
-                    );
-                }
+            //  USAR PIPELINE: Una sola llamada procesa todo
+            bool exito = procesarAudioCompleto(s.path, allFeatures);
+            if (!exito) allFeatures.clear();
+
+            // Los fallidos tambien se registran (0 muestras): no se reintentan si no cambian
+            if (!almacen.guardar(worker, s.hash, s.bytes, s.path.string(), s.etiqueta, allFeatures)) {
+                exito = false;
             }
-        }
-        else {
-            stats.totalFallidos++;
-        }
 
-        stats.totalProcesados++;
-        int actual = ++procesados;
+            if (exito && !allFeatures.empty()) {
+                stats.totalExitosos++;
+                stats.audiosCrudos++;
+                stats.muestrasGeneradas += static_cast<int>(allFeatures.size());
+            }
+            else {
+                stats.totalFallidos++;
+            }
+
+            stats.totalProcesados++;
+            int actual = ++procesados;
 
-        if (actual % 10 == 0 || actual == total) {
+            if (actual % 10 == 0 || actual == total) {
 #pragma omp critical
-            {
-                stats.mostrarProgreso(actual, total,
-                    samples[i].path.filename().string());
+                {
+                    stats.mostrarProgreso(actual, total, s.path.filename().string());
+                }
             }
         }
     }
 
-    // Eliminar muestras originales (no procesadas)
-    samples.erase(
-        std::remove_if(samples.begin(), samples.begin() + total,
-            [](const AudioSampleData& s) { return !s.procesado; }),
-        samples.begin() + total
-    );
-
     std::cout << "   & Completado: " << stats.audiosCrudos.load() << " audios → "
         << stats.muestrasGeneradas.load() << " muestras" << std::endl;
 
@@ -446,19 +449,79 @@ void procesarMuestrasParalelo(
     }
 }
 
-// CONVERSION Y GUARDADO
+// FUSION DE SHARDS -> DATASET FINAL
+// Streaming en el orden del split (deterministico por seed); la etiqueta se toma
+// del split actual, no del shard (los IDs por nombre pueden cambiar al sumar hablantes)
+
+bool fusionarEnDataset(
+    const std::vector<AudioSampleData>& samples,
+    AlmacenShards& almacen,
+    const std::string& ruta,
+    EstadisticasProcesamiento& stats) {
+
+    const std::string rutaTmp = ruta + ".tmp";
+    std::error_code ec;
+    fs::path carpeta = fs::path(ruta).parent_path();
+    if (!carpeta.empty()) fs::create_directories(carpeta, ec);
 
-Dataset convertirADataset(const std::vector<AudioSampleData>& samples) {
-    Dataset dataset;
+    std::ofstream out(rutaTmp, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "! Error: No se pudo crear " << rutaTmp << std::endl;
+        return false;
+    }
+
+    std::cout << "-> Fusionando shards en: " << ruta << std::endl;
+
+    std::vector<std::vector<AudioSample>> features;
+    EntradaManifest entrada;
+    int dim = 0;
+
+    for (const auto& s : samples) {
+        if (!s.legible || !almacen.buscar(s.hash, entrada)) {
+            stats.totalFallidos++;
+            continue;
+        }
+        if (!almacen.leer(entrada, features)) {
+            std::cerr << "! Error: shard ilegible para " << s.path.filename().string() << std::endl;
+            stats.totalFallidos++;
+            continue;
+        }
+        if (features.empty()) {
+            stats.totalFallidos++;
+            continue;
+        }
 
-    for (const auto& sample : samples) {
-        if (sample.procesado && !sample.features.empty()) {
-            dataset.X.push_back(sample.features);
-            dataset.y.push_back(sample.etiqueta);
+        // Formato por muestra: [dim:int][features:AudioSample*dim][label:int]
+        for (const auto& x : features) {
+            dim = static_cast<int>(x.size());
+            out.write(reinterpret_cast<const char*>(&dim), sizeof(int));
+            out.write(reinterpret_cast<const char*>(x.data()), sizeof(AudioSample) * dim);
+            out.write(reinterpret_cast<const char*>(&s.etiqueta), sizeof(int));
         }
+
+        stats.totalExitosos++;
+        stats.audiosCrudos++;
+        stats.muestrasGeneradas += static_cast<int>(features.size());
+        stats.muestrasPorHablante[s.etiqueta] += static_cast<int>(features.size());
+    }
+
+    out.close();
+    if (!out || stats.muestrasGeneradas.load() == 0) {
+        fs::remove(rutaTmp, ec);
+        std::cerr << "! Error: dataset vacio o error de escritura en " << ruta << std::endl;
+        return false;
+    }
+
+    fs::rename(rutaTmp, ruta, ec);
+    if (ec) {
+        std::cerr << "! Error: No se pudo reemplazar " << ruta << ": " << ec.message() << std::endl;
+        return false;
     }
 
-    return dataset;
+    std::cout << "   & Dataset guardado:" << std::endl;
+    std::cout << "      Muestras: " << stats.muestrasGeneradas.load() << std::endl;
+    std::cout << "      Dimension: " << dim << std::endl;
+    return true;
 }
 
 // MAIN
@@ -478,15 +541,26 @@ int main(int argc, char* argv[]) {
     std::string outputDir = "processed_dataset_bin";
     int seed = CONFIG_DATASET.seed;
 
-    if (argc >= 2) datasetPath = argv[1];
-    if (argc >= 3) outputDir = argv[2];
-    if (argc >= 4) seed = std::stoi(argv[3]);
+    // --rehacer descarta shards y manifiesto (reproceso total)
+    bool rehacer = false;
+    std::vector<std::string> posicionales;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--rehacer") rehacer = true;
+        else posicionales.push_back(arg);
+    }
+
+    if (posicionales.size() >= 1) datasetPath = posicionales[0];
+    if (posicionales.size() >= 2) outputDir = posicionales[1];
+    if (posicionales.size() >= 3) seed = std::stoi(posicionales[2]);
 
     std::cout << "\n-> Configuracion:" << std::endl;
     std::cout << "   Dataset: " << datasetPath << std::endl;
     std::cout << "   Salida: " << outputDir << std::endl;
     std::cout << "   Features: " << CONFIG_MFCC.totalFeatures << std::endl;
     std::cout << "   Threads: " << omp_get_max_threads() << std::endl;
+    std::cout << "   Shards: " << (fs::path(outputDir) / "shards").string()
+        << (rehacer ? " (rehacer)" : " (reanudable)") << std::endl;
     std::cout << "   Augmentation: "
         << (CONFIG_DATASET.usarAugmentation ? "SI" : "NO") << std::endl;
 
@@ -537,33 +611,57 @@ int main(int argc, char* argv[]) {
     std::vector<AudioSampleData> trainSamples, testSamples;
     dividirTrainTest(archivosPorHablante, trainSamples, testSamples, seed);
 
-    // 3. Procesar usando PIPELINE (maneja augmentation automáticamente)
-    EstadisticasProcesamiento statsTrain, statsTest;
-    MetricasRendimiento metricasTrain, metricasTest;
+    // 3. Hash de contenido: solo se procesan audios nuevos o modificados
+    AlmacenShards almacen((fs::path(outputDir) / "shards").string(),
+        CONFIG_MFCC.totalFeatures, omp_get_max_threads(), rehacer);
+
+    std::vector<AudioSampleData*> todos;
+    todos.reserve(trainSamples.size() + testSamples.size());
+    for (auto& s : trainSamples) todos.push_back(&s);
+    for (auto& s : testSamples) todos.push_back(&s);
+
+    std::cout << "\n-> Calculando hash de contenido (" << todos.size() << " archivos)..." << std::endl;
+    hashearArchivos(todos);
+
+    std::vector<AudioSampleData*> pendientes;
+    std::set<uint64_t> hashesPendientes;
+    int ilegibles = 0;
+    for (auto* s : todos) {
+        if (!s->legible) {
+            ++ilegibles;
+            continue;
+        }
+        // Contenido duplicado en el corpus: se procesa una sola vez
+        if (!almacen.contiene(s->hash) && hashesPendientes.insert(s->hash).second) {
+            pendientes.push_back(s);
+        }
+    }
+    std::cout << "   & Reutilizados del manifiesto: " << (todos.size() - ilegibles - hashesPendientes.size())
+        << " | Pendientes: " << pendientes.size();
+    if (ilegibles > 0) std::cout << " | Ilegibles: " << ilegibles;
+    std::cout << std::endl;
 
-    procesarMuestrasParalelo(trainSamples, "TRAIN", statsTrain, &metricasTrain);
-    procesarMuestrasParalelo(testSamples, "TEST", statsTest, &metricasTest);
+    // 4. Procesar usando PIPELINE (maneja augmentation automáticamente)
+    EstadisticasProcesamiento statsProceso;
+    MetricasRendimiento metricasProceso;
 
-    if (trainSamples.empty() || testSamples.empty()) {
-        std::cerr << "! Error: Insuficientes muestras procesadas" << std::endl;
-        return -1;
+    if (!pendientes.empty()) {
+        procesarPendientes(pendientes, almacen, statsProceso, &metricasProceso);
     }
 
-    // 4. Convertir y guardar
+    // 5. Fusionar shards en los datasets finales
     std::cout << "\n-> Guardando datasets..." << std::endl;
 
-    Dataset datasetTrain = convertirADataset(trainSamples);
-    Dataset datasetTest = convertirADataset(testSamples);
-
+    EstadisticasProcesamiento statsTrain, statsTest;
     std::string trainPath = obtenerRutaDatasetTrain();
     std::string testPath = obtenerRutaDatasetTest();
 
-    if (!guardarDatasetBinario(trainPath, datasetTrain)) {
+    if (!fusionarEnDataset(trainSamples, almacen, trainPath, statsTrain)) {
         std::cerr << "! Error guardando train" << std::endl;
         return -1;
     }
 
-    if (!guardarDatasetBinario(testPath, datasetTest)) {
+    if (!fusionarEnDataset(testSamples, almacen, testPath, statsTest)) {
         std::cerr << "! Error guardando test" << std::endl;
         return -1;
     }
@@ -571,7 +669,7 @@ int main(int argc, char* argv[]) {
     std::cout << "   & Train: " << trainPath << std::endl;
     std::cout << "   & Test: " << testPath << std::endl;
 
-    // 5. Mapeo ahora se genera automaticamente en metadata.json durante el entrenamiento
+    // 6. Mapeo ahora se genera automaticamente en metadata.json durante el entrenamiento
     std::cout << "   @ Mapeo se generara en metadata.json durante entrenamiento (" 
               << idANombre.size() << " hablantes)" << std::endl;
 
@@ -582,10 +680,12 @@ int main(int argc, char* argv[]) {
 
     std::cout << "\n@ RESUMEN:" << std::endl;
     std::cout << "   Archivos train: " << statsTrain.audiosCrudos.load() << " → "
-        << trainSamples.size() << " muestras" << std::endl;
+        << statsTrain.muestrasGeneradas.load() << " muestras" << std::endl;
     std::cout << "   Archivos test: " << statsTest.audiosCrudos.load() << " → "
-        << testSamples.size() << " muestras" << std::endl;
+        << statsTest.muestrasGeneradas.load() << " muestras" << std::endl;
     std::cout << "   Hablantes: " << idANombre.size() << std::endl;
+    std::cout << "   Procesados en esta corrida: " << statsProceso.totalProcesados.load()
+        << " (" << statsProceso.totalFallidos.load() << " fallidos)" << std::endl;
 
     if (CONFIG_DATASET.usarAugmentation) {
         float factor = (float)statsTrain.muestrasGeneradas / statsTrain.audiosCrudos.load();
@@ -593,59 +693,34 @@ int main(int argc, char* argv[]) {
             << factor << std::endl;
     }
 
-    // RESUMEN DE PROFILING
-    if (CONFIG_PROFILING.habilitado) {
+    // RESUMEN DE PROFILING (solo audios procesados en esta corrida)
+    if (CONFIG_PROFILING.habilitado && statsProceso.totalProcesados.load() > 0) {
         std::cout << "\n" << std::string(70, '*') << std::endl;
         std::cout << "*  RESUMEN DE PROFILING DE RENDIMIENTO  *" << std::endl;
         std::cout << std::string(70, '*') << std::endl;
 
-        std::cout << "\n# PROCESAMIENTO TRAIN:" << std::endl;
-        if (CONFIG_PROFILING.medirTiempo) {
-            std::cout << "   Tiempo: " << std::fixed << std::setprecision(2)
-                      << (metricasTrain.tiempoMs / 1000.0) << " segundos"
-                      << " (" << (metricasTrain.tiempoMs / statsTrain.audiosCrudos.load())
-                      << " ms/audio)" << std::endl;
-        }
-        if (CONFIG_PROFILING.medirRAM) {
-            std::cout << "   RAM Peak: " << std::fixed << std::setprecision(1)
-                      << metricasTrain.ramPeakMB << " MB" << std::endl;
-            std::cout << "   RAM Promedio: " << std::fixed << std::setprecision(1)
-                      << metricasTrain.ramPromMB << " MB" << std::endl;
-        }
-        if (CONFIG_PROFILING.medirCPU) {
-            std::cout << "   CPU Promedio: " << std::fixed << std::setprecision(1)
-                      << metricasTrain.cpuProm << " %" << std::endl;
-        }
+        const int procesados = statsProceso.totalProcesados.load();
+        const double tiempoTotalS = metricasProceso.tiempoMs / 1000.0;
 
-        std::cout << "\n# PROCESAMIENTO TEST:" << std::endl;
+        std::cout << "\n# PROCESAMIENTO:" << std::endl;
         if (CONFIG_PROFILING.medirTiempo) {
             std::cout << "   Tiempo: " << std::fixed << std::setprecision(2)
-                      << (metricasTest.tiempoMs / 1000.0) << " segundos"
-                      << " (" << (metricasTest.tiempoMs / statsTest.audiosCrudos.load())
+                      << tiempoTotalS << " segundos"
+                      << " (" << (metricasProceso.tiempoMs / procesados)
                       << " ms/audio)" << std::endl;
         }
         if (CONFIG_PROFILING.medirRAM) {
             std::cout << "   RAM Peak: " << std::fixed << std::setprecision(1)
-                      << metricasTest.ramPeakMB << " MB" << std::endl;
+                      << metricasProceso.ramPeakMB << " MB" << std::endl;
             std::cout << "   RAM Promedio: " << std::fixed << std::setprecision(1)
-                      << metricasTest.ramPromMB << " MB" << std::endl;
+                      << metricasProceso.ramPromMB << " MB" << std::endl;
         }
         if (CONFIG_PROFILING.medirCPU) {
             std::cout << "   CPU Promedio: " << std::fixed << std::setprecision(1)
-                      << metricasTest.cpuProm << " %" << std::endl;
+                      << metricasProceso.cpuProm << " %" << std::endl;
         }
-
-        double tiempoTotalS = (metricasTrain.tiempoMs + metricasTest.tiempoMs) / 1000.0;
-        double ramMaxTotal = std::max(metricasTrain.ramPeakMB, metricasTest.ramPeakMB);
-
-        std::cout << "\n# TOTALES:" << std::endl;
-        std::cout << "   Tiempo procesamiento: " << std::fixed << std::setprecision(2)
-                  << tiempoTotalS << " segundos" << std::endl;
-        std::cout << "   RAM Peak global: " << std::fixed << std::setprecision(1)
-                  << ramMaxTotal << " MB" << std::endl;
         std::cout << "   Throughput: " << std::fixed << std::setprecision(2)
-                  << ((statsTrain.audiosCrudos.load() + statsTest.audiosCrudos.load()) / tiempoTotalS)
-                  << " audios/segundo" << std::endl;
+                  << (procesados / tiempoTotalS) << " audios/segundo" << std::endl;
     }
 
     return 0;
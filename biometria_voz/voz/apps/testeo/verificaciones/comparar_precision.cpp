@@ -0,0 +1,226 @@
+// ============================================================================
+// COMPARACION DE PRECISION float vs double EN EL PIPELINE DE FEATURES
+// ============================================================================
+// Corre extraerFeatures<double> y extraerFeatures<float> sobre el mismo PCM
+// y reporta error de features, tiempo por precision y el EER de verificacion
+// (similitud coseno entre audios del mismo hablante vs hablantes distintos).
+// Sirve para decidir si compilar con VOZ_AUDIO_FLOAT32=ON.
+//
+// Uso: voz_comparar_precision <dir_audios> [maxAudiosPorHablante]
+//   <dir_audios>/<id_hablante>/*.wav|flac|mp3|aiff
+// ============================================================================
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "../../../core/pipeline/audio_pipeline.h"
+#include "../../../utils/config.h"
+
+namespace fs = std::filesystem;
+
+struct MuestraPrecision {
+    std::string hablante;
+    std::vector<double> featuresDouble;
+    std::vector<float> featuresFloat;
+};
+
+template <typename T>
+static double similitudCoseno(const std::vector<T>& a, const std::vector<T>& b) {
+    double dot = 0.0, na = 0.0, nb = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        dot += static_cast<double>(a[i]) * b[i];
+        na += static_cast<double>(a[i]) * a[i];
+        nb += static_cast<double>(b[i]) * b[i];
+    }
+    if (na < 1e-300 || nb < 1e-300) return 0.0;
+    return dot / std::sqrt(na * nb);
+}
+
+/**
+ * EER por barrido de umbral sobre los scores ordenados
+ * Devuelve el punto donde FAR y FRR se cruzan (promedio de ambos)
+ */
+static double calcularEER(std::vector<double> genuinos, std::vector<double> impostores) {
+    if (genuinos.empty() || impostores.empty()) return 0.0;
+
+    std::sort(genuinos.begin(), genuinos.end());
+    std::sort(impostores.begin(), impostores.end());
+
+    std::vector<double> umbrales = genuinos;
+    umbrales.insert(umbrales.end(), impostores.begin(), impostores.end());
+    std::sort(umbrales.begin(), umbrales.end());
+
+    double mejorDif = 2.0, eer = 1.0;
+    for (double u : umbrales) {
+        // Acepta si score >= u
+        const double frr = static_cast<double>(std::lower_bound(genuinos.begin(), genuinos.end(), u) - genuinos.begin()) / genuinos.size();
+        const double far = static_cast<double>(impostores.end() - std::lower_bound(impostores.begin(), impostores.end(), u)) / impostores.size();
+        if (std::abs(far - frr) < mejorDif) {
+            mejorDif = std::abs(far - frr);
+            eer = 0.5 * (far + frr);
+        }
+    }
+    return eer;
+}
+
+static bool esAudio(const fs::path& p) {
+    std::string ext = p.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".wav" || ext == ".flac" || ext == ".mp3" || ext == ".aiff";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Uso: " << argv[0] << " <dir_audios> [maxAudiosPorHablante]" << std::endl;
+        return 1;
+    }
+
+    const fs::path raiz = argv[1];
+    const int maxPorHablante = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 1000000;
+
+    if (!fs::is_directory(raiz)) {
+        std::cerr << "! No existe el directorio: " << raiz << std::endl;
+        return 1;
+    }
+
+    CONFIG_PREP.verbose = false;
+
+    std::cout << "\n" << std::string(70, '=') << std::endl;
+    std::cout << "COMPARACION DE PRECISION: float vs double" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "-> Compilado con AudioSample = "
+              << (sizeof(AudioSample) == sizeof(float) ? "float" : "double") << std::endl;
+
+    // Rutas ordenadas (resultado reproducible)
+    std::map<std::string, std::vector<fs::path>> porHablante;
+    for (const auto& dir : fs::directory_iterator(raiz)) {
+        if (!dir.is_directory()) continue;
+        auto& lista = porHablante[dir.path().filename().string()];
+        for (const auto& f : fs::directory_iterator(dir.path())) {
+            if (f.is_regular_file() && esAudio(f.path())) lista.push_back(f.path());
+        }
+        std::sort(lista.begin(), lista.end());
+        if (static_cast<int>(lista.size()) > maxPorHablante) lista.resize(maxPorHablante);
+    }
+
+    std::vector<MuestraPrecision> muestras;
+    double msDouble = 0.0, msFloat = 0.0;
+    double errAbsMax = 0.0, errAbsSuma = 0.0, errRelMax = 0.0, cosMin = 1.0;
+    size_t valores = 0;
+    int fallidos = 0, discrepantes = 0;
+
+    using Reloj = std::chrono::steady_clock;
+
+    for (const auto& [hablante, rutas] : porHablante) {
+        for (const auto& ruta : rutas) {
+            auto audio = decodificarAudio(ruta);
+            if (!audio) {
+                ++fallidos;
+                continue;
+            }
+
+            const std::vector<double> pcmDouble(audio->muestras.begin(), audio->muestras.end());
+            const std::vector<float> pcmFloat(audio->muestras.begin(), audio->muestras.end());
+
+            auto t0 = Reloj::now();
+            auto fd = extraerFeatures(pcmDouble, audio->sampleRate);
+            auto t1 = Reloj::now();
+            auto ff = extraerFeatures(pcmFloat, audio->sampleRate);
+            auto t2 = Reloj::now();
+
+            msDouble += std::chrono::duration<double, std::milli>(t1 - t0).count();
+            msFloat += std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+            // Una precision acepta el audio y la otra no (VAD en el limite)
+            if (fd.has_value() != ff.has_value()) {
+                ++discrepantes;
+                std::cout << "% " << ruta.filename().string() << ": solo "
+                          << (fd ? "double" : "float") << " produjo features" << std::endl;
+                continue;
+            }
+            if (!fd) {
+                ++fallidos;
+                continue;
+            }
+
+            for (size_t i = 0; i < fd->size(); ++i) {
+                const double ref = (*fd)[i];
+                const double err = std::abs(ref - static_cast<double>((*ff)[i]));
+                errAbsMax = std::max(errAbsMax, err);
+                errAbsSuma += err;
+                if (std::abs(ref) > 1e-6) {
+                    errRelMax = std::max(errRelMax, err / std::abs(ref));
+                }
+                ++valores;
+            }
+            const std::vector<double> ffDouble(ff->begin(), ff->end());
+            cosMin = std::min(cosMin, similitudCoseno(*fd, ffDouble));
+
+            muestras.push_back({ hablante, std::move(*fd), std::move(*ff) });
+        }
+    }
+
+    if (muestras.empty()) {
+        std::cerr << "! Ningun audio produjo features" << std::endl;
+        return 1;
+    }
+
+    // Scores de verificacion: todos los pares, una lista por precision
+    std::vector<double> genD, impD, genF, impF;
+    double scoreDifMax = 0.0;
+    for (size_t i = 0; i < muestras.size(); ++i) {
+        for (size_t j = i + 1; j < muestras.size(); ++j) {
+            const double sd = similitudCoseno(muestras[i].featuresDouble, muestras[j].featuresDouble);
+            const double sf = similitudCoseno(muestras[i].featuresFloat, muestras[j].featuresFloat);
+            scoreDifMax = std::max(scoreDifMax, std::abs(sd - sf));
+            if (muestras[i].hablante == muestras[j].hablante) {
+                genD.push_back(sd);
+                genF.push_back(sf);
+            }
+            else {
+                impD.push_back(sd);
+                impF.push_back(sf);
+            }
+        }
+    }
+
+    const double eerD = calcularEER(genD, impD);
+    const double eerF = calcularEER(genF, impF);
+    const size_t n = muestras.size();
+
+    std::cout << std::fixed;
+    std::cout << "\n# Audios" << std::endl;
+    std::cout << "   Hablantes: " << porHablante.size() << " | Procesados: " << n
+              << " | Fallidos: " << fallidos << " | Discrepantes: " << discrepantes << std::endl;
+
+    std::cout << "\n# Error de features (float respecto a double)" << std::endl;
+    std::cout << "   +" << std::string(66, '-') << "+" << std::endl;
+    std::cout << "   | Error abs. maximo      | " << std::setw(22) << std::scientific << std::setprecision(3) << errAbsMax << std::endl;
+    std::cout << "   | Error abs. medio       | " << std::setw(22) << errAbsSuma / std::max<size_t>(1, valores) << std::endl;
+    std::cout << "   | Error rel. maximo      | " << std::setw(22) << errRelMax << std::endl;
+    std::cout << "   | Coseno minimo          | " << std::setw(22) << std::fixed << std::setprecision(9) << cosMin << std::endl;
+
+    std::cout << "\n# Tiempo de extraccion (promedio por audio)" << std::endl;
+    std::cout << std::setprecision(2);
+    std::cout << "   double: " << msDouble / n << " ms | float: " << msFloat / n
+              << " ms | speedup: " << (msFloat > 0 ? msDouble / msFloat : 0.0) << "x" << std::endl;
+
+    std::cout << "\n# Verificacion (coseno, " << genD.size() << " genuinos / "
+              << impD.size() << " impostores)" << std::endl;
+    std::cout << std::setprecision(4);
+    std::cout << "   EER double: " << 100.0 * eerD << "% | EER float: " << 100.0 * eerF
+              << "% | delta: " << 100.0 * (eerF - eerD) << " pp" << std::endl;
+    std::cout << "   Diferencia maxima de score entre precisiones: "
+              << std::scientific << std::setprecision(3) << scoreDifMax << std::endl;
+
+    std::cout << "\n@ " << (discrepantes == 0 && std::abs(eerF - eerD) < 1e-3
+        ? "float32 equivalente en este corpus"
+        : "float32 cambia decisiones en este corpus: revisar antes de activarlo") << std::endl;
+
+    return 0;
+}
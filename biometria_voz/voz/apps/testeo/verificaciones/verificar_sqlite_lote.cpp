@@ -0,0 +1,134 @@
+// ============================================================================
+// VERIFICACION DEL INSERT EN LOTE DE SQLiteAdapter (libreria movil)
+// ============================================================================
+// Sobre una base temporal comprueba que insertarCaracteristicasLocales:
+//   1) inserta todo el lote con ids en orden y los BLOB intactos
+//   2) es todo o nada: si una fila falla, no queda ninguna del lote
+//   3) dentro de una transaccion externa se confirma o deshace con ella
+//
+// Uso: voz_verificar_sqlite_lote        (exit 0 = OK)
+// ============================================================================
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../../mobile/sqlite_adapter.h"
+
+namespace fs = std::filesystem;
+
+static int fallos = 0;
+
+static void comprobar(bool condicion, const std::string& descripcion) {
+    std::cout << (condicion ? "   OK    " : "   FALLO ") << descripcion << std::endl;
+    if (!condicion) ++fallos;
+}
+
+static std::vector<std::vector<double>> loteSintetico(int filas, int dimension, double base) {
+    std::vector<std::vector<double>> lote(filas, std::vector<double>(dimension));
+    for (int i = 0; i < filas; ++i)
+        for (int j = 0; j < dimension; ++j) lote[i][j] = base + i + j * 0.001;
+    return lote;
+}
+
+// Disparador en una conexion aparte: rechaza filas con la dimension dada
+static bool instalarRechazo(const std::string& ruta, int dimension) {
+    sqlite3* db = nullptr;
+    if (sqlite3_open(ruta.c_str(), &db) != SQLITE_OK) return false;
+    const std::string sql =
+        "CREATE TRIGGER rechazar_dimension BEFORE INSERT ON caracteristicas_hablantes "
+        "WHEN NEW.dimension = " + std::to_string(dimension) +
+        " BEGIN SELECT RAISE(ABORT, 'dimension rechazada'); END;";
+    const bool ok = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK;
+    sqlite3_close(db);
+    return ok;
+}
+
+int main() {
+    const std::string ruta = (fs::temp_directory_path() / "voz_verificar_sqlite_lote.db").string();
+    for (const char* sufijo : { "", "-wal", "-shm" }) {
+        std::error_code ec;
+        fs::remove(ruta + sufijo, ec);
+    }
+
+    std::cout << "=== VERIFICACION INSERT EN LOTE (SQLite) ===" << std::endl;
+    std::cout << "   Base: " << ruta << std::endl;
+
+    int codigo = 0;
+    try {
+        SQLiteAdapter db(ruta);
+        if (!db.conectar()) {
+            std::cerr << "! No se pudo abrir la base temporal" << std::endl;
+            return 2;
+        }
+
+        // 1) Lote completo
+        const auto lote = loteSintetico(50, 64, 1.0);
+        const auto ids = db.insertarCaracteristicasLocales(1, 10, lote, "disp-1");
+        bool ordenados = ids.size() == lote.size();
+        for (size_t i = 1; ordenados && i < ids.size(); ++i) ordenados = ids[i] > ids[i - 1];
+        comprobar(ordenados, "50 ids devueltos en orden creciente");
+
+        const auto leidas = db.obtenerCaracteristicasPorUsuario(1);
+        bool intactas = leidas.size() == lote.size();
+        for (size_t i = 0; intactas && i < leidas.size(); ++i) {
+            intactas = leidas[i].id_caracteristica == ids[i] && leidas[i].dimension == 64 &&
+                       leidas[i].vector_features == lote[i] && leidas[i].id_credencial == 10 &&
+                       leidas[i].uuid_dispositivo == "disp-1" && leidas[i].sincronizado == 0;
+        }
+        comprobar(intactas, "filas leidas = lote escrito (BLOB, dimension, credencial, uuid)");
+
+        // Lote float (build VOZ_AUDIO_FLOAT32): se guarda en float64
+        const std::vector<std::vector<float>> loteFloat = { { 0.5f, -0.25f }, { 1.5f, 2.0f } };
+        db.insertarCaracteristicasLocales(2, 20, loteFloat);
+        const auto leidasFloat = db.obtenerCaracteristicasPorUsuario(2);
+        comprobar(leidasFloat.size() == 2 && leidasFloat[1].vector_features == std::vector<double>{ 1.5, 2.0 },
+                  "lote float guardado como float64");
+
+        // 2) Todo o nada: la fila 3 de 5 es rechazada por el disparador
+        comprobar(instalarRechazo(ruta, 7), "disparador de rechazo instalado");
+        auto conFalla = loteSintetico(5, 8, 100.0);
+        conFalla[2].resize(7);
+        bool lanzo = false;
+        try {
+            db.insertarCaracteristicasLocales(3, 30, conFalla);
+        } catch (const std::exception& e) {
+            lanzo = true;
+            std::cout << "   (esperado) " << e.what() << std::endl;
+        }
+        comprobar(lanzo, "lote con una fila rechazada lanza excepcion");
+        comprobar(db.obtenerCaracteristicasPorUsuario(3).empty(), "ninguna fila del lote fallido quedo escrita");
+
+        // 3) Anidado: sin confirmar la externa, el lote se deshace con ella
+        {
+            SQLiteAdapter::Transaccion externa(db);
+            db.insertarCaracteristicasLocales(4, 40, loteSintetico(3, 8, 0.0));
+            comprobar(db.obtenerCaracteristicasPorUsuario(4).size() == 3, "lote visible dentro de la transaccion externa");
+        }
+        comprobar(db.obtenerCaracteristicasPorUsuario(4).empty(), "rollback externo deshace el lote");
+        {
+            SQLiteAdapter::Transaccion externa(db);
+            db.insertarCaracteristicasLocales(5, 50, loteSintetico(3, 8, 0.0));
+            comprobar(externa.confirmar(), "commit externo");
+        }
+        comprobar(db.obtenerCaracteristicasPorUsuario(5).size() == 3, "commit externo conserva el lote");
+
+        // La base sigue usable tras el fallo (sin transaccion colgada)
+        comprobar(db.insertarCaracteristicaLocal(6, 60, std::vector<double>{ 1.0, 2.0 }) > 0,
+                  "insert individual despues del lote fallido");
+        db.desconectar();
+    } catch (const std::exception& e) {
+        std::cerr << "! Excepcion inesperada: " << e.what() << std::endl;
+        codigo = 2;
+    }
+
+    for (const char* sufijo : { "", "-wal", "-shm" }) {
+        std::error_code ec;
+        fs::remove(ruta + sufijo, ec);
+    }
+
+    if (codigo == 0 && fallos > 0) codigo = 1;
+    std::cout << (codigo == 0 ? "-> Verificacion OK" : "! Verificacion con fallos") << std::endl;
+    return codigo;
+}
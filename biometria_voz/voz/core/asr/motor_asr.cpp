@@ -0,0 +1,320 @@
+#include "motor_asr.h"
+#include "../load_audio/audio_io.h"
+#include "../../external/dr_wav.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#ifdef VOZ_WHISPER_INPROC
+#include <whisper.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// UTILIDADES
+// ============================================================================
+
+std::vector<float> remuestrearA16k(const std::vector<AudioSample>& audio, int sampleRate) {
+    std::vector<float> out;
+    if (audio.empty() || sampleRate <= 0) return out;
+
+    if (sampleRate == ASR_SAMPLE_RATE) {
+        out.assign(audio.begin(), audio.end());
+        return out;
+    }
+
+    // Sinc enventanada (Blackman) evaluada en la posicion fraccional de cada
+    // muestra de salida. El pasa-bajos corta bajo el Nyquist menor de las dos
+    // tasas: al bajar de 44.1/48 kHz, lo que hay sobre 8 kHz se filtra en vez
+    // de plegarse (aliasing) sobre la banda de voz
+    constexpr double PI = 3.14159265358979323846;
+    constexpr int CRUCES = 16;   // cruces por cero del nucleo a cada lado
+    constexpr int FASES = 256;   // resolucion de la tabla por muestra de entrada
+
+    const double ratio = static_cast<double>(ASR_SAMPLE_RATE) / sampleRate;  // salida / entrada
+    const double escala = std::min(1.0, ratio);      // al diezmar el nucleo se ensancha
+    const double fc = 0.5 * escala * 0.94;           // ciclos por muestra de entrada (con transicion)
+    const int radio = static_cast<int>(std::ceil(CRUCES / escala));  // en muestras de entrada
+
+    // Mitad derecha del nucleo, muestreada cada 1/FASES de muestra de entrada
+    std::vector<float> nucleo(static_cast<size_t>(radio) * FASES + 1);
+    for (size_t j = 0; j < nucleo.size(); ++j) {
+        const double t = static_cast<double>(j) / FASES;
+        const double x = PI * 2.0 * fc * t;
+        const double sinc = (j == 0) ? 1.0 : std::sin(x) / x;
+        const double w = 0.42 + 0.5 * std::cos(PI * t / radio) + 0.08 * std::cos(2.0 * PI * t / radio);
+        nucleo[j] = static_cast<float>(2.0 * fc * sinc * w);
+    }
+
+    const long long total = static_cast<long long>(audio.size());
+    const size_t n = static_cast<size_t>(audio.size() * ratio);
+    out.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const double pos = i / ratio;
+        const long long centro = static_cast<long long>(pos);
+        const long long k0 = std::max(0LL, centro - radio + 1);
+        const long long k1 = std::min(total - 1, centro + radio);
+
+        double acc = 0.0;
+        for (long long k = k0; k <= k1; ++k) {
+            const double d = std::abs(pos - static_cast<double>(k)) * FASES;
+            const size_t j = static_cast<size_t>(d);
+            if (j + 1 >= nucleo.size()) continue;
+            const double h = nucleo[j] + (nucleo[j + 1] - nucleo[j]) * (d - static_cast<double>(j));
+            acc += static_cast<double>(audio[static_cast<size_t>(k)]) * h;
+        }
+        out[i] = static_cast<float>(acc);
+    }
+    return out;
+}
+
+std::string MotorASR::transcribirArchivo(const std::string& audioPath) {
+    int sampleRate = 0, numChannels = 0, numSamples = 0;
+    auto audio = loadAudio(audioPath.c_str(), sampleRate, numChannels, numSamples);
+    if (audio.empty()) {
+        std::cerr << "! ASR: no se pudo decodificar " << audioPath << std::endl;
+        return "";
+    }
+    return transcribir(remuestrearA16k(audio, sampleRate));
+}
+
+// ============================================================================
+// BACKEND CLI (whisper-cli por popen)
+// ============================================================================
+
+class MotorASRCli : public MotorASR {
+public:
+    explicit MotorASRCli(const ConfigASR& cfg) : config(cfg) {}
+
+    const char* nombre() const override { return "cli"; }
+
+    std::string transcribirArchivo(const std::string& audioPath) override {
+        // Detectar ejecutable segun sistema operativo
+#ifdef _WIN32
+        std::string whisperExe = ".\\whisper-cli.exe";
+#else
+        std::string whisperExe = "./whisper-cli";
+#endif
+        std::string comando =
+            whisperExe + " "
+            "-m " + config.rutaModelo + " "
+            "-f \"" + audioPath + "\" "
+            "--language " + config.idioma + " "
+            "--no-timestamps --no-prints 2>&1";  // Suprimir logs de debug
+
+        std::cout << "-> Ejecutando Whisper: " << comando << std::endl;
+
+#ifdef _WIN32
+        FILE* pipe = _popen(comando.c_str(), "r");
+#else
+        FILE* pipe = popen(comando.c_str(), "r");
+#endif
+        if (!pipe) {
+            std::cerr << "Error al ejecutar whisper.\n";
+            return "";
+        }
+
+        std::stringstream buffer;
+        char linea[256];
+        while (fgets(linea, sizeof(linea), pipe) != nullptr) {
+            buffer << linea;
+        }
+
+#ifdef _WIN32
+        int result = _pclose(pipe);
+#else
+        int result = pclose(pipe);
+#endif
+        if (result != 0) {
+            std::cerr << "Whisper termino con error: " << result << "\n";
+        }
+        return buffer.str();
+    }
+
+    // whisper-cli solo lee archivos: volcar el PCM a un WAV 16 kHz temporal
+    std::string transcribir(const std::vector<float>& pcm16k) override {
+        static std::atomic<unsigned> contador{0};
+        fs::path ruta = fs::temp_directory_path() /
+            ("asr_" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) +
+             "_" + std::to_string(contador++) + ".wav");
+
+        drwav_data_format formato{};
+        formato.container = drwav_container_riff;
+        formato.format = DR_WAVE_FORMAT_IEEE_FLOAT;
+        formato.channels = 1;
+        formato.sampleRate = ASR_SAMPLE_RATE;
+        formato.bitsPerSample = 32;
+
+        drwav wav;
+        if (!drwav_init_file_write(&wav, ruta.string().c_str(), &formato, nullptr)) {
+            std::cerr << "! ASR: no se pudo escribir " << ruta << std::endl;
+            return "";
+        }
+        drwav_write_pcm_frames(&wav, pcm16k.size(), pcm16k.data());
+        drwav_uninit(&wav);
+
+        std::string texto = transcribirArchivo(ruta.string());
+        std::error_code ec;
+        fs::remove(ruta, ec);
+        return texto;
+    }
+
+private:
+    ConfigASR config;
+};
+
+// ============================================================================
+// BACKEND STUB (pruebas)
+// ============================================================================
+
+class MotorASRStub : public MotorASR {
+public:
+    explicit MotorASRStub(std::string texto) : texto(std::move(texto)) {}
+
+    const char* nombre() const override { return "stub"; }
+    std::string transcribir(const std::vector<float>&) override { return texto; }
+    std::string transcribirArchivo(const std::string&) override { return texto; }
+
+private:
+    std::string texto;
+};
+
+// ============================================================================
+// BACKEND WHISPER EN PROCESO (modelo residente)
+// ============================================================================
+
+#ifdef VOZ_WHISPER_INPROC
+class MotorASRWhisper : public MotorASR {
+public:
+    explicit MotorASRWhisper(const ConfigASR& cfg) : config(cfg) {
+        whisper_context_params cparams = whisper_context_default_params();
+        ctx = whisper_init_from_file_with_params(config.rutaModelo.c_str(), cparams);
+        if (!ctx) {
+            std::cerr << "! ASR: no se pudo cargar el modelo " << config.rutaModelo << std::endl;
+            return;
+        }
+
+        // Un estado por slot: los pesos se comparten, el KV-cache no
+        for (int i = 0; i < config.maxConcurrencia; ++i) {
+            if (whisper_state* st = whisper_init_state(ctx)) estadosLibres.push_back(st);
+        }
+        totalEstados = estadosLibres.size();
+        std::cout << "-> ASR: modelo " << config.rutaModelo << " residente ("
+                  << totalEstados << " slots)" << std::endl;
+    }
+
+    ~MotorASRWhisper() override {
+        for (whisper_state* st : estadosLibres) whisper_free_state(st);
+        if (ctx) whisper_free(ctx);
+    }
+
+    bool listo() const { return ctx != nullptr && totalEstados > 0; }
+
+    const char* nombre() const override { return "whisper"; }
+
+    std::string transcribir(const std::vector<float>& pcm16k) override {
+        if (!listo() || pcm16k.empty()) return "";
+
+        // Tomar un slot (bloquea si todas las inferencias estan ocupadas)
+        whisper_state* st = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this] { return !estadosLibres.empty(); });
+            st = estadosLibres.back();
+            estadosLibres.pop_back();
+        }
+
+        whisper_full_params wparams = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+        wparams.language = config.idioma.c_str();
+        wparams.n_threads = config.hilosPorInferencia;
+        wparams.no_timestamps = true;
+        wparams.print_progress = false;
+        wparams.print_realtime = false;
+        wparams.print_special = false;
+        wparams.print_timestamps = false;
+
+        std::string texto;
+        if (whisper_full_with_state(ctx, st, wparams, pcm16k.data(), static_cast<int>(pcm16k.size())) == 0) {
+            const int nSegmentos = whisper_full_n_segments_from_state(st);
+            for (int i = 0; i < nSegmentos; ++i) {
+                texto += whisper_full_get_segment_text_from_state(st, i);
+            }
+        } else {
+            std::cerr << "! ASR: whisper_full fallo" << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            estadosLibres.push_back(st);
+        }
+        cv.notify_one();
+        return texto;
+    }
+
+private:
+    ConfigASR config;
+    whisper_context* ctx = nullptr;
+    size_t totalEstados = 0;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<whisper_state*> estadosLibres;
+};
+#endif
+
+// ============================================================================
+// FABRICA Y MOTOR GLOBAL
+// ============================================================================
+
+std::unique_ptr<MotorASR> crearMotorASR(const ConfigASR& config) {
+    if (config.backend == "stub") {
+        return std::make_unique<MotorASRStub>(config.textoStub);
+    }
+    if (config.backend == "cli") {
+        return std::make_unique<MotorASRCli>(config);
+    }
+    if (config.backend == "whisper") {
+#ifdef VOZ_WHISPER_INPROC
+        auto motor = std::make_unique<MotorASRWhisper>(config);
+        if (motor->listo()) return motor;
+#else
+        std::cerr << "% ASR: backend whisper no compilado (VOZ_WHISPER_INPROC)" << std::endl;
+#endif
+        return nullptr;
+    }
+    std::cerr << "! ASR: backend desconocido '" << config.backend << "'" << std::endl;
+    return nullptr;
+}
+
+namespace {
+    // shared_ptr bajo mutex (no std::atomic<shared_ptr>: el NDK de Android no lo tiene).
+    // El lock solo cubre la copia del puntero, nunca una transcripcion
+    std::mutex mtxMotor;
+    std::shared_ptr<MotorASR> motorGlobal;
+}
+
+std::shared_ptr<MotorASR> obtenerMotorASR() {
+    std::lock_guard<std::mutex> lock(mtxMotor);
+    if (!motorGlobal) {
+        motorGlobal = crearMotorASR(CONFIG_ASR);
+        if (!motorGlobal) {
+            std::cerr << "% ASR: usando whisper-cli como respaldo" << std::endl;
+            motorGlobal = std::make_shared<MotorASRCli>(CONFIG_ASR);
+        }
+        std::cout << "-> ASR: backend " << motorGlobal->nombre() << std::endl;
+    }
+    return motorGlobal;
+}
+
+void establecerMotorASR(std::shared_ptr<MotorASR> motor) {
+    std::lock_guard<std::mutex> lock(mtxMotor);
+    motorGlobal = std::move(motor);
+}
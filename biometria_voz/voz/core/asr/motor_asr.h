@@ -0,0 +1,52 @@
+#ifndef MOTOR_ASR_H
+#define MOTOR_ASR_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "config.h"
+
+// ============================================================================
+// MOTOR ASR INTERCAMBIABLE
+// ============================================================================
+// Interfaz comun para los backends de transcripcion (ver ConfigASR en config.h):
+//   - MotorASRWhisper: modelo cargado UNA vez, estados whisper reutilizados,
+//                      concurrencia limitada a CONFIG_ASR.maxConcurrencia
+//   - MotorASRCli:     whisper-cli por popen (comportamiento original)
+//   - MotorASRStub:    devuelve un texto fijo, sin modelo (pruebas)
+//
+// Entrada: PCM mono float en [-1, 1] a 16 kHz (formato nativo de Whisper).
+// remuestrearA16k() adapta el audio ya decodificado del pipeline de voz.
+// ============================================================================
+
+constexpr int ASR_SAMPLE_RATE = 16000;
+
+class MotorASR {
+public:
+    virtual ~MotorASR() = default;
+
+    // Transcripcion cruda (sin normalizar). Thread-safe.
+    virtual std::string transcribir(const std::vector<float>& pcm16k) = 0;
+
+    // Por defecto decodifica con loadAudio y delega en transcribir()
+    virtual std::string transcribirArchivo(const std::string& audioPath);
+
+    virtual const char* nombre() const = 0;
+};
+
+// Crea el backend indicado en config.backend (nullptr si no esta disponible)
+std::unique_ptr<MotorASR> crearMotorASR(const ConfigASR& config);
+
+// Motor global: se crea con CONFIG_ASR en el primer uso (fallback a "cli").
+// Cada llamada devuelve una referencia propia: el motor vive mientras alguien
+// lo use, aunque establecerMotorASR() lo reemplace a mitad de una transcripcion
+std::shared_ptr<MotorASR> obtenerMotorASR();
+
+// Reemplaza el motor global (pruebas o servidor con config propia)
+void establecerMotorASR(std::shared_ptr<MotorASR> motor);
+
+// Audio mono del pipeline (cualquier sample rate) -> float 16 kHz, con
+// pasa-bajos anti-aliasing al bajar de tasa
+std::vector<float> remuestrearA16k(const std::vector<AudioSample>& audio, int sampleRate);
+
+#endif // MOTOR_ASR_H
@@ -1,73 +1,20 @@
 ﻿#include "whisper_asr.h"
-#include <fstream>
-#include <sstream>
+#include "motor_asr.h"
 #include <iostream>
-#include <filesystem>
 #include <regex>
-#include <cstdio>
 #include "similaridad.h"
+#include "comun/metricas.h"
+#include "comun/trazas.h"
 #include <iomanip> 
-// Cache thread-local
-namespace {
-    thread_local std::string _ultimaRutaAudio;
-    thread_local std::string _ultimaTranscripcion;
-}
 
-// Función auxiliar para transcribir y cachear resultado
-static std::string transcribirYCached(const std::string& audioPath) {
-    if (audioPath == _ultimaRutaAudio && !_ultimaTranscripcion.empty()) {
-        return _ultimaTranscripcion;
-    }
-    
-    // Detectar ejecutable según sistema operativo
-    #ifdef _WIN32
-        std::string whisperExe = ".\\whisper-cli.exe";
-    #else
-        std::string whisperExe = "./whisper-cli";
-    #endif
-    
-    std::string comando =
-        whisperExe + " "
-        "-m ggml-tiny.bin "
-        "-f \"" + audioPath + "\" "
-        "--language es "
-        "--no-timestamps --no-prints 2>&1";  // Suprimir logs de debug
+// La transcripcion la hace el motor global (core/asr/motor_asr.h): con el
+// backend "whisper" el modelo queda residente y no se relanza un proceso por frase.
+// Sin cache por ruta: los audios temporales reutilizan nombres entre requests.
 
-    std::cout << "-> Ejecutando Whisper: " << comando << std::endl;
-    
-    // Usar popen para capturar salida directamente
-    #ifdef _WIN32
-        FILE* pipe = _popen(comando.c_str(), "r");
-    #else
-        FILE* pipe = popen(comando.c_str(), "r");
-    #endif
-    
-    if (!pipe) {
-        std::cerr << "Error al ejecutar whisper.\n";
-        _ultimaTranscripcion.clear();
-        return "";
-    }
-    
-    // Leer salida directamente
-    std::stringstream buffer;
-    char linea[256];
-    while (fgets(linea, sizeof(linea), pipe) != nullptr) {
-        buffer << linea;
-    }
-    
-    #ifdef _WIN32
-        int result = _pclose(pipe);
-    #else
-        int result = pclose(pipe);
-    #endif
-    
-    if (result != 0) {
-        std::cerr << "Whisper termino con error: " << result << "\n";
-    }
-
-    _ultimaRutaAudio = audioPath;
-    _ultimaTranscripcion = buffer.str();
-    return _ultimaTranscripcion;
+// voz_etapa_duracion_segundos{etapa="asr"}: remuestreo + transcripcion
+static metricas::Histograma& histogramaASR() {
+    static auto& h = metricas::etapa("asr");
+    return h;
 }
 
 // Normaliza texto
@@ -91,7 +38,9 @@ std::string normalizarTxt(const std::string& texto) {
 
 // API pública: compara contra la frase estática
 bool transcribeAndCompare(const std::string& audioPath, const std::string& fraseEsperada) {
-    std::string transcripcion = transcribirYCached(audioPath);
+    metricas::Temporizador t(histogramaASR());
+    trazas::Span s("asr");
+    std::string transcripcion = obtenerMotorASR()->transcribirArchivo(audioPath);
     if (transcripcion.empty()) return false;
 
     std::string esperado = normalizarTxt(fraseEsperada);
@@ -106,6 +55,16 @@ bool transcribeAndCompare(const std::string& audioPath, const std::string& frase
 
 // API pública: devuelve transcripción normalizada (si la quieres usar)
 std::string obtenerTranscripcion(const std::string& audioPath) {
-    std::string transcripcion = transcribirYCached(audioPath);
+    metricas::Temporizador t(histogramaASR());
+    trazas::Span s("asr");
+    std::string transcripcion = obtenerMotorASR()->transcribirArchivo(audioPath);
+    return normalizarTxt(transcripcion);
+}
+
+// API pública: transcribe audio ya decodificado (evita volver a leer el archivo)
+std::string obtenerTranscripcion(const std::vector<AudioSample>& audio, int sampleRate) {
+    metricas::Temporizador t(histogramaASR());
+    trazas::Span s("asr");
+    std::string transcripcion = obtenerMotorASR()->transcribir(remuestrearA16k(audio, sampleRate));
     return normalizarTxt(transcripcion);
 }
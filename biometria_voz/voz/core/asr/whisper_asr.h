@@ -2,9 +2,12 @@
 #define WHISPER_ASR_H
 
 #include <string>
+#include <vector>
+#include "config.h"
 
 bool transcribeAndCompare(const std::string& audioPath, const std::string& fraseEsperada);
 std::string obtenerTranscripcion(const std::string& audioPath);
+std::string obtenerTranscripcion(const std::vector<AudioSample>& audio, int sampleRate);
 std::string normalizarTxt(const std::string& texto);
 
 #endif
@@ -6,6 +6,7 @@
 #include "../../../utils/config.h"
 #include "../../../utils/additional.h"
 #include <algorithm>
+#include <numeric>
 #include <random>
 #include <iostream>
 #include <cmath>
@@ -91,25 +92,44 @@ void aplicarActualizacionGradiente(
         // ADAM OPTIMIZER
         estado.adam_t++;
         
+        // Correccion de sesgo: depende solo del paso, se calcula una vez
+        // (antes eran 2 std::pow por peso y el bucle no vectorizaba)
+        const double beta1 = cfg.beta1Adam, beta2 = cfg.beta2Adam;
+        const double uno_menos_beta1 = 1.0 - beta1;
+        const double uno_menos_beta2 = 1.0 - beta2;
+        const double correccion1 = 1.0 - std::pow(beta1, estado.adam_t);
+        const double correccion2 = 1.0 - std::pow(beta2, estado.adam_t);
+        const AudioSample tasa = estado.tasa_actual;
+        const double epsilon = cfg.epsilonAdam;
+        
+        AudioSample* pw = w.data();
+        AudioSample* v_w = estado.v_w.data();
+        AudioSample* m_w = estado.m_w.data();
+        const AudioSample* gw = grad_w.data();
+        const int n = static_cast<int>(w.size());
+        
         // Actualizar pesos
-        for (size_t j = 0; j < w.size(); ++j) {
-            AudioSample g = grad_w[j] / batch_size + lambda * w[j];
-            estado.v_w[j] = cfg.beta1Adam * estado.v_w[j] + (1.0 - cfg.beta1Adam) * g;
-            estado.m_w[j] = cfg.beta2Adam * estado.m_w[j] + (1.0 - cfg.beta2Adam) * g * g;
+#if ENABLE_OPENMP
+#pragma omp simd
+#endif
+        for (int j = 0; j < n; ++j) {
+            AudioSample g = gw[j] / batch_size + lambda * pw[j];
+            v_w[j] = beta1 * v_w[j] + uno_menos_beta1 * g;
+            m_w[j] = beta2 * m_w[j] + uno_menos_beta2 * g * g;
             
-            AudioSample v_hat = estado.v_w[j] / (1.0 - std::pow(cfg.beta1Adam, estado.adam_t));
-            AudioSample m_hat = estado.m_w[j] / (1.0 - std::pow(cfg.beta2Adam, estado.adam_t));
+            AudioSample v_hat = v_w[j] / correccion1;
+            AudioSample m_hat = m_w[j] / correccion2;
             
-            w[j] -= estado.tasa_actual * v_hat / (std::sqrt(m_hat) + cfg.epsilonAdam);
+            pw[j] -= tasa * v_hat / (std::sqrt(m_hat) + epsilon);
         }
         
         // Actualizar bias
         AudioSample g_b = grad_b / batch_size;
-        estado.v_b = cfg.beta1Adam * estado.v_b + (1.0 - cfg.beta1Adam) * g_b;
-        estado.m_b = cfg.beta2Adam * estado.m_b + (1.0 - cfg.beta2Adam) * g_b * g_b;
+        estado.v_b = beta1 * estado.v_b + uno_menos_beta1 * g_b;
+        estado.m_b = beta2 * estado.m_b + uno_menos_beta2 * g_b * g_b;
         
-        AudioSample v_b_hat = estado.v_b / (1.0 - std::pow(cfg.beta1Adam, estado.adam_t));
-        AudioSample m_b_hat = estado.m_b / (1.0 - std::pow(cfg.beta2Adam, estado.adam_t));
+        AudioSample v_b_hat = estado.v_b / correccion1;
+        AudioSample m_b_hat = estado.m_b / correccion2;
         
         b -= estado.tasa_actual * v_b_hat / (std::sqrt(m_b_hat) + cfg.epsilonAdam);
         
@@ -279,11 +299,33 @@ bool evaluarYActualizarMejor(
 // FUNCION CORE: ENTRENAMIENTO DE CLASIFICADOR BINARIO
 // ============================================================================
 
+std::vector<AudioSample> aplanarMatriz(const std::vector<std::vector<AudioSample>>& X) {
+    const size_t n = X.empty() ? 0 : X[0].size();
+    std::vector<AudioSample> plano(X.size() * n);
+    for (size_t i = 0; i < X.size(); ++i) {
+        std::copy(X[i].begin(), X[i].end(), plano.begin() + i * n);
+    }
+    return plano;
+}
+
 ResultadoEntrenamiento entrenarClasificadorBinario(
     const std::vector<std::vector<AudioSample>>& X,
     const std::vector<int>& y_binario,
     const ConfigSVM& cfg,
     int seed
+) {
+    const std::vector<AudioSample> plano = aplanarMatriz(X);
+    const MatrizPlana XPlano{ plano.data(), static_cast<int>(X.size()),
+                              X.empty() ? 0 : static_cast<int>(X[0].size()) };
+    return entrenarClasificadorBinario(X, XPlano, y_binario, cfg, seed);
+}
+
+ResultadoEntrenamiento entrenarClasificadorBinario(
+    const std::vector<std::vector<AudioSample>>& X,
+    const MatrizPlana& XPlano,
+    const std::vector<int>& y_binario,
+    const ConfigSVM& cfg,
+    int seed
 ) {
     ResultadoEntrenamiento resultado;
     
@@ -328,6 +370,13 @@ ResultadoEntrenamiento entrenarClasificadorBinario(
     std::vector<int> indices_todos(m);
     std::iota(indices_todos.begin(), indices_todos.end(), 0);
     
+    // XPlano (fila por muestra): el mini-batch lee filas secuenciales
+    // en lugar de saltar entre m vectores independientes
+    
+    // Buffers reutilizados por todos los mini-batches de todas las epocas
+    std::vector<AudioSample> grad_w(n, 0.0);
+    const AudioSample lambda = 1.0 / (cfg.C * m);
+    
     // ========================================================================
     // BUCLE PRINCIPAL DE ENTRENAMIENTO
     // ========================================================================
@@ -341,34 +390,38 @@ ResultadoEntrenamiento entrenarClasificadorBinario(
         // MINI-BATCH SGD
         for (size_t start = 0; start < indices_todos.size(); start += batch_size) {
             size_t end = std::min(start + batch_size, indices_todos.size());
-            std::vector<int> batch_indices(indices_todos.begin() + start,
-                indices_todos.begin() + end);
             
             // Acumuladores de gradiente
-            std::vector<AudioSample> grad_w(n, 0.0);
+            std::fill(grad_w.begin(), grad_w.end(), 0.0);
             AudioSample grad_b = 0.0;
+            AudioSample* gw = grad_w.data();
             
-            // Calcular gradientes para el batch
-            for (int idx : batch_indices) {
+            // Calcular gradientes para el batch (solo violan el margen)
+            for (size_t k = start; k < end; ++k) {
+                int idx = indices_todos[k];
+                const AudioSample* x = XPlano.fila(idx);
                 int y_i = y_binario[idx];
-                AudioSample score = b + dotProduct(w, X[idx]);
+                AudioSample score = b + std::inner_product(w.begin(), w.end(), x, 0.0);
                 AudioSample margin = 1.0 - y_i * score;
                 AudioSample w_i = (y_i == 1) ? peso_positivo : peso_negativo;
                 
                 if (margin > 0.0) {
+                    const AudioSample coef = -w_i * y_i;
+#if ENABLE_OPENMP
+#pragma omp simd
+#endif
                     for (int j = 0; j < n; ++j) {
-                        grad_w[j] += (-w_i * y_i * X[idx][j]);
+                        gw[j] += coef * x[j];
                     }
-                    grad_b += (-w_i * y_i);
+                    grad_b += coef;
                     loss_total += w_i * margin;
                 }
             }
             
             // Aplicar actualizacion
-            AudioSample lambda = 1.0 / (cfg.C * m);
             aplicarActualizacionGradiente(
                 w, b, grad_w, grad_b, estado,
-                static_cast<int>(batch_indices.size()),
+                static_cast<int>(end - start),
                 lambda, cfg
             );
         }
@@ -94,6 +94,11 @@ ModeloSVM entrenarSVMOVA(const std::vector<std::vector<AudioSample>>& X,
     std::cout << "\n-> Modo SERIAL (OpenMP desactivado)" << std::endl;
 #endif
     
+    // X contigua una sola vez: todos los clasificadores leen la misma copia
+    const std::vector<AudioSample> bufferPlano = aplanarMatriz(X);
+    const MatrizPlana XPlano{ bufferPlano.data(), static_cast<int>(X.size()),
+                              X.empty() ? 0 : static_cast<int>(X[0].size()) };
+    
     // LOOP PARALELIZABLE: cada clasificador es independiente
     OMP_PARALLEL_FOR
     for (int idx = 0; idx < num_clases; ++idx) {
@@ -124,7 +129,7 @@ ModeloSVM entrenarSVMOVA(const std::vector<std::vector<AudioSample>>& X,
         // ENTRENAR CLASIFICADOR BINARIO (FUNCION CORE)
         // Cada thread entrena su clasificador de forma independiente
         ResultadoEntrenamiento resultado = entrenarClasificadorBinario(
-            X, y_binario, cfg, CONFIG_DATASET.seed + idx  // Seed diferente por thread
+            X, XPlano, y_binario, cfg, CONFIG_DATASET.seed + idx  // Seed diferente por thread
         );
         
         // Verificar si el entrenamiento fue exitoso
@@ -31,7 +31,7 @@ AudioSample calcularPesoClasePositiva(AudioSample ratio, const ConfigSVM& cfg) {
         peso = std::sqrt(ratio) * cfg.factorPesoConservador;
     }
     
-    return std::clamp(peso, cfg.pesoMinimo, cfg.pesoMaximo);
+    return std::clamp(peso, static_cast<AudioSample>(cfg.pesoMinimo), static_cast<AudioSample>(cfg.pesoMaximo));
 }
 
 // ============================================================================
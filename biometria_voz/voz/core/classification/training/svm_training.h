@@ -10,6 +10,25 @@
 // ESTRUCTURAS INTERNAS DEL ENTRENAMIENTO
 // ============================================================================
 
+/**
+ * Vista de X contigua (fila por muestra), sin ser duena de los datos
+ * OVA la arma una vez y la comparten todos los clasificadores binarios
+ */
+struct MatrizPlana {
+    const AudioSample* datos = nullptr;
+    int filas = 0;
+    int columnas = 0;
+
+    const AudioSample* fila(int i) const {
+        return datos + static_cast<size_t>(i) * columnas;
+    }
+};
+
+/**
+ * Copia X a un buffer contiguo; la vista se arma con MatrizPlana{buf.data(), m, n}
+ */
+std::vector<AudioSample> aplanarMatriz(const std::vector<std::vector<AudioSample>>& X);
+
 /**
  * Resultado del entrenamiento de un clasificador binario
  * Contiene los parametros entrenados y metricas finales
@@ -113,4 +132,15 @@ ResultadoEntrenamiento entrenarClasificadorBinario(
     int seed
 );
 
+/**
+ * Igual, con X ya aplanada por el llamador (XPlano debe corresponder a X)
+ */
+ResultadoEntrenamiento entrenarClasificadorBinario(
+    const std::vector<std::vector<AudioSample>>& X,
+    const MatrizPlana& XPlano,
+    const std::vector<int>& y_binario,
+    const ConfigSVM& cfg,
+    int seed
+);
+
 #endif // SVM_TRAINING_H
\ No newline at end of file
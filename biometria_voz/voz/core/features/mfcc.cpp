@@ -6,6 +6,7 @@
 #include <iostream>
 #include <algorithm>
 #include <iomanip>
+#include <limits>
 #include <vector>
 
 // ============================================================================
@@ -59,7 +60,8 @@ static inline double melToHz(double mel) {
  * Crea banco de filtros mel-scale (triangulares)
  * Retorna matriz 2D [numFilters][numBins]
  */
-static std::vector<std::vector<double>> createMelFilterbank(
+template <typename T>
+static std::vector<std::vector<T>> createMelFilterbank(
     int sampleRate,
     int numFilters,
     int fftSize)
@@ -77,9 +79,9 @@ static std::vector<std::vector<double>> createMelFilterbank(
     }
 
     // Inicializar matriz de filtros
-    std::vector<std::vector<double>> filterbank(
+    std::vector<std::vector<T>> filterbank(
         numFilters,
-        std::vector<double>(numBins, 0.0)
+        std::vector<T>(numBins, T(0))
     );
 
     // Calcular puntos mel equiespaciados
@@ -112,7 +114,7 @@ static std::vector<std::vector<double>> createMelFilterbank(
         if (peak > start) {
             const double slope = 1.0 / (peak - start);
             for (int j = start; j < peak; ++j) {
-                filterbank[i][j] = (j - start) * slope;
+                filterbank[i][j] = static_cast<T>((j - start) * slope);
             }
         }
 
@@ -120,7 +122,7 @@ static std::vector<std::vector<double>> createMelFilterbank(
         if (end > peak) {
             const double slope = 1.0 / (end - peak);
             for (int j = peak; j < end; ++j) {
-                filterbank[i][j] = (end - j) * slope;
+                filterbank[i][j] = static_cast<T>((end - j) * slope);
             }
         }
     }
@@ -128,9 +130,64 @@ static std::vector<std::vector<double>> createMelFilterbank(
     return filterbank;
 }
 
+// MFCC DE UN FRAME
+
+template <typename T>
+MFCCFrame<T>::MFCCFrame(int sampleRate, int numBins_)
+    : numBins(numBins_),
+      numFilters(CONFIG_MFCC.numFilters),
+      numCoeffs(CONFIG_MFCC.numCoefficients),
+      filterbank(createMelFilterbank<T>(sampleRate, CONFIG_MFCC.numFilters, numBins_ * 2)),
+      baseDCT(static_cast<size_t>(numCoeffs) * numFilters)
+{
+    // Base DCT precalculada: los mismos cos que antes, una vez
+    // en vez de numCoeffs * numFilters por frame
+    for (int k = 0; k < numCoeffs; ++k) {
+        const double cosArg = M_PI * k / numFilters;
+        for (int n = 0; n < numFilters; ++n) {
+            baseDCT[static_cast<size_t>(k) * numFilters + n] = std::cos(cosArg * (n + 0.5));
+        }
+    }
+}
+
+template <typename T>
+void MFCCFrame<T>::calcular(const T* espectro, T* salida, double* filterEnergies) const {
+    // 1. Aplicar filterbank: calcular energia por filtro mel
+    for (int i = 0; i < numFilters; ++i) {
+        // Producto punto en T (vectorizable); el resultado sube a double
+        const T* filtro = filterbank[i].data();
+        T energia = 0;
+        for (int j = 0; j < numBins; ++j) {
+            energia += espectro[j] * filtro[j];
+        }
+        filterEnergies[i] = energia;
+
+        // Evitar log(0) con epsilon
+        if (filterEnergies[i] < 1e-12) {
+            filterEnergies[i] = 1e-12;
+        }
+
+        // 2. Aplicar logaritmo (compresion dinamica)
+        filterEnergies[i] = std::log(filterEnergies[i]);
+    }
+
+    // 3. DCT (Discrete Cosine Transform) para decorrelacion
+    for (int k = 0; k < numCoeffs; ++k) {
+        double sum = 0.0;
+        const double* fila = &baseDCT[static_cast<size_t>(k) * numFilters];
+
+        for (int n = 0; n < numFilters; ++n) {
+            sum += filterEnergies[n] * fila[n];
+        }
+
+        salida[k] = static_cast<T>(sum);
+    }
+}
+
 // EXTRACCION MFCC 
-std::vector<std::vector<AudioSample>> extractMFCC(
-    const std::vector<std::vector<AudioSample>>& spectrogram,
+template <typename T>
+std::vector<std::vector<T>> extractMFCC(
+    const std::vector<std::vector<T>>& spectrogram,
     int sampleRate)
 {
     if (spectrogram.empty() || spectrogram[0].empty()) {
@@ -155,48 +212,27 @@ std::vector<std::vector<AudioSample>> extractMFCC(
     }
 
     // Inicializar matriz MFCC
-    std::vector<std::vector<AudioSample>> mfcc(
+    std::vector<std::vector<T>> mfcc(
         numFrames,
-        std::vector<AudioSample>(numCoeffs, 0.0)
+        std::vector<T>(numCoeffs, T(0))
     );
 
-    // Crear filterbank mel
-    const int fftSize = numBins * 2;
-    auto filterbank = createMelFilterbank(sampleRate, numFilters, fftSize);
+    // Filterbank mel + base DCT (una vez por llamada)
+    const MFCCFrame<T> extractor(sampleRate, numBins);
 
     // Procesar cada frame en paralelo
 #if ENABLE_OPENMP
-#pragma omp parallel for schedule(dynamic)
+#pragma omp parallel
 #endif
-    for (int f = 0; f < numFrames; ++f) {
+    {
         // Buffer local para energias mel (privado por thread)
         std::vector<double> filterEnergies(numFilters, 0.0);
 
-        // 1. Aplicar filterbank: calcular energia por filtro mel
-        for (int i = 0; i < numFilters; ++i) {
-            for (int j = 0; j < numBins; ++j) {
-                filterEnergies[i] += spectrogram[f][j] * filterbank[i][j];
-            }
-
-            // Evitar log(0) con epsilon
-            if (filterEnergies[i] < 1e-12) {
-                filterEnergies[i] = 1e-12;
-            }
-
-            // 2. Aplicar logaritmo (compresion dinamica)
-            filterEnergies[i] = std::log(filterEnergies[i]);
-        }
-
-        // 3. DCT (Discrete Cosine Transform) para decorrelacion
-        for (int k = 0; k < numCoeffs; ++k) {
-            double sum = 0.0;
-            const double cosArg = M_PI * k / numFilters;
-
-            for (int n = 0; n < numFilters; ++n) {
-                sum += filterEnergies[n] * std::cos(cosArg * (n + 0.5));
-            }
-
-            mfcc[f][k] = sum;
+#if ENABLE_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int f = 0; f < numFrames; ++f) {
+            extractor.calcular(spectrogram[f].data(), mfcc[f].data(), filterEnergies.data());
         }
     }
 
@@ -212,12 +248,13 @@ std::vector<std::vector<AudioSample>> extractMFCC(
 // ESTADISTICAS MFCC 
 // ============================================================================
 
-std::vector<AudioSample> calcularEstadisticasMFCC(
-    const std::vector<std::vector<AudioSample>>& mfcc)
+template <typename T>
+std::vector<T> calcularEstadisticasMFCC(
+    const std::vector<std::vector<T>>& mfcc)
 {
     if (mfcc.empty() || mfcc[0].empty()) {
         std::cout << "% Warning: MFCC vacio, retornando vector cero" << std::endl;
-        return std::vector<AudioSample>(CONFIG_MFCC.totalFeatures, 0.0);
+        return std::vector<T>(CONFIG_MFCC.totalFeatures, T(0));
     }
 
     const int frames = static_cast<int>(mfcc.size());
@@ -228,11 +265,12 @@ std::vector<AudioSample> calcularEstadisticasMFCC(
     }
 
     // Vectores para cada estadistica
-    std::vector<AudioSample> medias(coeffs, 0.0);
-    std::vector<AudioSample> desviaciones(coeffs, 0.0);
-    std::vector<AudioSample> minimos(coeffs, std::numeric_limits<AudioSample>::max());
-    std::vector<AudioSample> maximos(coeffs, std::numeric_limits<AudioSample>::lowest());
-    std::vector<AudioSample> deltas(coeffs, 0.0);
+    // Medias en double: STD se calcula contra la media sin redondear a T
+    std::vector<double> medias(coeffs, 0.0);
+    std::vector<T> desviaciones(coeffs, T(0));
+    std::vector<T> minimos(coeffs, std::numeric_limits<T>::max());
+    std::vector<T> maximos(coeffs, std::numeric_limits<T>::lowest());
+    std::vector<T> deltas(coeffs, T(0));
 
     // PASO 1: Calcular MEAN, MIN, MAX en paralelo
 #if ENABLE_OPENMP
@@ -240,11 +278,11 @@ std::vector<AudioSample> calcularEstadisticasMFCC(
 #endif
     for (int c = 0; c < coeffs; ++c) {
         double suma = 0.0;
-        AudioSample minVal = std::numeric_limits<AudioSample>::max();
-        AudioSample maxVal = std::numeric_limits<AudioSample>::lowest();
+        T minVal = std::numeric_limits<T>::max();
+        T maxVal = std::numeric_limits<T>::lowest();
         
         for (int f = 0; f < frames; ++f) {
-            AudioSample val = mfcc[f][c];
+            T val = mfcc[f][c];
             suma += val;
             minVal = std::min(minVal, val);
             maxVal = std::max(maxVal, val);
@@ -265,7 +303,7 @@ std::vector<AudioSample> calcularEstadisticasMFCC(
             double diff = mfcc[f][c] - medias[c];
             sumaVarianza += diff * diff;
         }
-        desviaciones[c] = std::sqrt(sumaVarianza / frames);
+        desviaciones[c] = static_cast<T>(std::sqrt(sumaVarianza / frames));
     }
 
     // PASO 3: Calcular DELTA (primera derivada temporal - promedio de cambios)
@@ -276,18 +314,18 @@ std::vector<AudioSample> calcularEstadisticasMFCC(
     for (int c = 0; c < coeffs; ++c) {
         double sumaDelta = 0.0;
         for (int f = 1; f < frames; ++f) {
-            sumaDelta += (mfcc[f][c] - mfcc[f-1][c]);
+            sumaDelta += (static_cast<double>(mfcc[f][c]) - mfcc[f-1][c]);
         }
-        deltas[c] = (frames > 1) ? (sumaDelta / (frames - 1)) : 0.0;
+        deltas[c] = static_cast<T>((frames > 1) ? (sumaDelta / (frames - 1)) : 0.0);
     }
 
     // PASO 4: Concatenar todas las estadisticas
     // Orden: [MEAN(50), STD(50), MIN(50), MAX(50), DELTA(50)] = 250 features
-    std::vector<AudioSample> features;
+    std::vector<T> features;
     features.reserve(coeffs * 5);
     
     // Agregar MEAN
-    features.insert(features.end(), medias.begin(), medias.end());
+    for (double m : medias) features.push_back(static_cast<T>(m));
     // Agregar STD
     features.insert(features.end(), desviaciones.begin(), desviaciones.end());
     // Agregar MIN
@@ -316,6 +354,73 @@ std::vector<AudioSample> calcularEstadisticasMFCC(
     return features;
 }
 
+// ============================================================================
+// ESTADISTICAS MFCC INCREMENTALES (pipeline streaming)
+// ============================================================================
+
+template <typename T>
+AcumuladorEstadisticasMFCC<T>::AcumuladorEstadisticasMFCC(int numCoeffs)
+    : media(numCoeffs, 0.0), m2(numCoeffs, 0.0),
+      minimo(numCoeffs, std::numeric_limits<double>::max()),
+      maximo(numCoeffs, std::numeric_limits<double>::lowest()),
+      primero(numCoeffs, 0.0), ultimo(numCoeffs, 0.0) {}
+
+template <typename T>
+void AcumuladorEstadisticasMFCC<T>::agregar(const T* coefs) {
+    ++numFrames;
+    const double n = static_cast<double>(numFrames);
+    for (size_t c = 0; c < media.size(); ++c) {
+        const double x = coefs[c];
+        // Welford: varianza estable sin guardar los frames
+        const double d = x - media[c];
+        media[c] += d / n;
+        m2[c] += d * (x - media[c]);
+        minimo[c] = std::min(minimo[c], x);
+        maximo[c] = std::max(maximo[c], x);
+        if (numFrames == 1) primero[c] = x;
+        ultimo[c] = x;
+    }
+}
+
+template <typename T>
+std::vector<T> AcumuladorEstadisticasMFCC<T>::resultado(double desplazamientoC0) const {
+    const int coeffs = static_cast<int>(media.size());
+    if (numFrames == 0) {
+        return std::vector<T>(CONFIG_MFCC.totalFeatures, T(0));
+    }
+
+    std::vector<T> features;
+    features.reserve(coeffs * 5);
+    // Mismo orden que calcularEstadisticasMFCC: MEAN, STD, MIN, MAX, DELTA
+    for (int c = 0; c < coeffs; ++c) {
+        features.push_back(static_cast<T>(media[c] + (c == 0 ? desplazamientoC0 : 0.0)));
+    }
+    for (int c = 0; c < coeffs; ++c) {
+        features.push_back(static_cast<T>(std::sqrt(m2[c] / numFrames)));
+    }
+    for (int c = 0; c < coeffs; ++c) {
+        features.push_back(static_cast<T>(minimo[c] + (c == 0 ? desplazamientoC0 : 0.0)));
+    }
+    for (int c = 0; c < coeffs; ++c) {
+        features.push_back(static_cast<T>(maximo[c] + (c == 0 ? desplazamientoC0 : 0.0)));
+    }
+    // Suma de diferencias consecutivas = (ultimo - primero)
+    for (int c = 0; c < coeffs; ++c) {
+        features.push_back(static_cast<T>(numFrames > 1 ? (ultimo[c] - primero[c]) / (numFrames - 1) : 0.0));
+    }
+    return features;
+}
+
+template class MFCCFrame<float>;
+template class MFCCFrame<double>;
+template class AcumuladorEstadisticasMFCC<float>;
+template class AcumuladorEstadisticasMFCC<double>;
+
+template std::vector<std::vector<float>> extractMFCC<float>(const std::vector<std::vector<float>>&, int);
+template std::vector<std::vector<double>> extractMFCC<double>(const std::vector<std::vector<double>>&, int);
+template std::vector<float> calcularEstadisticasMFCC<float>(const std::vector<std::vector<float>>&);
+template std::vector<double> calcularEstadisticasMFCC<double>(const std::vector<std::vector<double>>&);
+
 // ============================================================================
 // I/O DE CARACTERISTICAS - VERSION CON DOUBLE
 // ============================================================================
@@ -83,12 +83,20 @@
  * - Cero memory leaks garantizados
  * - Codigo mas simple y mantenible
  * - Paralelizacion opcional y controlable
+ *
+ * PRECISION: plantilla sobre el tipo de muestra (float / double instanciados
+ * en mfcc.cpp). El producto espectro x filterbank corre en T; log y DCT
+ * siempre en double
  */
-std::vector<std::vector<AudioSample>> extractMFCC(
-    const std::vector<std::vector<AudioSample>>& spectrogram,
+template <typename T>
+std::vector<std::vector<T>> extractMFCC(
+    const std::vector<std::vector<T>>& spectrogram,
     int sampleRate
 );
 
+extern template std::vector<std::vector<float>> extractMFCC<float>(const std::vector<std::vector<float>>&, int);
+extern template std::vector<std::vector<double>> extractMFCC<double>(const std::vector<std::vector<double>>&, int);
+
 /**
  * Calcula estadisticas agregadas extendidas de coeficientes MFCC
  * Genera vector de caracteristicas con 5 estadisticas por coeficiente
@@ -122,11 +130,73 @@ std::vector<std::vector<AudioSample>> extractMFCC(
  *
  * Complejidad: O(F * C) donde F=frames, C=coefficients
  * Paralelizado con OpenMP si ENABLE_OPENMP=1
+ * Acumuladores en double para cualquier T
  */
-std::vector<AudioSample> calcularEstadisticasMFCC(
-    const std::vector<std::vector<AudioSample>>& mfcc
+template <typename T>
+std::vector<T> calcularEstadisticasMFCC(
+    const std::vector<std::vector<T>>& mfcc
 );
 
+extern template std::vector<float> calcularEstadisticasMFCC<float>(const std::vector<std::vector<float>>&);
+extern template std::vector<double> calcularEstadisticasMFCC<double>(const std::vector<std::vector<double>>&);
+
+/**
+ * MFCC de UN frame: filterbank mel + log + DCT con CONFIG_MFCC
+ * extractMFCC lo aplica a cada frame del espectrograma; el pipeline
+ * streaming lo usa frame a frame sin guardar el espectrograma
+ *
+ * calcular() es const y thread-safe: el buffer de energias lo pone el
+ * llamador (numFiltros() doubles)
+ */
+template <typename T>
+class MFCCFrame {
+public:
+    MFCCFrame(int sampleRate, int numBins);
+
+    int numFiltros() const { return numFilters; }
+    int numCoeficientes() const { return numCoeffs; }
+
+    // espectro: numBins magnitudes | salida: numCoeficientes() coeficientes
+    void calcular(const T* espectro, T* salida, double* energias) const;
+
+private:
+    int numBins;
+    int numFilters;
+    int numCoeffs;
+    std::vector<std::vector<T>> filterbank;
+    std::vector<double> baseDCT;
+};
+
+/**
+ * Version incremental de calcularEstadisticasMFCC: acumula frame a frame
+ * MEAN/STD (Welford), MIN, MAX y DELTA sin guardar la matriz MFCC
+ * Memoria O(coeficientes), independiente de la duracion del audio
+ *
+ * desplazamientoC0 suma una constante a MEAN/MIN/MAX del coeficiente 0:
+ * una ganancia g sobre el audio desplaza c0 en numFiltros * ln(g) y no
+ * toca el resto (permite aplicar la normalizacion RMS al final)
+ */
+template <typename T>
+class AcumuladorEstadisticasMFCC {
+public:
+    explicit AcumuladorEstadisticasMFCC(int numCoeffs);
+
+    void agregar(const T* coefs);
+    long long frames() const { return numFrames; }
+
+    // [MEAN, STD, MIN, MAX, DELTA] (mismo layout que calcularEstadisticasMFCC)
+    std::vector<T> resultado(double desplazamientoC0 = 0.0) const;
+
+private:
+    long long numFrames = 0;
+    std::vector<double> media, m2, minimo, maximo, primero, ultimo;
+};
+
+extern template class MFCCFrame<float>;
+extern template class MFCCFrame<double>;
+extern template class AcumuladorEstadisticasMFCC<float>;
+extern template class AcumuladorEstadisticasMFCC<double>;
+
 /**
  * Guarda caracteristicas de UNA muestra en archivo binario (append mode)
  * Util para construir dataset incrementalmente
@@ -28,18 +28,17 @@ const int MIN_SAMPLES = 1000;           // Minimo de muestras validas
 // ============================================================================
 
 /**
- * Valida la calidad del audio cargado
+ * Valida la calidad del audio a partir de sus estadisticas acumuladas
+ * (la usan tanto loadAudio como la lectura por bloques)
  * Detecta: audio muy silencioso, muy ruidoso, o excede duracion maxima
  */
-static bool validarCalidadAudio(const std::vector<AudioSample>& samples, int sampleRate, 
-                                int channels, const char* contexto = "audio") {
-    if (samples.empty()) {
+static bool validarCalidadAudio(int64_t numSamples, double sumSquares, int64_t clippedSamples,
+                                int sampleRate, int channels) {
+    if (numSamples <= 0) {
         std::cerr << "! Error: Vector de audio vacio" << std::endl;
         return false;
     }
 
-    int numSamples = static_cast<int>(samples.size());
-    
     // VALIDACION 1: Duracion minima de 3.5 segundos para 69+ clases
     // Con muchas clases, audios cortos generan features poco discriminativos
     double duracionSegundos = static_cast<double>(numSamples) / (sampleRate * channels);
@@ -51,20 +50,7 @@ static bool validarCalidadAudio(const std::vector<AudioSample>& samples, int sam
         return false;
     }
     
-    // VALIDACION 2: Calcular RMS para detectar audio muy silencioso
-    double sumSquares = 0.0;
-    int clippedSamples = 0;
-    
-    for (int i = 0; i < numSamples; ++i) {
-        double val = samples[i];
-        sumSquares += val * val;
-        
-        // Contar muestras con clipping (muy ruidoso)
-        if (std::abs(val) >= 0.99) {
-            clippedSamples++;
-        }
-    }
-    
+    // VALIDACION 2: RMS para detectar audio muy silencioso
     double rms = std::sqrt(sumSquares / numSamples);
     
     // Umbral minimo de RMS (audio muy silencioso)
@@ -99,6 +85,24 @@ static bool validarCalidadAudio(const std::vector<AudioSample>& samples, int sam
     return true;
 }
 
+static bool validarCalidadAudio(const std::vector<AudioSample>& samples, int sampleRate,
+                                int channels) {
+    double sumSquares = 0.0;
+    int64_t clippedSamples = 0;
+
+    for (AudioSample s : samples) {
+        const double val = s;
+        sumSquares += val * val;
+
+        // Contar muestras con clipping (muy ruidoso)
+        if (std::abs(val) >= 0.99) {
+            clippedSamples++;
+        }
+    }
+    return validarCalidadAudio(static_cast<int64_t>(samples.size()), sumSquares, clippedSamples,
+                               sampleRate, channels);
+}
+
 /**
  * Valida que los parametros de audio sean razonables
  */
@@ -162,11 +166,13 @@ static bool validarArchivo(const char* filePath) {
  * Formatos WAV soportados: PCM 8/16/24/32 bits, float 32/64 bits
  */
 static std::vector<AudioSample> decodeWavToVector(const char* filePath, int& sampleRate,
-    int& channels, int& totalSamples) {
+    int& channels, int& totalSamples, const void* data = nullptr, size_t size = 0) {
     std::cout << "-> Decodificando archivo WAV: " << filePath << std::endl;
 
     drwav wav;
-    if (!drwav_init_file(&wav, filePath, nullptr)) {
+    bool abierto = data ? drwav_init_memory(&wav, data, size, nullptr)
+                        : drwav_init_file(&wav, filePath, nullptr);
+    if (!abierto) {
         std::cerr << "! Error: No se pudo abrir archivo WAV" << std::endl;
         return {};
     }
@@ -218,9 +224,10 @@ static std::vector<AudioSample> decodeWavToVector(const char* filePath, int& sam
  * FLAC es un formato de compresion sin perdidas
  */
 static std::vector<AudioSample> decodeFlacToVector(const char* filePath, int& sampleRate,
-    int& channels, int& totalSamples) {
+    int& channels, int& totalSamples, const void* data = nullptr, size_t size = 0) {
     
-    drflac* pFlac = drflac_open_file(filePath, nullptr);
+    drflac* pFlac = data ? drflac_open_memory(data, size, nullptr)
+                         : drflac_open_file(filePath, nullptr);
     if (!pFlac) {
         std::cerr << "! Error: No se pudo abrir archivo FLAC" << std::endl;
         return {};
@@ -271,14 +278,16 @@ static std::vector<AudioSample> decodeFlacToVector(const char* filePath, int& sa
  * Usa minimp3 para decodificacion
  */
 static std::vector<AudioSample> decodeMp3ToVector(const char* filePath, int& sampleRate,
-    int& channels, int& totalSamples) {
+    int& channels, int& totalSamples, const void* data = nullptr, size_t size = 0) {
     std::cout << "-> Decodificando archivo MP3: " << filePath << std::endl;
 
     mp3dec_t mp3d;
     mp3dec_file_info_t info;
     mp3dec_init(&mp3d);
 
-    if (mp3dec_load(&mp3d, filePath, &info, nullptr, nullptr)) {
+    int error = data ? mp3dec_load_buf(&mp3d, static_cast<const uint8_t*>(data), size, &info, nullptr, nullptr)
+                     : mp3dec_load(&mp3d, filePath, &info, nullptr, nullptr);
+    if (error) {
         std::cerr << "! Error: No se pudo decodificar MP3" << std::endl;
         return {};
     }
@@ -431,27 +440,37 @@ static void calcularEstadisticasAudio(const std::vector<AudioSample>& samples) {
     }
 }
 
-// FUNCION PRINCIPAL DE DECODIFICACION 
-std::vector<AudioSample> loadAudio(const char* filePath, int& sampleRate,
-    int& numChannels, int& numSamples) {
-    
-    // Validar archivo
-    if (!validarArchivo(filePath)) {
-        return {};
-    }
+/**
+ * Extension en minusculas ("" si no tiene)
+ */
+static std::string extraerExtension(const std::string& filename) {
+    size_t dotPos = filename.find_last_of('.');
+    if (dotPos == std::string::npos) return "";
 
-    // Extraer extension
-    std::string filename(filePath);
-    std::string extension;
+    std::string extension = filename.substr(dotPos + 1);
+    for (auto& c : extension) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return extension;
+}
 
-    size_t dotPos = filename.find_last_of('.');
-    if (dotPos == std::string::npos) {
-        std::cerr << "! Error: Archivo sin extension" << std::endl;
-        return {};
-    }
+/**
+ * Detecta el formato por la cabecera del buffer (el nombre subido puede mentir)
+ */
+static std::string detectarFormato(const uint8_t* data, size_t size) {
+    if (size >= 4 && std::memcmp(data, "fLaC", 4) == 0) return "flac";
+    if (size >= 4 && std::memcmp(data, "RIFF", 4) == 0) return "wav";
+    if (size >= 4 && std::memcmp(data, "RIFX", 4) == 0) return "wav";
+    if (size >= 4 && std::memcmp(data, "FORM", 4) == 0) return "aiff";
+    if (size >= 3 && std::memcmp(data, "ID3", 3) == 0) return "mp3";
+    if (size >= 2 && data[0] == 0xFF && (data[1] & 0xE0) == 0xE0) return "mp3";
+    return "";
+}
 
-    extension = filename.substr(dotPos + 1);
-    for (auto& c : extension) c = std::tolower(c);
+/**
+ * Decodifica desde archivo (data == nullptr) o desde memoria y aplica
+ * integridad, mono y validacion de calidad
+ */
+static std::vector<AudioSample> decodificarAudio(const char* filePath, const std::string& extension,
+    const void* data, size_t size, int& sampleRate, int& numChannels, int& numSamples) {
 
     std::cout << "\n" << std::string(70, '=') << std::endl;
     std::cout << "[ETAPA 1/6] CARGA DE AUDIO" << std::endl;
@@ -466,13 +485,13 @@ std::vector<AudioSample> loadAudio(const char* filePath, int& sampleRate,
 
     // Decodificar segun formato
     if (extension == "mp3") {
-        samples = decodeMp3ToVector(filePath, sampleRate, channels, totalSamples);
+        samples = decodeMp3ToVector(filePath, sampleRate, channels, totalSamples, data, size);
     }
     else if (extension == "wav" || extension == "aiff") {
-        samples = decodeWavToVector(filePath, sampleRate, channels, totalSamples);
+        samples = decodeWavToVector(filePath, sampleRate, channels, totalSamples, data, size);
     }
     else if (extension == "flac") {
-        samples = decodeFlacToVector(filePath, sampleRate, channels, totalSamples);
+        samples = decodeFlacToVector(filePath, sampleRate, channels, totalSamples, data, size);
     }
     else {
         std::cerr << "! Error: Formato no soportado: ." << extension << std::endl;
@@ -521,7 +540,7 @@ std::vector<AudioSample> loadAudio(const char* filePath, int& sampleRate,
     numChannels = 1;
     
     // VALIDAR CALIDAD DEL AUDIO (silencio, ruido, duracion)
-    if (!validarCalidadAudio(monoSamples, sampleRate, numChannels, filePath)) {
+    if (!validarCalidadAudio(monoSamples, sampleRate, numChannels)) {
         std::cerr << "! Error: El audio no cumple los criterios de calidad" << std::endl;
         return {};
     }
@@ -533,3 +552,233 @@ std::vector<AudioSample> loadAudio(const char* filePath, int& sampleRate,
     
     return monoSamples;  // Move semantics - sin copia
 }
+
+// FUNCION PRINCIPAL DE DECODIFICACION 
+std::vector<AudioSample> loadAudio(const char* filePath, int& sampleRate,
+    int& numChannels, int& numSamples) {
+    
+    // Validar archivo
+    if (!validarArchivo(filePath)) {
+        return {};
+    }
+
+    // Extraer extension
+    std::string extension = extraerExtension(filePath);
+    if (extension.empty()) {
+        std::cerr << "! Error: Archivo sin extension" << std::endl;
+        return {};
+    }
+
+    return decodificarAudio(filePath, extension, nullptr, 0, sampleRate, numChannels, numSamples);
+}
+
+// DECODIFICACION DESDE MEMORIA (sin archivo temporal)
+std::vector<AudioSample> loadAudioFromMemory(const void* data, size_t size,
+    const std::string& nombreArchivo, int& sampleRate, int& numChannels, int& numSamples) {
+
+    if (data == nullptr || size == 0) {
+        std::cerr << "! Error: Buffer de audio vacio" << std::endl;
+        return {};
+    }
+
+    std::string extension = detectarFormato(static_cast<const uint8_t*>(data), size);
+    if (extension.empty()) extension = extraerExtension(nombreArchivo);
+    if (extension.empty()) {
+        std::cerr << "! Error: Formato de audio no reconocido" << std::endl;
+        return {};
+    }
+
+    std::string nombre = nombreArchivo.empty() ? "<memoria>" : nombreArchivo;
+    return decodificarAudio(nombre.c_str(), extension, data, size, sampleRate, numChannels, numSamples);
+}
+
+// ============================================================================
+// LECTURA POR BLOQUES (pipeline streaming)
+// ============================================================================
+
+struct LectorAudioBloques::Impl {
+    enum class Formato { Ninguno, Wav, Flac, Mp3 };
+
+    Formato formato = Formato::Ninguno;
+    drwav wav{};
+    drflac* flac = nullptr;
+    mp3dec_ex_t mp3{};
+
+    int sampleRate = 0;
+    int channels = 0;
+    uint64_t totalFrames = 0;
+
+    std::vector<float> interleavedF;
+    std::vector<mp3d_sample_t> interleavedS;
+
+    // Estadisticas para la validacion de calidad final
+    int64_t muestras = 0;
+    double sumSquares = 0.0;
+    int64_t clipped = 0;
+
+    ~Impl() { cerrar(); }
+
+    void cerrar() {
+        switch (formato) {
+        case Formato::Wav:  drwav_uninit(&wav); break;
+        case Formato::Flac: drflac_close(flac); flac = nullptr; break;
+        case Formato::Mp3:  mp3dec_ex_close(&mp3); break;
+        default: break;
+        }
+        formato = Formato::Ninguno;
+    }
+};
+
+double duracionDesdeCabecera(const char* filePath) {
+    const std::string extension = extraerExtension(filePath);
+
+    if (extension == "wav" || extension == "aiff") {
+        drwav wav;
+        if (!drwav_init_file(&wav, filePath, nullptr)) return -1.0;
+        const double seg = wav.sampleRate > 0
+            ? static_cast<double>(wav.totalPCMFrameCount) / wav.sampleRate : -1.0;
+        drwav_uninit(&wav);
+        return seg;
+    }
+    if (extension == "flac") {
+        drflac* flac = drflac_open_file(filePath, nullptr);
+        if (!flac) return -1.0;
+        // STREAMINFO puede no traer el total (0 = desconocido)
+        const double seg = (flac->sampleRate > 0 && flac->totalPCMFrameCount > 0)
+            ? static_cast<double>(flac->totalPCMFrameCount) / flac->sampleRate : -1.0;
+        drflac_close(flac);
+        return seg;
+    }
+    if (extension == "mp3") {
+        // Sin MP3D_DO_NOT_SCAN, abrir recorre todo el stream para contar muestras
+        mp3dec_ex_t mp3;
+        if (mp3dec_ex_open(&mp3, filePath, MP3D_DO_NOT_SCAN) != 0) return -1.0;
+        double seg = -1.0;
+        if (mp3.info.hz > 0 && mp3.info.channels > 0) {
+            if (mp3.vbr_tag_found) {
+                seg = static_cast<double>(mp3.samples) / (mp3.info.channels * mp3.info.hz);
+            } else if (mp3.info.bitrate_kbps > 0 && mp3.file.size > mp3.start_offset) {
+                seg = static_cast<double>(mp3.file.size - mp3.start_offset) * 8.0 /
+                      (mp3.info.bitrate_kbps * 1000.0);
+            }
+        }
+        mp3dec_ex_close(&mp3);
+        return seg;
+    }
+    return -1.0;
+}
+
+LectorAudioBloques::LectorAudioBloques() : impl(std::make_unique<Impl>()) {}
+LectorAudioBloques::~LectorAudioBloques() = default;
+
+bool LectorAudioBloques::abrir(const char* filePath) {
+    impl = std::make_unique<Impl>();
+    if (!validarArchivo(filePath)) {
+        return false;
+    }
+
+    const std::string extension = extraerExtension(filePath);
+    auto& d = *impl;
+
+    if (extension == "wav" || extension == "aiff") {
+        if (!drwav_init_file(&d.wav, filePath, nullptr)) {
+            std::cerr << "! Error: No se pudo abrir archivo WAV" << std::endl;
+            return false;
+        }
+        d.formato = Impl::Formato::Wav;
+        d.sampleRate = static_cast<int>(d.wav.sampleRate);
+        d.channels = static_cast<int>(d.wav.channels);
+        d.totalFrames = d.wav.totalPCMFrameCount;
+    }
+    else if (extension == "flac") {
+        d.flac = drflac_open_file(filePath, nullptr);
+        if (!d.flac) {
+            std::cerr << "! Error: No se pudo abrir archivo FLAC" << std::endl;
+            return false;
+        }
+        d.formato = Impl::Formato::Flac;
+        d.sampleRate = static_cast<int>(d.flac->sampleRate);
+        d.channels = static_cast<int>(d.flac->channels);
+        d.totalFrames = d.flac->totalPCMFrameCount;
+    }
+    else if (extension == "mp3") {
+        if (mp3dec_ex_open(&d.mp3, filePath, MP3D_SEEK_TO_SAMPLE) != 0) {
+            std::cerr << "! Error: No se pudo decodificar MP3" << std::endl;
+            return false;
+        }
+        d.formato = Impl::Formato::Mp3;
+        d.sampleRate = d.mp3.info.hz;
+        d.channels = d.mp3.info.channels;
+        d.totalFrames = d.channels > 0 ? d.mp3.samples / d.channels : 0;
+    }
+    else {
+        std::cerr << "! Error: Formato no soportado: ." << extension << std::endl;
+        return false;
+    }
+
+    if (!validarParametrosAudio(d.sampleRate, d.channels, static_cast<int>(d.totalFrames * d.channels))) {
+        d.cerrar();
+        return false;
+    }
+    return true;
+}
+
+int LectorAudioBloques::sampleRate() const {
+    return impl->sampleRate;
+}
+
+double LectorAudioBloques::duracionSegundos() const {
+    return impl->sampleRate > 0 ? static_cast<double>(impl->totalFrames) / impl->sampleRate : 0.0;
+}
+
+size_t LectorAudioBloques::leer(std::vector<AudioSample>& bloque, size_t maxMuestras) {
+    bloque.clear();
+    auto& d = *impl;
+    if (d.formato == Impl::Formato::Ninguno || maxMuestras == 0) return 0;
+
+    const size_t ch = static_cast<size_t>(d.channels);
+    size_t frames = 0;
+
+    if (d.formato == Impl::Formato::Mp3) {
+        d.interleavedS.resize(maxMuestras * ch);
+        frames = mp3dec_ex_read(&d.mp3, d.interleavedS.data(), maxMuestras * ch) / ch;
+        d.interleavedF.resize(frames * ch);
+        const double scale = 1.0 / 32768.0;
+        for (size_t i = 0; i < frames * ch; ++i) {
+            d.interleavedF[i] = static_cast<float>(d.interleavedS[i] * scale);
+        }
+    }
+    else {
+        d.interleavedF.resize(maxMuestras * ch);
+        frames = (d.formato == Impl::Formato::Wav)
+            ? static_cast<size_t>(drwav_read_pcm_frames_f32(&d.wav, maxMuestras, d.interleavedF.data()))
+            : static_cast<size_t>(drflac_read_pcm_frames_f32(d.flac, maxMuestras, d.interleavedF.data()));
+    }
+
+    if (frames == 0) {
+        d.cerrar();
+        return 0;
+    }
+
+    // Integridad + mezcla a mono (mismos pasos que decodificarAudio)
+    bloque.resize(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        double sum = 0.0;
+        for (size_t c = 0; c < ch; ++c) {
+            const float v = d.interleavedF[i * ch + c];
+            sum += (std::isnan(v) || std::isinf(v)) ? 0.0 : static_cast<double>(v);
+        }
+        const AudioSample mono = static_cast<AudioSample>(sum / static_cast<double>(ch));
+        bloque[i] = mono;
+
+        const double val = mono;
+        d.sumSquares += val * val;
+        if (std::abs(val) >= 0.99) d.clipped++;
+    }
+    d.muestras += static_cast<int64_t>(frames);
+    return frames;
+}
+
+bool LectorAudioBloques::calidadValida() const {
+    return validarCalidadAudio(impl->muestras, impl->sumSquares, impl->clipped, impl->sampleRate, 1);
+}
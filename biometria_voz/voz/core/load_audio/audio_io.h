@@ -1,7 +1,10 @@
 ﻿#ifndef AUDIO_IO_H
 #define AUDIO_IO_H
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 #include "config.h"  // Para AudioSample
 // ============================================================================
@@ -120,6 +123,83 @@ std::vector<AudioSample> loadAudio(const char* filePath,
     int& numChannels,
     int& numSamples);
 
+/**
+ * Igual que loadAudio, pero decodifica un archivo ya cargado en memoria
+ * (ej. el multipart de un request HTTP) sin escribirlo a disco.
+ *
+ * El formato se detecta por la cabecera (RIFF/FORM/fLaC/ID3/sync MP3);
+ * si no se reconoce, se usa la extension de nombreArchivo.
+ *
+ * @param data Bytes del archivo codificado (no se copian)
+ * @param size Tamano en bytes
+ * @param nombreArchivo Nombre original (solo para logs y como pista de formato)
+ * @return Igual que loadAudio: muestras mono, vector vacio si falla
+ */
+std::vector<AudioSample> loadAudioFromMemory(const void* data, size_t size,
+    const std::string& nombreArchivo,
+    int& sampleRate,
+    int& numChannels,
+    int& numSamples);
+
+/**
+ * Duracion en segundos leyendo solo la cabecera (sin decodificar)
+ *
+ * WAV/AIFF/FLAC: cuenta de frames de la cabecera. MP3: tag Xing/Info si
+ * existe; si no, estimada por tamano de archivo y bitrate del primer frame
+ * (exacta en CBR, aproximada en VBR sin tag). Sirve para decidir la ruta
+ * de procesamiento, no para validar.
+ *
+ * @return Duracion, o < 0 si no se pudo determinar
+ */
+double duracionDesdeCabecera(const char* filePath);
+
+/**
+ * Lectura por bloques (memoria acotada) para el pipeline streaming
+ *
+ * Mismos formatos, limites (sample rate, canales, duracion) y criterios de
+ * calidad que loadAudio, pero entrega el audio mono en bloques de tamano
+ * fijo en vez de un vector con el archivo completo. WAV/AIFF/FLAC se leen
+ * del disco incrementalmente; MP3 via mp3dec_ex (decodifica por frames).
+ *
+ * Los criterios de calidad (duracion, RMS, clipping) dependen del audio
+ * completo: se acumulan mientras se lee y se evaluan con calidadValida()
+ * despues del ultimo bloque.
+ *
+ * Ejemplo:
+ * @code
+ *   LectorAudioBloques lector;
+ *   if (lector.abrir("largo.wav")) {
+ *       std::vector<AudioSample> bloque;
+ *       while (lector.leer(bloque) > 0) { consumir(bloque); }
+ *       bool ok = lector.calidadValida();
+ *   }
+ * @endcode
+ */
+class LectorAudioBloques {
+public:
+    LectorAudioBloques();
+    ~LectorAudioBloques();
+    LectorAudioBloques(const LectorAudioBloques&) = delete;
+    LectorAudioBloques& operator=(const LectorAudioBloques&) = delete;
+
+    // Abre y valida parametros (sin decodificar el contenido)
+    bool abrir(const char* filePath);
+
+    int sampleRate() const;
+    double duracionSegundos() const;
+
+    // Lee hasta maxMuestras muestras mono en `bloque` (NaN/Inf -> 0)
+    // Devuelve cuantas se leyeron; 0 = fin del audio
+    size_t leer(std::vector<AudioSample>& bloque, size_t maxMuestras = 4096);
+
+    // Tras el ultimo bloque: mismos criterios que la validacion de loadAudio
+    bool calidadValida() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
 // ============================================================================
 // NOTAS DE IMPLEMENTACION
 // ============================================================================
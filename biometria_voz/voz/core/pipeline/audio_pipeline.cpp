@@ -1,17 +1,21 @@
 ﻿#include "audio_pipeline.h"
 #include "../../utils/config.h"
+#include "comun/metricas.h"
+#include "comun/trazas.h"
 #include "../load_audio/audio_io.h"
 #include "../preprocessing/preprocesar.h"
 #include "../segmentation/stft.h"
 #include "../features/mfcc.h"
 #include "../augmentation/audio_augmentation.h"
+#include "pipeline_streaming.h"
 #include <iostream>
 #include <optional>
 #include <cmath>
 
-// FUNCION INTERNA (PRIVADA): Procesa UN buffer 
-static std::optional<std::vector<AudioSample>> procesarUnBuffer(
-    const std::vector<AudioSample>& audioBuffer,
+// Procesa UN buffer (sin augmentation), en la precision T del buffer
+template <typename T>
+std::optional<std::vector<T>> extraerFeatures(
+    const std::vector<T>& audioBuffer,
     int sampleRate)
 {
     // Validar duracion minima
@@ -25,9 +29,13 @@ static std::optional<std::vector<AudioSample>> procesarUnBuffer(
         std::cout << std::string(50, '-') << std::endl;
     }
 
+    // Series registradas una vez; observar es lock-free
+    static auto& hPreproc = metricas::etapa("preproc");
+    static auto& hFeatures = metricas::etapa("features");
+
     try {
         // Declarar variable para audio procesado
-        std::vector<AudioSample> procesadoAudio;
+        std::vector<T> procesadoAudio;
 
         // BYPASS OPCIONAL DE PREPROCESAMIENTO (PARA PRUEBAS)
         if (!CONFIG_PREP.enablePreprocessing) {
@@ -38,6 +46,9 @@ static std::optional<std::vector<AudioSample>> procesarUnBuffer(
             procesadoAudio = audioBuffer;
         }
         else {
+            metricas::Temporizador tPreproc(hPreproc);
+            trazas::Span sPreproc("preproc");
+
             // PASO 1: NORMALIZACION RMS
             // Estabiliza amplitud para etapas posteriores
             auto normalized = normalizeRMS(audioBuffer, CONFIG_PREP.normalizationTargetRMS);
@@ -57,6 +68,10 @@ static std::optional<std::vector<AudioSample>> procesarUnBuffer(
             procesadoAudio = std::move(voz);
         }
 
+        // PASOS 3-7: STFT -> MFCC -> estadisticas -> posproceso
+        metricas::Temporizador tFeatures(hFeatures);
+        trazas::Span sFeatures("features");
+
         // PASO 3: STFT
         // Transformada tiempo-frecuencia con precision double
         auto stft = applySTFT(procesadoAudio, sampleRate);
@@ -83,48 +98,8 @@ static std::optional<std::vector<AudioSample>> procesarUnBuffer(
             return std::nullopt;
         }
 
-        // PASO 6: EXPANSION POLINOMIAL (si esta habilitada)
-        // IMPORTANTE: Hacer ANTES de normalización L2
-        // Transforma: [x1...xN] -> [x1...xN, x1²...xN²]
-        // Permite fronteras de decision cuadraticas con SVM lineal
-        if (CONFIG_SVM.usarExpansionPolinomial) {
-            size_t n_original = features.size();
-            std::vector<AudioSample> cuadraticas(n_original);
-            
-            // Calcular terminos cuadraticos
-            for (size_t i = 0; i < n_original; ++i) {
-                cuadraticas[i] = features[i] * features[i];
-            }
-            
-            // Concatenar: features = [originales, cuadraticas]
-            features.insert(features.end(), cuadraticas.begin(), cuadraticas.end());
-            
-            if (CONFIG_PREP.verbose) {
-                std::cout << "-> Expansion polinomial aplicada (" << n_original 
-                          << " -> " << features.size() << " features)" << std::endl;
-            }
-        }
-
-        // PASO 7: NORMALIZACION L2 (si esta habilitada)
-        // Normaliza el vector completo [originales + cuadraticas] a norma unitaria
-        if (CONFIG_SVM.usarNormalizacionL2) {
-            AudioSample norma = 0.0;
-            for (AudioSample val : features) {
-                norma += val * val;
-            }
-            norma = std::sqrt(norma);
-
-            if (norma > 1e-10) {
-                for (AudioSample& val : features) {
-                    val /= norma;
-                }
-            }
-            else if (CONFIG_PREP.verbose) {
-                std::cerr << "% Warning: Norma ~0, no normalizado" << std::endl;
-            }
-        } else if (CONFIG_PREP.verbose) {
-            std::cout << "-> Normalizacion L2: DESACTIVADA" << std::endl;
-        }
+        // PASOS 6-7: expansion polinomial + L2 (segun CONFIG_SVM)
+        posprocesarFeatures(features);
 
         if (CONFIG_PREP.verbose) {
             std::cout << "[PROCESAMIENTO COMPLETO]" << std::endl;
@@ -142,22 +117,122 @@ static std::optional<std::vector<AudioSample>> procesarUnBuffer(
         return std::nullopt;
     }
 }
+
+template <typename T>
+void posprocesarFeatures(std::vector<T>& features)
+{
+    // PASO 6: EXPANSION POLINOMIAL (si esta habilitada)
+    // IMPORTANTE: Hacer ANTES de normalización L2
+    // Transforma: [x1...xN] -> [x1...xN, x1²...xN²]
+    // Permite fronteras de decision cuadraticas con SVM lineal
+    if (CONFIG_SVM.usarExpansionPolinomial) {
+        size_t n_original = features.size();
+        std::vector<T> cuadraticas(n_original);
+        
+        // Calcular terminos cuadraticos
+        for (size_t i = 0; i < n_original; ++i) {
+            cuadraticas[i] = features[i] * features[i];
+        }
+        
+        // Concatenar: features = [originales, cuadraticas]
+        features.insert(features.end(), cuadraticas.begin(), cuadraticas.end());
+        
+        if (CONFIG_PREP.verbose) {
+            std::cout << "-> Expansion polinomial aplicada (" << n_original 
+                      << " -> " << features.size() << " features)" << std::endl;
+        }
+    }
+
+    // PASO 7: NORMALIZACION L2 (si esta habilitada)
+    // Normaliza el vector completo [originales + cuadraticas] a norma unitaria
+    if (CONFIG_SVM.usarNormalizacionL2) {
+        double norma = 0.0;
+        for (T val : features) {
+            norma += static_cast<double>(val) * val;
+        }
+        norma = std::sqrt(norma);
+
+        if (norma > 1e-10) {
+            for (T& val : features) {
+                val = static_cast<T>(val / norma);
+            }
+        }
+        else if (CONFIG_PREP.verbose) {
+            std::cerr << "% Warning: Norma ~0, no normalizado" << std::endl;
+        }
+    } else if (CONFIG_PREP.verbose) {
+        std::cout << "-> Normalizacion L2: DESACTIVADA" << std::endl;
+    }
+}
+
+template std::optional<std::vector<float>> extraerFeatures<float>(const std::vector<float>&, int);
+template std::optional<std::vector<double>> extraerFeatures<double>(const std::vector<double>&, int);
+template void posprocesarFeatures<float>(std::vector<float>&);
+template void posprocesarFeatures<double>(std::vector<double>&);
+
+// DECODIFICACION (una sola vez por audio)
+std::optional<AudioDecodificado> decodificarAudio(const std::filesystem::path& audioPath)
+{
+    int sr, ch, samples;
+    auto audio = loadAudio(audioPath.string().c_str(), sr, ch, samples);
+
+    if (audio.empty()) {
+        std::cerr << "! Pipeline: Error al cargar " << audioPath.filename() << std::endl;
+        return std::nullopt;
+    }
+    return AudioDecodificado{std::move(audio), sr};
+}
+
+std::optional<AudioDecodificado> decodificarAudio(const std::string& contenido,
+                                                  const std::string& nombreArchivo)
+{
+    static auto& hDecode = metricas::etapa("decode");
+    metricas::Temporizador tDecode(hDecode);
+    trazas::Span sDecode("decode");
+
+    int sr, ch, samples;
+    auto audio = loadAudioFromMemory(contenido.data(), contenido.size(), nombreArchivo, sr, ch, samples);
+
+    if (audio.empty()) {
+        std::cerr << "! Pipeline: Error al decodificar " << nombreArchivo << " desde memoria" << std::endl;
+        return std::nullopt;
+    }
+    return AudioDecodificado{std::move(audio), sr};
+}
+
 // FUNCION PRINCIPAL: Maneja augmentation y procesa archivo completo
 bool procesarAudioCompleto(
     const std::filesystem::path& audioPath,
     std::vector<std::vector<AudioSample>>& outFeatures)
 {
     outFeatures.clear();
-    // PASO 1: Cargar audio desde archivo 
-    int sr, ch, samples;
-    auto audio = loadAudio(audioPath.string().c_str(), sr, ch, samples);
 
-    if (audio.empty()) {
-        std::cerr << "! Pipeline: Error al cargar " << audioPath.filename() << std::endl;
+    // Grabaciones largas sin augmentation: por bloques, memoria acotada.
+    // La decision sale de la cabecera (abrir el lector completo recorre todo el MP3)
+    const int desdeSeg = CONFIG_PREP.streamingDesdeSegundos;
+    const bool usarAugmentation = CONFIG_DATASET.usarAugmentation && (CONFIG_AUG.numVariaciones > 0);
+    if (desdeSeg > 0 && !usarAugmentation &&
+        duracionDesdeCabecera(audioPath.string().c_str()) >= desdeSeg) {
+        return procesarAudioStreaming(audioPath, outFeatures);
+    }
+
+    // PASO 1: Cargar audio desde archivo 
+    auto decodificado = decodificarAudio(audioPath);
+    if (!decodificado) {
         return false;
     }
+    return procesarAudioCompleto(*decodificado, outFeatures);
+}
+
+bool procesarAudioCompleto(
+    const AudioDecodificado& decodificado,
+    std::vector<std::vector<AudioSample>>& outFeatures)
+{
+    outFeatures.clear();
+    const auto& audio = decodificado.muestras;
+    const int sr = decodificado.sampleRate;
 
-    if (samples < CONFIG_DATASET.minAudioSamples) {
+    if (audio.size() < static_cast<size_t>(CONFIG_DATASET.minAudioSamples)) {
         std::cerr << "! Pipeline: Audio muy corto" << std::endl;
         return false;
     }
@@ -168,7 +243,7 @@ bool procesarAudioCompleto(
 
     if (!usarAugmentation) {
         // MODO SIN AUGMENTATION: Procesar solo el original
-        auto resultado = procesarUnBuffer(audio, sr);
+        auto resultado = extraerFeatures(audio, sr);
 
         if (resultado.has_value()) {
             outFeatures.push_back(resultado.value());
@@ -190,7 +265,7 @@ bool procesarAudioCompleto(
     int exitosas = 0;
 
     for (const auto& variacion : variaciones) {
-        auto resultado = procesarUnBuffer(variacion, sr);
+        auto resultado = extraerFeatures(variacion, sr);
 
         if (resultado.has_value()) {
             outFeatures.push_back(resultado.value());
@@ -5,6 +5,7 @@
 #include <vector>
 #include <filesystem>
 #include <optional>
+#include <string>
 
 // ============================================================================
 // MODULO PIPELINE - PROCESAMIENTO COMPLETO DE AUDIO - VERSION 3.0
@@ -86,4 +87,55 @@ bool procesarAudioCompleto(
     std::vector<std::vector<AudioSample>>& outFeatures
 );
 
+// ============================================================================
+// DECODIFICAR UNA SOLA VEZ
+// ============================================================================
+// Un request de autenticacion necesita el mismo PCM para ASR y para MFCC:
+// se decodifica una vez (desde archivo o desde el buffer del multipart)
+// y el AudioDecodificado se comparte entre ambos.
+
+struct AudioDecodificado {
+    std::vector<AudioSample> muestras;  // mono, [-1, 1], ya validado (calidad)
+    int sampleRate = 0;
+};
+
+// Desde archivo (usa loadAudio)
+std::optional<AudioDecodificado> decodificarAudio(const std::filesystem::path& audioPath);
+
+// Desde memoria: contenido = bytes del archivo codificado (.wav/.flac/.mp3/.aiff)
+std::optional<AudioDecodificado> decodificarAudio(const std::string& contenido,
+                                                  const std::string& nombreArchivo);
+
+// Mismo pipeline que la version por ruta, sin volver a decodificar
+bool procesarAudioCompleto(
+    const AudioDecodificado& audio,
+    std::vector<std::vector<AudioSample>>& outFeatures
+);
+
+// ============================================================================
+// PIPELINE DE UN BUFFER EN PRECISION EXPLICITA
+// ============================================================================
+// Normalize -> VAD -> STFT -> MFCC -> Stats (+ expansion / L2 segun CONFIG_SVM)
+// sobre un buffer ya decodificado, sin augmentation. T = float o double,
+// independiente de AudioSample: permite comparar ambas precisiones en el
+// mismo binario (voz_comparar_precision). procesarAudioCompleto lo usa con
+// T = AudioSample. nullopt si el audio es muy corto o alguna etapa falla.
+
+template <typename T>
+std::optional<std::vector<T>> extraerFeatures(
+    const std::vector<T>& audioBuffer,
+    int sampleRate
+);
+
+extern template std::optional<std::vector<float>> extraerFeatures<float>(const std::vector<float>&, int);
+extern template std::optional<std::vector<double>> extraerFeatures<double>(const std::vector<double>&, int);
+
+// Pasos finales sobre [MEAN..DELTA]: expansion polinomial y normalizacion L2
+// segun CONFIG_SVM (compartido por extraerFeatures y el pipeline streaming)
+template <typename T>
+void posprocesarFeatures(std::vector<T>& features);
+
+extern template void posprocesarFeatures<float>(std::vector<float>&);
+extern template void posprocesarFeatures<double>(std::vector<double>&);
+
 #endif // AUDIO_PIPELINE_H
\ No newline at end of file
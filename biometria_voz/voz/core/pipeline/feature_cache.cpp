@@ -0,0 +1,305 @@
+#include "feature_cache.h"
+#include "../../utils/config.h"
+#include "../../utils/hash_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char kMagic[4] = { 'V', 'F', 'C', '1' };
+
+std::atomic<uint64_t> g_aciertos{ 0 };
+std::atomic<uint64_t> g_fallos{ 0 };
+std::atomic<uint64_t> g_escrituras{ 0 };
+std::atomic<bool> g_podando{ false };
+std::mutex g_mtxUsuarios;  // indices usuarios/<id>.lst
+
+constexpr uint64_t PODA_CADA_ESCRITURAS = 256;
+
+int enteroEntorno(const char* nombre, int porDefecto) {
+    const char* v = std::getenv(nombre);
+    if (!v || !*v) return porDefecto;
+    return std::max(0, std::atoi(v));
+}
+
+std::string rutaRaizCache() {
+    if (const char* dir = std::getenv("VOZ_FEATURE_CACHE_DIR")) {
+        std::string r = dir;
+        if (!r.empty() && r.back() != '/') r += '/';
+        return r;
+    }
+    return obtenerRutaBase() + "cache/features/";
+}
+
+// Directorio de la huella actual; la primera vez purga las huellas viejas
+const fs::path& directorioHuella() {
+    static const fs::path dir = [] {
+        const fs::path raiz = rutaRaizCache();
+        const std::string huella = huellaConfigFeatures();
+
+        std::error_code ec;
+        for (const auto& e : fs::directory_iterator(raiz, ec)) {
+            uint64_t h;
+            const std::string nombre = e.path().filename().string();
+            if (e.is_directory() && nombre != huella && hexAHash(nombre, h)) {
+                fs::remove_all(e.path(), ec);
+                std::cout << "-> Cache features: purgada huella obsoleta "
+                          << nombre << std::endl;
+            }
+        }
+
+        fs::path d = raiz / huella;
+        fs::create_directories(d, ec);
+        return d;
+    }();
+    return dir;
+}
+
+fs::path rutaIndiceUsuario(int idUsuario) {
+    return fs::path(rutaRaizCache()) / "usuarios" / (std::to_string(idUsuario) + ".lst");
+}
+
+// TTL por fecha de ultimo uso y tope de tamano (las de uso mas antiguo primero).
+// Una sola poda a la vez; las demas llamadas siguen sin esperar
+void podarCache() {
+    bool esperado = false;
+    if (!g_podando.compare_exchange_strong(esperado, true)) return;
+
+    const auto ttl = std::chrono::hours(24) * enteroEntorno("VOZ_FEATURE_CACHE_TTL_DIAS", 30);
+    const uint64_t maxBytes = uint64_t(enteroEntorno("VOZ_FEATURE_CACHE_MAX_MB", 1024)) << 20;
+    const auto ahora = fs::file_time_type::clock::now();
+
+    struct Archivo {
+        fs::path ruta;
+        fs::file_time_type fecha;
+        uint64_t bytes;
+    };
+    std::vector<Archivo> vivos;
+    uint64_t total = 0;
+    size_t borrados = 0;
+
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(directorioHuella(), ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        std::error_code ecArchivo;
+        const auto fecha = it->last_write_time(ecArchivo);
+        const uint64_t bytes = it->file_size(ecArchivo);
+        if (ecArchivo) continue;
+
+        // .tmp huerfanos de escrituras cortadas: una hora de gracia
+        const bool tmp = it->path().extension() != ".bin";
+        if ((tmp && ahora - fecha > std::chrono::hours(1)) || (!tmp && ahora - fecha > ttl)) {
+            if (fs::remove(it->path(), ecArchivo)) ++borrados;
+            continue;
+        }
+        if (tmp) continue;
+        vivos.push_back({ it->path(), fecha, bytes });
+        total += bytes;
+    }
+
+    if (total > maxBytes) {
+        // Baja al 90% del tope para no podar en cada escritura
+        const uint64_t objetivo = maxBytes / 10 * 9;
+        std::sort(vivos.begin(), vivos.end(),
+                  [](const Archivo& a, const Archivo& b) { return a.fecha < b.fecha; });
+        for (const auto& a : vivos) {
+            if (total <= objetivo) break;
+            std::error_code ecArchivo;
+            if (fs::remove(a.ruta, ecArchivo)) {
+                total -= a.bytes;
+                ++borrados;
+            }
+        }
+    }
+
+    if (borrados > 0) {
+        std::cout << "-> Cache features: " << borrados << " entradas expiradas ("
+                  << (total >> 20) << " MB en uso)" << std::endl;
+    }
+    g_podando = false;
+}
+
+fs::path rutaEntrada(uint64_t clave) {
+    const std::string hex = hashAHex(clave);
+    return directorioHuella() / hex.substr(0, 2) / (hex + ".bin");
+}
+
+bool leerEntrada(const fs::path& ruta, std::vector<std::vector<AudioSample>>& out) {
+    std::ifstream in(ruta, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    char magic[4];
+    uint32_t num = 0, dim = 0;
+    in.read(magic, 4);
+    in.read(reinterpret_cast<char*>(&num), sizeof(num));
+    in.read(reinterpret_cast<char*>(&dim), sizeof(dim));
+    if (!in || std::memcmp(magic, kMagic, 4) != 0) return false;
+
+    // Entrada truncada o ajena: el tamano tiene que cerrar exacto
+    std::error_code ec;
+    const uint64_t esperado = 12 + uint64_t(num) * dim * sizeof(AudioSample);
+    if (fs::file_size(ruta, ec) != esperado || ec) return false;
+
+    out.assign(num, std::vector<AudioSample>(dim));
+    for (auto& v : out) {
+        in.read(reinterpret_cast<char*>(v.data()), sizeof(AudioSample) * dim);
+    }
+    if (!in) {
+        out.clear();
+        return false;
+    }
+    // Fecha de ultimo uso para el TTL y la poda por tamano
+    fs::last_write_time(ruta, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+void escribirEntrada(const fs::path& ruta, const std::vector<std::vector<AudioSample>>& features) {
+    const uint32_t num = static_cast<uint32_t>(features.size());
+    const uint32_t dim = features.empty() ? 0 : static_cast<uint32_t>(features[0].size());
+    for (const auto& v : features) {
+        if (v.size() != dim) return;  // no se cachean salidas inconsistentes
+    }
+
+    std::error_code ec;
+    fs::create_directories(ruta.parent_path(), ec);
+
+    // tmp unico por hilo + rename: un lector nunca ve una entrada a medias
+    static std::atomic<uint64_t> contador{ 0 };
+    const fs::path tmp = ruta.string() + ".tmp" +
+        std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + "_" +
+        std::to_string(contador++);
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return;
+        out.write(kMagic, 4);
+        out.write(reinterpret_cast<const char*>(&num), sizeof(num));
+        out.write(reinterpret_cast<const char*>(&dim), sizeof(dim));
+        for (const auto& v : features) {
+            out.write(reinterpret_cast<const char*>(v.data()), sizeof(AudioSample) * dim);
+        }
+        if (!out) {
+            out.close();
+            fs::remove(tmp, ec);
+            return;
+        }
+    }
+    fs::rename(tmp, ruta, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return;
+    }
+    if (++g_escrituras % PODA_CADA_ESCRITURAS == 0) podarCache();
+}
+
+} // namespace
+
+bool cacheFeaturesHabilitada() {
+    static const bool habilitada = [] {
+        const char* v = std::getenv("VOZ_FEATURE_CACHE");
+        return !(v && std::string(v) == "0");
+    }();
+    return habilitada;
+}
+
+uint64_t hashAudioDecodificado(const AudioDecodificado& audio) {
+    uint64_t h = hashFNV1a64(&audio.sampleRate, sizeof(audio.sampleRate));
+    return hashFNV1a64(audio.muestras.data(), audio.muestras.size() * sizeof(AudioSample), h);
+}
+
+bool procesarAudioConCache(
+    const AudioDecodificado& audio,
+    std::vector<std::vector<AudioSample>>& outFeatures,
+    uint64_t* clave)
+{
+    outFeatures.clear();
+    if (clave) *clave = 0;
+    if (!cacheFeaturesHabilitada()) {
+        return procesarAudioCompleto(audio, outFeatures);
+    }
+
+    static std::once_flag podaInicial;
+    std::call_once(podaInicial, podarCache);
+
+    const uint64_t h = hashAudioDecodificado(audio);
+    if (clave) *clave = h;
+    const fs::path ruta = rutaEntrada(h);
+    if (leerEntrada(ruta, outFeatures)) {
+        g_aciertos++;
+        if (CONFIG_PREP.verbose) {
+            std::cout << "   * Cache features: HIT (" << outFeatures.size() << " vectores)" << std::endl;
+        }
+        return !outFeatures.empty();
+    }
+
+    g_fallos++;
+    const bool ok = procesarAudioCompleto(audio, outFeatures);
+    if (!ok) outFeatures.clear();
+    escribirEntrada(ruta, outFeatures);
+    return ok;
+}
+
+bool procesarAudioConCache(
+    const fs::path& audioPath,
+    std::vector<std::vector<AudioSample>>& outFeatures,
+    uint64_t* clave)
+{
+    outFeatures.clear();
+    if (clave) *clave = 0;
+    auto decodificado = decodificarAudio(audioPath);
+    if (!decodificado) {
+        return false;
+    }
+    return procesarAudioConCache(*decodificado, outFeatures, clave);
+}
+
+void asociarCacheUsuario(int idUsuario, const std::vector<uint64_t>& claves) {
+    if (!cacheFeaturesHabilitada()) return;
+
+    const fs::path indice = rutaIndiceUsuario(idUsuario);
+    std::lock_guard<std::mutex> lock(g_mtxUsuarios);
+    std::error_code ec;
+    fs::create_directories(indice.parent_path(), ec);
+    std::ofstream out(indice, std::ios::app);
+    for (uint64_t c : claves) {
+        if (c != 0) out << hashAHex(c) << '\n';
+    }
+}
+
+void purgarCacheUsuario(int idUsuario) {
+    if (!cacheFeaturesHabilitada()) return;
+
+    const fs::path indice = rutaIndiceUsuario(idUsuario);
+    std::lock_guard<std::mutex> lock(g_mtxUsuarios);
+    std::ifstream in(indice);
+    if (!in.is_open()) return;
+
+    size_t borradas = 0;
+    std::string linea;
+    std::error_code ec;
+    while (std::getline(in, linea)) {
+        uint64_t c;
+        if (hexAHash(linea, c) && fs::remove(rutaEntrada(c), ec)) ++borradas;
+    }
+    in.close();
+    fs::remove(indice, ec);
+    std::cout << "-> Cache features: " << borradas << " entradas del usuario "
+              << idUsuario << " eliminadas" << std::endl;
+}
+
+EstadisticasCacheFeatures estadisticasCacheFeatures() {
+    EstadisticasCacheFeatures e;
+    e.aciertos = g_aciertos.load();
+    e.fallos = g_fallos.load();
+    e.escrituras = g_escrituras.load();
+    return e;
+}
@@ -0,0 +1,80 @@
+#ifndef FEATURE_CACHE_H
+#define FEATURE_CACHE_H
+
+#include "audio_pipeline.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// CACHE DE FEATURES DIRECCIONADA POR CONTENIDO
+// ============================================================================
+//
+// Clave = hash del PCM decodificado (muestras + sampleRate) y subdirectorio =
+// huellaConfigFeatures() (PREP/STFT/MFCC/AUG). Mismo audio + misma config ->
+// mismos vectores, sin volver a correr VAD/STFT/MFCC ni el augmentation.
+// Si la config cambia, la clave cae en otro subdirectorio y las entradas
+// viejas se purgan la primera vez que se usa la cache.
+//
+//   <base>/cache/features/<huella>/<hh>/<hash>.bin
+//   [magic 'V''F''C''1'][numVectores:uint32][dim:uint32][AudioSample * num * dim]
+//
+// numVectores = 0 recuerda un audio que el pipeline rechazo.
+// VOZ_FEATURE_CACHE=0 desactiva la cache; VOZ_FEATURE_CACHE_DIR cambia la ruta.
+//
+// Expiracion: al primer uso y cada PODA_CADA_ESCRITURAS escrituras se borran
+// las entradas sin uso hace mas de VOZ_FEATURE_CACHE_TTL_DIAS (default 30) y,
+// si la cache supera VOZ_FEATURE_CACHE_MAX_MB (default 1024), las de uso mas
+// antiguo. Un acierto renueva la fecha de la entrada.
+//
+// Las claves de cada usuario registrado se anotan en <base>/cache/features/
+// usuarios/<id>.lst para poder borrar sus entradas al eliminarlo.
+// ============================================================================
+
+struct EstadisticasCacheFeatures {
+    uint64_t aciertos = 0;
+    uint64_t fallos = 0;
+    uint64_t escrituras = 0;
+};
+
+/**
+ * Hash del contenido PCM ya decodificado (independiente del contenedor:
+ * el mismo audio en .wav o re-subido con otro nombre da la misma clave)
+ */
+uint64_t hashAudioDecodificado(const AudioDecodificado& audio);
+
+/**
+ * procesarAudioCompleto consultando la cache antes del pipeline
+ * Misma semantica de retorno que procesarAudioCompleto
+ */
+bool procesarAudioConCache(
+    const AudioDecodificado& audio,
+    std::vector<std::vector<AudioSample>>& outFeatures,
+    uint64_t* clave = nullptr
+);
+
+/**
+ * @param clave Opcional: clave de cache del audio (0 si no se pudo decodificar
+ *              o la cache esta desactivada), para asociarCacheUsuario
+ */
+bool procesarAudioConCache(
+    const std::filesystem::path& audioPath,
+    std::vector<std::vector<AudioSample>>& outFeatures,
+    uint64_t* clave = nullptr
+);
+
+/**
+ * Anota las entradas de cache que pertenecen a un usuario (audios de registro)
+ */
+void asociarCacheUsuario(int idUsuario, const std::vector<uint64_t>& claves);
+
+/**
+ * Borra las entradas de cache anotadas para el usuario y su indice
+ */
+void purgarCacheUsuario(int idUsuario);
+
+bool cacheFeaturesHabilitada();
+EstadisticasCacheFeatures estadisticasCacheFeatures();
+
+#endif // FEATURE_CACHE_H
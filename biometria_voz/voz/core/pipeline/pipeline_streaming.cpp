@@ -0,0 +1,160 @@
+#include "pipeline_streaming.h"
+#include "../load_audio/audio_io.h"
+#include "../../utils/config.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+ExtractorFeaturesStreaming::Rama::Rama(int sampleRate)
+    : espectro(sampleRate),
+      mfcc(sampleRate, espectro.numBins()),
+      stats(mfcc.numCoeficientes()),
+      magnitudes(espectro.numBins()),
+      coefs(mfcc.numCoeficientes()),
+      energias(mfcc.numFiltros()) {}
+
+void ExtractorFeaturesStreaming::Rama::consumir(const AudioSample* pcm, size_t n) {
+    if (n == 0 || !espectro.valido()) return;
+
+    pendiente.insert(pendiente.end(), pcm, pcm + n);
+    maxPendiente = std::max(maxPendiente, pendiente.size());
+
+    // Mismos frames que applySTFT: completos, cada salto() muestras
+    const size_t frame = static_cast<size_t>(espectro.tamFrame());
+    const size_t salto = static_cast<size_t>(espectro.salto());
+    size_t pos = 0;
+    while (pendiente.size() - pos >= frame) {
+        espectro.calcular(pendiente.data() + pos, magnitudes.data());
+        mfcc.calcular(magnitudes.data(), coefs.data(), energias.data());
+        stats.agregar(coefs.data());
+        pos += salto;
+    }
+    pendiente.erase(pendiente.begin(), pendiente.begin() + static_cast<std::ptrdiff_t>(std::min(pos, pendiente.size())));
+}
+
+ExtractorFeaturesStreaming::ExtractorFeaturesStreaming(int sampleRate_)
+    : sampleRate(sampleRate_),
+      conPreprocesamiento(CONFIG_PREP.enablePreprocessing),
+      vad(sampleRate_),
+      voz(sampleRate_) {
+    if (conPreprocesamiento) {
+        completo.emplace(sampleRate_);
+    }
+}
+
+void ExtractorFeaturesStreaming::agregar(const AudioSample* pcm, size_t n) {
+    if (n == 0) return;
+    recibidas += n;
+    for (size_t i = 0; i < n; ++i) {
+        const double s = pcm[i];
+        sumaCuadrados += s * s;
+    }
+
+    // Bypass de preprocesamiento: el audio va directo a STFT
+    if (!conPreprocesamiento) {
+        voz.consumir(pcm, n);
+        return;
+    }
+
+    bloqueVoz.clear();
+    vad.procesar(pcm, n, bloqueVoz);
+    voz.consumir(bloqueVoz.data(), bloqueVoz.size());
+
+    if (completo) {
+        if (vad.muestrasVoz() > 0) {
+            completo.reset();
+        }
+        else {
+            completo->consumir(pcm, n);
+        }
+    }
+}
+
+size_t ExtractorFeaturesStreaming::maxMuestrasRetenidas() const {
+    return vad.maxRetenidas() + voz.maxPendiente + (completo ? completo->maxPendiente : 0);
+}
+
+std::optional<std::vector<AudioSample>> ExtractorFeaturesStreaming::finalizar() {
+    if (recibidas < static_cast<uint64_t>(CONFIG_DATASET.minAudioSamples)) {
+        return std::nullopt;
+    }
+
+    const Rama* rama = &voz;
+    double desplazamientoC0 = 0.0;
+
+    if (conPreprocesamiento) {
+        bloqueVoz.clear();
+        vad.finalizar(bloqueVoz);
+        voz.consumir(bloqueVoz.data(), bloqueVoz.size());
+
+        // Sin voz detectada: audio completo (mismo criterio que applyVAD)
+        uint64_t muestrasVoz = vad.muestrasVoz();
+        if (muestrasVoz == 0 && completo) {
+            rama = &*completo;
+            muestrasVoz = recibidas;
+        }
+        if (muestrasVoz < static_cast<uint64_t>(CONFIG_DATASET.minAudioSamples)) {
+            std::cerr << "! Pipeline streaming: VAD no detecto suficiente voz" << std::endl;
+            return std::nullopt;
+        }
+
+        // Normalizacion RMS diferida: ganancia g sobre el audio = c0 + numFiltros * ln(g)
+        double targetRMS = CONFIG_PREP.normalizationTargetRMS;
+        if (targetRMS <= 0.0 || targetRMS > 1.0) targetRMS = 0.1;
+        const double rms = std::sqrt(sumaCuadrados / recibidas);
+        if (rms >= 1e-12) {
+            desplazamientoC0 = rama->mfcc.numFiltros() * std::log(targetRMS / rms);
+        }
+    }
+
+    if (rama->stats.frames() == 0) {
+        std::cerr << "! Pipeline streaming: audio sin frames STFT completos" << std::endl;
+        return std::nullopt;
+    }
+
+    auto features = rama->stats.resultado(desplazamientoC0);
+    if (features.size() != static_cast<size_t>(CONFIG_MFCC.totalFeatures)) {
+        std::cerr << "! Pipeline streaming: Dimension de features incorrecta" << std::endl;
+        return std::nullopt;
+    }
+
+    posprocesarFeatures(features);
+    return features;
+}
+
+bool procesarAudioStreaming(
+    const std::filesystem::path& audioPath,
+    std::vector<std::vector<AudioSample>>& outFeatures)
+{
+    outFeatures.clear();
+
+    LectorAudioBloques lector;
+    if (!lector.abrir(audioPath.string().c_str())) {
+        std::cerr << "! Pipeline: Error al cargar " << audioPath.filename() << std::endl;
+        return false;
+    }
+
+    ExtractorFeaturesStreaming extractor(lector.sampleRate());
+    std::vector<AudioSample> bloque;
+    while (lector.leer(bloque) > 0) {
+        extractor.agregar(bloque.data(), bloque.size());
+    }
+
+    if (!lector.calidadValida()) {
+        std::cerr << "! Error: El audio no cumple los criterios de calidad" << std::endl;
+        return false;
+    }
+
+    auto features = extractor.finalizar();
+
+    std::cout << "-> Pipeline streaming: " << audioPath.filename().string() << " | "
+              << extractor.muestrasEntrada() / lector.sampleRate() << "s | voz "
+              << extractor.muestrasVoz() / lector.sampleRate() << "s | retenidas max "
+              << extractor.maxMuestrasRetenidas() << " muestras" << std::endl;
+
+    if (!features) {
+        return false;
+    }
+    outFeatures.push_back(std::move(*features));
+    return true;
+}
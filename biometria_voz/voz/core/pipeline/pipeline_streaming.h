@@ -0,0 +1,89 @@
+#ifndef PIPELINE_STREAMING_H
+#define PIPELINE_STREAMING_H
+
+#include "audio_pipeline.h"
+#include "../preprocessing/preprocesar.h"
+#include "../segmentation/stft.h"
+#include "../features/mfcc.h"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+// ============================================================================
+// PIPELINE STREAMING - MEMORIA ACOTADA PARA GRABACIONES LARGAS
+// ============================================================================
+//
+// Mismo vector de features que extraerFeatures, calculado a medida que llega
+// el PCM:
+//   bloque -> VADStreaming -> frames STFT -> MFCC -> acumuladores
+//   MEAN/STD/MIN/MAX/DELTA
+// Nunca existe el audio completo, ni la voz concatenada, ni el espectrograma:
+// solo las muestras aun no decididas por el VAD y un frame STFT.
+//
+// Diferencias con el pipeline por buffer:
+// - VAD causal (umbrales con lo visto hasta cada frame, ver VADStreaming)
+// - La normalizacion RMS no se aplica a las muestras. Con la magnitud
+//   espectral, una ganancia g solo desplaza c0 en numFiltros * ln(g); se
+//   corrige al final con el RMS global (identico salvo soft clipping)
+// - Sin augmentation (requiere el audio completo)
+// Si el VAD no detecta voz se usan las features del audio completo, igual
+// que applyVAD. Esa rama se abandona en cuanto aparece voz.
+// ============================================================================
+
+class ExtractorFeaturesStreaming {
+public:
+    explicit ExtractorFeaturesStreaming(int sampleRate);
+
+    // Agrega un bloque de PCM mono (cualquier tamano)
+    void agregar(const AudioSample* pcm, size_t n);
+
+    /**
+     * Cierra el audio y devuelve las features (expansion/L2 incluidas)
+     * nullopt si el audio es muy corto o no alcanza un frame STFT
+     */
+    std::optional<std::vector<AudioSample>> finalizar();
+
+    uint64_t muestrasEntrada() const { return recibidas; }
+    uint64_t muestrasVoz() const { return vad.muestrasVoz(); }
+    // Pico de muestras retenidas a la vez (VAD + frame STFT)
+    size_t maxMuestrasRetenidas() const;
+
+private:
+    // STFT + MFCC + estadisticas sobre un flujo de muestras
+    struct Rama {
+        Rama(int sampleRate);
+        void consumir(const AudioSample* pcm, size_t n);
+
+        EspectroFrame<AudioSample> espectro;
+        MFCCFrame<AudioSample> mfcc;
+        AcumuladorEstadisticasMFCC<AudioSample> stats;
+        std::vector<AudioSample> pendiente;   // < tamFrame() + bloque
+        std::vector<AudioSample> magnitudes;
+        std::vector<AudioSample> coefs;
+        std::vector<double> energias;
+        size_t maxPendiente = 0;
+    };
+
+    int sampleRate;
+    bool conPreprocesamiento;
+    uint64_t recibidas = 0;
+    double sumaCuadrados = 0.0;
+
+    VADStreaming<AudioSample> vad;
+    Rama voz;
+    std::optional<Rama> completo;        // respaldo mientras no haya voz
+    std::vector<AudioSample> bloqueVoz;
+};
+
+/**
+ * procesarAudioCompleto por bloques: lee el archivo con LectorAudioBloques
+ * y lo pasa por ExtractorFeaturesStreaming. Misma validacion de calidad
+ * que loadAudio. Devuelve 1 vector (sin augmentation).
+ */
+bool procesarAudioStreaming(
+    const std::filesystem::path& audioPath,
+    std::vector<std::vector<AudioSample>>& outFeatures
+);
+
+#endif // PIPELINE_STREAMING_H
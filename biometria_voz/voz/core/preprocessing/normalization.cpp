@@ -8,30 +8,33 @@
 #include <vector>
 
 
-AudioSample calcularRMS(const std::vector<AudioSample>& audio) {
-    if (audio.empty()) return 0.0;
+template <typename T>
+T calcularRMS(const std::vector<T>& audio) {
+    if (audio.empty()) return T(0);
 
-    // Acumulacion directa en double sin conversiones
+    // Acumulacion en double aunque las muestras sean float
     double sumSquares = 0.0;
 
 #if ENABLE_OPENMP
 #pragma omp parallel for reduction(+:sumSquares)
 #endif
     for (int i = 0; i < static_cast<int>(audio.size()); ++i) {
-        sumSquares += audio[i] * audio[i];
+        const double s = audio[i];
+        sumSquares += s * s;
     }
 
-    return std::sqrt(sumSquares / audio.size());
+    return static_cast<T>(std::sqrt(sumSquares / audio.size()));
 }
 
-AudioSample encontrarPico(const std::vector<AudioSample>& audio) {
-    if (audio.empty()) return 0.0;
+template <typename T>
+T encontrarPico(const std::vector<T>& audio) {
+    if (audio.empty()) return T(0);
 
-    AudioSample maxAbs = 0.0;
+    T maxAbs = 0;
 
     // NOMINMAX impide usar reduction(max) en OpenMP, calcular max secuencialmente
     for (int i = 0; i < static_cast<int>(audio.size()); ++i) {
-        AudioSample absVal = std::abs(audio[i]);
+        T absVal = std::abs(audio[i]);
         if (absVal > maxAbs) maxAbs = absVal;
     }
 
@@ -41,9 +44,10 @@ AudioSample encontrarPico(const std::vector<AudioSample>& audio) {
 // ============================================================================
 // NORMALIZACION RMS 
 
-std::vector<AudioSample> normalizeRMS(
-    const std::vector<AudioSample>& audio,
-    AudioSample targetRMS)
+template <typename T>
+std::vector<T> normalizeRMS(
+    const std::vector<T>& audio,
+    double targetRMS)
 {
     if (audio.empty()) {
         std::cerr << "! Error: Audio invalido en normalizeRMS" << std::endl;
@@ -56,7 +60,7 @@ std::vector<AudioSample> normalizeRMS(
     }
 
     // Calcular RMS actual
-    AudioSample currentRMS = calcularRMS(audio);
+    const double currentRMS = calcularRMS(audio);
 
     if (CONFIG_PREP.verbose) {
         std::cout << "\n" << std::string(70, '=') << std::endl;
@@ -71,7 +75,7 @@ std::vector<AudioSample> normalizeRMS(
     }
 
     // Calcular factor de ganancia
-    AudioSample gain = targetRMS / currentRMS;
+    const T gain = static_cast<T>(targetRMS / currentRMS);
 
     if (CONFIG_PREP.verbose) {
         std::cout << "\n# Parametros de normalizacion" << std::endl;
@@ -84,18 +88,18 @@ std::vector<AudioSample> normalizeRMS(
     }
 
     // Aplicar ganancia con soft clipping
-    std::vector<AudioSample> output;
+    std::vector<T> output;
     output.reserve(audio.size());
 
     for (size_t i = 0; i < audio.size(); ++i) {
-        AudioSample normalized = audio[i] * gain;
+        T normalized = audio[i] * gain;
 
         // Soft clipping si excede ±1.0 (preservar forma de onda)
-        if (normalized > 1.0) {
-            normalized = 1.0 - 0.1 * (1.0 - std::tanh((normalized - 1.0) * 2.0));
+        if (normalized > T(1)) {
+            normalized = static_cast<T>(1.0 - 0.1 * (1.0 - std::tanh((normalized - 1.0) * 2.0)));
         }
-        else if (normalized < -1.0) {
-            normalized = -1.0 + 0.1 * (1.0 - std::tanh((-normalized - 1.0) * 2.0));
+        else if (normalized < T(-1)) {
+            normalized = static_cast<T>(-1.0 + 0.1 * (1.0 - std::tanh((-normalized - 1.0) * 2.0)));
         }
 
         output.push_back(normalized);
@@ -103,8 +107,8 @@ std::vector<AudioSample> normalizeRMS(
 
     // Verificar RMS final
     if (CONFIG_PREP.verbose) {
-        AudioSample finalRMS = calcularRMS(output);
-        AudioSample finalPeak = encontrarPico(output);
+        T finalRMS = calcularRMS(output);
+        T finalPeak = encontrarPico(output);
         std::cout << "\n# Resultado de normalizacion" << std::endl;
         std::cout << "   +" << std::string(66, '-') << "+" << std::endl;
         std::cout << "   | Metrica                | Umbral/Esperado        | Resultado        " << std::endl;
@@ -116,6 +120,13 @@ std::vector<AudioSample> normalizeRMS(
     return output;
 }
 
+template float calcularRMS<float>(const std::vector<float>&);
+template double calcularRMS<double>(const std::vector<double>&);
+template float encontrarPico<float>(const std::vector<float>&);
+template double encontrarPico<double>(const std::vector<double>&);
+template std::vector<float> normalizeRMS<float>(const std::vector<float>&, double);
+template std::vector<double> normalizeRMS<double>(const std::vector<double>&, double);
+
 // ============================================================================
 // NORMALIZACION POR PICO 
 // ============================================================================
@@ -224,7 +235,7 @@ std::vector<AudioSample> automaticGainControl(
         AudioSample gain = 1.0;
         if (windowRMS > 1e-4) {  // Umbral minimo para evitar amplificar ruido
             gain = targetRMS / windowRMS;
-            gain = std::min(gain, 10.0);  // Limitar ganancia maxima
+            gain = std::min(gain, AudioSample(10.0));  // Limitar ganancia maxima
         }
 
         // Aplicar ganancia con ventana de Hanning para suavizar transiciones
@@ -1,6 +1,11 @@
 ﻿#ifndef PREPROCESAR_H
 #define PREPROCESAR_H
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
 #include <vector>
 #include "config.h"  // Para AudioSample
 
@@ -18,6 +23,10 @@
  * - API moderna con RAII automatico
  * - Mejor precision numerica en todas las operaciones
  *
+ * PRECISION: las etapas del pipeline (normalizeRMS, applyVAD, calcularRMS,
+ * encontrarPico) son plantillas sobre el tipo de muestra, instanciadas para
+ * float y double. AudioSample (config.h) elige cual usa el resto del sistema
+ *
  * ORDEN RECOMENDADO DE APLICACION (PIPELINE ACTUAL):
  * 1. Normalizacion (RMS/Peak/AGC)
  * 2. VAD Avanzado
@@ -48,8 +57,9 @@
   * @param targetRMS Nivel RMS objetivo (0.05-0.2, default: 0.1)
   * @return Audio normalizado (auto-gestionado)
   */
-std::vector<AudioSample> normalizeRMS(const std::vector<AudioSample>& audio,
-    AudioSample targetRMS = 0.1);
+template <typename T>
+std::vector<T> normalizeRMS(const std::vector<T>& audio,
+    double targetRMS = 0.1);
 
 /**
  * Normalizacion por pico maximo
@@ -79,9 +89,12 @@ std::vector<AudioSample> automaticGainControl(const std::vector<AudioSample>& au
 
 /**
  * UTILIDADES DE ANALISIS
+ * Acumulacion en double para cualquier T
  */
-AudioSample calcularRMS(const std::vector<AudioSample>& audio);
-AudioSample encontrarPico(const std::vector<AudioSample>& audio);
+template <typename T>
+T calcularRMS(const std::vector<T>& audio);
+template <typename T>
+T encontrarPico(const std::vector<T>& audio);
 
 // ===================================================================
 // VAD - Voice Activity Detection
@@ -98,7 +111,91 @@ AudioSample encontrarPico(const std::vector<AudioSample>& audio);
  * NOTA: Este VAD usa la segmentacion del denoising previo para
  *       clasificar frames como voz/ruido de manera mas precisa
  */
-std::vector<AudioSample> applyVAD(const std::vector<AudioSample>& audio,
+template <typename T>
+std::vector<T> applyVAD(const std::vector<T>& audio,
     int sampleRate);
 
+/**
+ * VAD por bloques para audios largos (memoria acotada)
+ * Mismas caracteristicas por frame (energia, ZCR, entropia), relleno de
+ * huecos de 1-2 frames, padding, duracion minima y merge que applyVAD,
+ * pero decidiendo a medida que llega el audio:
+ * - Umbrales con estadisticas acumuladas hasta el frame actual (media, y
+ *   mediana de energia por histograma logaritmico) en vez de globales
+ * - La normalizacion RMS no se aplica a las muestras: el umbral absoluto
+ *   vadEnergyThreshold se escala con el RMS acumulado de la entrada
+ * Solo retiene las muestras aun no decididas (padding + merge gap +
+ * duracion minima), nunca el audio completo.
+ *
+ * Ejemplo:
+ *   VADStreaming<AudioSample> vad(16000);
+ *   std::vector<AudioSample> voz;
+ *   while (leer(bloque)) { vad.procesar(bloque.data(), bloque.size(), voz); consumir(voz); voz.clear(); }
+ *   vad.finalizar(voz);
+ */
+template <typename T>
+class VADStreaming {
+public:
+    explicit VADStreaming(int sampleRate);
+
+    // Agrega PCM; anexa a `voz` las muestras ya decididas como voz
+    void procesar(const T* pcm, size_t n, std::vector<T>& voz);
+    // Fin del audio: cierra el ultimo segmento y vacia lo pendiente
+    void finalizar(std::vector<T>& voz);
+
+    uint64_t muestrasEntrada() const { return recibidas; }
+    uint64_t muestrasVoz() const { return emitidasVoz; }
+    size_t maxRetenidas() const { return maxBuffer; }
+    double rmsEntrada() const;
+
+private:
+    void analizarFrames();
+    void decidirFrame(bool voz);
+    void cerrarRun();
+    void agregarSegmento(int64_t ini, int64_t fin);
+    void emitir(std::vector<T>& voz, bool final);
+
+    // Parametros (muestras), mismos que applyVAD
+    int frameSize, stride, padding, minDuracion, mergeGap, muestrasPorBin;
+
+    // Audio retenido: muestras [base, recibidas)
+    std::deque<T> buffer;
+    int64_t base = 0;
+    uint64_t recibidas = 0;
+    size_t maxBuffer = 0;
+    double sumaCuadrados = 0.0;
+
+    // Estadisticas acumuladas para umbrales
+    int64_t siguienteFrame = 0;
+    double sumEnergia = 0.0, sumZcr = 0.0, sumEntropia = 0.0;
+    std::array<uint32_t, 256> histEnergia{};
+
+    // Run de frames con voz en curso [inicioRun, finRun)
+    int64_t inicioRun = -1, finRun = -1;
+    int silencioRun = 0;
+    bool runComprometido = false;
+
+    // Segmento (ya con merge) pendiente de cerrar [segIni, segFin) y
+    // segmentos cerrados cuyo audio aun no se emitio
+    bool haySegmento = false;
+    int64_t segIni = 0, segFin = 0;
+    std::deque<std::pair<int64_t, int64_t>> segmentosCerrados;
+
+    int64_t decididoHasta = 0;  // muestras < decididoHasta ya emitidas o descartadas
+    uint64_t emitidasVoz = 0;
+    bool finalizado = false;
+};
+
+extern template class VADStreaming<float>;
+extern template class VADStreaming<double>;
+
+extern template std::vector<float> normalizeRMS<float>(const std::vector<float>&, double);
+extern template std::vector<double> normalizeRMS<double>(const std::vector<double>&, double);
+extern template float calcularRMS<float>(const std::vector<float>&);
+extern template double calcularRMS<double>(const std::vector<double>&);
+extern template float encontrarPico<float>(const std::vector<float>&);
+extern template double encontrarPico<double>(const std::vector<double>&);
+extern template std::vector<float> applyVAD<float>(const std::vector<float>&, int);
+extern template std::vector<double> applyVAD<double>(const std::vector<double>&, int);
+
 #endif // PREPROCESAR_H
\ No newline at end of file
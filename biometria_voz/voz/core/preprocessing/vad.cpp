@@ -8,7 +8,8 @@
 
 // VAD AVANZADO 
 // Analisis multicaracteristica (energia, ZCR, entropia) sin denoising previo
-std::vector<AudioSample> applyVAD(const std::vector<AudioSample>& audio,
+template <typename T>
+std::vector<T> applyVAD(const std::vector<T>& audio,
     int sampleRate) {
     if (audio.empty()) {
         std::cerr << "! Error: Audio invalido en VAD avanzado" << std::endl;
@@ -248,7 +249,7 @@ std::vector<AudioSample> applyVAD(const std::vector<AudioSample>& audio,
         return {};
     }
 
-    std::vector<AudioSample> result;
+    std::vector<T> result;
     result.reserve(totalKeep);
 
     for (const auto& seg : merged) {
@@ -266,4 +267,7 @@ std::vector<AudioSample> applyVAD(const std::vector<AudioSample>& audio,
     }
 
     return result;
-}
\ No newline at end of file
+}
+
+template std::vector<float> applyVAD<float>(const std::vector<float>&, int);
+template std::vector<double> applyVAD<double>(const std::vector<double>&, int);
@@ -0,0 +1,304 @@
+#include "preprocesar.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// VAD POR BLOQUES
+// Mismo analisis por frame que applyVAD (vad.cpp); las decisiones se toman
+// con lo visto hasta el frame actual y solo se retiene lo no decidido
+
+namespace {
+
+constexpr int kEntropyBins = 8;
+constexpr double kEps = 1e-12;
+
+// Histograma log10 de energias RMS en [1e-8, 10] para la mediana acumulada
+constexpr double kLogMin = -8.0;
+constexpr double kLogRango = 9.0;
+
+int binEnergia(double energia, size_t numBins) {
+    const double l = std::log10(energia + kEps);
+    const int b = static_cast<int>((l - kLogMin) / kLogRango * numBins);
+    return std::clamp(b, 0, static_cast<int>(numBins) - 1);
+}
+
+template <size_t N>
+double medianaHistograma(const std::array<uint32_t, N>& hist, int64_t total) {
+    int64_t acumulado = 0;
+    for (size_t b = 0; b < N; ++b) {
+        acumulado += hist[b];
+        if (2 * acumulado >= total) {
+            return std::pow(10.0, kLogMin + (b + 0.5) * kLogRango / N);
+        }
+    }
+    return 0.0;
+}
+
+} // namespace
+
+template <typename T>
+VADStreaming<T>::VADStreaming(int sampleRate) {
+    const auto& cfg = CONFIG_PREP;
+    frameSize = std::max(1, cfg.vadFrameSizeMs * sampleRate / 1000);
+    stride = std::max(1, cfg.vadFrameStrideMs * sampleRate / 1000);
+    padding = std::max(0, cfg.vadPaddingMs * sampleRate / 1000);
+    minDuracion = std::max(1, cfg.vadMinDurationMs * sampleRate / 1000);
+    mergeGap = std::max(0, cfg.vadMergeGapMs * sampleRate / 1000);
+    muestrasPorBin = std::max(1, frameSize / kEntropyBins);
+}
+
+template <typename T>
+double VADStreaming<T>::rmsEntrada() const {
+    return recibidas > 0 ? std::sqrt(sumaCuadrados / recibidas) : 0.0;
+}
+
+template <typename T>
+void VADStreaming<T>::procesar(const T* pcm, size_t n, std::vector<T>& voz) {
+    if (finalizado || n == 0) return;
+
+    for (size_t i = 0; i < n; ++i) {
+        const double s = pcm[i];
+        sumaCuadrados += s * s;
+    }
+    buffer.insert(buffer.end(), pcm, pcm + n);
+    recibidas += n;
+    maxBuffer = std::max(maxBuffer, buffer.size());
+
+    analizarFrames();
+    emitir(voz, false);
+}
+
+template <typename T>
+void VADStreaming<T>::finalizar(std::vector<T>& voz) {
+    if (finalizado) return;
+    finalizado = true;
+
+    // Audio mas corto que un frame: se conserva completo (igual que applyVAD)
+    if (siguienteFrame == 0) {
+        for (size_t i = static_cast<size_t>(decididoHasta - base); i < buffer.size(); ++i) {
+            voz.push_back(buffer[i]);
+        }
+        emitidasVoz += recibidas - decididoHasta;
+        decididoHasta = static_cast<int64_t>(recibidas);
+        buffer.clear();
+        return;
+    }
+
+    cerrarRun();
+    emitir(voz, true);
+    buffer.clear();
+}
+
+template <typename T>
+void VADStreaming<T>::analizarFrames() {
+    const double targetRMS = CONFIG_PREP.normalizationTargetRMS;
+
+    while (siguienteFrame * stride + frameSize <= static_cast<int64_t>(recibidas)) {
+        const size_t start = static_cast<size_t>(siguienteFrame * stride - base);
+
+        std::array<double, kEntropyBins> binEnergy{};
+        double energySum = 0.0;
+        double zeroCrossings = 0.0;
+        double prevSample = buffer[start];
+
+        for (int j = 0; j < frameSize; ++j) {
+            const double sample = buffer[start + j];
+            energySum += sample * sample;
+
+            if (j > 0 && ((sample >= 0 && prevSample < 0) || (sample < 0 && prevSample >= 0))) {
+                zeroCrossings += 1.0;
+            }
+            prevSample = sample;
+
+            const int binIdx = std::min(kEntropyBins - 1, j / muestrasPorBin);
+            binEnergy[binIdx] += sample * sample;
+        }
+
+        const double frameEnergy = std::sqrt(energySum / frameSize);
+        const double frameZcr = (frameSize > 1) ? zeroCrossings / (frameSize - 1) : 0.0;
+
+        double totalBinEnergy = 0.0;
+        for (double value : binEnergy) totalBinEnergy += value;
+        totalBinEnergy = std::max(totalBinEnergy, kEps);
+
+        double entropy = 0.0;
+        for (double value : binEnergy) {
+            if (value <= 0.0) continue;
+            const double p = value / totalBinEnergy;
+            entropy -= p * std::log2(p);
+        }
+        entropy /= std::log2(static_cast<double>(kEntropyBins));
+
+        // Estadisticas hasta este frame (incluido)
+        const int64_t n = siguienteFrame + 1;
+        sumEnergia += frameEnergy;
+        sumZcr += frameZcr;
+        sumEntropia += entropy;
+        histEnergia[binEnergia(frameEnergy, histEnergia.size())]++;
+
+        // Umbral absoluto expresado en la escala del audio sin normalizar
+        const double rms = rmsEntrada();
+        const double ganancia = (rms > kEps) ? targetRMS / rms : 1.0;
+        const double energyThreshold = std::max(CONFIG_PREP.vadEnergyThreshold / ganancia,
+            std::max(medianaHistograma(histEnergia, n) * 0.75, (sumEnergia / n) * 0.6));
+        const double zcrThreshold = std::max(0.02, (sumZcr / n) * 0.9);
+        const double entropyThreshold = std::max(0.05, (sumEntropia / n) * 0.95);
+
+        const bool energyGate = frameEnergy >= energyThreshold;
+        const bool relaxedEnergy = frameEnergy >= energyThreshold * 0.5;
+        const bool zcrGate = frameZcr <= zcrThreshold * 1.15;
+        const bool entropyGate = entropy <= entropyThreshold * 1.1;
+
+        bool voice = (energyGate && (zcrGate || entropyGate));
+        if (!voice && relaxedEnergy) {
+            voice = (frameZcr <= zcrThreshold * 0.9 && entropy <= entropyThreshold);
+        }
+
+        decidirFrame(voice);
+        ++siguienteFrame;
+    }
+}
+
+template <typename T>
+void VADStreaming<T>::decidirFrame(bool voz) {
+    const int64_t f = siguienteFrame;
+
+    if (!voz) {
+        // Huecos de 1-2 frames se rellenan (suavizado de applyVAD)
+        if (inicioRun >= 0 && ++silencioRun > 2) {
+            cerrarRun();
+        }
+        return;
+    }
+
+    if (inicioRun < 0) {
+        inicioRun = f;
+        runComprometido = false;
+    }
+    finRun = f + 1;
+    silencioRun = 0;
+
+    const int64_t ini = std::max<int64_t>(0, inicioRun * stride - padding);
+    const int64_t fin = finRun * stride + frameSize + padding;
+
+    // Un run que ya supera la duracion minima solo puede crecer: se
+    // registra desde ya para poder emitir su audio sin esperar al cierre
+    if (!runComprometido && fin - ini >= minDuracion) {
+        runComprometido = true;
+        agregarSegmento(ini, fin);
+    }
+    else if (runComprometido) {
+        segFin = std::max(segFin, fin);
+    }
+}
+
+template <typename T>
+void VADStreaming<T>::cerrarRun() {
+    if (inicioRun < 0) return;
+
+    const int64_t ini = std::max<int64_t>(0, inicioRun * stride - padding);
+    int64_t fin = finRun * stride + frameSize + padding;
+    if (finalizado) {
+        fin = std::min<int64_t>(fin, recibidas);
+    }
+
+    if (runComprometido) {
+        segFin = finalizado ? std::min<int64_t>(segFin, recibidas) : segFin;
+    }
+    else if (fin - ini >= minDuracion) {
+        agregarSegmento(ini, fin);
+    }
+
+    inicioRun = -1;
+    finRun = -1;
+    silencioRun = 0;
+    runComprometido = false;
+}
+
+template <typename T>
+void VADStreaming<T>::agregarSegmento(int64_t ini, int64_t fin) {
+    if (haySegmento && ini - segFin <= mergeGap) {
+        segFin = std::max(segFin, fin);
+        return;
+    }
+    if (haySegmento) {
+        // Todo el segmento anterior ya llego (termina antes de `ini`)
+        segmentosCerrados.emplace_back(segIni, segFin);
+    }
+    haySegmento = true;
+    segIni = ini;
+    segFin = fin;
+}
+
+template <typename T>
+void VADStreaming<T>::emitir(std::vector<T>& voz, bool final) {
+    const int64_t total = static_cast<int64_t>(recibidas);
+
+    // Inicio mas temprano posible de un segmento futuro
+    int64_t proximoInicio = std::numeric_limits<int64_t>::max();
+    if (!final) {
+        proximoInicio = (inicioRun >= 0 && !runComprometido)
+            ? std::max<int64_t>(0, inicioRun * stride - padding)
+            : std::max<int64_t>(0, siguienteFrame * stride - padding);
+    }
+    if (final && haySegmento) {
+        segFin = std::min(segFin, total);
+    }
+    const bool mergePosible = !final && haySegmento && proximoInicio - segFin <= mergeGap;
+
+    auto copiar = [&](int64_t desde, int64_t hasta) {
+        const auto it = buffer.begin() + static_cast<std::ptrdiff_t>(desde - base);
+        voz.insert(voz.end(), it, it + static_cast<std::ptrdiff_t>(hasta - desde));
+        emitidasVoz += static_cast<uint64_t>(hasta - desde);
+    };
+
+    while (decididoHasta < total) {
+        const int64_t p = decididoHasta;
+
+        if (!segmentosCerrados.empty()) {
+            const auto [a, b] = segmentosCerrados.front();
+            if (p < a) {
+                decididoHasta = std::min(a, total);
+            }
+            else if (p < b) {
+                decididoHasta = std::min(b, total);
+                copiar(p, decididoHasta);
+            }
+            else {
+                segmentosCerrados.pop_front();
+            }
+            continue;
+        }
+
+        int64_t hasta;
+        if (haySegmento && p < segIni) {
+            hasta = std::min(segIni, total);          // antes del segmento: silencio
+        }
+        else if (haySegmento && p < segFin) {
+            hasta = std::min(segFin, total);          // dentro: voz segura
+            copiar(p, hasta);
+            decididoHasta = hasta;
+            continue;
+        }
+        else if (mergePosible) {
+            break;                                    // el hueco aun puede unirse
+        }
+        else {
+            hasta = std::min(proximoInicio, total);   // silencio definitivo
+        }
+
+        if (hasta <= p) break;
+        decididoHasta = hasta;
+    }
+
+    // Retener solo lo no decidido y lo que falta analizar
+    const int64_t conservarDesde = std::min(decididoHasta, siguienteFrame * stride);
+    if (conservarDesde > base) {
+        const int64_t k = std::min<int64_t>(conservarDesde - base, static_cast<int64_t>(buffer.size()));
+        buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(k));
+        base += k;
+    }
+}
+
+template class VADStreaming<float>;
+template class VADStreaming<double>;
@@ -0,0 +1,307 @@
+#include "dataset_shards.h"
+#include "hash_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* kCabecera = "# voz_shards v1";
+
+bool parsearEntrada(const std::string& linea, EntradaManifest& e) {
+    std::istringstream is(linea);
+    std::string hashHex;
+    if (!std::getline(is, hashHex, '\t') || !hexAHash(hashHex, e.hash)) return false;
+    if (!(is >> e.bytes)) return false;
+    is.get();
+    if (!std::getline(is, e.shard, '\t')) return false;
+    if (!(is >> e.offset >> e.numMuestras)) return false;
+    is.get();
+    std::getline(is, e.ruta);
+    return e.numMuestras >= 0;
+}
+
+} // namespace
+
+bool hashArchivo(const fs::path& ruta, uint64_t& hash, uint64_t& bytes) {
+    std::ifstream in(ruta, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    hash = kFNV1aOffset;
+    bytes = 0;
+    std::vector<char> buf(1 << 16);
+    while (in) {
+        in.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+        const auto n = static_cast<size_t>(in.gcount());
+        if (n == 0) break;
+        hash = hashFNV1a64(buf.data(), n, hash);
+        bytes += n;
+    }
+    return !in.bad();
+}
+
+AlmacenShards::AlmacenShards(const std::string& dir_, int dim_, int numWorkers, bool reiniciar)
+    : dir(dir_), dim(dim_), huella(huellaConfigFeatures()) {
+
+    rutaManifiesto = (fs::path(dir) / "manifest.tsv").string();
+    fs::create_directories(dir);
+
+    const auto ahora = std::chrono::system_clock::now().time_since_epoch().count();
+    etiquetaCorrida = hashAHex(static_cast<uint64_t>(ahora)).substr(8);
+
+    writers.resize(std::max(1, numWorkers));
+    offsets.assign(writers.size(), 0);
+
+    if (reiniciar) {
+        reiniciarAlmacen();
+    } else {
+        cargarManifiesto();
+    }
+
+    manifiesto.open(rutaManifiesto, std::ios::app);
+    if (!manifiesto.is_open()) {
+        std::cerr << "! Shards: no se pudo abrir " << rutaManifiesto << std::endl;
+    }
+}
+
+size_t AlmacenShards::bytesPorMuestra() const {
+    return sizeof(int) + sizeof(AudioSample) * static_cast<size_t>(dim) + sizeof(int);
+}
+
+void AlmacenShards::reiniciarAlmacen() {
+    std::error_code ec;
+    for (const auto& f : fs::directory_iterator(dir, ec)) {
+        const std::string nombre = f.path().filename().string();
+        if (nombre.rfind("shard_", 0) == 0 && f.path().extension() == ".bin") {
+            fs::remove(f.path(), ec);
+        }
+    }
+    indice.clear();
+    reutilizables = 0;
+
+    std::ofstream out(rutaManifiesto, std::ios::trunc);
+    out << kCabecera << " huella=" << huella << " dim=" << dim << '\n';
+}
+
+void AlmacenShards::cargarManifiesto() {
+    std::ifstream in(rutaManifiesto);
+    if (!in.is_open()) {
+        reiniciarAlmacen();
+        return;
+    }
+
+    std::string cabecera;
+    std::getline(in, cabecera);
+    std::ostringstream esperada;
+    esperada << kCabecera << " huella=" << huella << " dim=" << dim;
+    if (cabecera != esperada.str()) {
+        std::cout << "-> Shards: configuracion de features distinta, se descarta el almacen previo" << std::endl;
+        in.close();
+        reiniciarAlmacen();
+        return;
+    }
+
+    // Una entrada solo vale si su shard tiene todos los bytes (caida a mitad de escritura)
+    std::map<std::string, uint64_t> tamShard;
+    const size_t rec = bytesPorMuestra();
+    size_t descartadas = 0;
+
+    std::string linea;
+    while (std::getline(in, linea)) {
+        if (linea.empty() || linea[0] == '#') continue;
+        EntradaManifest e;
+        if (!parsearEntrada(linea, e)) {
+            ++descartadas;
+            continue;
+        }
+        if (e.numMuestras > 0) {
+            auto it = tamShard.find(e.shard);
+            if (it == tamShard.end()) {
+                std::error_code ec;
+                const auto tam = fs::file_size(fs::path(dir) / e.shard, ec);
+                it = tamShard.emplace(e.shard, ec ? 0 : static_cast<uint64_t>(tam)).first;
+            }
+            if (e.offset + rec * static_cast<uint64_t>(e.numMuestras) > it->second) {
+                ++descartadas;
+                continue;
+            }
+        }
+        indice[e.hash] = std::move(e);
+    }
+
+    in.close();
+
+    reutilizables = indice.size();
+    std::cout << "-> Shards: " << reutilizables << " audios en manifiesto";
+    if (descartadas > 0) std::cout << " (" << descartadas << " entradas incompletas descartadas)";
+    std::cout << std::endl;
+
+    if (descartadas > 0) compactarManifiesto();
+    podarShardsHuerfanos();
+}
+
+// Reescribe el manifiesto solo con las entradas validas (tmp + rename: una
+// caida a mitad deja el manifiesto anterior intacto)
+void AlmacenShards::compactarManifiesto() {
+    const std::string tmp = rutaManifiesto + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        out << kCabecera << " huella=" << huella << " dim=" << dim << '\n';
+        for (const auto& [hash, e] : indice) {
+            out << hashAHex(e.hash) << '\t' << e.bytes << '\t' << e.shard << '\t'
+                << e.offset << '\t' << e.numMuestras << '\t' << e.ruta << '\n';
+        }
+        out.flush();
+        if (!out) {
+            std::error_code ec;
+            fs::remove(tmp, ec);
+            return;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmp, rutaManifiesto, ec);
+    if (ec) {
+        std::cerr << "! Shards: no se pudo compactar el manifiesto: " << ec.message() << std::endl;
+        fs::remove(tmp, ec);
+    }
+}
+
+// Shards de corridas anteriores que ninguna entrada del manifiesto referencia
+// (caidas antes de indexar, entradas descartadas): sin esto crecen sin limite
+void AlmacenShards::podarShardsHuerfanos() {
+    std::unordered_set<std::string> referenciados;
+    for (const auto& [hash, e] : indice) {
+        if (e.numMuestras > 0) referenciados.insert(e.shard);
+    }
+
+    size_t borrados = 0;
+    uint64_t bytesLiberados = 0;
+    std::error_code ec;
+    for (const auto& f : fs::directory_iterator(dir, ec)) {
+        const std::string nombre = f.path().filename().string();
+        if (nombre.rfind("shard_", 0) != 0 || f.path().extension() != ".bin") continue;
+        if (referenciados.count(nombre)) continue;
+
+        std::error_code ecTam, ecBorrar;
+        const auto tam = f.file_size(ecTam);
+        if (fs::remove(f.path(), ecBorrar)) {
+            ++borrados;
+            if (!ecTam) bytesLiberados += static_cast<uint64_t>(tam);
+        }
+    }
+    if (borrados > 0) {
+        std::cout << "-> Shards: " << borrados << " shards sin referencias eliminados ("
+                  << (bytesLiberados >> 20) << " MB)" << std::endl;
+    }
+}
+
+bool AlmacenShards::contiene(uint64_t hash) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return indice.count(hash) > 0;
+}
+
+bool AlmacenShards::buscar(uint64_t hash, EntradaManifest& out) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = indice.find(hash);
+    if (it == indice.end()) return false;
+    out = it->second;
+    return true;
+}
+
+size_t AlmacenShards::numEntradas() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return indice.size();
+}
+
+void AlmacenShards::escribirEntrada(const EntradaManifest& e) {
+    manifiesto << hashAHex(e.hash) << '\t' << e.bytes << '\t' << e.shard << '\t'
+               << e.offset << '\t' << e.numMuestras << '\t' << e.ruta << '\n';
+    manifiesto.flush();
+}
+
+bool AlmacenShards::guardar(int worker, uint64_t hash, uint64_t bytes, const std::string& ruta,
+    int etiqueta, const std::vector<std::vector<AudioSample>>& muestras) {
+
+    EntradaManifest e;
+    e.hash = hash;
+    e.bytes = bytes;
+    e.ruta = ruta;
+    e.shard = "-";
+
+    if (!muestras.empty()) {
+        if (worker < 0 || worker >= static_cast<int>(writers.size())) return false;
+
+        auto& w = writers[worker];
+        e.shard = "shard_" + etiquetaCorrida + "_" + std::to_string(worker) + ".bin";
+        if (!w) {
+            w = std::make_unique<std::ofstream>(fs::path(dir) / e.shard, std::ios::binary | std::ios::trunc);
+            if (!w->is_open()) {
+                std::cerr << "! Shards: no se pudo crear " << e.shard << std::endl;
+                w.reset();
+                return false;
+            }
+        }
+        e.offset = offsets[worker];
+
+        for (const auto& x : muestras) {
+            if (static_cast<int>(x.size()) != dim) {
+                std::cerr << "! Shards: dimension " << x.size() << " != " << dim
+                          << " en " << ruta << std::endl;
+                return false;
+            }
+        }
+        for (const auto& x : muestras) {
+            w->write(reinterpret_cast<const char*>(&dim), sizeof(int));
+            w->write(reinterpret_cast<const char*>(x.data()), sizeof(AudioSample) * dim);
+            w->write(reinterpret_cast<const char*>(&etiqueta), sizeof(int));
+        }
+        // El shard llega a disco antes que la entrada que lo referencia
+        w->flush();
+        if (!*w) {
+            std::cerr << "! Shards: error escribiendo " << e.shard << std::endl;
+            return false;
+        }
+        e.numMuestras = static_cast<int>(muestras.size());
+        offsets[worker] += bytesPorMuestra() * muestras.size();
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    escribirEntrada(e);
+    indice[hash] = std::move(e);
+    return true;
+}
+
+bool AlmacenShards::leer(const EntradaManifest& e, std::vector<std::vector<AudioSample>>& out) {
+    out.clear();
+    if (e.numMuestras == 0) return true;
+
+    auto it = lectores.find(e.shard);
+    if (it == lectores.end()) {
+        it = lectores.emplace(e.shard, std::ifstream(fs::path(dir) / e.shard, std::ios::binary)).first;
+    }
+    auto& in = it->second;
+    if (!in.is_open()) return false;
+
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(e.offset));
+    out.resize(e.numMuestras);
+    for (auto& x : out) {
+        int d = 0, etiqueta = 0;
+        in.read(reinterpret_cast<char*>(&d), sizeof(int));
+        if (!in || d != dim) {
+            out.clear();
+            return false;
+        }
+        x.resize(d);
+        in.read(reinterpret_cast<char*>(x.data()), sizeof(AudioSample) * d);
+        in.read(reinterpret_cast<char*>(&etiqueta), sizeof(int));
+    }
+    if (!in) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+#ifndef DATASET_SHARDS_H
+#define DATASET_SHARDS_H
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "config.h"  // Para AudioSample
+
+// ============================================================================
+// ALMACEN DE FEATURES POR SHARDS (construccion de dataset reanudable)
+//
+// Cada worker escribe sus muestras en su propio shard (append, sin locks) con
+// el mismo formato por muestra que el dataset binario:
+//   [dim:int][features:AudioSample*dim][label:int]
+// Un manifiesto de texto (append + flush por archivo) indexa cada audio por
+// hash de contenido:
+//   # voz_shards v1 huella=<huellaConfigFeatures> dim=<dim>
+//   <hash>\t<bytes>\t<shard>\t<offset>\t<numMuestras>\t<ruta>
+// Si el proceso se cae, solo se pierde el audio en curso; al relanzar se
+// saltan los audios ya indexados y sin cambios. Si cambia la huella de
+// configuracion el almacen se descarta entero. Al abrir se borran los shards
+// que el manifiesto ya no referencia.
+// ============================================================================
+
+/**
+ * Entrada del manifiesto: un audio ya procesado
+ * numMuestras = 0 -> audio invalido (se recuerda para no reintentarlo)
+ */
+struct EntradaManifest {
+    uint64_t hash = 0;
+    uint64_t bytes = 0;
+    std::string shard;        // nombre del shard dentro del directorio ("-" si no hay muestras)
+    uint64_t offset = 0;      // byte de inicio dentro del shard
+    int numMuestras = 0;
+    std::string ruta;         // informativo (el indice es el hash)
+};
+
+/**
+ * Hash FNV-1a 64 del contenido de un archivo (lectura por bloques)
+ *
+ * @return false si el archivo no se pudo leer
+ */
+bool hashArchivo(const std::filesystem::path& ruta, uint64_t& hash, uint64_t& bytes);
+
+class AlmacenShards {
+public:
+    /**
+     * Abre (o crea) el almacen en `dir`
+     *
+     * @param dim Dimension esperada de las features
+     * @param numWorkers Workers que escriben en paralelo (un shard por worker)
+     * @param reiniciar true = descarta manifiesto y shards existentes
+     */
+    AlmacenShards(const std::string& dir, int dim, int numWorkers, bool reiniciar = false);
+
+    AlmacenShards(const AlmacenShards&) = delete;
+    AlmacenShards& operator=(const AlmacenShards&) = delete;
+
+    // Thread-safe
+    bool contiene(uint64_t hash) const;
+    bool buscar(uint64_t hash, EntradaManifest& out) const;
+
+    /**
+     * Agrega las muestras de un audio al shard del worker y lo registra
+     * en el manifiesto. Cada worker debe usar su propio indice.
+     */
+    bool guardar(int worker, uint64_t hash, uint64_t bytes, const std::string& ruta,
+        int etiqueta, const std::vector<std::vector<AudioSample>>& muestras);
+
+    /**
+     * Lee las muestras de una entrada (fase de fusion, un solo hilo)
+     */
+    bool leer(const EntradaManifest& entrada, std::vector<std::vector<AudioSample>>& out);
+
+    size_t numEntradas() const;
+    size_t entradasReutilizables() const { return reutilizables; }
+    const std::string& directorio() const { return dir; }
+
+private:
+    void cargarManifiesto();
+    void reiniciarAlmacen();
+    void compactarManifiesto();
+    void podarShardsHuerfanos();
+    void escribirEntrada(const EntradaManifest& e);
+    size_t bytesPorMuestra() const;
+
+    std::string dir;
+    std::string rutaManifiesto;
+    int dim;
+    std::string huella;
+    std::string etiquetaCorrida;  // distingue los shards de cada ejecucion
+    size_t reutilizables = 0;
+
+    mutable std::mutex mtx;
+    std::unordered_map<uint64_t, EntradaManifest> indice;
+    std::ofstream manifiesto;
+
+    std::vector<std::unique_ptr<std::ofstream>> writers;
+    std::vector<uint64_t> offsets;
+
+    std::map<std::string, std::ifstream> lectores;
+};
+
+#endif // DATASET_SHARDS_H
@@ -1,19 +1,29 @@
 ﻿#include "stft.h"
 #include "../../utils/config.h"
 #include "../../utils/additional.h"
+#include <algorithm>
 #include <cmath>
 #include <complex>
 #include <vector>
 #include <iostream>
 #include <iomanip>  
 
+// Producto complejo sin la rama NaN/Inf de operator* (__mulsc3/__muldc3),
+// que impide vectorizar el butterfly. Mismo resultado para valores finitos
+template <typename T>
+static inline std::complex<T> mulComplejo(const std::complex<T>& a, const std::complex<T>& b) {
+    return { a.real() * b.real() - a.imag() * b.imag(),
+             a.real() * b.imag() + a.imag() * b.real() };
+}
+
 /**
- * FFT iterativa Cooley-Tukey con precision double
+ * FFT iterativa Cooley-Tukey (float o double)
  * Algoritmo in-place con bit-reversal y butterfly operations
  *
  * @param data Vector de numeros complejos (debe ser potencia de 2)
  */
-void fft_iterative(std::vector<std::complex<double>>& data) {
+template <typename T>
+static void fft_iterative(std::vector<std::complex<T>>& data) {
     const int n = static_cast<int>(data.size());
     if (n <= 1) return;
 
@@ -38,16 +48,16 @@ void fft_iterative(std::vector<std::complex<double>>& data) {
     // Cooley-Tukey decimation-in-time radix-2 FFT
     for (int len = 2; len <= n; len <<= 1) {
         const double angle = -2.0 * M_PI / len;
-        const std::complex<double> wlen(std::cos(angle), std::sin(angle));
+        const std::complex<T> wlen(static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle)));
 
         for (int i = 0; i < n; i += len) {
-            std::complex<double> w(1.0, 0.0);
+            std::complex<T> w(1, 0);
             for (int j = 0; j < len / 2; ++j) {
-                const std::complex<double> u = data[i + j];
-                const std::complex<double> v = data[i + j + len / 2] * w;
+                const std::complex<T> u = data[i + j];
+                const std::complex<T> v = mulComplejo(data[i + j + len / 2], w);
                 data[i + j] = u + v;
                 data[i + j + len / 2] = u - v;
-                w *= wlen;
+                w = mulComplejo(w, wlen);
             }
         }
     }
@@ -64,11 +74,12 @@ int nextPowerOf2(int n) {
 }
 
 // ============================================================================
-// STFT - VERSION CON VECTORES Y DOUBLE
+// STFT - VERSION CON VECTORES (float o double)
 // ============================================================================
 
-std::vector<std::vector<AudioSample>> applySTFT(
-    const std::vector<AudioSample>& audio,
+template <typename T>
+std::vector<std::vector<T>> applySTFT(
+    const std::vector<T>& audio,
     int sampleRate)
 {
     if (audio.empty()) {
@@ -114,9 +125,9 @@ std::vector<std::vector<AudioSample>> applySTFT(
     }
 
     // Inicializar espectrograma con vectores (gestion automatica)
-    std::vector<std::vector<AudioSample>> spectrogram(
+    std::vector<std::vector<T>> spectrogram(
         numFrames,
-        std::vector<AudioSample>(numBins, 0.0)
+        std::vector<T>(numBins, T(0))
     );
 
     // Procesar frames en paralelo (si OpenMP esta activado)
@@ -124,48 +135,63 @@ std::vector<std::vector<AudioSample>> applySTFT(
 #pragma omp parallel
 #endif
     {
-        // Buffer local para cada thread
-        std::vector<std::complex<double>> fftInput(fftSize);
+        // Ventana + buffer FFT locales para cada thread
+        EspectroFrame<T> espectro(sampleRate);
 
 #if ENABLE_OPENMP
 #pragma omp for
 #endif
         for (int f = 0; f < numFrames; ++f) {
-            const int start = f * frameStride;
+            // numFrames garantiza frames completos dentro del audio
+            espectro.calcular(audio.data() + static_cast<size_t>(f) * frameStride, spectrogram[f].data());
+        }
+    }
 
-            // Extraer frame y aplicar ventana Hann
-            for (int j = 0; j < fftSize; ++j) {
-                double sample = 0.0;
+    if (CONFIG_PREP.verbose) {
+        std::cout << "   & STFT completado: " << numFrames << " frames x " << numBins << " bins" << std::endl;
+    }
 
-                if (j < frameSize) {
-                    const int idx = start + j;
-                    if (idx < totalSamples) {
-                        sample = audio[idx];
-                    }
+    return spectrogram;
+}
 
-                    // Ventana Hann en double precision
-                    const double window = 0.5 * (1.0 - std::cos(2.0 * M_PI * j / (frameSize - 1)));
-                    sample *= window;
-                }
+template <typename T>
+EspectroFrame<T>::EspectroFrame(int sampleRate) {
+    const auto& cfg = CONFIG_STFT;
+    frameSize = sampleRate * cfg.frameSizeMs / 1000;
+    frameStride = sampleRate * cfg.frameStrideMs / 1000;
+    fftSize = frameSize > 0 ? nextPowerOf2(frameSize) : 0;
+
+    // Ventana Hann precalculada (en vez de un cos por muestra y frame)
+    ventana.resize(std::max(0, frameSize));
+    for (int j = 0; j < frameSize; ++j) {
+        ventana[j] = static_cast<T>(0.5 * (1.0 - std::cos(2.0 * M_PI * j / (frameSize - 1))));
+    }
+    fftBuffer.resize(fftSize);
+}
 
-                fftInput[j] = std::complex<double>(sample, 0.0);
-            }
+template <typename T>
+void EspectroFrame<T>::calcular(const T* frame, T* salida) {
+    // Extraer frame, aplicar ventana Hann y zero-padding hasta fftSize
+    for (int j = 0; j < frameSize; ++j) {
+        fftBuffer[j] = std::complex<T>(frame[j] * ventana[j], 0);
+    }
+    for (int j = frameSize; j < fftSize; ++j) {
+        fftBuffer[j] = std::complex<T>(0, 0);
+    }
 
-            // Aplicar FFT
-            fft_iterative(fftInput);
+    fft_iterative(fftBuffer);
 
-            // Calcular magnitudes espectrales (sqrt(re^2 + im^2))
-            for (int k = 0; k < numBins; ++k) {
-                const double re = fftInput[k].real();
-                const double im = fftInput[k].imag();
-                spectrogram[f][k] = std::sqrt(re * re + im * im);
-            }
-        }
+    // Calcular magnitudes espectrales (sqrt(re^2 + im^2))
+    const int numBins = fftSize / 2;
+    for (int k = 0; k < numBins; ++k) {
+        const T re = fftBuffer[k].real();
+        const T im = fftBuffer[k].imag();
+        salida[k] = std::sqrt(re * re + im * im);
     }
+}
 
-    if (CONFIG_PREP.verbose) {
-        std::cout << "   & STFT completado: " << numFrames << " frames x " << numBins << " bins" << std::endl;
-    }
+template class EspectroFrame<float>;
+template class EspectroFrame<double>;
 
-    return spectrogram;
-}
\ No newline at end of file
+template std::vector<std::vector<float>> applySTFT<float>(const std::vector<float>&, int);
+template std::vector<std::vector<double>> applySTFT<double>(const std::vector<double>&, int);
@@ -2,6 +2,7 @@
 #define STFT_H
 
 #include "config.h"
+#include <complex>
 #include <vector>
 
 /**
@@ -69,12 +70,20 @@
  * - Cero memory leaks (RAII automatico)
  * - Codigo mas simple y mantenible
  * - Sin necesidad de liberar memoria manualmente
+ *
+ * PRECISION: plantilla sobre el tipo de muestra (float / double instanciados
+ * en stft.cpp). La FFT corre en std::complex<T>: con float el doble de
+ * lanes SIMD y la mitad de trafico de memoria
  */
-std::vector<std::vector<AudioSample>> applySTFT(
-    const std::vector<AudioSample>& audio,
+template <typename T>
+std::vector<std::vector<T>> applySTFT(
+    const std::vector<T>& audio,
     int sampleRate
 );
 
+extern template std::vector<std::vector<float>> applySTFT<float>(const std::vector<float>&, int);
+extern template std::vector<std::vector<double>> applySTFT<double>(const std::vector<double>&, int);
+
 /**
  * Encuentra la siguiente potencia de 2 mayor o igual a n
  * Util para calcular tamaño optimo de FFT
@@ -91,4 +100,40 @@ std::vector<std::vector<AudioSample>> applySTFT(
  */
 int nextPowerOf2(int n);
 
+/**
+ * Espectro de UN frame con los parametros de CONFIG_STFT
+ * Misma ventana Hann, zero-padding y FFT que applySTFT (que lo usa por
+ * thread); el pipeline streaming lo alimenta frame a frame
+ *
+ * Ejemplo:
+ *   EspectroFrame<AudioSample> esp(16000);
+ *   std::vector<AudioSample> mag(esp.numBins());
+ *   esp.calcular(audio.data() + f * esp.salto(), mag.data());
+ *
+ * No es thread-safe (buffer FFT interno): una instancia por hilo
+ */
+template <typename T>
+class EspectroFrame {
+public:
+    explicit EspectroFrame(int sampleRate);
+
+    bool valido() const { return frameSize > 0 && frameStride > 0; }
+    int tamFrame() const { return frameSize; }
+    int salto() const { return frameStride; }
+    int numBins() const { return fftSize / 2; }
+
+    // frame: tamFrame() muestras | salida: numBins() magnitudes
+    void calcular(const T* frame, T* salida);
+
+private:
+    int frameSize;
+    int frameStride;
+    int fftSize;
+    std::vector<T> ventana;
+    std::vector<std::complex<T>> fftBuffer;
+};
+
+extern template class EspectroFrame<float>;
+extern template class EspectroFrame<double>;
+
 #endif // STFT_H
\ No newline at end of file
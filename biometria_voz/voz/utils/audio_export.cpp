@@ -39,7 +39,7 @@ void saveAudioToWav(const char* wavFile, const AudioSample* audioData,
             tempBuffer[i] = 0.0f;  // Reemplazar invalidos con silencio
         } else {
             // Clipping sin distorsion
-            tempBuffer[i] = static_cast<float>(std::max(-1.0, std::min(1.0, val)));
+            tempBuffer[i] = static_cast<float>(std::max(-1.0, std::min(1.0, static_cast<double>(val))));
         }
     }
 
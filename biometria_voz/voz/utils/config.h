@@ -7,12 +7,27 @@
 #include <cstdlib>
 #include <iostream>
 #include <regex>
+#include <algorithm>
 #include <utility>
+#include <sstream>
+#include "hash_utils.h"
 
 // CONTROL DE PRECISION Y PARALELISMO
 
 // Tipo unificado para muestras de audio (double para precision biometrica)
+// VOZ_AUDIO_FLOAT32=1 (cmake -DVOZ_AUDIO_FLOAT32=ON) cambia todo el sistema a
+// float: mitad de memoria y el doble de lanes SIMD en STFT/MFCC. Datasets,
+// modelos y cache de features quedan ligados a la precision (sizeof entra en
+// huellaConfigFeatures). Medir antes con voz_comparar_precision
+#ifndef VOZ_AUDIO_FLOAT32
+    #define VOZ_AUDIO_FLOAT32 0
+#endif
+
+#if VOZ_AUDIO_FLOAT32
+using AudioSample = float;
+#else
 using AudioSample = double;
+#endif
 
 // CONTROL AVANZADO DE PARALELIZACION CON OPENMP
 // Se detecta automaticamente si el compilador tiene OpenMP habilitado (_OPENMP)
@@ -202,6 +217,12 @@ struct ConfigPreprocessing
     // SECCION 2: NORMALIZACION
     double normalizationTargetRMS; // RMS objetivo (0.05-0.2, default 0.1)
 
+    // SECCION 3: PIPELINE STREAMING (memoria acotada)
+    // Archivos >= N s van por bloques (0 = nunca). Sus features NO son identicas
+    // a las de batch (VAD causal, RMS diferida sobre c0): activar solo con un modelo
+    // entrenado tambien por streaming
+    int streamingDesdeSegundos;
+
     // SECCION 4: CONTROL GLOBAL
     bool enablePreprocessing; // Master switch (false = bypass total)
     bool verbose;             // Logging detallado
@@ -218,6 +239,9 @@ struct ConfigPreprocessing
         // === NORMALIZACION ===
         normalizationTargetRMS = 0.1;
 
+        // === STREAMING ===
+        streamingDesdeSegundos = 0;
+
         // === CONTROL GLOBAL ===
         enablePreprocessing = true;
         verbose = true;
@@ -246,6 +270,10 @@ struct ConfigPreprocessing
         // NORMALIZACION
         std::cout << "\n   [NORMALIZACION]" << std::endl;
         std::cout << "     Target RMS: " << normalizationTargetRMS << std::endl;
+
+        // STREAMING
+        std::cout << "\n   [STREAMING]" << std::endl;
+        std::cout << "     Desde: " << (streamingDesdeSegundos > 0 ? std::to_string(streamingDesdeSegundos) + "s" : "desactivado") << std::endl;
     }
 };
 
@@ -470,6 +498,48 @@ struct ConfigDataset
     }
 };
 
+// CONFIG ASR (verificacion de frase dinamica)
+// Backend por variable de entorno VOZ_ASR_BACKEND:
+//   "whisper" -> modelo residente en proceso (requiere compilar con VOZ_WHISPER_INPROC)
+//   "cli"     -> whisper-cli por popen (recarga el modelo en cada llamada)
+//   "stub"    -> texto fijo (VOZ_ASR_TEXTO_STUB), para pruebas sin modelo
+struct ConfigASR
+{
+    std::string backend;
+    std::string rutaModelo;       // ggml-*.bin
+    std::string idioma;
+    int maxConcurrencia;          // inferencias simultaneas (1 estado whisper por slot)
+    int hilosPorInferencia;
+    std::string textoStub;
+
+    ConfigASR()
+    {
+#ifdef VOZ_WHISPER_INPROC
+        backend = "whisper";
+#else
+        backend = "cli";
+#endif
+        rutaModelo = "ggml-tiny.bin";
+        idioma = "es";
+        maxConcurrencia = 1;
+        hilosPorInferencia = 4;
+
+        if (const char *b = std::getenv("VOZ_ASR_BACKEND")) backend = b;
+        if (const char *m = std::getenv("VOZ_ASR_MODELO")) rutaModelo = m;
+        if (const char *c = std::getenv("VOZ_ASR_CONCURRENCIA")) maxConcurrencia = std::max(1, std::atoi(c));
+        if (const char *h = std::getenv("VOZ_ASR_HILOS")) hilosPorInferencia = std::max(1, std::atoi(h));
+        if (const char *t = std::getenv("VOZ_ASR_TEXTO_STUB")) textoStub = t;
+    }
+
+    void mostrar() const
+    {
+        std::cout << "-> Config ASR:" << std::endl;
+        std::cout << "   Backend: " << backend << std::endl;
+        std::cout << "   Modelo: " << rutaModelo << " (" << idioma << ")" << std::endl;
+        std::cout << "   Concurrencia: " << maxConcurrencia << " x " << hilosPorInferencia << " hilos" << std::endl;
+    }
+};
+
 // CONFIG PROFILING
 struct ConfigProfiling
 {
@@ -514,6 +584,7 @@ public:
     ConfigAutenticacion autenticacion;
     ConfigDataset dataset;
     ConfigProfiling profiling;
+    ConfigASR asr;
 
     static ConfigGlobal &getInstance()
     {
@@ -545,6 +616,8 @@ public:
         dataset.mostrar();
         std::cout << std::endl;
         profiling.mostrar();
+        std::cout << std::endl;
+        asr.mostrar();
 
         std::cout << std::string(60, '=') << std::endl;
     }
@@ -566,5 +639,32 @@ private:
 #define CONFIG_AUTH ConfigGlobal::getInstance().autenticacion
 #define CONFIG_DATASET ConfigGlobal::getInstance().dataset
 #define CONFIG_PROFILING ConfigGlobal::getInstance().profiling
+#define CONFIG_ASR ConfigGlobal::getInstance().asr
+
+// HUELLA DE CONFIGURACION DE FEATURES
+// Todo parametro que cambie el vector de salida de procesarAudioCompleto entra aqui:
+// caches de features (dataset por shards, registro) se invalidan si la huella cambia
+inline std::string huellaConfigFeatures()
+{
+    const auto& p = CONFIG_PREP;
+    const auto& s = CONFIG_STFT;
+    const auto& m = CONFIG_MFCC;
+    const auto& a = CONFIG_AUG;
+    std::ostringstream os;
+    os.precision(17);
+    os << "v1|sample=" << sizeof(AudioSample)
+       << "|prep=" << p.enablePreprocessing << ',' << p.vadEnergyThreshold << ',' << p.vadMinDurationMs
+       << ',' << p.vadPaddingMs << ',' << p.vadFrameSizeMs << ',' << p.vadFrameStrideMs << ','
+       << p.vadMergeGapMs << ',' << p.normalizationTargetRMS << ',' << p.streamingDesdeSegundos
+       << "|stft=" << s.frameSizeMs << ',' << s.frameStrideMs
+       << "|mfcc=" << m.numCoefficients << ',' << m.numFilters << ',' << m.freqMin << ','
+       << m.freqMax << ',' << m.totalFeatures
+       << "|aug=" << CONFIG_DATASET.usarAugmentation << ',' << a.numVariaciones << ','
+       << a.intensidadRuido << ',' << a.volumenMin << ',' << a.volumenMax << ','
+       << a.velocidadMin << ',' << a.velocidadMax << ',' << a.seed
+       << "|min=" << CONFIG_DATASET.minAudioSamples
+       << "|svm=" << CONFIG_SVM.usarExpansionPolinomial << ',' << CONFIG_SVM.usarNormalizacionL2;
+    return hashAHex(hashFNV1a64(os.str()));
+}
 
 #endif // CONFIG_H
@@ -0,0 +1,58 @@
+#ifndef HASH_UTILS_H
+#define HASH_UTILS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ============================================================================
+// HASH DE CONTENIDO (FNV-1a 64 bits)
+// No criptografico: solo identifica contenido para caches y manifiestos.
+// Encadenable: hashFNV1a64(b, nb, hashFNV1a64(a, na)) == hash de a+b
+// ============================================================================
+
+constexpr uint64_t kFNV1aOffset = 14695981039346656037ULL;
+constexpr uint64_t kFNV1aPrime = 1099511628211ULL;
+
+inline uint64_t hashFNV1a64(const void* data, size_t n, uint64_t h = kFNV1aOffset)
+{
+    const auto* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < n; ++i)
+    {
+        h ^= p[i];
+        h *= kFNV1aPrime;
+    }
+    return h;
+}
+
+inline uint64_t hashFNV1a64(const std::string& s, uint64_t h = kFNV1aOffset)
+{
+    return hashFNV1a64(s.data(), s.size(), h);
+}
+
+// 16 digitos hex (formato estable para nombres de archivo y manifiestos)
+inline std::string hashAHex(uint64_t h)
+{
+    static const char kHex[] = "0123456789abcdef";
+    std::string out(16, '0');
+    for (int i = 15; i >= 0; --i, h >>= 4) out[i] = kHex[h & 15];
+    return out;
+}
+
+inline bool hexAHash(const std::string& s, uint64_t& h)
+{
+    if (s.size() != 16) return false;
+    h = 0;
+    for (char c : s)
+    {
+        int v;
+        if (c >= '0' && c <= '9') v = c - '0';
+        else if (c >= 'a' && c <= 'f') v = 10 + (c - 'a');
+        else if (c >= 'A' && c <= 'F') v = 10 + (c - 'A');
+        else return false;
+        h = (h << 4) | static_cast<uint64_t>(v);
+    }
+    return true;
+}
+
+#endif // HASH_UTILS_H